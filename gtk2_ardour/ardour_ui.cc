@@ -5394,6 +5394,7 @@ ARDOUR_UI::popup_editor_meter_menu (GdkEventButton* ev)
 	_suspend_editor_meter_callbacks = true;
 	add_editor_meter_type_item (items, group, ArdourMeter::meter_type_string(MeterPeak), MeterPeak);
 	add_editor_meter_type_item (items, group, ArdourMeter::meter_type_string(MeterPeak0dB), MeterPeak0dB);
+	add_editor_meter_type_item (items, group, ArdourMeter::meter_type_string(MeterTruePeak), MeterTruePeak);
 	add_editor_meter_type_item (items, group, ArdourMeter::meter_type_string(MeterKrms),  MeterKrms);
 	add_editor_meter_type_item (items, group, ArdourMeter::meter_type_string(MeterIEC1DIN), MeterIEC1DIN);
 	add_editor_meter_type_item (items, group, ArdourMeter::meter_type_string(MeterIEC1NOR), MeterIEC1NOR);
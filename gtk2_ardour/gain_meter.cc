@@ -27,6 +27,7 @@
 
 #include "ardour/amp.h"
 #include "ardour/logmeter.h"
+#include "ardour/loudness_meter.h"
 #include "ardour/route_group.h"
 #include "ardour/session_route.h"
 #include "ardour/dB.h"
@@ -464,6 +465,9 @@ GainMeterBase::reset_peak_display ()
 	max_peak = minus_infinity ();
 	peak_display.set_text (_("-inf"));
 	peak_display.set_name ("MixerStripPeakDisplay");
+	if (_route->loudness_meter ()) {
+		_route->loudness_meter ()->reset ();
+	}
 }
 
 void
@@ -855,6 +859,41 @@ GainMeterBase::update_meters()
 	if (mpeak >= UIConfiguration::instance().get_meter_peak()) {
 		peak_display.set_name ("MixerStripPeakDisplayPeak");
 	}
+	update_loudness_tooltip ();
+}
+
+static std::string
+loudness_value (float v, const char* unit)
+{
+	if (v <= -200.f) {
+		return _("-inf");
+	}
+	char buf[32];
+	snprintf (buf, sizeof (buf), "%.1f %s", v, unit);
+	return buf;
+}
+
+void
+GainMeterBase::update_loudness_tooltip ()
+{
+	boost::shared_ptr<LoudnessMeter> lm = _route ? _route->loudness_meter () : boost::shared_ptr<LoudnessMeter> ();
+	LoudnessMeter::Readout r;
+
+	std::string tip;
+	if (lm && lm->read (r)) {
+		tip = string_compose (_("Loudness (EBU R128)\nMomentary: %1 (max %2)\nShort-term: %3 (max %4)\nIntegrated: %5\nRange: %6\nTrue-peak: %7"),
+				loudness_value (r.momentary, "LUFS"), loudness_value (r.max_momentary, "LUFS"),
+				loudness_value (r.short_term, "LUFS"), loudness_value (r.max_short_term, "LUFS"),
+				loudness_value (r.integrated, "LUFS"), loudness_value (r.range, "LU"),
+				loudness_value (r.true_peak, "dBTP"));
+	} else if (lm) {
+		return;
+	}
+
+	if (tip != loudness_tooltip) {
+		loudness_tooltip = tip;
+		set_tooltip (peak_display, loudness_tooltip);
+	}
 }
 
 void GainMeterBase::color_handler(bool /*dpi*/)
@@ -158,6 +158,9 @@ protected:
 	bool gain_focused (GdkEventFocus*);
 
 	float max_peak;
+	std::string loudness_tooltip;
+
+	void update_loudness_tooltip ();
 
 	void fader_moved ();
 	void gain_changed ();
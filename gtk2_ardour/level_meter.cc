@@ -153,7 +153,7 @@ LevelMeterBase::update_meters ()
 				const float peak = _meter->meter_level (n, _meter_type);
 				if (_meter_type == MeterPeak) {
 					(*i).meter->set (log_meter (peak));
-				} else if (_meter_type == MeterPeak0dB) {
+				} else if (_meter_type == MeterPeak0dB || _meter_type == MeterTruePeak) {
 					(*i).meter->set (log_meter0dB (peak));
 				} else if (_meter_type == MeterIEC1NOR) {
 					(*i).meter->set (meter_deflect_nordic (peak + meter_lineup(0)));
@@ -413,6 +413,7 @@ LevelMeterBase::setup_meters (int len, int initial_width, int thin_width)
 					c[7] = c[8] = c[9] = c[6];
 					break;
 				case MeterPeak0dB:
+				case MeterTruePeak:
 					 stp[1] =  89.125; // 115.0 * log_meter0dB(-9);
 					 stp[2] = 106.375; // 115.0 * log_meter0dB(-3);
 					 stp[3] = 115.0;   // 115.0 * log_meter0dB(0);
@@ -87,6 +87,9 @@ ArdourMeter::meter_type_string (ARDOUR::MeterType mt)
 		case MeterPeak0dB:
 			return _("Peak (0dBFS)");
 			break;
+		case MeterTruePeak:
+			return _("True Peak (0dBTP)");
+			break;
 		case MeterKrms:
 			return _("RMS + Peak");
 			break;
@@ -149,6 +152,7 @@ static inline float mtr_col_and_fract(
 			}
 			break;
 		case MeterPeak0dB:
+		case MeterTruePeak:
 			fraction = log_meter0dB (val);
 			if (val >= 0 || val == -9) {
 				cairo_set_source_rgb (cr,
@@ -517,6 +521,7 @@ meter_render_ticks (Gtk::Widget& w, MeterType type, vector<ARDOUR::DataType> typ
 					points.insert (std::pair<float,float>(  5, 0.5));
 					// no break
 				case MeterPeak0dB:
+				case MeterTruePeak:
 					points.insert (std::pair<float,float>(-60, 0.5));
 					points.insert (std::pair<float,float>(-50, 1.0));
 					points.insert (std::pair<float,float>(-40, 1.0));
@@ -703,7 +708,7 @@ meter_render_metrics (Gtk::Widget& w, MeterType type, vector<DataType> types)
 		switch (*i) {
 		case DataType::AUDIO:
 			layout->set_attributes (audio_font_attributes);
-			if (type == MeterPeak0dB) {
+			if (type == MeterPeak0dB || type == MeterTruePeak) {
 				overlay_midi = 4;
 			}
 			switch (type) {
@@ -756,6 +761,7 @@ meter_render_metrics (Gtk::Widget& w, MeterType type, vector<DataType> types)
 					points.insert (std::pair<float,string>(  3.0f, "+3"));
 					// no break
 				case MeterPeak0dB:
+				case MeterTruePeak:
 					points.insert (std::pair<float,string>(-50.0f, "-50"));
 					points.insert (std::pair<float,string>(-40.0f, "-40"));
 					points.insert (std::pair<float,string>(-30.0f, "-30"));
@@ -989,6 +995,9 @@ meter_render_metrics (Gtk::Widget& w, MeterType type, vector<DataType> types)
 					case MeterKrms:
 						layout->set_text("dBFS");
 						break;
+					case MeterTruePeak:
+						layout->set_text("dBTP");
+						break;
 					case MeterIEC2EBU:
 						layout->set_text("EBU");
 						break;
@@ -1765,6 +1765,11 @@ MixerStrip::build_route_ops_menu ()
 	denormal_menu_item = dynamic_cast<Gtk::CheckMenuItem *> (&items.back());
 	denormal_menu_item->set_active (_route->denormal_protection());
 
+	items.push_back (CheckMenuElem (_("Loudness Meter (EBU R128)")));
+	i = dynamic_cast<Gtk::CheckMenuItem *> (&items.back());
+	i->set_active (_route->loudness_meter () != 0);
+	i->signal_activate().connect (sigc::bind (sigc::mem_fun (*_route, &Route::set_loudness_metering), !_route->loudness_meter ()));
+
 	if (_route) {
 		/* note that this relies on selection being shared across editor and
 		   mixer (or global to the backend, in the future), which is the only
@@ -2543,6 +2548,7 @@ MixerStrip::popup_level_meter_menu (GdkEventButton* ev)
 
 	add_level_meter_item_type (items, tgroup, ArdourMeter::meter_type_string(MeterPeak), MeterPeak);
 	add_level_meter_item_type (items, tgroup, ArdourMeter::meter_type_string(MeterPeak0dB), MeterPeak0dB);
+	add_level_meter_item_type (items, tgroup, ArdourMeter::meter_type_string(MeterTruePeak), MeterTruePeak);
 	add_level_meter_item_type (items, tgroup, ArdourMeter::meter_type_string(MeterKrms),  MeterKrms);
 	add_level_meter_item_type (items, tgroup, ArdourMeter::meter_type_string(MeterIEC1DIN), MeterIEC1DIN);
 	add_level_meter_item_type (items, tgroup, ArdourMeter::meter_type_string(MeterIEC1NOR), MeterIEC1NOR);
@@ -161,6 +161,7 @@ ProcessorEntry::ProcessorEntry (ProcessorBox* parent, boost::shared_ptr<Processo
 	_button.set_fallthrough_to_parent(true);
 	_button.set_led_left (true);
 	_button.signal_led_clicked.connect (sigc::mem_fun (*this, &ProcessorEntry::led_clicked));
+	_button.signal_enter_notify_event ().connect (sigc::mem_fun (*this, &ProcessorEntry::button_enter_notify), false);
 	_button.set_text (name (_width));
 
 	if (boost::dynamic_pointer_cast<PeakMeter> (_processor)) {
@@ -500,9 +501,35 @@ ProcessorEntry::processor_configuration_changed (const ChanCount in, const ChanC
 	output_routing_icon.queue_draw();
 }
 
+bool
+ProcessorEntry::button_enter_notify (GdkEventCrossing*)
+{
+	if (Config->get_processor_cycle_stats () || Config->get_skip_silent_processing ()) {
+		/* update DSP statistics */
+		setup_tooltip ();
+	}
+	return false;
+}
+
+std::string
+ProcessorEntry::cycle_stats_tooltip () const
+{
+	double min, max, avg, p95, p99;
+	if (!_processor || !Config->get_processor_cycle_stats ()) {
+		return "";
+	}
+	if (!_processor->get_cycle_stats (min, max, avg, p95, p99)) {
+		return _("\nDSP: no data");
+	}
+	return string_compose (_("\nDSP [usec]: min %1, avg %2, max %3, 99%% %4"),
+			(int) rint (min), (int) rint (avg), (int) rint (max), (int) rint (p99));
+}
+
 void
 ProcessorEntry::setup_tooltip ()
 {
+	const std::string stats = cycle_stats_tooltip ();
+
 	if (_processor) {
 		boost::shared_ptr<PluginInsert> pi = boost::dynamic_pointer_cast<PluginInsert> (_processor);
 		if (pi) {
@@ -517,6 +544,17 @@ ProcessorEntry::setup_tooltip ()
 				postfix += string_compose(_("\nThis mono plugin has been replicated %1 times."), replicated);
 			}
 
+			postfix += stats;
+
+			samplecnt_t slept;
+			double saved_usec;
+			if (Config->get_skip_silent_processing () && pi->get_sleep_stats (slept, saved_usec)) {
+				postfix += string_compose (_("\n%1 for %2 sec, saved %3 ms DSP time"),
+						pi->sleeping () ? _("Sleeping") : _("Slept"),
+						(int) rint (slept / (double) pi->session ().nominal_sample_rate ()),
+						(int) rint (saved_usec / 1000.));
+			}
+
 			if (pi->plugin()->has_editor()) {
 				set_tooltip (_button,
 						string_compose (_("<b>%1</b>\nDouble-click to show GUI.\n%2+double-click to show generic GUI.%3"), name (Wide), Keyboard::secondary_modifier_name (), postfix));
@@ -535,14 +573,14 @@ ProcessorEntry::setup_tooltip ()
 		if ((send = boost::dynamic_pointer_cast<Send> (_processor)) != 0 &&
 				!boost::dynamic_pointer_cast<InternalSend>(_processor)) {
 			if (send->remove_on_disconnect ()) {
-				set_tooltip (_button, string_compose ("<b>&gt; %1</b>\nThis (sidechain) send will be removed when disconnected.", _processor->name()));
+				set_tooltip (_button, string_compose ("<b>&gt; %1</b>\nThis (sidechain) send will be removed when disconnected.%2", _processor->name(), stats));
 			} else {
-				set_tooltip (_button, string_compose ("<b>&gt; %1</b>", _processor->name()));
+				set_tooltip (_button, string_compose ("<b>&gt; %1</b>%2", _processor->name(), stats));
 			}
 			return;
 		}
 	}
-	set_tooltip (_button, string_compose ("<b>%1</b>", name (Wide)));
+	set_tooltip (_button, string_compose ("<b>%1</b>%2", name (Wide), stats));
 }
 
 string
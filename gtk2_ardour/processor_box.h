@@ -186,6 +186,8 @@ private:
 	void processor_configuration_changed (const ARDOUR::ChanCount in, const ARDOUR::ChanCount out);
 	std::string name (Width) const;
 	void setup_tooltip ();
+	std::string cycle_stats_tooltip () const;
+	bool button_enter_notify (GdkEventCrossing*);
 
 	boost::shared_ptr<ARDOUR::Processor> _processor;
 	Width _width;
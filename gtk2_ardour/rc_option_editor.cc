@@ -2160,6 +2160,18 @@ RCOptionEditor::RCOptionEditor ()
 		add_option (_("General"), procs);
 	}
 
+	add_option (_("General"), new OptionEditorHeading (_("DSP Profiling")));
+
+	bo = new BoolOption (
+			"processor-cycle-stats",
+			_("Collect per-processor DSP statistics"),
+			sigc::mem_fun (*_rc_config, &RCConfiguration::get_processor_cycle_stats),
+			sigc::mem_fun (*_rc_config, &RCConfiguration::set_processor_cycle_stats)
+			);
+	Gtkmm2ext::UI::instance()->set_tip (bo->tip_widget(),
+			_("When enabled, the time spent in every plugin and processor is measured. Statistics are shown in the processor-box tooltips, and available via OSC and Lua."));
+	add_option (_("General"), bo);
+
 	/* Image cache size */
 	add_option (_("General"), new OptionEditorHeading (_("Memory Usage")));
 
@@ -2823,6 +2835,61 @@ RCOptionEditor::RCOptionEditor ()
 
 	add_option (_("Audio"), dm);
 
+	add_option (_("Audio"), new OptionEditorHeading (_("DSP Optimizations")));
+
+	bo = new BoolOption (
+		     "skip-silent-processing",
+		     _("Skip processing of silent signals"),
+		     sigc::mem_fun (*_rc_config, &RCConfiguration::get_skip_silent_processing),
+		     sigc::mem_fun (*_rc_config, &RCConfiguration::set_skip_silent_processing)
+		     );
+	Gtkmm2ext::UI::instance()->set_tip (bo->tip_widget(),
+			_("When enabled, silence from disk and inputs is detected, and processors and plugins are not run while their input is silent and their output has decayed."));
+	add_option (_("Audio"), bo);
+
+	bo = new BoolOption (
+		     "parallel-replicated-plugins",
+		     _("Process replicated plugins in parallel"),
+		     sigc::mem_fun (*_rc_config, &RCConfiguration::get_parallel_replicated_plugins),
+		     sigc::mem_fun (*_rc_config, &RCConfiguration::set_parallel_replicated_plugins)
+		     );
+	Gtkmm2ext::UI::instance()->set_tip (bo->tip_widget(),
+			_("When enabled, the instances of a mono plugin that is replicated for multi-channel tracks are processed concurrently on separate CPU cores, if a single instance takes longer than the given threshold."));
+	add_option (_("Audio"), bo);
+
+	add_option (_("Audio"),
+	     new SpinOption<uint32_t> (
+		     "parallel-plugin-threshold",
+		     _("Parallel processing threshold [usec]"),
+		     sigc::mem_fun (*_rc_config, &RCConfiguration::get_parallel_plugin_threshold),
+		     sigc::mem_fun (*_rc_config, &RCConfiguration::set_parallel_plugin_threshold),
+		     10, 10000, 10, 100
+		     ));
+
+	ComboOption<uint32_t>* vq = new ComboOption<uint32_t> (
+		     "varispeed-quality",
+		     _("Varispeed resampling"),
+		     sigc::mem_fun (*_rc_config, &RCConfiguration::get_varispeed_quality),
+		     sigc::mem_fun (*_rc_config, &RCConfiguration::set_varispeed_quality)
+		     );
+	vq->add (0, _("Cubic (lowest CPU load)"));
+	vq->add (1, _("Band-limited, fast"));
+	vq->add (2, _("Band-limited, medium"));
+	vq->add (3, _("Band-limited, best"));
+	Gtkmm2ext::UI::instance()->set_tip (vq->tip_widget(),
+			_("Interpolation used when playing back from disk at a speed other than 1.0. Band-limited resampling avoids aliasing and imaging artifacts, at a higher CPU cost."));
+	add_option (_("Audio"), vq);
+
+	bo = new BoolOption (
+		     "cache-resampled-sources",
+		     _("Cache resampled files"),
+		     sigc::mem_fun (*_rc_config, &RCConfiguration::get_cache_resampled_sources),
+		     sigc::mem_fun (*_rc_config, &RCConfiguration::set_cache_resampled_sources)
+		     );
+	Gtkmm2ext::UI::instance()->set_tip (bo->tip_widget(),
+			_("When enabled, files that are played back with sample-rate conversion (e.g. when auditioning) are resampled once in the background, and kept in the session's peak folder. Later reads of the file are plain disk reads."));
+	add_option (_("Audio"), bo);
+
 	add_option (_("Audio"), new OptionEditorHeading (_("Regions")));
 
 	add_option (_("Audio"),
@@ -3028,6 +3095,7 @@ RCOptionEditor::RCOptionEditor ()
 		sigc::mem_fun (*_rc_config, &RCConfiguration::set_meter_type_master)
 		);
 	mtm->add (MeterPeak,    ArdourMeter::meter_type_string(MeterPeak));
+	mtm->add (MeterTruePeak, ArdourMeter::meter_type_string(MeterTruePeak));
 	mtm->add (MeterK20,     ArdourMeter::meter_type_string(MeterK20));
 	mtm->add (MeterK14,     ArdourMeter::meter_type_string(MeterK14));
 	mtm->add (MeterK12,     ArdourMeter::meter_type_string(MeterK12));
@@ -3046,6 +3114,7 @@ RCOptionEditor::RCOptionEditor ()
 		sigc::mem_fun (*_rc_config, &RCConfiguration::set_meter_type_bus)
 		);
 	mtb->add (MeterPeak,    ArdourMeter::meter_type_string(MeterPeak));
+	mtb->add (MeterTruePeak, ArdourMeter::meter_type_string(MeterTruePeak));
 	mtb->add (MeterK20,     ArdourMeter::meter_type_string(MeterK20));
 	mtb->add (MeterK14,     ArdourMeter::meter_type_string(MeterK14));
 	mtb->add (MeterK12,     ArdourMeter::meter_type_string(MeterK12));
@@ -3064,6 +3133,7 @@ RCOptionEditor::RCOptionEditor ()
 		);
 	mtt->add (MeterPeak,    ArdourMeter::meter_type_string(MeterPeak));
 	mtt->add (MeterPeak0dB, ArdourMeter::meter_type_string(MeterPeak0dB));
+	mtt->add (MeterTruePeak, ArdourMeter::meter_type_string(MeterTruePeak));
 
 	add_option (S_("Preferences|Metering"), mtt);
 
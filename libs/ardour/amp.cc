@@ -108,8 +108,16 @@ Amp::run (BufferSet& bufs, samplepos_t /*start_sample*/, samplepos_t /*end_sampl
 		gain_t lpf = _current_gain;
 
 		for (BufferSet::audio_iterator i = bufs.audio_begin(); i != bufs.audio_end(); ++i) {
-			Sample* const sp = i->data();
 			lpf = _current_gain;
+			if (i->silent ()) {
+				/* no need to apply gain to silence (and keep the buffer
+				 * flagged as silent), only follow the automation */
+				for (pframes_t nx = 0; nx < nframes; ++nx) {
+					lpf += a * (gab[nx] - lpf);
+				}
+				continue;
+			}
+			Sample* const sp = i->data();
 			for (pframes_t nx = 0; nx < nframes; ++nx) {
 				sp[nx] *= lpf;
 				lpf += a * (gab[nx] - lpf);
@@ -160,7 +168,9 @@ Amp::run (BufferSet& bufs, samplepos_t /*start_sample*/, samplepos_t /*end_sampl
 			}
 
 			for (BufferSet::audio_iterator i = bufs.audio_begin(); i != bufs.audio_end(); ++i) {
-				apply_gain_to_buffer (i->data(), nframes, _current_gain);
+				if (!i->silent ()) {
+					apply_gain_to_buffer (i->data(), nframes, _current_gain);
+				}
 			}
 		} else {
 			/* unity target gain */
@@ -222,12 +232,19 @@ Amp::apply_gain (BufferSet& bufs, samplecnt_t sample_rate, samplecnt_t nframes,
 	const gain_t a = 156.825f / (gain_t)sample_rate; // 25 Hz LPF
 
 	for (BufferSet::audio_iterator i = bufs.audio_begin(); i != bufs.audio_end(); ++i) {
-		Sample* const buffer = i->data();
 		double lpf = initial;
 
-		for (pframes_t nx = 0; nx < nframes; ++nx) {
-			buffer[nx] *= lpf;
-			lpf += a * (target - lpf);
+		if (i->silent ()) {
+			/* no need to apply gain to silence, only follow the ramp */
+			for (pframes_t nx = 0; nx < nframes; ++nx) {
+				lpf += a * (target - lpf);
+			}
+		} else {
+			Sample* const buffer = i->data();
+			for (pframes_t nx = 0; nx < nframes; ++nx) {
+				buffer[nx] *= lpf;
+				lpf += a * (target - lpf);
+			}
 		}
 		if (i == bufs.audio_begin()) {
 			rv = lpf;
@@ -329,7 +346,9 @@ Amp::apply_simple_gain (BufferSet& bufs, samplecnt_t nframes, gain_t target, boo
 		}
 
 		for (BufferSet::audio_iterator i = bufs.audio_begin(); i != bufs.audio_end(); ++i) {
-			memset (i->data(), 0, sizeof (Sample) * nframes);
+			if (!i->silent ()) {
+				memset (i->data(), 0, sizeof (Sample) * nframes);
+			}
 		}
 
 	} else if (target != GAIN_COEFF_UNITY) {
@@ -349,7 +368,9 @@ Amp::apply_simple_gain (BufferSet& bufs, samplecnt_t nframes, gain_t target, boo
 		}
 
 		for (BufferSet::audio_iterator i = bufs.audio_begin(); i != bufs.audio_end(); ++i) {
-			apply_gain_to_buffer (i->data(), nframes, target);
+			if (!i->silent ()) {
+				apply_gain_to_buffer (i->data(), nframes, target);
+			}
 		}
 	}
 }
@@ -614,6 +614,18 @@ class LIBARDOUR_API AudioBackend : public PortEngine {
      */
     virtual float dsp_load() const  = 0;
 
+    /** return a human readable report of process cycle timing
+     * statistics collected since the backend was started or since
+     * reset_cycle_timing() was called (e.g. the achieved realtime factor
+     * and a histogram of cycle durations).
+     *
+     * Backends that do not collect statistics return an empty string.
+     */
+    virtual std::string cycle_timing_report () const { return std::string (); }
+
+    /** restart collecting process cycle timing statistics */
+    virtual void reset_cycle_timing () {}
+
     /* Transport Control (JACK is the only audio API that currently offers
        the concept of shared transport control)
     */
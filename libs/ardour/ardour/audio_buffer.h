@@ -220,6 +220,18 @@ public:
 	 */
 	bool check_silence (pframes_t nframes, pframes_t& n) const;
 
+	/** scan the complete buffer (capacity) and flag it as silent
+	 * if all samples are zero.
+	 * @return true if the buffer is silent
+	 */
+	bool detect_silence () {
+		if (!_silent && _capacity > 0) {
+			pframes_t n;
+			_silent = check_silence (_capacity, n);
+		}
+		return _silent;
+	}
+
 	void prepare () {
 		if (!_owns_data) {
 			_data = 0;
@@ -71,6 +71,7 @@ class LIBARDOUR_API AUPlugin : public ARDOUR::Plugin
 	uint32_t parameter_count () const;
 	float default_value (uint32_t port);
 	samplecnt_t signal_latency() const;
+	samplecnt_t signal_tail () const;
 	void set_parameter (uint32_t which, float val);
 	float get_parameter (uint32_t which) const;
 
@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2026 The Ardour Developers
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef __ardour_cycle_stats_h__
+#define __ardour_cycle_stats_h__
+
+#include <stdint.h>
+#include <glib.h>
+
+#include "ardour/libardour_visibility.h"
+#include "ardour/cycles.h"
+
+namespace ARDOUR {
+
+/** Lock-free accumulator for the CPU cycles spent in a single
+ * process-thread code path (e.g. one Processor::run () call).
+ *
+ * There must only be a single writer (the thread calling update()).
+ * Readers may query the statistics from any thread at any time; values
+ * are not guaranteed to be a consistent snapshot, which is fine for
+ * monitoring purposes.
+ *
+ * Besides min/max/average, a coarse logarithmic histogram (4 buckets per
+ * octave, ~19% resolution) is kept, from which percentiles are estimated.
+ */
+class LIBARDOUR_API CycleStats
+{
+public:
+	CycleStats ();
+
+	/** add a measurement (process thread) */
+	void update (uint64_t elapsed);
+
+	/** add a measurement given two get_cycles() values (process thread).
+	 * Readings of a 64-bit counter that went backwards are discarded.
+	 */
+	void update (cycles_t start, cycles_t end) {
+		if (end >= start || sizeof (cycles_t) < 8) {
+			update (elapsed (start, end));
+		}
+	}
+
+	/** @return cycles between two get_cycles() calls.
+	 * Most platforms only provide the lower 32 bits of the counter,
+	 * take care of wrap-around. A 64-bit counter does not wrap, if it
+	 * went backwards (e.g. the thread moved to a CPU whose counter is
+	 * behind), 0 is returned.
+	 */
+	static uint64_t elapsed (cycles_t start, cycles_t end) {
+		if (end >= start) {
+			return end - start;
+		}
+		if (sizeof (cycles_t) >= 8) {
+			return 0;
+		}
+		return (uint64_t) end + 0x100000000ULL - (uint64_t) start;
+	}
+
+	/** request a reset, performed by the writer on the next update() */
+	void reset () { g_atomic_int_set (&_reset, 1); }
+
+	/** @return number of measurements since the last reset */
+	uint64_t count () const { return _cnt; }
+
+	/** query statistics in CPU cycles.
+	 * @return false if there is no data
+	 */
+	bool get_stats (uint64_t& min, uint64_t& max, double& avg) const;
+
+	/** estimate the given percentile (0..100) in CPU cycles */
+	uint64_t percentile (float pc) const;
+
+	/** query statistics in microseconds,
+	 * @return false if there is no data, or cycle counters are not available
+	 */
+	bool get_stats_usec (double& min, double& max, double& avg, double& p95, double& p99) const;
+
+	/** calibrate and return the cycle-counter rate.
+	 * This is done once, by ARDOUR::init (). The first call blocks
+	 * for ~20ms and must not be made from a realtime thread.
+	 * @return cycles per microsecond, 0 if the platform has no cycle counter
+	 */
+	static double cycles_per_usec ();
+
+	/** @return cycles per microsecond, without calibrating (realtime safe).
+	 * The value is negative if cycles_per_usec () has not yet been called.
+	 */
+	static double calibrated_cycles_per_usec () { return _cycles_per_usec; }
+
+private:
+	static const int n_buckets = 256;
+
+	static int bucket (uint64_t v);
+	static uint64_t bucket_value (int b);
+
+	void clear ();
+
+	gint     _reset;
+	uint64_t _cnt;
+	uint64_t _min;
+	uint64_t _max;
+	uint64_t _sum;
+	uint32_t _hist[n_buckets];
+
+	static gpointer calibrate (gpointer);
+	static double _cycles_per_usec;
+};
+
+} // namespace ARDOUR
+
+#endif /* __ardour_cycle_stats_h__ */
@@ -23,6 +23,8 @@
 #include <boost/shared_ptr.hpp>
 #include <boost/shared_array.hpp>
 
+#include <glib.h>
+
 #include "ardour/types.h"
 #include "ardour/processor.h"
 
@@ -51,11 +53,17 @@ public:
 	bool can_support_io_configuration (const ChanCount& in, ChanCount& out);
 	void flush ();
 
+	/** memory used by the audio delay buffers of this line, in bytes */
+	size_t memory_used () const { return _buf.size () * _bsiz * sizeof (Sample); }
+	/** memory used by the audio delay buffers of all lines, in bytes */
+	static size_t allocated_bytes ();
+
 protected:
 	XMLNode& state ();
 
 private:
 	void allocate_pending_buffers (samplecnt_t, ChanCount const&);
+	static samplecnt_t buffer_size_for (samplecnt_t);
 
 	void write_to_rb (Sample* rb, Sample* src, samplecnt_t); // honor _woff, _bsiz.
 	void read_from_rb (Sample* rb, Sample* dst, samplecnt_t); // honor _roff, _bsiz
@@ -67,13 +75,20 @@ private:
 	samplecnt_t    _delay, _pending_delay;
 	sampleoffset_t _roff, _woff;
 	bool           _pending_flush;
+	bool           _release_buffers; // set by run() when the delay reached zero
 
-	typedef std::vector<boost::shared_array<Sample> > AudioDlyBuf;
+	/* one ringbuffer per channel, in a single allocation (_buf_data).
+	 * Nothing is allocated until the line has a delay.
+	 */
+	typedef std::vector<Sample*> AudioDlyBuf;
 	typedef std::vector<boost::shared_array<MidiBuffer> > MidiDlyBuf;
 
 	AudioDlyBuf _buf;
+	boost::shared_array<Sample> _buf_data;
 	boost::shared_ptr<MidiBuffer> _midi_buf;
 
+	static gint _allocated_samples;
+
 #ifndef NDEBUG
 	Glib::Threads::Mutex _set_delay_mutex;
 #endif
@@ -175,6 +175,7 @@ class LIBARDOUR_API DiskIOProcessor : public Processor
 	int remove_channel_from (boost::shared_ptr<ChannelList>, uint32_t how_many);
 
 	CubicInterpolation interpolation;
+	SincInterpolation  sinc_interpolation;
 
 	boost::shared_ptr<Playlist> _playlists[DataType::num_types];
 	PBD::ScopedConnectionList playlist_connections;
@@ -117,6 +117,7 @@ private:
 	samplepos_t   overwrite_sample;
 	off_t         overwrite_offset;
 	bool          _pending_overwrite;
+	gint          _pending_interpolation_reset; // set by seek (), handled by run ()
 	bool          overwrite_queued;
 	IOChange      input_change_pending;
 	samplepos_t   file_sample[DataType::num_types];
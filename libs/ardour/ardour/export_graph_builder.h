@@ -41,6 +41,8 @@ namespace AudioGrapher {
 	template <typename T> class SndfileWriter;
 	template <typename T> class SilenceTrimmer;
 	template <typename T> class TmpFile;
+	class SpillBuffer;
+	class SpillBudget;
 	template <typename T> class Threader;
 	template <typename T> class AllocatingProcessContext;
 }
@@ -67,6 +69,11 @@ class LIBARDOUR_API ExportGraphBuilder
 	ExportGraphBuilder (Session const & session);
 	~ExportGraphBuilder ();
 
+	/** Process one cycle.
+	 * Configurations of several timespans can be added (see set_current_timespan ()),
+	 * the cycle is then passed to all timespans that overlap it, concurrently
+	 * using the thread-pool. Processing starts at the earliest timespan start.
+	 */
 	int process (samplecnt_t samples, bool last_cycle);
 	bool post_process (); // returns true when finished
 	bool need_postprocessing () const { return !intermediates.empty(); }
@@ -75,6 +82,7 @@ class LIBARDOUR_API ExportGraphBuilder
 
 	void reset ();
 	void cleanup (bool remove_out_files = false);
+	/** Set the timespan for subsequently added configurations. */
 	void set_current_timespan (boost::shared_ptr<ExportTimespan> span);
 	void add_config (FileSpec const & config, bool rt);
 	void get_analysis_results (AnalysisResults& results);
@@ -87,6 +95,10 @@ class LIBARDOUR_API ExportGraphBuilder
 
 	void add_split_config (FileSpec const & config);
 
+	struct TimespanGraph;
+	void process_timespan (TimespanGraph&);
+	void process_timespan_job (TimespanGraph*);
+
 	class Encoder {
             public:
 		template <typename T> boost::shared_ptr<AudioGrapher::Sink<T> > init (FileSpec const & new_config);
@@ -165,6 +177,7 @@ class LIBARDOUR_API ExportGraphBuilder
 		typedef boost::shared_ptr<AudioGrapher::LoudnessReader> LoudnessReaderPtr;
 		typedef boost::shared_ptr<AudioGrapher::Normalizer> NormalizerPtr;
 		typedef boost::shared_ptr<AudioGrapher::TmpFile<Sample> > TmpFilePtr;
+		typedef boost::shared_ptr<AudioGrapher::SpillBuffer> SpillBufferPtr;
 		typedef boost::shared_ptr<AudioGrapher::Threader<Sample> > ThreaderPtr;
 		typedef boost::shared_ptr<AudioGrapher::AllocatingProcessContext<Sample> > BufferPtr;
 
@@ -179,7 +192,8 @@ class LIBARDOUR_API ExportGraphBuilder
 		bool            use_peak;
 		BufferPtr       buffer;
 		PeakReaderPtr   peak_reader;
-		TmpFilePtr      tmp_file;
+		TmpFilePtr      tmp_file; // realtime export
+		SpillBufferPtr  spill;    // freewheel export
 		NormalizerPtr   normalizer;
 		ThreaderPtr     threader;
 		LoudnessReaderPtr    loudness_reader;
@@ -238,6 +252,7 @@ class LIBARDOUR_API ExportGraphBuilder
 		void add_child (FileSpec const & new_config);
 		void remove_children (bool remove_out_files);
 		bool operator== (FileSpec const & other_config) const;
+		boost::shared_ptr<ExportTimespan> get_timespan () const { return timespan; }
 
 	                                        private:
 		typedef boost::shared_ptr<AudioGrapher::Interleaver<Sample> > InterleaverPtr;
@@ -245,6 +260,7 @@ class LIBARDOUR_API ExportGraphBuilder
 
 		ExportGraphBuilder &      parent;
 		FileSpec                  config;
+		boost::shared_ptr<ExportTimespan> timespan;
 		boost::ptr_list<SilenceHandler> children;
 		InterleaverPtr            interleaver;
 		ChunkerPtr                chunker;
@@ -258,18 +274,43 @@ class LIBARDOUR_API ExportGraphBuilder
 	typedef boost::ptr_list<ChannelConfig> ChannelConfigList;
 	ChannelConfigList channel_configs;
 
-	// The sources of all data, each channel is read only once
-	ChannelMap channels;
+	// The sources of all data, each channel is read only once per cycle
+	typedef std::map<ExportChannelPtr, Sample const *> ChannelData;
+	ChannelData channel_data;
+
+	// Per timespan inputs, each timespan receives the part of the cycle it covers
+	struct TimespanGraph {
+		TimespanGraph (boost::shared_ptr<ExportTimespan> s) : span (s) {}
+		boost::shared_ptr<ExportTimespan> span;
+		ChannelMap channels;
+	};
+	typedef std::list<TimespanGraph> TimespanGraphList;
+	TimespanGraphList timespans;
+	std::vector<TimespanGraph*> active_timespans;
 
 	samplecnt_t process_buffer_samples;
+	samplepos_t process_position;
+	samplecnt_t cycle_samples;
+	bool        cycle_last;
 
 	std::list<Intermediate *> intermediates;
+	Glib::Threads::Mutex intermediates_lock;
 
 	AnalysisMap analysis_map;
 
 	bool _realtime;
 
+	/* memory shared by all Intermediates of an export */
+	boost::shared_ptr<AudioGrapher::SpillBudget> spill_budget;
+
 	Glib::ThreadPool thread_pool;
+
+	/* concurrent processing of timespans */
+	Glib::Threads::Mutex wait_mutex;
+	Glib::Threads::Cond  wait_cond;
+	gint                 n_jobs;
+	Glib::Threads::Mutex failure_mutex;
+	std::string          failure;
 };
 
 } // namespace ARDOUR
@@ -22,6 +22,7 @@
 #define __ardour_export_handler_h__
 
 #include <map>
+#include <set>
 
 #include <boost/operators.hpp>
 #include <boost/shared_ptr.hpp>
@@ -126,7 +127,8 @@ class LIBARDOUR_API ExportHandler : public ExportElementFactory, public sigc::tr
 
   private:
 
-	void handle_duplicate_format_extensions();
+	void handle_duplicate_format_extensions (ExportTimespanPtr);
+	bool can_export_in_parallel (ExportTimespanPtr) const;
 	int process (samplecnt_t samples);
 
 	Session &          session;
@@ -148,12 +150,17 @@ class LIBARDOUR_API ExportHandler : public ExportElementFactory, public sigc::tr
 	int  post_process ();
 	void finish_timespan ();
 
-	typedef std::pair<ConfigMap::iterator, ConfigMap::iterator> TimespanBounds;
+	/* With export-parallel-timespans, timespans that overlap or adjoin are
+	 * rendered in a single pass: current_timespans holds all of them, and
+	 * process_position..timespan_end covers the union of their ranges.
+	 */
+	typedef std::set<ExportTimespanPtr> TimespanSet;
 	ExportTimespanPtr     current_timespan;
-	TimespanBounds        timespan_bounds;
+	TimespanSet           current_timespans;
 
 	PBD::ScopedConnection process_connection;
 	samplepos_t             process_position;
+	samplepos_t             timespan_end;
 
 	/* CD Marker stuff */
 
@@ -18,6 +18,7 @@
 */
 
 #include <math.h>
+#include <vector>
 #include <samplerate.h>
 
 #include "ardour/libardour_visibility.h"
@@ -48,8 +49,16 @@ public:
 	double target_speed()          const { return _target_speed; }
 	double speed()                 const { return _speed; }
 
-	void add_channel ()    { phase.push_back (0.0); }
-	void remove_channel () { phase.pop_back (); }
+	virtual void add_channel ()    { phase.push_back (0.0); }
+	virtual void remove_channel () { phase.pop_back (); }
+
+	/** resample one channel of @a input into @a output.
+	 * @param output_samples number of samples to produce, set to the number produced
+	 * @return number of input samples consumed
+	 */
+	virtual samplecnt_t interpolate (int channel, samplecnt_t input_samples, Sample* input, samplecnt_t & output_samples, Sample* output) = 0;
+	/** number of input samples consumed when producing @a nframes at the current speed */
+	virtual samplecnt_t distance (samplecnt_t nframes) = 0;
 
 	virtual void reset () {
 		for (size_t i = 0; i < phase.size(); i++) {
@@ -75,6 +84,86 @@ class LIBARDOUR_API CubicInterpolation : public Interpolation {
 	void invalidate (int n)     { valid_z_bits &= (1<<n); }
 };
 
+/** Band-limited interpolation with a Kaiser-windowed sinc filter.
+ *
+ * The filter is a polyphase table, coefficients between two phases are
+ * linearly interpolated. When playing faster than 1.0, the cutoff is lowered
+ * (and the filter made longer) so that the result does not alias: one of a
+ * few tables with increasing stretch is chosen for the current speed.
+ * Tables are shared by all instances and built once, which makes
+ * set_quality () realtime safe.
+ *
+ * The filter is centered on the output position, so up to lookahead ()
+ * samples past the last consumed one are read. Unlike CubicInterpolation,
+ * all given input is used when the output is not complete: the most recent
+ * input samples of every channel are kept and used at the start of the next
+ * call, so the two halves of a ringbuffer read-vector can be passed in two
+ * calls without a discontinuity.
+ *
+ * Like the session's transport, distance () is floor (speed * nframes), the
+ * output of a cycle is spread evenly over that input. The pitch follows the
+ * actual transport motion and the playback position never drifts from it.
+ * distance () must be called once per cycle, before interpolate ().
+ */
+class LIBARDOUR_API SincInterpolation : public Interpolation {
+  public:
+	enum Quality {
+		Fast,
+		Medium,
+		Best
+	};
+
+	SincInterpolation (Quality q = Medium);
+
+	samplecnt_t interpolate (int channel, samplecnt_t input_samples, Sample* input, samplecnt_t & output_samples, Sample* output);
+	samplecnt_t distance (samplecnt_t nframes);
+	void reset ();
+
+	void add_channel ();
+	void remove_channel ();
+
+	/** change the filter, this resets the interpolator */
+	void set_quality (Quality);
+	Quality quality () const { return _quality; }
+
+	/** number of input samples needed after the ones that are consumed */
+	samplecnt_t lookahead () const { return _lookahead; }
+
+	struct Table {
+		uint32_t taps;   ///< multiple of 8
+		uint32_t phases;
+		std::vector<float> coeff; ///< phases + 1 rows of taps
+		std::vector<float> delta; ///< phases rows, difference to the next row
+	};
+
+	static const uint32_t n_stretch = 8;
+
+  private:
+	Quality      _quality;
+	Table const* _tables[n_stretch];
+	samplecnt_t  _lookahead;
+
+	std::vector<std::vector<float> > _history;
+	std::vector<float>               _edge;
+
+	/* outputs produced and inputs given since phase[] was last updated,
+	 * when a cycle's input is passed in more than one call */
+	std::vector<samplecnt_t> _produced;
+	std::vector<samplecnt_t> _absorbed;
+
+	/* input consumed and output produced per cycle, set by distance ().
+	 * The input advances by exactly as much as the transport moves
+	 * (floor (speed * nframes)), the outputs are spread evenly over it */
+	samplecnt_t _cycle_distance;
+	samplecnt_t _cycle_length;
+
+	double position (double base, samplecnt_t n) const {
+		return base + (double) (_cycle_distance * n) / (double) _cycle_length;
+	}
+
+	static void build_tables ();
+};
+
 } // namespace ARDOUR
 
 #endif
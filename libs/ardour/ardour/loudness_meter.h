@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2026 The Ardour Developers
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef __ardour_loudness_meter_h__
+#define __ardour_loudness_meter_h__
+
+#include <vector>
+#include <glib.h>
+
+#include "audiographer/general/loudness.h"
+#include "audiographer/general/true_peak.h"
+
+#include "ardour/libardour_visibility.h"
+#include "ardour/processor.h"
+#include "ardour/types.h"
+
+namespace ARDOUR {
+
+/** Realtime EBU R128 loudness meter.
+ *
+ * Measures momentary, short-term and integrated loudness, loudness range
+ * and true-peak of all audio channels passing through it (the signal is
+ * not modified). Integration only proceeds while the transport is rolling.
+ *
+ * Values are updated every 50 ms in the process thread and published
+ * lock-free; any thread can poll them using read ().
+ *
+ * The DSP is shared with export analysis, see AudioGrapher::LoudnessKernel.
+ */
+class LIBARDOUR_API LoudnessMeter : public Processor
+{
+public:
+	LoudnessMeter (Session&);
+
+	struct Readout {
+		Readout ()
+			: momentary (-200), short_term (-200), integrated (-200), range (0)
+			, max_momentary (-200), max_short_term (-200), true_peak (-200) {}
+
+		float momentary;      ///< LUFS
+		float short_term;     ///< LUFS
+		float integrated;     ///< LUFS, -200 if there is no data
+		float range;          ///< LU
+		float max_momentary;  ///< LUFS
+		float max_short_term; ///< LUFS
+		float true_peak;      ///< dBTP, max since reset
+	};
+
+	bool display_to_user () const { return false; }
+	void run (BufferSet& bufs, samplepos_t start_sample, samplepos_t end_sample, double speed, pframes_t nframes, bool result_required);
+	bool configure_io (ChanCount in, ChanCount out);
+	bool can_support_io_configuration (const ChanCount& in, ChanCount& out);
+
+	/** Get the most recent values, RT safe and lock-free.
+	 * @return false if no consistent readout could be obtained (the process thread was updating it)
+	 */
+	bool read (Readout&) const;
+
+	float momentary () const      { Readout r; read (r); return r.momentary; }
+	float short_term () const     { Readout r; read (r); return r.short_term; }
+	float integrated () const     { Readout r; read (r); return r.integrated; }
+	float range () const          { Readout r; read (r); return r.range; }
+	float max_momentary () const  { Readout r; read (r); return r.max_momentary; }
+	float max_short_term () const { Readout r; read (r); return r.max_short_term; }
+	float true_peak () const      { Readout r; read (r); return r.true_peak; }
+
+	/** Restart measurement and integration.
+	 * This can be called from any thread, it takes effect with the next process cycle.
+	 */
+	void reset ();
+
+protected:
+	XMLNode& state ();
+
+private:
+	void publish ();
+
+	AudioGrapher::LoudnessKernel _kernel;
+	AudioGrapher::TruePeakKernel _tp;
+	std::vector<float const*>    _data;
+	float                        _tp_max;
+	uint64_t                     _n_published;
+	gint                         _reset_request;
+
+	/* seqlock: odd while the process thread updates _readout */
+	mutable gint _seq;
+	Readout      _readout;
+};
+
+} // namespace ARDOUR
+
+#endif // __ardour_loudness_meter_h__
@@ -76,6 +76,7 @@ class LIBARDOUR_API LV2Plugin : public ARDOUR::Plugin, public ARDOUR::Workee
 	float       default_value (uint32_t port);
 	samplecnt_t  max_latency () const;
 	samplecnt_t  signal_latency () const;
+	bool        uses_transport_position () const;
 	void        set_parameter (uint32_t port, float val);
 	float       get_parameter (uint32_t port) const;
 	std::string get_docs() const;
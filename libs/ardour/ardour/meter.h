@@ -25,10 +25,9 @@
 #include "ardour/processor.h"
 #include "pbd/fastlog.h"
 
-#include "ardour/kmeterdsp.h"
-#include "ardour/iec1ppmdsp.h"
-#include "ardour/iec2ppmdsp.h"
-#include "ardour/vumeterdsp.h"
+#include "audiographer/general/true_peak.h"
+
+#include "ardour/meter_kernel.h"
 
 namespace ARDOUR {
 
@@ -101,10 +100,13 @@ private:
 	std::vector<float> _max_peak_signal; // dB calculation is done on demand
 	float _combined_peak; // Mackie surfaces expect the highest peak of all track channels
 
-	std::vector<Kmeterdsp *> _kmeter;
-	std::vector<Iec1ppmdsp *> _iec1meter;
-	std::vector<Iec2ppmdsp *> _iec2meter;
-	std::vector<Vumeterdsp *> _vumeter;
+	/* K-, IEC- and VU-meters of all audio channels */
+	MeterKernel _kernel;
+	std::vector<float const*> _kernel_data; // per audio channel
+	std::vector<float> _kernel_peak;        // per audio channel
+
+	/* 4x oversampled peak of all audio channels, used for MeterTruePeak */
+	AudioGrapher::TruePeakKernel _true_peak;
 
 	MeterType _meter_type;
 };
@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2026 The Ardour Developers
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef __ardour_meter_kernel_h__
+#define __ardour_meter_kernel_h__
+
+#include <vector>
+
+#include "ardour/libardour_visibility.h"
+#include "ardour/types.h"
+
+namespace ARDOUR {
+
+/** Multi-channel meter DSP.
+ *
+ * Computes sample-peak and the ballistics of K-meter (RMS),
+ * IEC1 (DIN/Nordic) and IEC2 (BBC/EBU) PPM and VU meters for all
+ * channels in a single pass over the audio data.
+ *
+ * The filter state of all channels is kept in arrays, channels are
+ * processed in groups of 4, allowing the compiler to vectorize the
+ * computation across channels.
+ *
+ * The ballistics are identical to Kmeterdsp, Iec1ppmdsp, Iec2ppmdsp
+ * and Vumeterdsp.
+ */
+class LIBARDOUR_API MeterKernel
+{
+public:
+	MeterKernel ();
+
+	/** set filter coefficients for the given sample-rate */
+	static void init (float fsamp);
+
+	/** allocate state for the given number of channels (not realtime safe) */
+	void set_channels (uint32_t n);
+	uint32_t n_channels () const { return _n_channels; }
+
+	/** reset all meters */
+	void reset ();
+	/** reset meters of the given MeterType(s) */
+	void reset (uint32_t types);
+
+	/** Process one cycle.
+	 *
+	 * Meter ballistics are only computed for multiples of 4 samples.
+	 *
+	 * @param data one buffer per channel
+	 * @param n_chn number of channels to process, must not exceed n_channels ()
+	 * @param n_samples number of samples in each buffer
+	 * @param types bitmask of MeterType, meters that are not included are not processed
+	 * @param peak per channel, set to the absolute sample peak of this cycle
+	 */
+	void process (float const* const* data, uint32_t n_chn, pframes_t n_samples, uint32_t types, float* peak);
+
+	/** read the current value of a given channel (GUI thread).
+	 * Like the per-channel meter objects, reading resets the
+	 * value that is retained until the next read.
+	 */
+	float read_k (uint32_t c);
+	float read_iec1 (uint32_t c);
+	float read_iec2 (uint32_t c);
+	float read_vu (uint32_t c);
+
+	static const uint32_t k_types    = MeterKrms | MeterK20 | MeterK14 | MeterK12;
+	static const uint32_t iec1_types = MeterIEC1DIN | MeterIEC1NOR;
+	static const uint32_t iec2_types = MeterIEC2BBC | MeterIEC2EBU;
+	static const uint32_t vu_types   = MeterVU;
+
+private:
+	template <bool K, bool IEC1, bool IEC2, bool VU>
+	void process_group (float const* const* p, uint32_t c0, uint32_t n_valid, pframes_t n_samples, float* peak);
+
+	typedef void (MeterKernel::*GroupFn) (float const* const*, uint32_t, uint32_t, pframes_t, float*);
+	static const GroupFn _group_fn[16];
+
+	uint32_t _n_channels;
+
+	/* K-meter */
+	std::vector<float> _k_z1;
+	std::vector<float> _k_z2;
+	std::vector<float> _k_rms;
+	std::vector<char>  _k_flag;
+
+	/* IEC1 PPM */
+	std::vector<float> _i1_z1;
+	std::vector<float> _i1_z2;
+	std::vector<float> _i1_m;
+	std::vector<char>  _i1_res;
+
+	/* IEC2 PPM */
+	std::vector<float> _i2_z1;
+	std::vector<float> _i2_z2;
+	std::vector<float> _i2_m;
+	std::vector<char>  _i2_res;
+
+	/* VU */
+	std::vector<float> _vu_z1;
+	std::vector<float> _vu_z2;
+	std::vector<float> _vu_m;
+	std::vector<char>  _vu_res;
+
+	static float _k_omega;
+	static float _i1_w1, _i1_w2, _i1_w3, _i1_g;
+	static float _i2_w1, _i2_w2, _i2_w3, _i2_g;
+	static float _vu_w, _vu_g;
+};
+
+} // namespace ARDOUR
+
+#endif /* __ardour_meter_kernel_h__ */
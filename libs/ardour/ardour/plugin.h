@@ -251,6 +251,18 @@ class LIBARDOUR_API Plugin : public PBD::StatefulDestructible, public Latent
 	/** the max possible latency a plugin will have */
 	virtual samplecnt_t max_latency () const { return 0; } // TODO = 0, require implementation
 
+	/** @return the time it takes for the output to decay to silence after
+	 * the input became silent (e.g. reverb tail) in samples, not including
+	 * latency, or -1 if the plugin does not provide this information.
+	 */
+	virtual samplecnt_t signal_tail () const { return -1; }
+
+	/** @return true if the plugin is given the transport position or tempo
+	 * (e.g. arpeggiators, sequencers, synced effects). Such plugins may
+	 * produce output for silent input.
+	 */
+	virtual bool uses_transport_position () const { return false; }
+
 	/** Emitted when a preset is added or removed, respectively */
 	PBD::Signal0<void> PresetAdded;
 	PBD::Signal0<void> PresetRemoved;
@@ -452,6 +464,7 @@ class LIBARDOUR_API PluginInfo {
 
   protected:
 	friend class PluginManager;
+	friend class PluginIndex;
 	uint32_t index;
 };
 
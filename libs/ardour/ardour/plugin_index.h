@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2026 The Ardour Developers
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef __ardour_plugin_index_h__
+#define __ardour_plugin_index_h__
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <stdint.h>
+
+#include "ardour/libardour_visibility.h"
+#include "ardour/chan_count.h"
+
+namespace ARDOUR {
+
+class PluginInfo;
+
+/** On-disk index of plugins that are otherwise only known after loading a
+ * library (LADSPA) or parsing a bundle (LV2).
+ *
+ * Entries are grouped by module (library or bundle path) and are valid as long
+ * as the module's modification time is unchanged. The whole index is read
+ * in one go, and only modules that were used during the last scan are written
+ * back, so removed plugins drop out.
+ */
+class LIBARDOUR_API PluginIndex
+{
+public:
+	struct LIBARDOUR_API Entry {
+		Entry () : index (0) {}
+		Entry (PluginInfo const&);
+
+		/** fill in the cached fields, path and type are left alone */
+		void apply (PluginInfo&) const;
+
+		std::string name;
+		std::string category;
+		std::string creator;
+		std::string unique_id;
+		uint32_t    index;
+		ChanCount   n_inputs;
+		ChanCount   n_outputs;
+	};
+
+	typedef std::vector<Entry> Entries;
+
+	/** @param path file to read from and write to */
+	PluginIndex (std::string const& path);
+
+	/** read the index file, returns false if there is none or it is invalid */
+	bool load ();
+	/** write modules that were looked up or set since load () */
+	bool save () const;
+
+	void clear ();
+
+	/** get cached entries of a module, returns false if the module is
+	 * not cached, or was modified since */
+	bool lookup (std::string const& module, Entries&);
+	void set (std::string const& module, Entries const&);
+
+	/** true if the index contains exactly the given modules, unmodified */
+	bool up_to_date (std::vector<std::string> const& modules) const;
+
+	/** all modules in the index */
+	std::vector<std::string> modules () const;
+
+	size_t n_modules () const { return _modules.size (); }
+
+	/** modification time of a file, or for directories the most recent one
+	 * of the directory and the files directly in it (e.g. the .ttl files of an LV2 bundle)
+	 */
+	static int64_t modification_time (std::string const& path);
+
+private:
+	struct Module {
+		Module () : mtime (0), used (false) {}
+		int64_t mtime;
+		bool    used;
+		Entries entries;
+	};
+
+	typedef std::map<std::string, Module> Modules;
+
+	std::string _path;
+	Modules     _modules;
+};
+
+} // namespace ARDOUR
+
+#endif /* __ardour_plugin_index_h__ */
@@ -35,7 +35,9 @@
 #include "ardour/plugin.h"
 #include "ardour/processor.h"
 #include "ardour/readonly_control.h"
+#include "ardour/rt_tasklist.h"
 #include "ardour/sidechain.h"
+#include "ardour/trace_recorder.h"
 #include "ardour/automation_control.h"
 
 class XMLNode;
@@ -57,6 +59,7 @@ public:
 	static const std::string port_automation_node_name;
 
 	int set_state(const XMLNode&, int version);
+	bool set_name (const std::string&);
 	void update_id (PBD::ID);
 	void set_owner (SessionObject*);
 	void set_state_dir (const std::string& d = "");
@@ -171,6 +174,24 @@ public:
 	bool     strict_io  () const { return _strict_io; }
 	bool     custom_cfg () const { return _custom_cfg; }
 
+	/** Allow to suspend processing while the input is silent and
+	 * the plugin's output has decayed (plugin latency + tail).
+	 * This requires Config->get_skip_silent_processing ().
+	 */
+	void set_sleep_when_silent (bool yn) { _sleep_when_silent = yn; }
+	bool sleep_when_silent () const { return _sleep_when_silent; }
+
+	/** @return true if the plugin is currently not being run */
+	bool sleeping () const { return _sleeping; }
+
+	/** query sleep statistics since the last reset
+	 * @param slept_samples number of samples for which the plugin was not run
+	 * @param saved_usec estimated DSP time that was saved [usec]
+	 * @return false if the plugin did not sleep
+	 */
+	bool get_sleep_stats (samplecnt_t& slept_samples, double& saved_usec) const;
+	void reset_sleep_stats () { g_atomic_int_set (&_reset_sleep_stats, 1); }
+
 	bool can_support_io_configuration (const ChanCount& in, ChanCount& out);
 	bool configure_io (ChanCount in, ChanCount out);
 
@@ -324,6 +345,19 @@ private:
 	uint32_t _sc_capture_latency;
 	uint32_t _plugin_signal_latency;
 
+	samplecnt_t _plugin_signal_tail; // -1: unknown
+
+	/* sleep when silent */
+	bool        _sleep_when_silent;
+	bool        _may_sleep;      // false if the plugin may produce output for silent input
+	bool        _sleeping;
+	samplecnt_t _silent_samples; // consecutive samples of silent output for silent input
+	gint        _wake;           // set when a parameter or the transport state changes
+	gint        _reset_sleep_stats;
+	samplecnt_t _slept_samples;
+	double      _saved_cycles;
+	double      _run_cost;       // average CPU cycles per sample
+
 	boost::weak_ptr<Plugin> _impulseAnalysisPlugin;
 
 	samplecnt_t _signal_analysis_collected_nframes;
@@ -350,6 +384,8 @@ private:
 	bool _maps_from_state;
 	bool _mapping_changed;
 
+	TraceLabel _trace_label;
+
 	Match private_can_support_io_configuration (ChanCount const &, ChanCount &) const;
 	Match internal_can_support_io_configuration (ChanCount const &, ChanCount &) const;
 	Match automatic_can_support_io_configuration (ChanCount const &, ChanCount &) const;
@@ -362,11 +398,42 @@ private:
 	PinMappings _out_map;
 	ChanMapping _thru_map; // out-idx <=  in-idx
 
+	/* concurrent processing of replicated instances */
+	struct ParallelRun {
+		BufferSet*         bufs;
+		samplepos_t        start;
+		samplepos_t        end;
+		double             speed;
+		PinMappings const* in_map;
+		PinMappings const* out_map;
+		pframes_t          nframes;
+		samplecnt_t        offset;
+		gint               failed;
+	};
+
+	bool                  _parallel_safe;
+	ParallelRun           _parallel_run;
+	std::vector<uint64_t> _parallel_cycles; // per instance
+	uint64_t              _parallel_extra_cycles;
+	RTTaskList::TaskList  _replicated_tasks;
+
 	void automate_and_run (BufferSet& bufs, samplepos_t start, samplepos_t end, double speed, pframes_t nframes);
 	void connect_and_run (BufferSet& bufs, samplepos_t start, samplecnt_t end, double speed, pframes_t nframes, samplecnt_t offset, bool with_auto);
 	void bypass (BufferSet& bufs, pframes_t nframes);
 	void inplace_silence_unconnected (BufferSet&, const PinMappings&, samplecnt_t nframes, samplecnt_t offset) const;
 
+	bool silent_input (BufferSet&) const;
+	bool silent_output (BufferSet&) const;
+	void silence_output (BufferSet&, pframes_t nframes);
+	samplecnt_t silent_tail_length () const;
+	void update_may_sleep ();
+	void wake () { g_atomic_int_set (&_wake, 1); }
+	void update_run_cost (uint64_t cycles, pframes_t nframes);
+
+	bool check_parallel () const;
+	bool run_parallel (BufferSet&, samplepos_t start, samplepos_t end, double speed, PinMappings const&, PinMappings const&, pframes_t nframes, samplecnt_t offset);
+	void run_instance (uint32_t pc);
+
 	void create_automatable_parameters ();
 	void control_list_automation_state_changed (Evoral::Parameter, AutoState);
 	void set_parameter_state_2X (const XMLNode& node, int version);
@@ -33,6 +33,7 @@
 #include "ardour/libardour_visibility.h"
 #include "ardour/types.h"
 #include "ardour/plugin.h"
+#include "ardour/plugin_index.h"
 
 namespace ARDOUR {
 
@@ -184,6 +185,8 @@ private:
 	bool _cancel_scan;
 	bool _cancel_timeout;
 
+	uint32_t scan_jobs () const;
+
 	void ladspa_refresh ();
 	void lua_refresh ();
 	void lua_refresh_cb ();
@@ -211,7 +214,8 @@ private:
 	int lxvst_discover_from_path (std::string path, bool cache_only = false);
 	int lxvst_discover (std::string path, bool cache_only = false);
 
-	int ladspa_discover (std::string path);
+	int ladspa_discover (std::string path, PluginIndex::Entries&);
+	void ladspa_add (ARDOUR::PluginInfoPtr);
 
 	std::string get_ladspa_category (uint32_t id);
 	std::vector<uint32_t> ladspa_plugin_whitelist;
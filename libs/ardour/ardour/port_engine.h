@@ -361,6 +361,12 @@ public:
 	 *
 	 * The return value is untyped because buffers containing different data
 	 * depending on the port type.
+	 *
+	 * The buffer of an input port must be treated as read-only. If an input
+	 * port has exactly one connection, a backend may return the buffer of
+	 * the connected output port directly, rather than copying it (JACK
+	 * does the same). Callers that want to modify the data (e.g. process
+	 * it in place) have to copy it first.
 	 */
 	virtual void* get_buffer (PortHandle, pframes_t) = 0;
 
@@ -28,6 +28,7 @@
 
 #include "ardour/ardour.h"
 #include "ardour/buffer_set.h"
+#include "ardour/cycle_stats.h"
 #include "ardour/latent.h"
 #include "ardour/session_object.h"
 #include "ardour/libardour_visibility.h"
@@ -148,6 +149,21 @@ class LIBARDOUR_API Processor : public SessionObject, public Automatable, public
 	virtual void set_owner (SessionObject*);
 	SessionObject* owner() const;
 
+	/** DSP profiling, collected by the owning Route if
+	 * Config->get_processor_cycle_stats() is enabled.
+	 */
+	CycleStats& cycle_stats () { return _cycle_stats; }
+	CycleStats const& cycle_stats () const { return _cycle_stats; }
+
+	/** query time spent in run() in microseconds (per process cycle).
+	 * @return false if no data is available
+	 */
+	bool get_cycle_stats (double& min, double& max, double& avg, double& p95, double& p99) const {
+		return _cycle_stats.get_stats_usec (min, max, avg, p95, p99);
+	}
+
+	void reset_cycle_stats () { _cycle_stats.reset (); }
+
 protected:
 	virtual XMLNode& state ();
 	virtual int set_state_2X (const XMLNode&, int version);
@@ -173,6 +189,7 @@ protected:
 	samplecnt_t _capture_offset;
 	samplecnt_t _playback_offset;
 	Location*   _loop_location;
+	CycleStats  _cycle_stats;
 };
 
 } // namespace ARDOUR
@@ -225,6 +225,7 @@ CONFIG_VARIABLE_SPECIAL (std::string, default_session_parent_dir, "default-sessi
 #endif
 CONFIG_VARIABLE (bool, allow_special_bus_removal, "allow-special-bus-removal", false)
 CONFIG_VARIABLE (int32_t, processor_usage, "processor-usage", -1)
+CONFIG_VARIABLE (bool, processor_cycle_stats, "processor-cycle-stats", false)
 CONFIG_VARIABLE (gain_t, max_gain, "max-gain", 2.0) /* +6.0dB */
 CONFIG_VARIABLE (uint32_t, max_recent_sessions, "max-recent-sessions", 10)
 CONFIG_VARIABLE (uint32_t, max_recent_templates, "max-recent-templates", 10)
@@ -243,6 +244,7 @@ CONFIG_VARIABLE (bool, use_macvst, "use-macvst", true)
 CONFIG_VARIABLE (bool, discover_vst_on_start, "discover-vst-on-start", false)
 CONFIG_VARIABLE (bool, verbose_plugin_scan, "verbose-plugin-scan", false)
 CONFIG_VARIABLE (int, vst_scan_timeout, "vst-scan-timeout", 1200) /* deciseconds, per plugin, <= 0 no timeout */
+CONFIG_VARIABLE (uint32_t, plugin_scan_jobs, "plugin-scan-jobs", 0) /* concurrent VST scanner processes, 0: one per CPU core, 1: sequential */
 CONFIG_VARIABLE (bool, discover_audio_units, "discover-audio-units", false)
 CONFIG_VARIABLE (bool, ask_replace_instrument, "ask-replace-instrument", true)
 CONFIG_VARIABLE (bool, ask_setup_instrument, "ask-setup-instrument", true)
@@ -256,6 +258,14 @@ CONFIG_VARIABLE (std::string, plugin_path_lxvst, "plugin-path-lxvst", "@default@
 CONFIG_VARIABLE (bool, denormal_protection, "denormal-protection", false)
 CONFIG_VARIABLE (DenormalModel, denormal_model, "denormal-model", DenormalFTZDAZ)
 
+/* DSP optimizations */
+
+CONFIG_VARIABLE (bool, skip_silent_processing, "skip-silent-processing", false)
+CONFIG_VARIABLE (bool, parallel_replicated_plugins, "parallel-replicated-plugins", false)
+CONFIG_VARIABLE (uint32_t, parallel_plugin_threshold, "parallel-plugin-threshold", 100) /* usec per instance and cycle */
+CONFIG_VARIABLE (uint32_t, varispeed_quality, "varispeed-quality", 0) /* 0: cubic, 1..3: SincInterpolation::Quality + 1 */
+CONFIG_VARIABLE (bool, cache_resampled_sources, "cache-resampled-sources", false)
+
 /* visibility of various things */
 
 
@@ -282,3 +292,5 @@ CONFIG_VARIABLE (bool, show_video_server_dialog, "show-video-server-dialog", fal
 
 CONFIG_VARIABLE (float, export_preroll, "export-preroll", 10.0) // seconds
 CONFIG_VARIABLE (float, export_silence_threshold, "export-silence-threshold", -INFINITY) // dB
+CONFIG_VARIABLE (bool, export_parallel_timespans, "export-parallel-timespans", false) // render overlapping or adjacent timespans in one pass
+CONFIG_VARIABLE (uint32_t, export_memory_budget, "export-memory-budget", 512) // MiB, for normalization; the remainder is spilled to disk
@@ -57,6 +57,7 @@
 #include "ardour/solo_control.h"
 #include "ardour/solo_safe_control.h"
 #include "ardour/slavable.h"
+#include "ardour/trace_recorder.h"
 
 class RoutePinWindowProxy;
 class PatchChangeGridDialog;
@@ -69,6 +70,7 @@ class Delivery;
 class DiskReader;
 class DiskWriter;
 class IOProcessor;
+class LoudnessMeter;
 class Panner;
 class PannerShell;
 class PolarityProcessor;
@@ -131,6 +133,9 @@ public:
 	bool set_name (const std::string& str);
 	static void set_name_in_state (XMLNode &, const std::string &, bool rename_playlist = true);
 
+	/** realtime-safe copy of the route's name, for TraceRecorder spans */
+	const char* trace_label () const { return _trace_label.c_str (); }
+
 	boost::shared_ptr<MonitorControl> monitoring_control() const { return _monitoring_control; }
 
 	MonitorState monitoring_state () const;
@@ -206,6 +211,10 @@ public:
 	boost::shared_ptr<const PeakMeter> peak_meter() const { return _meter; }
 	boost::shared_ptr<PeakMeter> shared_peak_meter() const { return _meter; }
 
+	/** @return the EBU R128 loudness meter, or a null pointer if loudness metering is disabled */
+	boost::shared_ptr<LoudnessMeter> loudness_meter() const { return _loudness_meter; }
+	void set_loudness_metering (bool);
+
 	void flush_processors ();
 
 	void foreach_processor (boost::function<void(boost::weak_ptr<Processor>)> method) {
@@ -679,6 +688,7 @@ protected:
 
 	InstrumentInfo _instrument_info;
 	Location*      _loop_location;
+	TraceLabel     _trace_label;
 
 	virtual ChanCount input_streams () const;
 
@@ -704,6 +714,7 @@ protected:
 	boost::shared_ptr<Amp>               _trim;
 	boost::shared_ptr<PeakMeter>         _meter;
 	boost::shared_ptr<PolarityProcessor> _polarity;
+	boost::shared_ptr<LoudnessMeter>     _loudness_meter;
 
 	boost::shared_ptr<DelayLine> _delayline;
 
@@ -43,6 +43,12 @@ public:
 	/** process tasks in list in parallel, wait for them to complete */
 	void process (TaskList const&);
 
+	/** process tasks in list in parallel unless the worker threads are
+	 * currently busy with another task-list.
+	 * @return false if the tasks were not processed
+	 */
+	bool try_process (TaskList const&);
+
 private:
 	gint _threads_active;
 	std::vector<pthread_t> _threads;
@@ -50,7 +56,7 @@ private:
 	void reset_thread_list ();
 	void drop_threads ();
 
-	void process_tasklist ();
+	void process_tasklist (TaskList const&);
 
 	static void* _thread_run (void *arg);
 	void run ();
@@ -60,7 +66,10 @@ private:
 	PBD::Semaphore _task_run_sem;
 	PBD::Semaphore _task_end_sem;
 
-	TaskList _tasklist;
+	/* the list passed to process (), tasks are run in place and
+	 * not copied, so that nothing is allocated in realtime context */
+	TaskList const*          _tasklist;
+	TaskList::const_iterator _next_task;
 };
 
 } // namespace ARDOUR
@@ -22,8 +22,12 @@
 #define __ardour_srcfilesource_h__
 
 #include <cstring>
+#include <list>
 #include <samplerate.h>
 
+#include <glib.h>
+#include <glibmm/threads.h>
+
 #include "ardour/libardour_visibility.h"
 #include "ardour/audiofilesource.h"
 #include "ardour/session.h"
@@ -51,6 +55,9 @@ public:
 	bool can_be_analysed() const { return false; }
 	bool clamped_at_unity() const { return false; }
 
+	/** true if reads are served from a resampled cache file */
+	bool cached () const { return _cache_fd >= 0; }
+
 protected:
 	void close ();
 	samplecnt_t read_unlocked (Sample *dst, samplepos_t start, samplecnt_t cnt) const;
@@ -66,6 +73,9 @@ private:
 	static const uint32_t max_blocksize;
 	boost::shared_ptr<AudioFileSource> _source;
 
+	SrcQuality _srcq;
+	int        _src_type;
+
 	mutable SRC_STATE* _src_state;
 	mutable SRC_DATA   _src_data;
 
@@ -76,6 +86,24 @@ private:
 
 	double _ratio;
 	samplecnt_t src_buffer_size;
+
+	/* resampled cache file in the session's peak folder, written by a
+	 * background thread and used for all reads once complete */
+	std::string cache_path () const;
+	bool open_cache ();
+	void build_cache ();
+	samplecnt_t read_cache (Sample* dst, samplepos_t start, samplecnt_t cnt) const;
+
+	int           _cache_fd;
+	volatile gint _cache_abort;
+
+	static void cache_thread_work ();
+
+	static std::list<SrcFileSource*> _cache_queue;
+	static SrcFileSource*            _cache_building;
+	static bool                      _cache_thread_running;
+	static Glib::Threads::Mutex      _cache_lock;
+	static Glib::Threads::Cond       _cache_cond;
 };
 
 } // namespace ARDOUR
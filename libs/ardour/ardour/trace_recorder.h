@@ -0,0 +1,158 @@
+/*
+ * Copyright (C) 2026 The Ardour Developers
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef __ardour_trace_recorder_h__
+#define __ardour_trace_recorder_h__
+
+#include <cstring>
+#include <string>
+#include <stdint.h>
+#include <glib.h>
+
+#include "ardour/libardour_visibility.h"
+
+namespace ARDOUR {
+
+/** A fixed size copy of an object's name, that can be used
+ * by realtime threads without allocating memory.
+ * Set it from a non-realtime context whenever the name changes.
+ */
+class LIBARDOUR_API TraceLabel
+{
+public:
+	TraceLabel () { _label[0] = '\0'; }
+
+	void set (std::string const& s) {
+		strncpy (_label, s.c_str (), sizeof (_label) - 1);
+		_label[sizeof (_label) - 1] = '\0';
+	}
+
+	const char* c_str () const { return _label; }
+
+private:
+	char _label[32];
+};
+
+/** Low-overhead recorder of timed spans on the process-, graph- and
+ * butler-threads.
+ *
+ * Every thread that records spans must call register_thread() when it
+ * is created, to claim one of the preallocated, fixed size ring-buffers.
+ * Spans of threads that are not registered are ignored, no memory is
+ * allocated by realtime threads.
+ * Recording is disabled by default, and the cost of a disabled span is
+ * a single atomic load.
+ *
+ * The collected data can be written as Chrome Trace Event JSON, which
+ * can be loaded by chrome://tracing or https://ui.perfetto.dev
+ */
+class LIBARDOUR_API TraceRecorder
+{
+public:
+	/** allocate buffers (if needed) and start recording (not realtime safe).
+	 * The buffer size is fixed by the first call.
+	 * @param events_per_thread capacity of each thread's ring-buffer,
+	 *        older events are overwritten.
+	 */
+	static void start (uint32_t events_per_thread = 16384);
+
+	/** stop recording, data is retained until the next start().
+	 * This does not wait for spans that are currently being recorded.
+	 */
+	static void stop ();
+
+	static bool active () { return g_atomic_int_get (&_active); }
+
+	/** claim a ring-buffer for the calling thread (not realtime safe).
+	 * Call this once from every process-, graph- or butler-thread
+	 * before it starts processing. The ring is released when the
+	 * thread exits. Calling this more than once has no effect.
+	 */
+	static void register_thread ();
+
+	/** write the recorded data as Chrome Trace JSON (not realtime safe).
+	 * This implicitly stops recording.
+	 * @return 0 on success
+	 */
+	static int dump (std::string const& path);
+
+	/** record a span (realtime safe).
+	 * @param name static string identifying the code path
+	 * @param label optional name of the object that is processed, copied
+	 * @param start start time in usec (g_get_monotonic_time)
+	 * @param end end time in usec
+	 */
+	static void record (const char* name, const char* label, int64_t start, int64_t end);
+
+	/** RAII helper to record a span for the current scope */
+	class Span
+	{
+	public:
+		Span (const char* name, const char* label = 0)
+			: _name (name)
+			, _label (label)
+			, _start (TraceRecorder::active () ? g_get_monotonic_time () : 0)
+		{}
+
+		~Span () {
+			if (_start != 0) {
+				TraceRecorder::record (_name, _label, _start, g_get_monotonic_time ());
+			}
+		}
+
+	private:
+		const char* _name;
+		const char* _label;
+		int64_t     _start;
+	};
+
+private:
+	struct Event {
+		const char* name;
+		char        label[32];
+		int64_t     start;
+		int64_t     end;
+	};
+
+	struct ThreadRing {
+		ThreadRing () : events (0), n_written (0) { thread_name[0] = '\0'; }
+		~ThreadRing () { delete [] events; }
+
+		char     thread_name[32];
+		Event*   events;
+		uint64_t n_written;
+	};
+
+	static ThreadRing* thread_ring ();
+	static void wait_for_writers ();
+	static void release_thread (void*);
+
+	static GPrivate    _thread_slot;
+
+	static const int max_threads = 64;
+
+	static gint        _active;
+	static gint        _n_writers; /* threads currently in record () */
+	static gint        _slot_used[max_threads];
+	static uint32_t    _ring_size;
+	static ThreadRing  _rings[max_threads];
+};
+
+} // namespace ARDOUR
+
+#endif /* __ardour_trace_recorder_h__ */
@@ -204,7 +204,8 @@ namespace ARDOUR {
 		MeterVU        = 0x0400,
 		MeterK12       = 0x0800,
 		MeterPeak0dB   = 0x1000,
-		MeterMCP       = 0x2000
+		MeterMCP       = 0x2000,
+		MeterTruePeak  = 0x4000
 	};
 
 	enum TrackMode {
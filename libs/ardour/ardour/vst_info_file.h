@@ -23,6 +23,7 @@
 
 #include "ardour/libardour_visibility.h"
 #include "ardour/vst_types.h"
+#include <string>
 #include <vector>
 
 /* Cache File extensions */
@@ -64,6 +65,14 @@ LIBARDOUR_API extern std::vector<VSTInfo*> * vstfx_get_info_fst (char *, enum VS
 LIBARDOUR_API extern std::vector<VSTInfo*> * vstfx_get_info_mac (char *, enum VSTScanMode mode = VST_SCAN_USE_APP);
 #endif
 
+#ifndef VST_SCANNER_APP
+/** Scan plugins that have no up-to-date cache file, using up to n_jobs
+ * concurrent scanner processes. Results are written to the cache and the
+ * blacklist, to be picked up by vstfx_get_info_*().
+ */
+LIBARDOUR_API extern void vstfx_scan_parallel (std::vector<std::string> const& dllpaths, uint32_t n_jobs);
+#endif
+
 #ifndef VST_SCANNER_APP
 } // namespace
 #endif
@@ -59,6 +59,7 @@ public:
 	int get_parameter_descriptor (uint32_t which, ParameterDescriptor&) const;
 	std::string describe_parameter (Evoral::Parameter);
 	samplecnt_t signal_latency() const;
+	samplecnt_t signal_tail () const;
 	std::set<Evoral::Parameter> automatable() const;
 
 	PBD::Signal0<void> LoadPresetProgram;
@@ -31,6 +31,7 @@
 #include "ardour/async_midi_port.h"
 #include "ardour/audioengine.h"
 #include "ardour/midi_buffer.h"
+#include "ardour/trace_recorder.h"
 
 using namespace MIDI;
 using namespace ARDOUR;
@@ -310,6 +311,8 @@ AsyncMIDIPort::read (MIDI::byte *, size_t)
 		return 0;
 	}
 
+	TraceRecorder::Span span ("AsyncMIDIPort::parse");
+
 	timestamp_t time;
 	Evoral::EventType type;
 	uint32_t size;
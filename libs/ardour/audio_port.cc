@@ -26,6 +26,7 @@
 #include "ardour/audio_port.h"
 #include "ardour/data_type.h"
 #include "ardour/port_engine.h"
+#include "ardour/rc_configuration.h"
 
 using namespace ARDOUR;
 using namespace std;
@@ -127,6 +128,11 @@ AudioPort::get_audio_buffer (pframes_t nframes)
 	} else {
 		_buffer->set_data (&_data[_global_port_buffer_offset], nframes);
 	}
+	if (receives_input () && Config->get_skip_silent_processing ()) {
+		/* flag silent input, to allow downstream processors
+		 * to skip processing */
+		_buffer->detect_silence ();
+	}
 	return *_buffer;
 }
 
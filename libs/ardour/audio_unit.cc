@@ -961,6 +961,17 @@ AUPlugin::signal_latency () const
 	return lat;
 }
 
+samplecnt_t
+AUPlugin::signal_tail () const
+{
+	Float64 secs;
+	UInt32 size = sizeof (secs);
+	if (unit->GetProperty (kAudioUnitProperty_TailTime, kAudioUnitScope_Global, 0, &secs, &size)) {
+		return -1;
+	}
+	return secs * _session.sample_rate ();
+}
+
 void
 AUPlugin::set_parameter (uint32_t which, float val)
 {
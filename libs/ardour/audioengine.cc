@@ -55,6 +55,7 @@
 #include "ardour/process_thread.h"
 #include "ardour/rc_configuration.h"
 #include "ardour/session.h"
+#include "ardour/trace_recorder.h"
 
 #include "pbd/i18n.h"
 
@@ -189,6 +190,7 @@ __attribute__((annotate("realtime")))
 int
 AudioEngine::process_callback (pframes_t nframes)
 {
+	TraceRecorder::Span span ("AudioEngine::process_callback");
 	Glib::Threads::Mutex::Lock tm (_process_lock, Glib::Threads::TRY_LOCK);
 	Port::set_speed_ratio (1.0);
 
@@ -1278,6 +1280,7 @@ AudioEngine::thread_init_callback (void* arg)
 	SessionEvent::create_per_thread_pool (thread_name, 512);
 	PBD::notify_event_loops_about_thread_creation (pthread_self(), thread_name, 4096);
 	AsyncMIDIPort::set_process_thread (pthread_self());
+	TraceRecorder::register_thread ();
 
 	if (arg) {
 		delete AudioEngine::instance()->_main_thread;
@@ -35,6 +35,7 @@
 #include "ardour/io.h"
 #include "ardour/session.h"
 #include "ardour/track.h"
+#include "ardour/trace_recorder.h"
 #include "ardour/auditioner.h"
 
 #include "pbd/i18n.h"
@@ -159,6 +160,7 @@ Butler::_thread_work (void* arg)
 {
 	SessionEvent::create_per_thread_pool ("butler events", 4096);
 	pthread_set_name (X_("butler"));
+	TraceRecorder::register_thread ();
 	return ((Butler *) arg)->thread_work ();
 }
 
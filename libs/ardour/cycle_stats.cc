@@ -0,0 +1,189 @@
+/*
+ * Copyright (C) 2026 The Ardour Developers
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include <cstring>
+
+#include "ardour/cycle_stats.h"
+
+using namespace ARDOUR;
+
+double CycleStats::_cycles_per_usec = -1;
+
+CycleStats::CycleStats ()
+	: _reset (0)
+{
+	clear ();
+}
+
+void
+CycleStats::clear ()
+{
+	_cnt = 0;
+	_min = 0;
+	_max = 0;
+	_sum = 0;
+	memset (_hist, 0, sizeof (_hist));
+}
+
+/* map a value to a histogram bucket: values 0..3 map 1:1,
+ * larger values use 4 buckets per power of two (2 bits of mantissa).
+ */
+int
+CycleStats::bucket (uint64_t v)
+{
+	if (v < 4) {
+		return v;
+	}
+
+	int e = 0;
+	for (uint64_t x = v; x > 1; x >>= 1) {
+		++e;
+	}
+
+	return (e - 1) * 4 + ((v >> (e - 2)) & 3);
+}
+
+/* center value of a given bucket */
+uint64_t
+CycleStats::bucket_value (int b)
+{
+	if (b < 4) {
+		return b;
+	}
+
+	const int e = b / 4 + 1;
+	const uint64_t width = 1ULL << (e - 2);
+	return (4 + (b % 4)) * width + width / 2;
+}
+
+void
+CycleStats::update (uint64_t elapsed)
+{
+	if (g_atomic_int_compare_and_exchange (&_reset, 1, 0)) {
+		clear ();
+	}
+
+	if (_cnt == 0 || elapsed < _min) {
+		_min = elapsed;
+	}
+	if (elapsed > _max) {
+		_max = elapsed;
+	}
+
+	_sum += elapsed;
+	++_hist[bucket (elapsed)];
+	++_cnt;
+}
+
+bool
+CycleStats::get_stats (uint64_t& min, uint64_t& max, double& avg) const
+{
+	const uint64_t cnt = _cnt;
+	if (cnt == 0) {
+		return false;
+	}
+	min = _min;
+	max = _max;
+	avg = _sum / (double) cnt;
+	return true;
+}
+
+uint64_t
+CycleStats::percentile (float pc) const
+{
+	uint64_t total = 0;
+	for (int b = 0; b < n_buckets; ++b) {
+		total += _hist[b];
+	}
+
+	if (total == 0) {
+		return 0;
+	}
+
+	uint64_t target = total * pc / 100.f;
+	if (target < 1) {
+		target = 1;
+	}
+
+	const uint64_t min = _min;
+	const uint64_t max = _max;
+
+	uint64_t acc = 0;
+	for (int b = 0; b < n_buckets; ++b) {
+		acc += _hist[b];
+		if (acc >= target) {
+			/* clamp to the actual range, the bucket may be
+			 * wider than the measured span */
+			const uint64_t v = bucket_value (b);
+			if (v < min) {
+				return min;
+			}
+			if (v > max) {
+				return max;
+			}
+			return v;
+		}
+	}
+	return max;
+}
+
+bool
+CycleStats::get_stats_usec (double& min, double& max, double& avg, double& p95, double& p99) const
+{
+	const double cpu = cycles_per_usec ();
+	uint64_t cmin, cmax;
+	double cavg;
+
+	if (cpu <= 0 || !get_stats (cmin, cmax, cavg)) {
+		return false;
+	}
+
+	min = cmin / cpu;
+	max = cmax / cpu;
+	avg = cavg / cpu;
+	p95 = percentile (95) / cpu;
+	p99 = percentile (99) / cpu;
+	return true;
+}
+
+double
+CycleStats::cycles_per_usec ()
+{
+	static GOnce once = G_ONCE_INIT;
+	g_once (&once, calibrate, NULL);
+	return _cycles_per_usec;
+}
+
+gpointer
+CycleStats::calibrate (gpointer)
+{
+	const gint64 t0 = g_get_monotonic_time ();
+	const cycles_t c0 = get_cycles ();
+	g_usleep (20000);
+	const cycles_t c1 = get_cycles ();
+	const gint64 t1 = g_get_monotonic_time ();
+
+	const uint64_t dc = elapsed (c0, c1);
+
+	if (t1 > t0 && dc > 0) {
+		_cycles_per_usec = dc / (double) (t1 - t0);
+	} else {
+		_cycles_per_usec = 0;
+	}
+	return NULL;
+}
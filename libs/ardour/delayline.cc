@@ -33,6 +33,8 @@ using namespace std;
 using namespace PBD;
 using namespace ARDOUR;
 
+gint DelayLine::_allocated_samples = 0;
+
 DelayLine::DelayLine (Session& s, const std::string& name)
     : Processor (s, string_compose ("latcomp-%1-%2", name, this))
 		, _bsiz (0)
@@ -41,11 +43,19 @@ DelayLine::DelayLine (Session& s, const std::string& name)
 		, _roff (0)
 		, _woff (0)
 		, _pending_flush (false)
+		, _release_buffers (false)
 {
 }
 
 DelayLine::~DelayLine ()
 {
+	g_atomic_int_add (&_allocated_samples, - (gint) (_buf.size () * _bsiz));
+}
+
+size_t
+DelayLine::allocated_bytes ()
+{
+	return (size_t) g_atomic_int_get (&_allocated_samples) * sizeof (Sample);
 }
 
 bool
@@ -90,7 +100,7 @@ DelayLine::run (BufferSet& bufs, samplepos_t /* start_sample */, samplepos_t /*
 				if (add > 0) {
 					AudioDlyBuf::iterator bi = _buf.begin ();
 					for (BufferSet::audio_iterator i = bufs.audio_begin (); i != bufs.audio_end (); ++i, ++bi) {
-						Sample* rb = (*bi).get ();
+						Sample* rb = *bi;
 						write_to_rb (rb, i->data (), add);
 					}
 					_woff = (_woff + add) & _bsiz_mask;
@@ -102,7 +112,7 @@ DelayLine::run (BufferSet& bufs, samplepos_t /* start_sample */, samplepos_t /*
 
 			/* fade-out, end of previously written data */
 			for (AudioDlyBuf::iterator i = _buf.begin(); i != _buf.end (); ++i) {
-				Sample* rb = (*i).get ();
+				Sample* rb = *i;
 				for (uint32_t s = 0; s < fade_out_len; ++s) {
 					sampleoffset_t off = (_woff + _bsiz - s) & _bsiz_mask;
 					rb[off] *= s / (float) fade_out_len;
@@ -132,7 +142,7 @@ DelayLine::run (BufferSet& bufs, samplepos_t /* start_sample */, samplepos_t /*
 
 			AudioDlyBuf::iterator bi = _buf.begin ();
 			for (BufferSet::audio_iterator i = bufs.audio_begin (); i != bufs.audio_end (); ++i, ++bi) {
-				Sample* rb = (*bi).get ();
+				Sample* rb = *bi;
 				Sample* src = i->data ();
 
 				// TODO consider handling fade_out & fade_in separately
@@ -157,12 +167,16 @@ DelayLine::run (BufferSet& bufs, samplepos_t /* start_sample */, samplepos_t /*
 		/* set new delay */
 		_delay = pending_delay;
 
+		/* the cross-fade to zero is complete, the buffers can be
+		 * released by the next set_delay() or configure_io() */
+		_release_buffers = (_delay == 0);
+
 		if (pending_flush) {
 			/* fade out data after read-pointer, clear buffer until write-pointer */
 			const samplecnt_t fade_out_len = std::min (_delay, (samplecnt_t)FADE_LEN);
 
 			for (AudioDlyBuf::iterator i = _buf.begin(); i != _buf.end (); ++i) {
-				Sample* rb = (*i).get ();
+				Sample* rb = *i;
 				uint32_t s = 0;
 				for (; s < fade_out_len; ++s) {
 					sampleoffset_t off = (_roff + s) & _bsiz_mask;
@@ -185,7 +199,7 @@ DelayLine::run (BufferSet& bufs, samplepos_t /* start_sample */, samplepos_t /*
 		} else if (n_samples <= _delay) {
 			/* write all samples to rb, read all from rb */
 			for (BufferSet::audio_iterator i = bufs.audio_begin (); i != bufs.audio_end (); ++i, ++bi) {
-				Sample* rb = (*bi).get ();
+				Sample* rb = *bi;
 				write_to_rb (rb, i->data (), n_samples);
 				read_from_rb (rb, i->data (), n_samples);
 			}
@@ -195,7 +209,7 @@ DelayLine::run (BufferSet& bufs, samplepos_t /* start_sample */, samplepos_t /*
 			/* only write _delay samples to ringbuffer, memmove buffer */
 			samplecnt_t tail = n_samples - _delay;
 			for (BufferSet::audio_iterator i = bufs.audio_begin (); i != bufs.audio_end (); ++i, ++bi) {
-				Sample* rb = (*bi).get ();
+				Sample* rb = *bi;
 				Sample* src = i->data ();
 				write_to_rb (rb, &src[tail], _delay);
 				memmove (&src[_delay], src, tail * sizeof(Sample));
@@ -286,6 +300,10 @@ DelayLine::set_delay (samplecnt_t signal_delay)
 		cerr << "WARNING: latency compensation is not possible.\n";
 	}
 
+	if (_release_buffers && signal_delay == 0 && _pending_delay == 0) {
+		allocate_pending_buffers (0, _configured_output);
+	}
+
 	if (signal_delay == _pending_delay) {
 		DEBUG_TRACE (DEBUG::LatencyCompensation,
 				string_compose ("%1 set_delay - no change: %2 samples for %3 channels\n",
@@ -297,7 +315,8 @@ DelayLine::set_delay (samplecnt_t signal_delay)
 			string_compose ("%1 set_delay to %2 samples for %3 channels\n",
 				name (), signal_delay, _configured_output.n_audio ()));
 
-	if (signal_delay + 8192 + 1 > _bsiz) {
+	if (buffer_size_for (signal_delay) > _bsiz || (signal_delay == 0 && _delay == 0)) {
+		/* grow, or release buffers that are no longer needed */
 		allocate_pending_buffers (signal_delay, _configured_output);
 	}
 
@@ -312,56 +331,93 @@ DelayLine::can_support_io_configuration (const ChanCount& in, ChanCount& out)
 	return true;
 }
 
-void
-DelayLine::allocate_pending_buffers (samplecnt_t signal_delay, ChanCount const& cc)
+/* The ringbuffer holds the delayed data. When n_samples <= delay, the data
+ * of the current cycle is written before it is read; cycles are at most
+ * 8192 samples.
+ */
+samplecnt_t
+DelayLine::buffer_size_for (samplecnt_t signal_delay)
 {
-	assert (signal_delay >= 0);
-	samplecnt_t rbs = signal_delay + 8192 + 1;
-	rbs = std::max (_bsiz, rbs);
+	if (signal_delay == 0) {
+		return 0;
+	}
+	const samplecnt_t rbs = signal_delay + std::min (signal_delay, (samplecnt_t) 8192) + 1;
 
 	uint64_t power_of_two;
 	for (power_of_two = 1; 1 << power_of_two < rbs; ++power_of_two) {}
-	rbs = 1 << power_of_two;
+	return 1 << power_of_two;
+}
 
-	if (cc.n_audio () == _buf.size () && _bsiz == rbs) {
-		return;
+void
+DelayLine::allocate_pending_buffers (samplecnt_t signal_delay, ChanCount const& cc)
+{
+	assert (signal_delay >= 0);
+
+	/* lines without delay do not need any buffers. The current delay is
+	 * kept until run() has cross-faded to the new one.
+	 */
+	samplecnt_t rbs = 0;
+	if (cc.n_audio () > 0 && (signal_delay > 0 || _delay > 0)) {
+		rbs = std::max (_bsiz, buffer_size_for (std::max (signal_delay, _delay)));
 	}
 
-	_buf.clear ();
-	if (cc.n_audio () == 0) {
+	if ((cc.n_audio () == _buf.size () || rbs == 0) && _bsiz == rbs) {
 		return;
 	}
 
 	AudioDlyBuf pending_buf;
-	for (uint32_t i = 0; i < cc.n_audio (); ++i) {
-		boost::shared_array<Sample> b (new Sample[rbs]);
-		pending_buf.push_back (b);
-		memset (b.get (), 0, rbs * sizeof (Sample));
+	boost::shared_array<Sample> pending_data;
+
+	if (rbs > 0) {
+		pending_data.reset (new Sample[cc.n_audio () * rbs]);
+		memset (pending_data.get (), 0, cc.n_audio () * rbs * sizeof (Sample));
+		for (uint32_t i = 0; i < cc.n_audio (); ++i) {
+			pending_buf.push_back (&pending_data[i * rbs]);
+		}
 	}
 
-	AudioDlyBuf::iterator bo = _buf.begin ();
-	AudioDlyBuf::iterator bn = pending_buf.begin ();
+	sampleoffset_t roff = 0;
+	sampleoffset_t woff = 0;
 
-	for (; bo != _buf.end () && bn != pending_buf.end(); ++bo, ++bn) {
-		Sample* rbo = (*bo).get ();
-		Sample* rbn = (*bn).get ();
-		if (_roff < _woff) {
-			/* copy data between _roff .. _woff to new buffer */
-			copy_vector (&rbn[_roff], &rbo[_roff], _woff - _roff);
-		} else {
-			/* copy data between _roff .. old_size to end of new buffer, increment _roff
-			 * copy data from 0.._woff to beginning of new buffer
-			 */
-			sampleoffset_t offset = rbs - _bsiz;
-			copy_vector (&rbn[_roff + offset], &rbo[_roff], _bsiz - _roff);
-			copy_vector (rbn, rbo, _woff);
-			_roff += offset;
-			assert (_roff < rbs);
+	if (rbs > 0 && _bsiz > 0) {
+		roff = _roff;
+		woff = _woff;
+
+		AudioDlyBuf::iterator bo = _buf.begin ();
+		AudioDlyBuf::iterator bn = pending_buf.begin ();
+
+		for (; bo != _buf.end () && bn != pending_buf.end(); ++bo, ++bn) {
+			Sample* rbo = *bo;
+			Sample* rbn = *bn;
+			if (_roff < _woff) {
+				/* copy data between _roff .. _woff to new buffer */
+				copy_vector (&rbn[_roff], &rbo[_roff], _woff - _roff);
+			} else {
+				/* copy data between _roff .. old_size to end of new buffer, increment _roff
+				 * copy data from 0.._woff to beginning of new buffer
+				 */
+				sampleoffset_t offset = rbs - _bsiz;
+				copy_vector (&rbn[_roff + offset], &rbo[_roff], _bsiz - _roff);
+				copy_vector (rbn, rbo, _woff);
+				roff = _roff + offset;
+				assert (roff < rbs);
+			}
 		}
 	}
+
+	g_atomic_int_add (&_allocated_samples, (gint) (pending_buf.size () * rbs) - (gint) (_buf.size () * _bsiz));
+
+	DEBUG_TRACE (DEBUG::LatencyCompensation,
+			string_compose ("%1 delay buffers: %2 x %3 samples, all delay-lines: %4 bytes\n",
+				name (), pending_buf.size (), rbs, allocated_bytes ()));
+
+	_release_buffers = false;
+	_roff = roff;
+	_woff = woff;
 	_bsiz = rbs;
-	_bsiz_mask = _bsiz - 1;
+	_bsiz_mask = rbs > 0 ? rbs - 1 : 0;
 	_buf.swap (pending_buf);
+	_buf_data = pending_data;
 }
 
 bool
@@ -376,7 +432,7 @@ DelayLine::configure_io (ChanCount in, ChanCount out)
 		return false;
 	}
 
-	if (_configured_output != out) {
+	if (_configured_output != out || (_release_buffers && _pending_delay == 0)) {
 		allocate_pending_buffers (_pending_delay, out);
 	}
 
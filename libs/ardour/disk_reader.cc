@@ -17,6 +17,8 @@
 
 */
 
+#include <algorithm>
+
 #include <boost/smart_ptr/scoped_ptr.hpp>
 
 #include "pbd/enumwriter.h"
@@ -55,6 +57,7 @@ DiskReader::DiskReader (Session& s, string const & str, DiskIOProcessor::Flag f)
 	, overwrite_sample (0)
 	, overwrite_offset (0)
 	, _pending_overwrite (false)
+	, _pending_interpolation_reset (0)
 	, overwrite_queued (false)
 {
 	file_sample[DataType::AUDIO] = 0;
@@ -268,9 +271,28 @@ DiskReader::run (BufferSet& bufs, samplepos_t start_sample, samplepos_t end_samp
 		goto midi;
 	}
 
+	/* varispeed-quality 0 is cubic interpolation, 1..3 are the
+	 * presets of the band-limited one */
+	const uint32_t vq = std::min (Config->get_varispeed_quality (), (uint32_t) 3);
+	Interpolation& interp (vq > 0 ? static_cast<Interpolation&> (sinc_interpolation) : interpolation);
+	samplecnt_t lookahead = 0;
+
+	if (vq > 0) {
+		const SincInterpolation::Quality q = SincInterpolation::Quality (vq - 1);
+		if (sinc_interpolation.quality () != q) {
+			sinc_interpolation.set_quality (q);
+		}
+		lookahead = sinc_interpolation.lookahead ();
+	}
+
+	if (g_atomic_int_compare_and_exchange (&_pending_interpolation_reset, 1, 0)) {
+		interpolation.reset ();
+		sinc_interpolation.reset ();
+	}
+
 	if (speed != 1.0f && speed != -1.0f) {
-		interpolation.set_speed (speed);
-		disk_samples_to_consume = interpolation.distance (nframes);
+		interp.set_speed (speed);
+		disk_samples_to_consume = interp.distance (nframes);
 		if (speed < 0.0) {
 			disk_samples_to_consume = -disk_samples_to_consume;
 		}
@@ -348,12 +370,18 @@ DiskReader::run (BufferSet& bufs, samplepos_t start_sample, samplepos_t end_samp
 
 			chaninfo->buf->get_read_vector (&(*chan)->rw_vector);
 
-			if (disk_samples_to_consume <= (samplecnt_t) chaninfo->rw_vector.len[0]) {
+			/* the band-limited interpolator reads ahead of the consumed samples */
+			const samplecnt_t disk_samples_needed = disk_samples_to_consume + (fabsf (speed) != 1.0f ? lookahead : 0);
+
+			if (disk_samples_needed <= (samplecnt_t) chaninfo->rw_vector.len[0]) {
 
 				if (fabsf (speed) != 1.0f) {
 					samplecnt_t ocnt = nframes;
 					samplecnt_t icnt = chaninfo->rw_vector.len[0];
-					(void) interpolation.interpolate (n, icnt, chaninfo->rw_vector.buf[0], ocnt, disk_signal);
+					(void) interp.interpolate (n, icnt, chaninfo->rw_vector.buf[0], ocnt, disk_signal);
+					if (ocnt < nframes) {
+						memset (disk_signal + ocnt, 0, sizeof (Sample) * (nframes - ocnt));
+					}
 				} else if (speed != 0.0) {
 					memcpy (disk_signal, chaninfo->rw_vector.buf[0], sizeof (Sample) * disk_samples_to_consume);
 				}
@@ -362,16 +390,21 @@ DiskReader::run (BufferSet& bufs, samplepos_t start_sample, samplepos_t end_samp
 
 				const samplecnt_t total = chaninfo->rw_vector.len[0] + chaninfo->rw_vector.len[1];
 
-				if (disk_samples_to_consume <= total) {
+				if (disk_samples_needed <= total) {
 
 					if (fabsf (speed) != 1.0f) {
 						samplecnt_t ocnt = nframes;
-						interpolation.interpolate (n, chaninfo->rw_vector.len[0], chaninfo->rw_vector.buf[0], ocnt, disk_signal);
+						interp.interpolate (n, chaninfo->rw_vector.len[0], chaninfo->rw_vector.buf[0], ocnt, disk_signal);
 
+						if (ocnt < nframes && chaninfo->rw_vector.len[1] > 0) {
+							samplecnt_t ocnt2 = nframes - ocnt;
+							interp.interpolate (n, chaninfo->rw_vector.len[1], chaninfo->rw_vector.buf[1], ocnt2, disk_signal + ocnt);
+							ocnt += ocnt2;
+						}
+
+						/* never leave stale data from a previous cycle behind */
 						if (ocnt < nframes) {
-							disk_signal += ocnt;
-							ocnt = nframes - ocnt;
-							interpolation.interpolate (n, chaninfo->rw_vector.len[1], chaninfo->rw_vector.buf[1], ocnt, disk_signal);
+							memset (disk_signal + ocnt, 0, sizeof (Sample) * (nframes - ocnt));
 						}
 
 					} else if (speed != 0.0) {
@@ -386,7 +419,7 @@ DiskReader::run (BufferSet& bufs, samplepos_t start_sample, samplepos_t end_samp
 
 				} else {
 
-					cerr << _name << " Need " << disk_samples_to_consume << " total = " << total << endl;
+					cerr << _name << " Need " << disk_samples_needed << " total = " << total << endl;
 					cerr << "underrun for " << _name << endl;
 					DEBUG_TRACE (DEBUG::Butler, string_compose ("%1 underrun in %2, total space = %3\n",
 					                                            DEBUG_THREAD_SELF, name(), total));
@@ -405,6 +438,12 @@ DiskReader::run (BufferSet& bufs, samplepos_t start_sample, samplepos_t end_samp
 			if (ms & MonitoringInput) {
 				/* mix the disk signal into the input signal (already in bufs) */
 				mix_buffers_no_gain (output.data(), disk_signal, disk_samples_to_consume);
+			} else if (Config->get_skip_silent_processing ()) {
+				/* flag silent playlist ranges, to allow downstream
+				 * processors to skip processing. The data was just
+				 * copied, so checking it is cheap.
+				 */
+				output.detect_silence ();
 			}
 		}
 	}
@@ -653,6 +692,7 @@ DiskReader::seek (samplepos_t sample, bool complete_refill)
 
 	playback_sample = sample;
 	file_sample[DataType::AUDIO] = sample;
+	g_atomic_int_set (&_pending_interpolation_reset, 1);
 	file_sample[DataType::MIDI] = sample;
 
 	if (complete_refill) {
@@ -705,6 +745,9 @@ DiskReader::internal_playback_seek (samplecnt_t distance)
 
 	playback_sample += distance;
 
+	/* the interpolators' history is not continuous with the new position */
+	g_atomic_int_set (&_pending_interpolation_reset, 1);
+
 	return 0;
 }
 
@@ -223,6 +223,7 @@ setup_enum_writer ()
 	REGISTER_ENUM (MeterVU);
 	REGISTER_ENUM (MeterPeak0dB);
 	REGISTER_ENUM (MeterMCP);
+	REGISTER_ENUM (MeterTruePeak);
 	REGISTER (_MeterType);
 
 	REGISTER_ENUM (Normal);
@@ -34,14 +34,15 @@
 #include "audiographer/general/sample_format_converter.h"
 #include "audiographer/general/sr_converter.h"
 #include "audiographer/general/silence_trimmer.h"
+#include "audiographer/general/spill_buffer.h"
 #include "audiographer/general/threader.h"
 #include "audiographer/sndfile/tmp_file.h"
 #include "audiographer/sndfile/tmp_file_rt.h"
-#include "audiographer/sndfile/tmp_file_sync.h"
 #include "audiographer/sndfile/sndfile_writer.h"
 
 #include "ardour/audioengine.h"
 #include "ardour/export_channel_configuration.h"
+#include "ardour/export_failed.h"
 #include "ardour/export_filename.h"
 #include "ardour/export_format_specification.h"
 #include "ardour/export_timespan.h"
@@ -58,9 +59,15 @@ namespace ARDOUR {
 
 ExportGraphBuilder::ExportGraphBuilder (Session const & session)
 	: session (session)
+	, process_position (max_samplepos)
+	, cycle_samples (0)
+	, cycle_last (false)
+	, _realtime (false)
 	, thread_pool (hardware_concurrency())
+	, n_jobs (0)
 {
 	process_buffer_samples = session.engine().samples_per_cycle();
+	spill_budget.reset (new SpillBudget ((size_t) Config->get_export_memory_budget () * 1048576));
 }
 
 ExportGraphBuilder::~ExportGraphBuilder ()
@@ -72,17 +79,86 @@ ExportGraphBuilder::process (samplecnt_t samples, bool last_cycle)
 {
 	assert(samples <= process_buffer_samples);
 
-	for (ChannelMap::iterator it = channels.begin(); it != channels.end(); ++it) {
-		Sample const * process_buffer = 0;
-		it->first->read (process_buffer, samples);
-		ConstProcessContext<Sample> context(process_buffer, samples, 1);
-		if (last_cycle) { context().set_flag (ProcessContext<Sample>::EndOfInput); }
-		it->second->process (context);
+	for (ChannelData::iterator it = channel_data.begin(); it != channel_data.end(); ++it) {
+		it->first->read (it->second, samples);
+	}
+
+	cycle_samples = samples;
+	cycle_last    = last_cycle;
+
+	active_timespans.clear ();
+	for (TimespanGraphList::iterator t = timespans.begin(); t != timespans.end(); ++t) {
+		samplepos_t const start = t->span->get_start();
+		samplepos_t const end   = t->span->get_end();
+		if (start < process_position + samples && end > process_position) {
+			active_timespans.push_back (&(*t));
+		} else if (start == end && start >= process_position && (start < process_position + samples || last_cycle)) {
+			/* empty timespans never overlap a cycle, but still need
+			 * EndOfInput to finalize their writers */
+			active_timespans.push_back (&(*t));
+		}
+	}
+
+	if (active_timespans.size () == 1) {
+		process_timespan (*active_timespans.front ());
+	} else if (active_timespans.size () > 1) {
+		/* timespans share no state other than the channel data,
+		 * process them concurrently, and wait until all are done */
+		wait_mutex.lock ();
+		failure.clear ();
+		g_atomic_int_set (&n_jobs, active_timespans.size ());
+		for (std::vector<TimespanGraph*>::const_iterator t = active_timespans.begin(); t != active_timespans.end(); ++t) {
+			thread_pool.push (sigc::bind (sigc::mem_fun (*this, &ExportGraphBuilder::process_timespan_job), *t));
+		}
+		while (g_atomic_int_get (&n_jobs) != 0) {
+			gint64 end_time = g_get_monotonic_time () + 500 * G_TIME_SPAN_MILLISECOND;
+			wait_cond.wait_until (wait_mutex, end_time);
+		}
+		wait_mutex.unlock ();
+
+		if (!failure.empty ()) {
+			throw ExportFailed (failure);
+		}
 	}
 
+	process_position += samples;
 	return 0;
 }
 
+void
+ExportGraphBuilder::process_timespan (TimespanGraph& t)
+{
+	samplepos_t const start = std::max (t.span->get_start(), process_position);
+	samplepos_t const end   = std::min (t.span->get_end(), process_position + cycle_samples);
+	samplecnt_t const offset = start - process_position;
+	bool const last = cycle_last || end == t.span->get_end();
+
+	for (ChannelMap::iterator it = t.channels.begin(); it != t.channels.end(); ++it) {
+		ConstProcessContext<Sample> context (channel_data.find (it->first)->second + offset, end - start, 1);
+		if (last) { context().set_flag (ProcessContext<Sample>::EndOfInput); }
+		it->second->process (context);
+	}
+}
+
+void
+ExportGraphBuilder::process_timespan_job (TimespanGraph* t)
+{
+	try {
+		process_timespan (*t);
+	} catch (std::exception const & e) {
+		// Only the first exception is passed on
+		Glib::Threads::Mutex::Lock lm (failure_mutex);
+		if (failure.empty ()) {
+			failure = e.what ();
+		}
+	}
+
+	if (g_atomic_int_dec_and_test (&n_jobs)) {
+		Glib::Threads::Mutex::Lock lm (wait_mutex);
+		wait_cond.signal ();
+	}
+}
+
 bool
 ExportGraphBuilder::post_process ()
 {
@@ -112,10 +188,14 @@ ExportGraphBuilder::reset ()
 {
 	timespan.reset();
 	channel_configs.clear ();
-	channels.clear ();
+	channel_data.clear ();
+	timespans.clear ();
+	active_timespans.clear ();
+	process_position = max_samplepos;
 	intermediates.clear ();
 	analysis_map.clear();
 	_realtime = false;
+	spill_budget.reset (new SpillBudget ((size_t) Config->get_export_memory_budget () * 1048576));
 }
 
 void
@@ -133,6 +213,16 @@ void
 ExportGraphBuilder::set_current_timespan (boost::shared_ptr<ExportTimespan> span)
 {
 	timespan = span;
+
+	for (TimespanGraphList::iterator t = timespans.begin(); t != timespans.end(); ++t) {
+		if (t->span == span) {
+			return;
+		}
+	}
+
+	timespans.push_back (TimespanGraph (span));
+	active_timespans.reserve (timespans.size ());
+	process_position = std::min (process_position, span->get_start());
 }
 
 void
@@ -195,14 +285,20 @@ void
 ExportGraphBuilder::add_split_config (FileSpec const & config)
 {
 	for (ChannelConfigList::iterator it = channel_configs.begin(); it != channel_configs.end(); ++it) {
-		if (*it == config) {
+		if (*it == config && it->get_timespan () == timespan) {
 			it->add_child (config);
 			return;
 		}
 	}
 
+	TimespanGraphList::iterator t = timespans.begin();
+	while (t != timespans.end() && t->span != timespan) {
+		++t;
+	}
+	assert (t != timespans.end());
+
 	// No duplicate channel config found, create new one
-	channel_configs.push_back (new ChannelConfig (*this, config, channels));
+	channel_configs.push_back (new ChannelConfig (*this, config, t->channels));
 }
 
 /* Encoder */
@@ -411,7 +507,7 @@ ExportGraphBuilder::SFC::operator== (FileSpec const & other_config) const
 	return config.format->sample_format() == other_config.format->sample_format();
 }
 
-/* Intermediate (Normalizer, TmpFile) */
+/* Intermediate (Normalizer, TmpFile or SpillBuffer) */
 
 ExportGraphBuilder::Intermediate::Intermediate (ExportGraphBuilder & parent, FileSpec const & new_config, samplecnt_t max_samples)
 	: parent (parent)
@@ -444,25 +540,32 @@ ExportGraphBuilder::Intermediate::Intermediate (ExportGraphBuilder & parent, Fil
 	normalizer->alloc_buffer (max_samples_out);
 	normalizer->add_output (threader);
 
-	int format = ExportFormatBase::F_RAW | ExportFormatBase::SF_Float;
-
 	if (parent._realtime) {
+		int format = ExportFormatBase::F_RAW | ExportFormatBase::SF_Float;
 		tmp_file.reset (new TmpFileRt<float> (&tmpfile_path_buf[0], format, channels, config.format->sample_rate()));
+
+		tmp_file->FileWritten.connect_same_thread (post_processing_connection,
+		                                           boost::bind (&Intermediate::prepare_post_processing, this));
+		tmp_file->FileFlushed.connect_same_thread (post_processing_connection,
+		                                           boost::bind (&Intermediate::start_post_processing, this));
 	} else {
-		tmp_file.reset (new TmpFileSync<float> (&tmpfile_path_buf[0], format, channels, config.format->sample_rate()));
-	}
+		/* keep the render in memory as far as the budget allows,
+		 * no need to go through libsndfile for the rest */
+		spill.reset (new SpillBuffer (channels, parent.spill_budget, tmpfile_path));
 
-	tmp_file->FileWritten.connect_same_thread (post_processing_connection,
-	                                           boost::bind (&Intermediate::prepare_post_processing, this));
-	tmp_file->FileFlushed.connect_same_thread (post_processing_connection,
-	                                           boost::bind (&Intermediate::start_post_processing, this));
+		spill->Written.connect_same_thread (post_processing_connection,
+		                                    boost::bind (&Intermediate::prepare_post_processing, this));
+		spill->Written.connect_same_thread (post_processing_connection,
+		                                    boost::bind (&Intermediate::start_post_processing, this));
+	}
 
 	add_child (new_config);
 
+	FloatSinkPtr buffer_sink = spill ? FloatSinkPtr (spill) : FloatSinkPtr (tmp_file);
 	if (use_loudness) {
-		loudness_reader->add_output (tmp_file);
+		loudness_reader->add_output (buffer_sink);
 	} else if (use_peak) {
-		peak_reader->add_output (tmp_file);
+		peak_reader->add_output (buffer_sink);
 	}
 }
 
@@ -473,6 +576,8 @@ ExportGraphBuilder::Intermediate::sink ()
 		return loudness_reader;
 	} else if (use_peak) {
 		return peak_reader;
+	} else if (spill) {
+		return spill;
 	}
 	return tmp_file;
 }
@@ -518,14 +623,14 @@ ExportGraphBuilder::Intermediate::operator== (FileSpec const & other_config) con
 unsigned
 ExportGraphBuilder::Intermediate::get_postprocessing_cycle_count() const
 {
-	return static_cast<unsigned>(std::ceil(static_cast<float>(tmp_file->get_samples_written()) /
-	                                       max_samples_out));
+	samplecnt_t const written = spill ? spill->get_samples_written() : tmp_file->get_samples_written();
+	return static_cast<unsigned>(std::ceil(static_cast<float>(written) / max_samples_out));
 }
 
 bool
 ExportGraphBuilder::Intermediate::process()
 {
-	samplecnt_t samples_read = tmp_file->read (*buffer);
+	samplecnt_t samples_read = spill ? spill->read (*buffer) : tmp_file->read (*buffer);
 	return samples_read != buffer->samples();
 }
 
@@ -547,7 +652,14 @@ ExportGraphBuilder::Intermediate::prepare_post_processing()
 			(*i).set_peak (gain);
 		}
 	}
-	tmp_file->add_output (normalizer);
+	if (spill) {
+		spill->add_output (normalizer);
+	} else {
+		tmp_file->add_output (normalizer);
+	}
+
+	// timespans may be processed concurrently
+	Glib::Threads::Mutex::Lock lm (parent.intermediates_lock);
 	parent.intermediates.push_back (this);
 }
 
@@ -555,7 +667,11 @@ void
 ExportGraphBuilder::Intermediate::start_post_processing()
 {
 	// called in disk-thread (when exporting in realtime)
-	tmp_file->seek (0, SEEK_SET);
+	if (spill) {
+		spill->rewind ();
+	} else {
+		tmp_file->seek (0, SEEK_SET);
+	}
 	if (!AudioEngine::instance()->freewheeling ()) {
 		AudioEngine::instance()->freewheel (true);
 	}
@@ -716,6 +832,7 @@ ExportGraphBuilder::ChannelConfig::ChannelConfig (ExportGraphBuilder & parent, F
 	typedef ExportChannelConfiguration::ChannelList ChannelList;
 
 	config = new_config;
+	timespan = parent.timespan;
 
 	samplecnt_t max_samples = parent.session.engine().samples_per_cycle();
 	interleaver.reset (new Interleaver<Sample> ());
@@ -741,6 +858,7 @@ ExportGraphBuilder::ChannelConfig::ChannelConfig (ExportGraphBuilder & parent, F
 			map_it = result_pair.first;
 		}
 		map_it->second->add_output (interleaver->input (chan));
+		parent.channel_data.insert (std::make_pair (*it, (Sample const *) 0));
 	}
 
 	add_child (new_config);
@@ -36,6 +36,7 @@
 #include "ardour/export_status.h"
 #include "ardour/export_format_specification.h"
 #include "ardour/export_filename.h"
+#include "ardour/rc_configuration.h"
 #include "ardour/soundcloud_upload.h"
 #include "ardour/system_exec.h"
 #include "pbd/openuri.h"
@@ -113,6 +114,8 @@ ExportHandler::ExportHandler (Session & session)
   , graph_builder (new ExportGraphBuilder (session))
   , export_status (session.get_export_status ())
   , post_processing (false)
+  , process_position (0)
+  , timespan_end (0)
   , cue_tracknum (0)
   , cue_indexnum (0)
 {
@@ -158,6 +161,16 @@ ExportHandler::do_export ()
 		}
 	}
 
+	if (export_status->total_timespans > 1 && Config->get_export_parallel_timespans ()) {
+		/* Filenames can be shared across timespans, but the path depends
+		 * on the timespan. Several timespans may be active at the same
+		 * time, so give each config its own copy */
+		for (ConfigMap::iterator it = config_map.begin(); it != config_map.end(); ++it) {
+			FileSpec & spec = it->second;
+			spec.filename = add_filename_copy (spec.filename);
+		}
+	}
+
 	/* Start export */
 
 	Glib::Threads::Mutex::Lock l (export_status->lock());
@@ -175,37 +188,71 @@ ExportHandler::start_timespan ()
 		return;
 	}
 
-	/* finish_timespan pops the config_map entry that has been done, so
+	/* finish_timespan pops the config_map entries that have been done, so
 	   this is the timespan to do this time
 	*/
 	current_timespan = config_map.begin()->first;
+	current_timespans.clear ();
+	current_timespans.insert (current_timespan);
+
+	samplepos_t start = current_timespan->get_start();
+	timespan_end = current_timespan->get_end();
+
+	if (Config->get_export_parallel_timespans () && can_export_in_parallel (current_timespan)) {
+		/* add all timespans that overlap or adjoin the range, until no more are found */
+		bool grown = true;
+		while (grown) {
+			grown = false;
+			for (ConfigMap::iterator it = config_map.begin(); it != config_map.end(); ++it) {
+				ExportTimespanPtr ts = it->first;
+				if (current_timespans.find (ts) != current_timespans.end ()) {
+					continue;
+				}
+				if (ts->get_start() > timespan_end || ts->get_end() < start || !can_export_in_parallel (ts)) {
+					continue;
+				}
+				current_timespans.insert (ts);
+				start = std::min (start, ts->get_start());
+				timespan_end = std::max (timespan_end, ts->get_end());
+				grown = true;
+			}
+		}
+		/* the timespan counter was incremented once for this pass */
+		export_status->timespan += current_timespans.size () - 1;
+	}
 
-	export_status->total_samples_current_timespan = current_timespan->get_length();
-	export_status->timespan_name = current_timespan->name();
+	export_status->total_samples_current_timespan = timespan_end - start;
+	if (current_timespans.size () == 1) {
+		export_status->timespan_name = current_timespan->name();
+	} else {
+		export_status->timespan_name = string_compose (_("%1 timespans"), current_timespans.size ());
+	}
 	export_status->processed_samples_current_timespan = 0;
 
 	/* Register file configurations to graph builder */
 
-	/* Here's the config_map entries that use this timespan */
-	timespan_bounds = config_map.equal_range (current_timespan);
 	graph_builder->reset ();
-	graph_builder->set_current_timespan (current_timespan);
-	handle_duplicate_format_extensions();
 	bool realtime = current_timespan->realtime ();
 	bool region_export = true;
-	for (ConfigMap::iterator it = timespan_bounds.first; it != timespan_bounds.second; ++it) {
-		// Filenames can be shared across timespans
-		FileSpec & spec = it->second;
-		spec.filename->set_timespan (it->first);
-		switch (spec.channel_config->region_processing_type ()) {
-			case RegionExportChannelFactory::None:
-			case RegionExportChannelFactory::Processed:
-				region_export = false;
-				break;
-			default:
-				break;
+	for (TimespanSet::const_iterator ts = current_timespans.begin(); ts != current_timespans.end(); ++ts) {
+		/* Here's the config_map entries that use this timespan */
+		std::pair<ConfigMap::iterator, ConfigMap::iterator> bounds = config_map.equal_range (*ts);
+		graph_builder->set_current_timespan (*ts);
+		handle_duplicate_format_extensions (*ts);
+		for (ConfigMap::iterator it = bounds.first; it != bounds.second; ++it) {
+			// Filenames can be shared across timespans
+			FileSpec & spec = it->second;
+			spec.filename->set_timespan (it->first);
+			switch (spec.channel_config->region_processing_type ()) {
+				case RegionExportChannelFactory::None:
+				case RegionExportChannelFactory::Processed:
+					region_export = false;
+					break;
+				default:
+					break;
+			}
+			graph_builder->add_config (spec, realtime);
 		}
-		graph_builder->add_config (spec, realtime);
 	}
 
 	// ExportDialog::update_realtime_selection does not allow this
@@ -215,18 +262,39 @@ ExportHandler::start_timespan ()
 
 	post_processing = false;
 	session.ProcessExport.connect_same_thread (process_connection, boost::bind (&ExportHandler::process, this, _1));
-	process_position = current_timespan->get_start();
+	process_position = start;
 	// TODO check if it's a RegionExport.. set flag to skip  process_without_events()
 	session.start_audio_export (process_position, realtime, region_export);
 }
 
+/** Timespans can be rendered in one pass if they are exported
+ * freewheeling, and none of them reads regions directly (those
+ * keep their own read position).
+ */
+bool
+ExportHandler::can_export_in_parallel (ExportTimespanPtr timespan) const
+{
+	if (timespan->realtime ()) {
+		return false;
+	}
+	std::pair<ConfigMap::const_iterator, ConfigMap::const_iterator> bounds = config_map.equal_range (timespan);
+	for (ConfigMap::const_iterator it = bounds.first; it != bounds.second; ++it) {
+		if (it->second.channel_config->region_processing_type () != RegionExportChannelFactory::None) {
+			return false;
+		}
+	}
+	return true;
+}
+
 void
-ExportHandler::handle_duplicate_format_extensions()
+ExportHandler::handle_duplicate_format_extensions (ExportTimespanPtr timespan)
 {
 	typedef std::map<std::string, int> ExtCountMap;
 
+	std::pair<ConfigMap::iterator, ConfigMap::iterator> bounds = config_map.equal_range (timespan);
+
 	ExtCountMap counts;
-	for (ConfigMap::iterator it = timespan_bounds.first; it != timespan_bounds.second; ++it) {
+	for (ConfigMap::iterator it = bounds.first; it != bounds.second; ++it) {
 		counts[it->second.format->extension()]++;
 	}
 
@@ -236,7 +304,7 @@ ExportHandler::handle_duplicate_format_extensions()
 	}
 
 	// Set this always, as the filenames are shared...
-	for (ConfigMap::iterator it = timespan_bounds.first; it != timespan_bounds.second; ++it) {
+	for (ConfigMap::iterator it = bounds.first; it != bounds.second; ++it) {
 		it->second.filename->include_format_name = duplicates_found;
 	}
 }
@@ -267,7 +335,7 @@ ExportHandler::process_timespan (samplecnt_t samples)
 	/* update position */
 
 	samplecnt_t samples_to_read = 0;
-	samplepos_t const end = current_timespan->get_end();
+	samplepos_t const end = timespan_end;
 
 	bool const last_cycle = (process_position + samples >= end);
 
@@ -278,8 +346,16 @@ ExportHandler::process_timespan (samplecnt_t samples)
 		samples_to_read = samples;
 	}
 
+	/* overall progress is the sum of all timespans' progress */
+	for (TimespanSet::const_iterator ts = current_timespans.begin(); ts != current_timespans.end(); ++ts) {
+		samplepos_t const s = std::max ((*ts)->get_start(), process_position);
+		samplepos_t const e = std::min ((*ts)->get_end(), process_position + samples_to_read);
+		if (e > s) {
+			export_status->processed_samples += e - s;
+		}
+	}
+
 	process_position += samples_to_read;
-	export_status->processed_samples += samples_to_read;
 	export_status->processed_samples_current_timespan += samples_to_read;
 
 	/* Do actual processing */
@@ -331,23 +407,31 @@ ExportHandler::finish_timespan ()
 {
 	graph_builder->get_analysis_results (export_status->result_map);
 
-	while (config_map.begin() != timespan_bounds.second) {
+	ConfigMap::iterator cfg = config_map.begin();
+	while (cfg != config_map.end()) {
+
+		if (current_timespans.find (cfg->first) == current_timespans.end ()) {
+			++cfg;
+			continue;
+		}
 
-		ExportFormatSpecPtr fmt = config_map.begin()->second.format;
-		std::string filename = config_map.begin()->second.filename->get_path(fmt);
+		ExportTimespanPtr timespan = cfg->first;
+		ExportFormatSpecPtr fmt = cfg->second.format;
+		cfg->second.filename->set_timespan (timespan);
+		std::string filename = cfg->second.filename->get_path(fmt);
 		if (fmt->with_cue()) {
-			export_cd_marker_file (current_timespan, fmt, filename, CDMarkerCUE);
+			export_cd_marker_file (timespan, fmt, filename, CDMarkerCUE);
 		}
 
 		if (fmt->with_toc()) {
-			export_cd_marker_file (current_timespan, fmt, filename, CDMarkerTOC);
+			export_cd_marker_file (timespan, fmt, filename, CDMarkerTOC);
 		}
 
 		if (fmt->with_mp4chaps()) {
-			export_cd_marker_file (current_timespan, fmt, filename, MP4Chaps);
+			export_cd_marker_file (timespan, fmt, filename, MP4Chaps);
 		}
 
-		Session::Exported (current_timespan->name(), filename); /* EMIT SIGNAL */
+		Session::Exported (timespan->name(), filename); /* EMIT SIGNAL */
 
 		/* close file first, otherwise TagLib enounters an ERROR_SHARING_VIOLATION
 		 * The process cannot access the file because it is being used.
@@ -402,7 +486,7 @@ ExportHandler::finish_timespan ()
 			subs.insert (std::pair<char, std::string> ('G', metadata.genre ()));
 			subs.insert (std::pair<char, std::string> ('L', total_tracks.str ()));
 			subs.insert (std::pair<char, std::string> ('M', metadata.mixer ()));
-			subs.insert (std::pair<char, std::string> ('N', current_timespan->name())); // =?= config_map.begin()->first->name ()
+			subs.insert (std::pair<char, std::string> ('N', timespan->name()));
 			subs.insert (std::pair<char, std::string> ('O', metadata.composer ()));
 			subs.insert (std::pair<char, std::string> ('P', metadata.producer ()));
 			subs.insert (std::pair<char, std::string> ('S', metadata.disc_subtitle ()));
@@ -459,7 +543,7 @@ ExportHandler::finish_timespan ()
 			}
 			delete soundcloud_uploader;
 		}
-		config_map.erase (config_map.begin());
+		config_map.erase (cfg++);
 	}
 
 	start_timespan ();
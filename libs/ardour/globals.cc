@@ -94,6 +94,7 @@
 #include "ardour/audioregion.h"
 #include "ardour/buffer_manager.h"
 #include "ardour/control_protocol_manager.h"
+#include "ardour/cycle_stats.h"
 #include "ardour/directory_names.h"
 #include "ardour/event_type_map.h"
 #include "ardour/filesystem_paths.h"
@@ -546,11 +547,18 @@ ARDOUR::init (bool use_windows_vst, bool try_optimization, const char* localedir
 	EventLoop::register_request_buffer_factory (X_("midiUI"), MidiControlUI::request_factory);
 
         ProcessThread::init ();
+
+	/* calibrate the cycle-counter, which is used for DSP statistics.
+	   This blocks for ~20ms, better here than when a plugin is added. */
+	CycleStats::cycles_per_usec ();
+
 	/* the + 4 is a bit of a handwave. i don't actually know
 	   how many more per-thread buffer sets we need above
 	   the h/w concurrency, but its definitely > 1 more.
+	   Process-graph threads and RTTaskList worker threads
+	   each need one.
 	*/
-        BufferManager::init (hardware_concurrency() + 4);
+        BufferManager::init (2 * hardware_concurrency() + 4);
 
         PannerManager::instance().discover_panners();
 
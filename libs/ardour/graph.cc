@@ -31,6 +31,7 @@
 #include "ardour/route.h"
 #include "ardour/process_thread.h"
 #include "ardour/audioengine.h"
+#include "ardour/trace_recorder.h"
 
 #include "pbd/i18n.h"
 
@@ -430,6 +431,7 @@ Graph::helper_thread()
 {
 	suspend_rt_malloc_checks ();
 	ProcessThread* pt = new ProcessThread ();
+	TraceRecorder::register_thread ();
 	resume_rt_malloc_checks ();
 
 	pt->get_buffers();
@@ -450,6 +452,7 @@ Graph::main_thread()
 {
 	suspend_rt_malloc_checks ();
 	ProcessThread* pt = new ProcessThread ();
+	TraceRecorder::register_thread ();
 	resume_rt_malloc_checks ();
 
 	pt->get_buffers();
@@ -571,6 +574,8 @@ Graph::process_one_route (Route* route)
 
 	assert (route);
 
+	TraceRecorder::Span span ("Graph::process_one_route", route->trace_label ());
+
 	DEBUG_TRACE (DEBUG::ProcessThreads, string_compose ("%1 runs route %2\n", pthread_name(), route->name()));
 
 	if (_process_noroll) {
@@ -17,11 +17,19 @@
 
 */
 
+#include <algorithm>
 #include <limits>
 #include <cstdio>
+#include <cstring>
 
 #include <stdint.h>
 
+#include <glibmm/threads.h>
+
+#if defined(__SSE__) || defined(USE_XMMINTRIN)
+#include <xmmintrin.h>
+#endif
+
 #include "ardour/interpolation.h"
 #include "ardour/midi_buffer.h"
 
@@ -225,3 +233,289 @@ CubicInterpolation::distance (samplecnt_t nsamples)
 	assert (phase.size () > 0);
 	return floor (floor (phase[0]) + (_speed * nsamples));
 }
+
+/* SincInterpolation */
+
+namespace {
+
+struct SincPreset {
+	uint32_t taps;
+	uint32_t phases;
+	double   rolloff; ///< cutoff relative to Nyquist
+	double   beta;    ///< Kaiser window shape
+};
+
+/* indexed by SincInterpolation::Quality */
+const SincPreset sinc_presets[3] = {
+	{ 16,  64, 0.85,   6.0 },
+	{ 32, 128, 0.91,   8.0 },
+	{ 64, 128, 0.945, 10.0 },
+};
+
+/* a table is used for all speeds up to its stretch, faster speeds use the last one */
+const double sinc_stretch[SincInterpolation::n_stretch] = { 1.0, 1.125, 1.25, 1.5, 2.0, 2.5, 3.0, 4.0 };
+
+SincInterpolation::Table sinc_tables[3][SincInterpolation::n_stretch];
+uint32_t             sinc_max_taps = 0;
+bool                 sinc_tables_built = false;
+Glib::Threads::Mutex sinc_table_lock;
+
+double
+bessel_i0 (double x)
+{
+	double sum  = 1.0;
+	double term = 1.0;
+	for (int k = 1; k < 50; ++k) {
+		term *= (x / (2.0 * k)) * (x / (2.0 * k));
+		sum  += term;
+		if (term < sum * 1e-12) {
+			break;
+		}
+	}
+	return sum;
+}
+
+void
+build_sinc_table (SincInterpolation::Table& t, SincPreset const& p, double stretch)
+{
+	t.taps   = ((uint32_t) ceil (p.taps * stretch) + 7) & ~7;
+	t.phases = p.phases;
+	t.coeff.resize ((t.phases + 1) * t.taps);
+	t.delta.resize (t.phases * t.taps);
+
+	const double fc   = p.rolloff / stretch;
+	const double half = t.taps / 2;
+	const double i0b  = bessel_i0 (p.beta);
+
+	/* row @a ph is the filter for an output at (ph / phases) after
+	 * input sample (taps / 2 - 1) of the window */
+	for (uint32_t ph = 0; ph <= t.phases; ++ph) {
+		float* row = &t.coeff[ph * t.taps];
+		double sum = 0;
+		for (uint32_t k = 0; k < t.taps; ++k) {
+			const double d = ph / (double) t.phases + half - 1 - k;
+			const double w = d / half;
+			double h = 0;
+			if (fabs (w) < 1.0) {
+				const double x = M_PI * fc * d;
+				h = fc * (fabs (x) < 1e-9 ? 1.0 : sin (x) / x) * bessel_i0 (p.beta * sqrt (1.0 - w * w)) / i0b;
+			}
+			row[k] = h;
+			sum += h;
+		}
+		/* unity gain at DC for every phase */
+		for (uint32_t k = 0; k < t.taps; ++k) {
+			row[k] /= sum;
+		}
+	}
+
+	for (uint32_t i = 0; i < t.phases * t.taps; ++i) {
+		t.delta[i] = t.coeff[i + t.taps] - t.coeff[i];
+	}
+}
+
+/* h and dh are rows of the table, the result is the dot-product of x with
+ * (h + frac * dh) */
+inline float
+sinc_fir (float const* h, float const* dh, float frac, float const* x, uint32_t taps)
+{
+#if defined(__SSE__) || defined(USE_XMMINTRIN)
+	/* two sets of partial sums to hide the latency of the additions */
+	__m128 a0 = _mm_setzero_ps ();
+	__m128 a1 = _mm_setzero_ps ();
+	__m128 b0 = _mm_setzero_ps ();
+	__m128 b1 = _mm_setzero_ps ();
+
+	for (uint32_t k = 0; k < taps; k += 8) {
+		const __m128 x0 = _mm_loadu_ps (x + k);
+		const __m128 x1 = _mm_loadu_ps (x + k + 4);
+		a0 = _mm_add_ps (a0, _mm_mul_ps (_mm_loadu_ps (h + k), x0));
+		a1 = _mm_add_ps (a1, _mm_mul_ps (_mm_loadu_ps (h + k + 4), x1));
+		b0 = _mm_add_ps (b0, _mm_mul_ps (_mm_loadu_ps (dh + k), x0));
+		b1 = _mm_add_ps (b1, _mm_mul_ps (_mm_loadu_ps (dh + k + 4), x1));
+	}
+
+	const __m128 r = _mm_add_ps (_mm_add_ps (a0, a1), _mm_mul_ps (_mm_set1_ps (frac), _mm_add_ps (b0, b1)));
+	float v[4];
+	_mm_storeu_ps (v, r);
+	return v[0] + v[1] + v[2] + v[3];
+#else
+	/* vectorized by the compiler with -ffast-math */
+	float a = 0;
+	float b = 0;
+	for (uint32_t k = 0; k < taps; ++k) {
+		a += h[k] * x[k];
+		b += dh[k] * x[k];
+	}
+	return a + frac * b;
+#endif
+}
+
+} // anonymous namespace
+
+void
+SincInterpolation::build_tables ()
+{
+	Glib::Threads::Mutex::Lock lm (sinc_table_lock);
+	if (sinc_tables_built) {
+		return;
+	}
+	for (uint32_t q = 0; q < 3; ++q) {
+		for (uint32_t s = 0; s < n_stretch; ++s) {
+			build_sinc_table (sinc_tables[q][s], sinc_presets[q], sinc_stretch[s]);
+			sinc_max_taps = std::max (sinc_max_taps, sinc_tables[q][s].taps);
+		}
+	}
+	sinc_tables_built = true;
+}
+
+SincInterpolation::SincInterpolation (Quality q)
+	: _cycle_distance (0)
+	, _cycle_length (0)
+{
+	build_tables ();
+	_edge.resize (2 * sinc_max_taps);
+	set_quality (q);
+}
+
+void
+SincInterpolation::set_quality (Quality q)
+{
+	_quality = q;
+	for (uint32_t s = 0; s < n_stretch; ++s) {
+		_tables[s] = &sinc_tables[q][s];
+	}
+	_lookahead = _tables[n_stretch - 1]->taps / 2 + 1;
+	reset ();
+}
+
+void
+SincInterpolation::add_channel ()
+{
+	Interpolation::add_channel ();
+	_history.push_back (std::vector<float> (sinc_max_taps, 0.f));
+	_produced.push_back (0);
+	_absorbed.push_back (0);
+}
+
+void
+SincInterpolation::remove_channel ()
+{
+	Interpolation::remove_channel ();
+	_history.pop_back ();
+	_produced.pop_back ();
+	_absorbed.pop_back ();
+}
+
+void
+SincInterpolation::reset ()
+{
+	Interpolation::reset ();
+	for (size_t c = 0; c < _history.size (); ++c) {
+		std::fill (_history[c].begin (), _history[c].end (), 0.f);
+		_produced[c] = 0;
+		_absorbed[c] = 0;
+	}
+}
+
+samplecnt_t
+SincInterpolation::interpolate (int channel, samplecnt_t input_samples, Sample* input, samplecnt_t & output_samples, Sample* output)
+{
+	assert (input_samples > 0);
+	assert (output_samples > 0);
+	assert (input);
+	assert (output);
+	assert (phase.size () > channel);
+
+	_speed = fabs (_speed);
+
+	uint32_t si = 0;
+	while (si < n_stretch - 1 && sinc_stretch[si] < _speed) {
+		++si;
+	}
+
+	Table const&      t (*_tables[si]);
+	const uint32_t    taps = t.taps;
+	const samplecnt_t half = taps / 2;
+	const samplecnt_t hist_size = sinc_max_taps;
+	float*            hist = &_history[channel][0];
+
+	/* windows that start before input[0] are read from a copy of the
+	 * history, followed by the start of the input. The history is longer
+	 * than needed for this table if a longer one was used before. */
+	float* edge = &_edge[0];
+	memcpy (edge, hist, sizeof (float) * hist_size);
+	memcpy (edge + hist_size, input, sizeof (float) * std::min<samplecnt_t> (taps, input_samples));
+
+	if (_cycle_length == 0) {
+		/* distance () was not called */
+		distance (output_samples);
+	}
+
+	/* positions are computed from the phase at the start of the cycle
+	 * and the number of outputs since, exactly as in distance (), so that
+	 * the consumed input always matches what the caller advances by */
+	const double      base     = phase[channel];
+	const samplecnt_t produced = _produced[channel];
+	const samplecnt_t absorbed = _absorbed[channel];
+	samplecnt_t       outsample = 0;
+
+	while (outsample < output_samples) {
+		const double      pos = position (base, produced + outsample) - absorbed;
+		const samplecnt_t i   = floor (pos);
+		if (i + half >= input_samples) {
+			break;
+		}
+		const samplecnt_t first = i + 1 - half;
+		float const* x = first < 0 ? edge + hist_size + first : input + first;
+
+		const double   fp = (pos - i) * t.phases;
+		const uint32_t p  = std::min ((uint32_t) fp, t.phases - 1);
+
+		output[outsample++] = sinc_fir (&t.coeff[p * taps], &t.delta[p * taps], fp - p, x, taps);
+	}
+
+	samplecnt_t used;
+	if (outsample < output_samples) {
+		/* the input was not sufficient: all of it is consumed and the
+		 * remaining samples are used from the history next time */
+		used = input_samples;
+		_produced[channel] = produced + outsample;
+		_absorbed[channel] = absorbed + input_samples;
+	} else {
+		const double      end_pos = position (base, produced + outsample);
+		const samplecnt_t end     = floor (end_pos);
+		used = std::min<samplecnt_t> (end - absorbed, input_samples);
+		phase[channel]     = end_pos - end;
+		_produced[channel] = 0;
+		/* non-zero only if the input did not reach the end position */
+		_absorbed[channel] = absorbed + used - end;
+	}
+
+	if (used < 0) {
+		/* the previous call consumed input that is needed as look-ahead
+		 * only, the caller will pass it again next time */
+		memmove (hist - used, hist, sizeof (float) * (hist_size + used));
+		memset (hist, 0, sizeof (float) * -used);
+	} else if (used >= hist_size) {
+		memcpy (hist, input + used - hist_size, sizeof (float) * hist_size);
+	} else if (used > 0) {
+		memmove (hist, hist + used, sizeof (float) * (hist_size - used));
+		memcpy (hist + hist_size - used, input, sizeof (float) * used);
+	}
+
+	output_samples = outsample;
+	return std::max<samplecnt_t> (0, used);
+}
+
+samplecnt_t
+SincInterpolation::distance (samplecnt_t nsamples)
+{
+	assert (phase.size () > 0);
+	if (nsamples <= 0) {
+		return 0;
+	}
+	_cycle_distance = floor (fabs (_speed) * nsamples);
+	_cycle_length   = nsamples;
+	return (samplecnt_t) floor (position (phase[0], _produced[0] + nsamples)) - _absorbed[0];
+}
@@ -0,0 +1,163 @@
+/*
+ * Copyright (C) 2026 The Ardour Developers
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include <algorithm>
+
+#include "ardour/audio_buffer.h"
+#include "ardour/buffer_set.h"
+#include "ardour/dB.h"
+#include "ardour/loudness_meter.h"
+#include "ardour/session.h"
+
+using namespace ARDOUR;
+using namespace PBD;
+
+LoudnessMeter::LoudnessMeter (Session& s)
+	: Processor (s, "Loudness")
+	, _tp_max (0)
+	, _n_published (0)
+	, _reset_request (0)
+	, _seq (0)
+{
+}
+
+bool
+LoudnessMeter::can_support_io_configuration (const ChanCount& in, ChanCount& out)
+{
+	out = in;
+	return true;
+}
+
+bool
+LoudnessMeter::configure_io (ChanCount in, ChanCount out)
+{
+	if (out != in) { // always 1:1
+		return false;
+	}
+
+	/* called with the process-lock held, the meter does not run concurrently */
+	const uint32_t n_audio = in.n_audio ();
+	_kernel.init (n_audio, _session.nominal_sample_rate ());
+
+	/* BS.1770 channel weighting, using the same channel order as
+	 * Ebu_r128_proc for 5 channels (L, R, C, Ls, Rs) and ITU order
+	 * for 5.1 (L, R, C, LFE, Ls, Rs). */
+	if (n_audio == 5) {
+		_kernel.set_channel_gain (3, 1.41f);
+		_kernel.set_channel_gain (4, 1.41f);
+	} else if (n_audio == 6) {
+		_kernel.set_channel_gain (3, 0.f);
+		_kernel.set_channel_gain (4, 1.41f);
+		_kernel.set_channel_gain (5, 1.41f);
+	}
+	_tp.set_channels (n_audio);
+	_data.resize (n_audio);
+	_tp_max = 0;
+	_n_published = 0;
+	publish ();
+
+	return Processor::configure_io (in, out);
+}
+
+void
+LoudnessMeter::reset ()
+{
+	g_atomic_int_set (&_reset_request, 1);
+}
+
+void
+LoudnessMeter::run (BufferSet& bufs, samplepos_t /*start_sample*/, samplepos_t /*end_sample*/, double speed, pframes_t nframes, bool)
+{
+	if (!_active && !_pending_active) {
+		return;
+	}
+	_active = _pending_active;
+
+	if (g_atomic_int_compare_and_exchange (&_reset_request, 1, 0)) {
+		_kernel.reset ();
+		_tp.reset ();
+		_tp_max = 0;
+		_n_published = 0;
+		publish ();
+	}
+
+	const uint32_t n_audio = _kernel.n_channels ();
+	if (n_audio == 0 || bufs.count ().n_audio () < n_audio) {
+		return;
+	}
+
+	BufferSet const& cbufs (bufs);
+	for (uint32_t c = 0; c < n_audio; ++c) {
+		/* read-only, keep the buffer's silent flag */
+		_data[c] = cbufs.get_audio (c).data ();
+		_tp_max = std::max (_tp_max, _tp.process (c, _data[c], nframes));
+	}
+
+	/* the momentary and short-term meters are always live,
+	 * only integrate what is played back or recorded */
+	_kernel.set_integrating (speed != 0);
+	_kernel.process (&_data[0], nframes);
+
+	if (_kernel.n_fragments () != _n_published) {
+		publish ();
+	}
+}
+
+void
+LoudnessMeter::publish ()
+{
+	Readout r;
+	r.momentary      = _kernel.momentary ();
+	r.short_term     = _kernel.short_term ();
+	r.integrated     = _kernel.integrated ();
+	r.range          = std::max (0.f, _kernel.range_max () - _kernel.range_min ());
+	r.max_momentary  = _kernel.max_momentary ();
+	r.max_short_term = _kernel.max_short_term ();
+	r.true_peak      = _tp_max > 0 ? accurate_coefficient_to_dB (_tp_max) : -200.f;
+
+	g_atomic_int_inc (&_seq);
+	_readout = r;
+	g_atomic_int_inc (&_seq);
+
+	_n_published = _kernel.n_fragments ();
+}
+
+bool
+LoudnessMeter::read (Readout& r) const
+{
+	for (int retry = 0; retry < 8; ++retry) {
+		const gint s = g_atomic_int_get (&_seq);
+		if (s & 1) {
+			continue;
+		}
+		r = _readout;
+		if (g_atomic_int_get (&_seq) == s) {
+			return true;
+		}
+	}
+	r = Readout ();
+	return false;
+}
+
+XMLNode&
+LoudnessMeter::state ()
+{
+	XMLNode& node (Processor::state ());
+	node.set_property ("type", "loudness");
+	return node;
+}
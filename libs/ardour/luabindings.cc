@@ -48,6 +48,7 @@
 #include "ardour/file_source.h"
 #include "ardour/fluid_synth.h"
 #include "ardour/interthread_info.h"
+#include "ardour/loudness_meter.h"
 #include "ardour/lua_api.h"
 #include "ardour/luabindings.h"
 #include "ardour/luaproc.h"
@@ -79,6 +80,7 @@
 #include "ardour/solo_isolate_control.h"
 #include "ardour/solo_safe_control.h"
 #include "ardour/stripable.h"
+#include "ardour/trace_recorder.h"
 #include "ardour/track.h"
 #include "ardour/tempo.h"
 #include "ardour/vca.h"
@@ -1087,6 +1089,8 @@ LuaBindings::common (lua_State* L)
 		.addFunction ("amp", &Route::amp)
 		.addFunction ("trim", &Route::trim)
 		.addFunction ("peak_meter", (boost::shared_ptr<PeakMeter> (Route::*)())&Route::peak_meter)
+		.addFunction ("loudness_meter", &Route::loudness_meter)
+		.addFunction ("set_loudness_metering", &Route::set_loudness_metering)
 		.addFunction ("set_meter_point", &Route::set_meter_point)
 		.addFunction ("signal_latency", &Route::signal_latency)
 		.addFunction ("playback_latency", &Route::playback_latency)
@@ -1348,6 +1352,7 @@ LuaBindings::common (lua_State* L)
 		.addCast<MonitorProcessor> ("to_monitorprocessor")
 		.addCast<Send> ("to_send")
 		.addCast<PolarityProcessor> ("to_polarityprocessor")
+		.addCast<LoudnessMeter> ("to_loudnessmeter")
 		.addCast<DelayLine> ("to_delayline")
 #if 0 // those objects are not yet bound
 		.addCast<CapturingProcessor> ("to_capturingprocessor")
@@ -1365,6 +1370,8 @@ LuaBindings::common (lua_State* L)
 		.addFunction ("output_streams", &Processor::output_streams)
 		.addFunction ("input_streams", &Processor::input_streams)
 		.addFunction ("signal_latency", &Processor::signal_latency)
+		.addRefFunction ("get_cycle_stats", &Processor::get_cycle_stats)
+		.addFunction ("reset_cycle_stats", &Processor::reset_cycle_stats)
 		.endClass ()
 
 		.deriveWSPtrClass <DiskIOProcessor, Processor> ("DiskIOProcessor")
@@ -1458,6 +1465,11 @@ LuaBindings::common (lua_State* L)
 		.addFunction ("type", &PluginInsert::type)
 		.addFunction ("signal_latency", &PluginInsert::signal_latency)
 		.addFunction ("get_count", &PluginInsert::get_count)
+		.addFunction ("sleep_when_silent", &PluginInsert::sleep_when_silent)
+		.addFunction ("set_sleep_when_silent", &PluginInsert::set_sleep_when_silent)
+		.addFunction ("sleeping", &PluginInsert::sleeping)
+		.addRefFunction ("get_sleep_stats", &PluginInsert::get_sleep_stats)
+		.addFunction ("reset_sleep_stats", &PluginInsert::reset_sleep_stats)
 		.endClass ()
 
 		.deriveWSPtrClass <ReadOnlyControl, PBD::StatefulDestructible> ("ReadOnlyControl")
@@ -1563,8 +1575,21 @@ LuaBindings::common (lua_State* L)
 		.deriveWSPtrClass <PolarityProcessor, Processor> ("PolarityProcessor")
 		.endClass ()
 
+		.deriveWSPtrClass <LoudnessMeter, Processor> ("LoudnessMeter")
+		.addFunction ("momentary", &LoudnessMeter::momentary)
+		.addFunction ("short_term", &LoudnessMeter::short_term)
+		.addFunction ("integrated", &LoudnessMeter::integrated)
+		.addFunction ("range", &LoudnessMeter::range)
+		.addFunction ("max_momentary", &LoudnessMeter::max_momentary)
+		.addFunction ("max_short_term", &LoudnessMeter::max_short_term)
+		.addFunction ("true_peak", &LoudnessMeter::true_peak)
+		.addFunction ("reset", &LoudnessMeter::reset)
+		.endClass ()
+
 		.deriveWSPtrClass <DelayLine, Processor> ("DelayLine")
 		.addFunction ("delay", &DelayLine::delay)
+		.addFunction ("memory_used", &DelayLine::memory_used)
+		.addStaticFunction ("allocated_bytes", &DelayLine::allocated_bytes)
 		.endClass ()
 
 		.deriveWSPtrClass <PluginInsert::PluginControl, AutomationControl> ("PluginControl")
@@ -1834,6 +1859,7 @@ LuaBindings::common (lua_State* L)
 		.addConst ("MeterK12", ARDOUR::MeterType(MeterK12))
 		.addConst ("MeterPeak0dB", ARDOUR::MeterType(MeterPeak0dB))
 		.addConst ("MeterMCP", ARDOUR::MeterType(MeterMCP))
+		.addConst ("MeterTruePeak", ARDOUR::MeterType(MeterTruePeak))
 		.endNamespace ()
 
 		.beginNamespace ("MeterPoint")
@@ -2276,6 +2302,13 @@ LuaBindings::common (lua_State* L)
 		.addStaticFunction ("clone_region", static_cast<boost::shared_ptr<Region> (*)(boost::shared_ptr<Region>, bool, bool)>(&RegionFactory::create))
 		.endClass ()
 
+		.beginClass <TraceRecorder> ("TraceRecorder")
+		.addStaticFunction ("start", &TraceRecorder::start)
+		.addStaticFunction ("stop", &TraceRecorder::stop)
+		.addStaticFunction ("active", &TraceRecorder::active)
+		.addStaticFunction ("dump", &TraceRecorder::dump)
+		.endClass ()
+
 		/* session enums (rt-safe, common) */
 		.beginNamespace ("Session")
 
@@ -18,6 +18,8 @@
 */
 
 #include <cctype>
+#include <map>
+#include <set>
 #include <string>
 #include <vector>
 #include <limits>
@@ -53,7 +55,9 @@
 #include "ardour/audioengine.h"
 #include "ardour/debug.h"
 #include "ardour/lv2_plugin.h"
+#include "ardour/filesystem_paths.h"
 #include "ardour/midi_patch_manager.h"
+#include "ardour/plugin_index.h"
 #include "ardour/session.h"
 #include "ardour/tempo.h"
 #include "ardour/types.h"
@@ -202,6 +206,7 @@ public:
 
 private:
 	bool _bundle_checked;
+	Glib::Threads::Mutex _bundle_lock;
 };
 
 static LV2World _world;
@@ -2356,6 +2361,20 @@ LV2Plugin::max_latency () const
 	return _max_latency;
 }
 
+bool
+LV2Plugin::uses_transport_position () const
+{
+	if (_bpm_control_port) {
+		return true;
+	}
+	for (std::vector<PortFlags>::const_iterator i = _port_flags.begin (); i != _port_flags.end (); ++i) {
+		if ((*i & PORT_POSITION) && (*i & PORT_INPUT)) {
+			return true;
+		}
+	}
+	return false;
+}
+
 samplecnt_t
 LV2Plugin::signal_latency() const
 {
@@ -3315,6 +3334,7 @@ LV2World::~LV2World()
 void
 LV2World::load_bundled_plugins(bool verbose)
 {
+	Glib::Threads::Mutex::Lock lm (_bundle_lock);
 	if (!_bundle_checked) {
 		if (verbose) {
 			cout << "Scanning folders for bundled LV2s: " << ARDOUR::lv2_bundled_search_path().to_string() << endl;
@@ -3353,6 +3373,10 @@ LV2PluginInfo::~LV2PluginInfo()
 PluginPtr
 LV2PluginInfo::load(Session& session)
 {
+	/* the world is only populated when it is needed, plugins may
+	 * have been discovered using the index, see discover () */
+	_world.load_bundled_plugins(true);
+
 	try {
 		PluginPtr plugin;
 		const LilvPlugins* plugins = lilv_world_get_all_plugins(_world.world);
@@ -3376,6 +3400,8 @@ LV2PluginInfo::get_presets (bool /*user_only*/) const
 {
 	std::vector<Plugin::PresetRecord> p;
 #ifndef NO_PLUGIN_STATE
+	_world.load_bundled_plugins(true);
+
 	const LilvPlugin* lp = NULL;
 	try {
 		PluginPtr plugin;
@@ -3413,12 +3439,97 @@ LV2PluginInfo::get_presets (bool /*user_only*/) const
 	return p;
 }
 
+/* all bundles that lilv will load: the bundled ones, those along LV2_PATH
+ * (or lilv's default path), and those in folders where bundles were found
+ * during the last scan (lilv may have been built with a different default path).
+ */
+static vector<string>
+lv2_bundles (PluginIndex const& index)
+{
+	Searchpath sp;
+	std::string lv2_path = Glib::getenv ("LV2_PATH");
+	if (!lv2_path.empty ()) {
+		sp += Searchpath (lv2_path);
+	} else {
+#if defined PLATFORM_WINDOWS
+		sp += Glib::build_filename (PBD::get_win_special_folder_path (CSIDL_APPDATA), "LV2");
+		sp += Glib::build_filename (PBD::get_win_special_folder_path (CSIDL_PROGRAM_FILES_COMMON), "LV2");
+#elif defined __APPLE__
+		sp += "~/Library/Audio/Plug-Ins/LV2";
+		sp += "~/.lv2";
+		sp += "/usr/local/lib/lv2";
+		sp += "/usr/lib/lv2";
+		sp += "/Library/Audio/Plug-Ins/LV2";
+#else
+		sp += "~/.lv2";
+		sp += "/usr/local/lib/lv2";
+		sp += "/usr/lib/lv2";
+#endif
+	}
+
+	vector<string> const modules = index.modules ();
+	for (vector<string>::const_iterator i = modules.begin (); i != modules.end (); ++i) {
+		sp += Glib::path_get_dirname (*i);
+	}
+
+	vector<string> found;
+	find_paths_matching_filter (found, ARDOUR::lv2_bundled_search_path(), lv2_filter, 0, true, true, true);
+	find_paths_matching_filter (found, sp, lv2_filter, 0, true, true, false);
+
+	std::set<string> unique (found.begin (), found.end ());
+	return vector<string> (unique.begin (), unique.end ());
+}
+
+/* bundle path of a plugin, in the same form as returned by lv2_bundles () */
+static string
+lv2_bundle_path (const LilvPlugin* p)
+{
+	string path;
+	try {
+		path = Glib::filename_from_uri (lilv_node_as_uri (lilv_plugin_get_bundle_uri (p)));
+	} catch (Glib::ConvertError const&) {
+		return "";
+	}
+	while (path.size () > 1 && path[path.size () - 1] == G_DIR_SEPARATOR) {
+		path.erase (path.size () - 1);
+	}
+	return Glib::build_filename (Glib::path_get_dirname (path), Glib::path_get_basename (path));
+}
+
 PluginInfoList*
 LV2PluginInfo::discover()
 {
+	PluginIndex index (Glib::build_filename (user_cache_directory (), X_("lv2_index")));
+	index.load ();
+
+	gint64 start = g_get_monotonic_time ();
+	vector<string> const bundles = lv2_bundles (index);
+
+	if (index.up_to_date (bundles)) {
+		/* nothing was added, removed or modified since the last scan,
+		 * lilv does not need to parse anything until a plugin is instantiated.
+		 */
+		PluginInfoList* plugs = new PluginInfoList;
+		for (vector<string>::const_iterator b = bundles.begin (); b != bundles.end (); ++b) {
+			PluginIndex::Entries entries;
+			index.lookup (*b, entries);
+			for (PluginIndex::Entries::const_iterator e = entries.begin (); e != entries.end (); ++e) {
+				LV2PluginInfoPtr info (new LV2PluginInfo (e->unique_id.c_str ()));
+				e->apply (*info);
+				info->type = LV2;
+				info->path = "/NOPATH"; // Meaningless for LV2
+				plugs->push_back (info);
+			}
+		}
+		PBD::info << string_compose (_("LV2: %1 plugins in %2 bundles read from index in %3 ms"),
+		                             plugs->size (), bundles.size (), (g_get_monotonic_time () - start) / 1000) << endmsg;
+		return plugs;
+	}
+
 	LV2World world;
 	world.load_bundled_plugins();
-	_world.load_bundled_plugins(true);
+
+	std::map<string, PluginIndex::Entries> bundle_entries;
 
 	PluginInfoList*    plugs   = new PluginInfoList;
 	const LilvPlugins* plugins = lilv_world_get_all_plugins(world.world);
@@ -3525,7 +3636,22 @@ LV2PluginInfo::discover()
 		info->index     = 0; // Meaningless for LV2
 
 		plugs->push_back(info);
+		bundle_entries[lv2_bundle_path (p)].push_back (PluginIndex::Entry (*info));
+	}
+
+	index.clear ();
+	for (vector<string>::const_iterator b = bundles.begin (); b != bundles.end (); ++b) {
+		index.set (*b, PluginIndex::Entries ());
 	}
+	for (std::map<string, PluginIndex::Entries>::const_iterator b = bundle_entries.begin (); b != bundle_entries.end (); ++b) {
+		if (!b->first.empty ()) {
+			index.set (b->first, b->second);
+		}
+	}
+	index.save ();
+
+	PBD::info << string_compose (_("LV2: %1 plugins in %2 bundles scanned in %3 ms"),
+	                             plugs->size (), bundles.size (), (g_get_monotonic_time () - start) / 1000) << endmsg;
 
 	return plugs;
 }
@@ -38,10 +38,7 @@ using namespace ARDOUR;
 PeakMeter::PeakMeter (Session& s, const std::string& name)
     : Processor (s, string_compose ("meter-%1", name))
 {
-	Kmeterdsp::init(s.nominal_sample_rate());
-	Iec1ppmdsp::init(s.nominal_sample_rate());
-	Iec2ppmdsp::init(s.nominal_sample_rate());
-	Vumeterdsp::init(s.nominal_sample_rate());
+	MeterKernel::init(s.nominal_sample_rate());
 	_pending_active = true;
 	_meter_type = MeterPeak;
 	_reset_dpm = true;
@@ -52,16 +49,6 @@ PeakMeter::PeakMeter (Session& s, const std::string& name)
 
 PeakMeter::~PeakMeter ()
 {
-	while (_kmeter.size() > 0) {
-		delete (_kmeter.back());
-		delete (_iec1meter.back());
-		delete (_iec2meter.back());
-		delete (_vumeter.back());
-		_kmeter.pop_back();
-		_iec1meter.pop_back();
-		_iec2meter.pop_back();
-		_vumeter.pop_back();
-	}
 	while (_peak_power.size() > 0) {
 		_peak_buffer.pop_back();
 		_peak_power.pop_back();
@@ -134,12 +121,41 @@ PeakMeter::run (BufferSet& bufs, samplepos_t /*start_sample*/, samplepos_t /*end
 		_max_peak_signal[n] = 0;
 	}
 
+	/* K-, IEC- and VU-meters are computed for all channels in a single
+	 * pass, which also yields the peak */
+	const uint32_t ballistics = _meter_type & (MeterKernel::k_types | MeterKernel::iec1_types | MeterKernel::iec2_types | MeterKernel::vu_types);
+	const uint32_t n_kernel = ballistics ? min (n_audio, _kernel.n_channels ()) : 0;
+
+	if (n_kernel > 0) {
+		for (uint32_t i = 0; i < n_kernel; ++i) {
+			/* use const access, to retain the buffer's silent flag */
+			AudioBuffer const& ab (bufs.get_audio (i));
+			_kernel_data[i] = ab.data();
+		}
+		_kernel.process (&_kernel_data[0], n_kernel, nframes, ballistics, &_kernel_peak[0]);
+	}
+
+	/* true-peak replaces the sample-peak of audio channels */
+	const uint32_t n_true_peak = (_meter_type & MeterTruePeak) ? min (n_audio, _true_peak.n_channels ()) : 0;
+
 	// Meter audio in to the rest of the peaks
 	for (uint32_t i = 0; i < n_audio; ++i, ++n) {
-		if (bufs.get_audio(i).silent()) {
+		/* use const access, to retain the buffer's silent flag */
+		AudioBuffer const& ab (bufs.get_audio (i));
+		if (ab.silent()) {
+			if (i < n_true_peak) {
+				/* flush the filter history */
+				_true_peak.process (i, ab.data(), min<pframes_t> (nframes, AudioGrapher::TruePeakKernel::taps));
+			}
 			_peak_buffer[n] = 0;
 		} else {
-			_peak_buffer[n] = compute_peak (bufs.get_audio(i).data(), nframes, _peak_buffer[n]);
+			if (i < n_true_peak) {
+				_peak_buffer[n] = std::max (_peak_buffer[n], _true_peak.process (i, ab.data(), nframes));
+			} else if (i < n_kernel) {
+				_peak_buffer[n] = std::max (_peak_buffer[n], _kernel_peak[i]);
+			} else {
+				_peak_buffer[n] = compute_peak (ab.data(), nframes, _peak_buffer[n]);
+			}
 			_peak_buffer[n] = std::min (_peak_buffer[n], 100.f); // cut off at +40dBFS for falloff.
 			_max_peak_signal[n] = std::max(_peak_buffer[n], _max_peak_signal[n]); // todo sync reset
 			_combined_peak = std::max(_peak_buffer[n], _combined_peak);
@@ -165,19 +181,6 @@ PeakMeter::run (BufferSet& bufs, samplepos_t /*start_sample*/, samplepos_t /*end
 				_peak_buffer[n] = 0;
 			}
 		}
-
-		if (_meter_type & (MeterKrms | MeterK20 | MeterK14 | MeterK12)) {
-			_kmeter[i]->process(bufs.get_audio(i).data(), nframes);
-		}
-		if (_meter_type & (MeterIEC1DIN | MeterIEC1NOR)) {
-			_iec1meter[i]->process(bufs.get_audio(i).data(), nframes);
-		}
-		if (_meter_type & (MeterIEC2BBC | MeterIEC2EBU)) {
-			_iec2meter[i]->process(bufs.get_audio(i).data(), nframes);
-		}
-		if (_meter_type & MeterVU) {
-			_vumeter[i]->process(bufs.get_audio(i).data(), nframes);
-		}
 	}
 
 	// Zero any excess peaks
@@ -206,12 +209,8 @@ PeakMeter::reset ()
 	}
 
 	// these are handled async just fine.
-	for (size_t n = 0; n < _kmeter.size(); ++n) {
-		_kmeter[n]->reset();
-		_iec1meter[n]->reset();
-		_iec2meter[n]->reset();
-		_vumeter[n]->reset();
-	}
+	_kernel.reset ();
+	_true_peak.reset ();
 }
 
 void
@@ -294,26 +293,14 @@ PeakMeter::set_max_channels (const ChanCount& chn)
 	assert(_max_peak_signal.size() == limit);
 
 	/* alloc/free other audio-only meter types. */
-	while (_kmeter.size() > n_audio) {
-		delete (_kmeter.back());
-		delete (_iec1meter.back());
-		delete (_iec2meter.back());
-		delete (_vumeter.back());
-		_kmeter.pop_back();
-		_iec1meter.pop_back();
-		_iec2meter.pop_back();
-		_vumeter.pop_back();
+	if (_kernel.n_channels () != n_audio) {
+		_kernel.set_channels (n_audio);
 	}
-	while (_kmeter.size() < n_audio) {
-		_kmeter.push_back(new Kmeterdsp());
-		_iec1meter.push_back(new Iec1ppmdsp());
-		_iec2meter.push_back(new Iec2ppmdsp());
-		_vumeter.push_back(new Vumeterdsp());
+	_kernel_data.resize (n_audio, 0);
+	_kernel_peak.resize (n_audio, 0);
+	if (_true_peak.n_channels () != n_audio) {
+		_true_peak.set_channels (n_audio);
 	}
-	assert(_kmeter.size() == n_audio);
-	assert(_iec1meter.size() == n_audio);
-	assert(_iec2meter.size() == n_audio);
-	assert(_vumeter.size() == n_audio);
 
 	reset();
 	reset_max();
@@ -324,7 +311,7 @@ PeakMeter::set_max_channels (const ChanCount& chn)
  * of meter size during this call.
  */
 
-#define CHECKSIZE(MTR) (n < MTR.size() + n_midi && n >= n_midi)
+#define CHECKSIZE (n < _kernel.n_channels() + n_midi && n >= n_midi)
 
 float
 PeakMeter::meter_level(uint32_t n, MeterType type) {
@@ -336,8 +323,8 @@ PeakMeter::meter_level(uint32_t n, MeterType type) {
 		case MeterK12:
 			{
 				const uint32_t n_midi = current_meters.n_midi();
-				if (CHECKSIZE(_kmeter)) {
-					return accurate_coefficient_to_dB (_kmeter[n - n_midi]->read());
+				if (CHECKSIZE) {
+					return accurate_coefficient_to_dB (_kernel.read_k (n - n_midi));
 				}
 			}
 			break;
@@ -345,8 +332,8 @@ PeakMeter::meter_level(uint32_t n, MeterType type) {
 		case MeterIEC1NOR:
 			{
 				const uint32_t n_midi = current_meters.n_midi();
-				if (CHECKSIZE(_iec1meter)) {
-					return accurate_coefficient_to_dB (_iec1meter[n - n_midi]->read());
+				if (CHECKSIZE) {
+					return accurate_coefficient_to_dB (_kernel.read_iec1 (n - n_midi));
 				}
 			}
 			break;
@@ -354,21 +341,22 @@ PeakMeter::meter_level(uint32_t n, MeterType type) {
 		case MeterIEC2EBU:
 			{
 				const uint32_t n_midi = current_meters.n_midi();
-				if (CHECKSIZE(_iec2meter)) {
-					return accurate_coefficient_to_dB (_iec2meter[n - n_midi]->read());
+				if (CHECKSIZE) {
+					return accurate_coefficient_to_dB (_kernel.read_iec2 (n - n_midi));
 				}
 			}
 			break;
 		case MeterVU:
 			{
 				const uint32_t n_midi = current_meters.n_midi();
-				if (CHECKSIZE(_vumeter)) {
-					return accurate_coefficient_to_dB (_vumeter[n - n_midi]->read());
+				if (CHECKSIZE) {
+					return accurate_coefficient_to_dB (_kernel.read_vu (n - n_midi));
 				}
 			}
 			break;
 		case MeterPeak:
 		case MeterPeak0dB:
+		case MeterTruePeak:
 			if (n < _peak_power.size()) {
 				return _peak_power[n];
 			}
@@ -398,29 +386,9 @@ PeakMeter::set_type(MeterType t)
 
 	_meter_type = t;
 
-	if (t & (MeterKrms | MeterK20 | MeterK14 | MeterK12)) {
-		const size_t n_audio = current_meters.n_audio();
-		for (size_t n = 0; n < n_audio; ++n) {
-			_kmeter[n]->reset();
-		}
-	}
-	if (t & (MeterIEC1DIN | MeterIEC1NOR)) {
-		const size_t n_audio = current_meters.n_audio();
-		for (size_t n = 0; n < n_audio; ++n) {
-			_iec1meter[n]->reset();
-		}
-	}
-	if (t & (MeterIEC2BBC | MeterIEC2EBU)) {
-		const size_t n_audio = current_meters.n_audio();
-		for (size_t n = 0; n < n_audio; ++n) {
-			_iec2meter[n]->reset();
-		}
-	}
-	if (t & MeterVU) {
-		const size_t n_audio = current_meters.n_audio();
-		for (size_t n = 0; n < n_audio; ++n) {
-			_vumeter[n]->reset();
-		}
+	_kernel.reset (t);
+	if (t & MeterTruePeak) {
+		_true_peak.reset ();
 	}
 
 	TypeChanged(t);
@@ -0,0 +1,379 @@
+/*
+ * Copyright (C) 2026 The Ardour Developers
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include <math.h>
+
+#include "ardour/meter_kernel.h"
+
+using namespace ARDOUR;
+
+float MeterKernel::_k_omega = 0;
+float MeterKernel::_i1_w1 = 0;
+float MeterKernel::_i1_w2 = 0;
+float MeterKernel::_i1_w3 = 0;
+float MeterKernel::_i1_g = 0;
+float MeterKernel::_i2_w1 = 0;
+float MeterKernel::_i2_w2 = 0;
+float MeterKernel::_i2_w3 = 0;
+float MeterKernel::_i2_g = 0;
+float MeterKernel::_vu_w = 0;
+float MeterKernel::_vu_g = 0;
+
+/* indexed by K | IEC1 << 1 | IEC2 << 2 | VU << 3 */
+const MeterKernel::GroupFn MeterKernel::_group_fn[16] = {
+	&MeterKernel::process_group<false, false, false, false>,
+	&MeterKernel::process_group<true,  false, false, false>,
+	&MeterKernel::process_group<false, true,  false, false>,
+	&MeterKernel::process_group<true,  true,  false, false>,
+	&MeterKernel::process_group<false, false, true,  false>,
+	&MeterKernel::process_group<true,  false, true,  false>,
+	&MeterKernel::process_group<false, true,  true,  false>,
+	&MeterKernel::process_group<true,  true,  true,  false>,
+	&MeterKernel::process_group<false, false, false, true>,
+	&MeterKernel::process_group<true,  false, false, true>,
+	&MeterKernel::process_group<false, true,  false, true>,
+	&MeterKernel::process_group<true,  true,  false, true>,
+	&MeterKernel::process_group<false, false, true,  true>,
+	&MeterKernel::process_group<true,  false, true,  true>,
+	&MeterKernel::process_group<false, true,  true,  true>,
+	&MeterKernel::process_group<true,  true,  true,  true>,
+};
+
+MeterKernel::MeterKernel ()
+	: _n_channels (0)
+{
+}
+
+void
+MeterKernel::init (float fsamp)
+{
+	/* same as Kmeterdsp::init () */
+	_k_omega = 9.72f / fsamp;
+
+	/* same as Iec1ppmdsp::init () */
+	_i1_w1 =  450.0f / fsamp;
+	_i1_w2 = 1300.0f / fsamp;
+	_i1_w3 = 1.0f - 5.4f / fsamp;
+	_i1_g  = 0.5108f;
+
+	/* same as Iec2ppmdsp::init () */
+	_i2_w1 = 200.0f / fsamp;
+	_i2_w2 = 860.0f / fsamp;
+	_i2_w3 = 1.0f - 4.0f / fsamp;
+	_i2_g  = 0.5141f;
+
+	/* same as Vumeterdsp::init () */
+	_vu_w = 11.1f / fsamp;
+	_vu_g = 1.5f * 1.571f;
+}
+
+void
+MeterKernel::set_channels (uint32_t n)
+{
+	/* round up to a complete group of 4 channels */
+	const uint32_t n4 = (n + 3) & ~3;
+
+	_k_z1.assign (n4, 0);
+	_k_z2.assign (n4, 0);
+	_k_rms.assign (n4, 0);
+	_k_flag.assign (n4, 0);
+
+	_i1_z1.assign (n4, 0);
+	_i1_z2.assign (n4, 0);
+	_i1_m.assign (n4, 0);
+	_i1_res.assign (n4, 1);
+
+	_i2_z1.assign (n4, 0);
+	_i2_z2.assign (n4, 0);
+	_i2_m.assign (n4, 0);
+	_i2_res.assign (n4, 1);
+
+	_vu_z1.assign (n4, 0);
+	_vu_z2.assign (n4, 0);
+	_vu_m.assign (n4, 0);
+	_vu_res.assign (n4, 1);
+
+	_n_channels = n;
+}
+
+void
+MeterKernel::reset ()
+{
+	reset (k_types | iec1_types | iec2_types | vu_types);
+}
+
+void
+MeterKernel::reset (uint32_t types)
+{
+	for (uint32_t c = 0; c < _k_z1.size (); ++c) {
+		if (types & k_types) {
+			_k_z1[c] = _k_z2[c] = _k_rms[c] = 0;
+			_k_flag[c] = 0;
+		}
+		if (types & iec1_types) {
+			_i1_z1[c] = _i1_z2[c] = _i1_m[c] = 0;
+			_i1_res[c] = 1;
+		}
+		if (types & iec2_types) {
+			_i2_z1[c] = _i2_z2[c] = _i2_m[c] = 0;
+			_i2_res[c] = 1;
+		}
+		if (types & vu_types) {
+			_vu_z1[c] = _vu_z2[c] = _vu_m[c] = 0;
+			_vu_res[c] = 1;
+		}
+	}
+}
+
+static inline float
+clamp (float v, float lo, float hi)
+{
+	return v > hi ? hi : (v < lo ? lo : v);
+}
+
+void
+MeterKernel::process (float const* const* data, uint32_t n_chn, pframes_t n_samples, uint32_t types, float* peak)
+{
+	if (n_chn > _n_channels) {
+		n_chn = _n_channels;
+	}
+
+	const int fn =
+		  ((types & k_types)    ? 1 : 0)
+		| ((types & iec1_types) ? 2 : 0)
+		| ((types & iec2_types) ? 4 : 0)
+		| ((types & vu_types)   ? 8 : 0);
+
+	const GroupFn group_fn = _group_fn[fn];
+
+	for (uint32_t c0 = 0; c0 < n_chn; c0 += 4) {
+		const uint32_t n_valid = n_chn - c0 < 4 ? n_chn - c0 : 4;
+		float const* p[4];
+		for (uint32_t c = 0; c < 4; ++c) {
+			/* excess channels of the last group re-use the first
+			 * channel's data, the result is discarded */
+			p[c] = data[c0 + (c < n_valid ? c : 0)];
+		}
+		(this->*group_fn) (p, c0, n_valid, n_samples, &peak[c0]);
+	}
+}
+
+template <bool K, bool IEC1, bool IEC2, bool VU>
+void
+MeterKernel::process_group (float const* const* p, uint32_t c0, uint32_t n_valid, pframes_t n_samples, float* peak)
+{
+	float pk[4];
+	float kz1[4], kz2[4];
+	float az1[4], az2[4], am[4];
+	float bz1[4], bz2[4], bm[4];
+	float vz1[4], vz2[4], vm[4], vt[4];
+
+	/* load state, see Kmeterdsp::process () etc. */
+	for (uint32_t c = 0; c < 4; ++c) {
+		const uint32_t i = c0 + c;
+		pk[c] = 0;
+		if (K) {
+			kz1[c] = clamp (_k_z1[i], 0, 50);
+			kz2[c] = clamp (_k_z2[i], 0, 50);
+		}
+		if (IEC1) {
+			az1[c] = clamp (_i1_z1[i], 0, 20);
+			az2[c] = clamp (_i1_z2[i], 0, 20);
+			am[c]  = _i1_res[i] ? 0 : _i1_m[i];
+		}
+		if (IEC2) {
+			bz1[c] = clamp (_i2_z1[i], 0, 20);
+			bz2[c] = clamp (_i2_z2[i], 0, 20);
+			bm[c]  = _i2_res[i] ? 0 : _i2_m[i];
+		}
+		if (VU) {
+			vz1[c] = clamp (_vu_z1[i], -20, 20);
+			vz2[c] = clamp (_vu_z2[i], -20, 20);
+			vm[c]  = _vu_res[i] ? 0 : _vu_m[i];
+		}
+	}
+
+	const float k_omega = _k_omega;
+	const float i1_w1 = _i1_w1;
+	const float i1_w2 = _i1_w2;
+	const float i1_w3 = _i1_w3;
+	const float i2_w1 = _i2_w1;
+	const float i2_w2 = _i2_w2;
+	const float i2_w3 = _i2_w3;
+	const float vu_w  = _vu_w;
+
+	/* The ballistics filters are evaluated in blocks of 4 samples,
+	 * the loops over channels are independent and can be vectorized.
+	 * Attack filters use max(t - z, 0) instead of a conditional,
+	 * which yields the same result without branches.
+	 */
+	const pframes_t n4 = n_samples & ~3;
+
+	for (pframes_t i = 0; i < n4; i += 4) {
+		if (IEC1) {
+			for (uint32_t c = 0; c < 4; ++c) {
+				az1[c] *= i1_w3;
+				az2[c] *= i1_w3;
+			}
+		}
+		if (IEC2) {
+			for (uint32_t c = 0; c < 4; ++c) {
+				bz1[c] *= i2_w3;
+				bz2[c] *= i2_w3;
+			}
+		}
+		if (VU) {
+			for (uint32_t c = 0; c < 4; ++c) {
+				vt[c] = vz2[c] / 2;
+			}
+		}
+
+		for (uint32_t s = 0; s < 4; ++s) {
+			for (uint32_t c = 0; c < 4; ++c) {
+				const float x = p[c][i + s];
+				const float a = fabsf (x);
+				pk[c] = a > pk[c] ? a : pk[c];
+				if (K) {
+					kz1[c] += k_omega * (x * x - kz1[c]);
+				}
+				if (IEC1) {
+					const float d1 = a - az1[c];
+					const float d2 = a - az2[c];
+					az1[c] += i1_w1 * (d1 > 0 ? d1 : 0.f);
+					az2[c] += i1_w2 * (d2 > 0 ? d2 : 0.f);
+				}
+				if (IEC2) {
+					const float d1 = a - bz1[c];
+					const float d2 = a - bz2[c];
+					bz1[c] += i2_w1 * (d1 > 0 ? d1 : 0.f);
+					bz2[c] += i2_w2 * (d2 > 0 ? d2 : 0.f);
+				}
+				if (VU) {
+					vz1[c] += vu_w * (a - vt[c] - vz1[c]);
+				}
+			}
+		}
+
+		for (uint32_t c = 0; c < 4; ++c) {
+			if (K) {
+				kz2[c] += 4 * k_omega * (kz1[c] - kz2[c]);
+			}
+			if (IEC1) {
+				const float t = az1[c] + az2[c];
+				am[c] = t > am[c] ? t : am[c];
+			}
+			if (IEC2) {
+				const float t = bz1[c] + bz2[c];
+				bm[c] = t > bm[c] ? t : bm[c];
+			}
+			if (VU) {
+				vz2[c] += 4 * vu_w * (vz1[c] - vz2[c]);
+				vm[c] = vz2[c] > vm[c] ? vz2[c] : vm[c];
+			}
+		}
+	}
+
+	/* remaining samples, peak only */
+	for (pframes_t i = n4; i < n_samples; ++i) {
+		for (uint32_t c = 0; c < 4; ++c) {
+			const float a = fabsf (p[c][i]);
+			pk[c] = a > pk[c] ? a : pk[c];
+		}
+	}
+
+	/* store state, the added constants avoid denormals */
+	for (uint32_t c = 0; c < n_valid; ++c) {
+		const uint32_t i = c0 + c;
+		peak[c] = pk[c];
+		if (K) {
+			if (isnan (kz1[c])) kz1[c] = 0;
+			if (isnan (kz2[c])) kz2[c] = 0;
+			_k_z1[i] = kz1[c] + 1e-20f;
+			_k_z2[i] = kz2[c] + 1e-20f;
+			const float s = sqrtf (2.0f * kz2[c]);
+			if (_k_flag[i]) {
+				/* display thread has read the rms value */
+				_k_rms[i]  = s;
+				_k_flag[i] = 0;
+			} else if (s > _k_rms[i]) {
+				_k_rms[i] = s;
+			}
+		}
+		if (IEC1) {
+			_i1_z1[i]  = az1[c] + 1e-10f;
+			_i1_z2[i]  = az2[c] + 1e-10f;
+			_i1_m[i]   = am[c];
+			_i1_res[i] = 0;
+		}
+		if (IEC2) {
+			_i2_z1[i]  = bz1[c] + 1e-10f;
+			_i2_z2[i]  = bz2[c] + 1e-10f;
+			_i2_m[i]   = bm[c];
+			_i2_res[i] = 0;
+		}
+		if (VU) {
+			if (isnan (vz1[c])) vz1[c] = 0;
+			if (isnan (vz2[c])) vz2[c] = 0;
+			_vu_z1[i]  = vz1[c];
+			_vu_z2[i]  = vz2[c] + 1e-10f;
+			_vu_m[i]   = vm[c];
+			_vu_res[i] = 0;
+		}
+	}
+}
+
+float
+MeterKernel::read_k (uint32_t c)
+{
+	if (c >= _n_channels) {
+		return 0;
+	}
+	const float rv = _k_rms[c];
+	_k_flag[c] = 1; // resets the value in the next process ()
+	return rv;
+}
+
+float
+MeterKernel::read_iec1 (uint32_t c)
+{
+	if (c >= _n_channels) {
+		return 0;
+	}
+	_i1_res[c] = 1;
+	return _i1_g * _i1_m[c];
+}
+
+float
+MeterKernel::read_iec2 (uint32_t c)
+{
+	if (c >= _n_channels) {
+		return 0;
+	}
+	_i2_res[c] = 1;
+	return _i2_g * _i2_m[c];
+}
+
+float
+MeterKernel::read_vu (uint32_t c)
+{
+	if (c >= _n_channels) {
+		return 0;
+	}
+	_vu_res[c] = 1;
+	return _vu_g * _vu_m[c];
+}
@@ -28,6 +28,7 @@
 #include "ardour/midi_buffer.h"
 #include "ardour/midi_port.h"
 #include "ardour/session.h"
+#include "ardour/trace_recorder.h"
 
 using namespace std;
 using namespace ARDOUR;
@@ -70,6 +71,7 @@ MidiPort::cycle_start (pframes_t nframes)
 	}
 
 	if (_always_parse || (receives_input() && _trace_on)) {
+		TraceRecorder::Span span ("MidiPort::parse");
 		MidiBuffer& mb (get_midi_buffer (nframes));
 
 		/* dump incoming MIDI to parser */
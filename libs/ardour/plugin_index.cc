@@ -0,0 +1,247 @@
+/*
+ * Copyright (C) 2026 The Ardour Developers
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include <glib.h>
+#include "pbd/gstdio_compat.h"
+
+#include <glibmm/fileutils.h>
+#include <glibmm/miscutils.h>
+
+#include "pbd/compose.h"
+#include "pbd/error.h"
+#include "pbd/xml++.h"
+
+#include "ardour/plugin.h"
+#include "ardour/plugin_index.h"
+
+#include "pbd/i18n.h"
+
+using namespace std;
+using namespace ARDOUR;
+using namespace PBD;
+
+#define PLUGIN_INDEX_VERSION 1
+
+PluginIndex::Entry::Entry (PluginInfo const& info)
+	: name (info.name)
+	, category (info.category)
+	, creator (info.creator)
+	, unique_id (info.unique_id)
+	, index (info.index)
+	, n_inputs (info.n_inputs)
+	, n_outputs (info.n_outputs)
+{
+}
+
+void
+PluginIndex::Entry::apply (PluginInfo& info) const
+{
+	info.name      = name;
+	info.category  = category;
+	info.creator   = creator;
+	info.unique_id = unique_id;
+	info.index     = index;
+	info.n_inputs  = n_inputs;
+	info.n_outputs = n_outputs;
+}
+
+PluginIndex::PluginIndex (std::string const& path)
+	: _path (path)
+{
+}
+
+void
+PluginIndex::clear ()
+{
+	_modules.clear ();
+}
+
+bool
+PluginIndex::load ()
+{
+	_modules.clear ();
+
+	if (!Glib::file_test (_path, Glib::FILE_TEST_EXISTS)) {
+		return false;
+	}
+
+	XMLTree tree;
+	if (!tree.read (_path)) {
+		warning << string_compose (_("Plugin index %1 is not a valid XML file, plugins will be re-scanned"), _path) << endmsg;
+		return false;
+	}
+
+	XMLNode const* root = tree.root ();
+	int version;
+	if (root->name () != X_("PluginIndex") || !root->get_property (X_("version"), version) || version != PLUGIN_INDEX_VERSION) {
+		return false;
+	}
+
+	XMLNodeList const& modules = root->children ();
+	for (XMLNodeConstIterator m = modules.begin (); m != modules.end (); ++m) {
+		std::string path;
+		Module module;
+		if ((*m)->name () != X_("Module") || !(*m)->get_property (X_("path"), path) || !(*m)->get_property (X_("mtime"), module.mtime)) {
+			continue;
+		}
+
+		XMLNodeList const& plugins = (*m)->children ();
+		for (XMLNodeConstIterator p = plugins.begin (); p != plugins.end (); ++p) {
+			Entry e;
+			uint32_t audio_in, audio_out, midi_in, midi_out;
+			if ((*p)->name () != X_("Plugin")
+			    || !(*p)->get_property (X_("unique-id"), e.unique_id)
+			    || !(*p)->get_property (X_("name"), e.name)
+			    || !(*p)->get_property (X_("index"), e.index)
+			    || !(*p)->get_property (X_("audio-in"), audio_in)
+			    || !(*p)->get_property (X_("audio-out"), audio_out)
+			    || !(*p)->get_property (X_("midi-in"), midi_in)
+			    || !(*p)->get_property (X_("midi-out"), midi_out)) {
+				continue;
+			}
+			(*p)->get_property (X_("category"), e.category);
+			(*p)->get_property (X_("creator"), e.creator);
+			e.n_inputs  = ChanCount (DataType::AUDIO, audio_in);
+			e.n_outputs = ChanCount (DataType::AUDIO, audio_out);
+			e.n_inputs.set_midi (midi_in);
+			e.n_outputs.set_midi (midi_out);
+			module.entries.push_back (e);
+		}
+
+		_modules[path] = module;
+	}
+
+	return true;
+}
+
+bool
+PluginIndex::save () const
+{
+	XMLNode* root = new XMLNode (X_("PluginIndex"));
+	root->set_property (X_("version"), PLUGIN_INDEX_VERSION);
+
+	for (Modules::const_iterator m = _modules.begin (); m != _modules.end (); ++m) {
+		if (!m->second.used) {
+			continue;
+		}
+		XMLNode* module = root->add_child (X_("Module"));
+		module->set_property (X_("path"), m->first);
+		module->set_property (X_("mtime"), m->second.mtime);
+
+		for (Entries::const_iterator e = m->second.entries.begin (); e != m->second.entries.end (); ++e) {
+			XMLNode* plugin = module->add_child (X_("Plugin"));
+			plugin->set_property (X_("unique-id"), e->unique_id);
+			plugin->set_property (X_("name"), e->name);
+			plugin->set_property (X_("category"), e->category);
+			plugin->set_property (X_("creator"), e->creator);
+			plugin->set_property (X_("index"), e->index);
+			plugin->set_property (X_("audio-in"), e->n_inputs.n_audio ());
+			plugin->set_property (X_("audio-out"), e->n_outputs.n_audio ());
+			plugin->set_property (X_("midi-in"), e->n_inputs.n_midi ());
+			plugin->set_property (X_("midi-out"), e->n_outputs.n_midi ());
+		}
+	}
+
+	XMLTree tree;
+	tree.set_root (root);
+	tree.set_compression (0);
+
+	if (!tree.write (_path)) {
+		error << string_compose (_("Could not save plugin index to %1"), _path) << endmsg;
+		::g_unlink (_path.c_str ());
+		return false;
+	}
+	return true;
+}
+
+bool
+PluginIndex::lookup (std::string const& module, Entries& entries)
+{
+	Modules::iterator m = _modules.find (module);
+	if (m == _modules.end () || m->second.mtime != modification_time (module)) {
+		return false;
+	}
+	m->second.used = true;
+	entries = m->second.entries;
+	return true;
+}
+
+void
+PluginIndex::set (std::string const& module, Entries const& entries)
+{
+	Module& m (_modules[module]);
+	m.mtime   = modification_time (module);
+	m.used    = true;
+	m.entries = entries;
+}
+
+bool
+PluginIndex::up_to_date (std::vector<std::string> const& modules) const
+{
+	if (modules.size () != _modules.size ()) {
+		return false;
+	}
+	for (std::vector<std::string>::const_iterator i = modules.begin (); i != modules.end (); ++i) {
+		Modules::const_iterator m = _modules.find (*i);
+		if (m == _modules.end () || m->second.mtime != modification_time (*i)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+std::vector<std::string>
+PluginIndex::modules () const
+{
+	std::vector<std::string> rv;
+	for (Modules::const_iterator m = _modules.begin (); m != _modules.end (); ++m) {
+		rv.push_back (m->first);
+	}
+	return rv;
+}
+
+int64_t
+PluginIndex::modification_time (std::string const& path)
+{
+	GStatBuf sb;
+	if (g_stat (path.c_str (), &sb) != 0) {
+		return -1;
+	}
+
+	int64_t mtime = sb.st_mtime;
+
+	if (!Glib::file_test (path, Glib::FILE_TEST_IS_DIR)) {
+		return mtime;
+	}
+
+	GDir* dir = g_dir_open (path.c_str (), 0, NULL);
+	if (!dir) {
+		return mtime;
+	}
+
+	const gchar* name;
+	while ((name = g_dir_read_name (dir))) {
+		std::string const fn = Glib::build_filename (path, name);
+		if (g_stat (fn.c_str (), &sb) == 0 && sb.st_mtime > mtime) {
+			mtime = sb.st_mtime;
+		}
+	}
+	g_dir_close (dir);
+
+	return mtime;
+}
@@ -34,9 +34,11 @@
 #include "ardour/event_type_map.h"
 #include "ardour/ladspa_plugin.h"
 #include "ardour/luaproc.h"
+#include "ardour/midi_buffer.h"
 #include "ardour/plugin.h"
 #include "ardour/plugin_insert.h"
 #include "ardour/port.h"
+#include "ardour/rc_configuration.h"
 
 #ifdef LV2_SUPPORT
 #include "ardour/lv2_plugin.h"
@@ -59,6 +61,7 @@
 #endif
 
 #include "ardour/session.h"
+#include "ardour/trace_recorder.h"
 #include "ardour/types.h"
 
 #include "pbd/i18n.h"
@@ -74,6 +77,16 @@ PluginInsert::PluginInsert (Session& s, boost::shared_ptr<Plugin> plug)
 	, _sc_playback_latency (0)
 	, _sc_capture_latency (0)
 	, _plugin_signal_latency (0)
+	, _plugin_signal_tail (-1)
+	, _sleep_when_silent (true)
+	, _may_sleep (false)
+	, _sleeping (false)
+	, _silent_samples (0)
+	, _wake (0)
+	, _reset_sleep_stats (0)
+	, _slept_samples (0)
+	, _saved_cycles (0)
+	, _run_cost (0)
 	, _signal_analysis_collected_nframes(0)
 	, _signal_analysis_collect_nframes_max(0)
 	, _configured (false)
@@ -81,9 +94,13 @@ PluginInsert::PluginInsert (Session& s, boost::shared_ptr<Plugin> plug)
 	, _strict_io (false)
 	, _custom_cfg (false)
 	, _maps_from_state (false)
+	, _parallel_safe (false)
+	, _parallel_extra_cycles (0)
 	, _latency_changed (false)
 	, _bypass_port (UINT32_MAX)
 {
+	_trace_label.set (name ());
+
 	/* the first is the master */
 
 	if (plug) {
@@ -94,6 +111,11 @@ PluginInsert::PluginInsert (Session& s, boost::shared_ptr<Plugin> plug)
 			add_sidechain (sc.n_audio (), sc.n_midi ());
 		}
 	}
+
+	/* plugins that follow the transport may start or stop producing
+	 * output when it starts, stops or locates */
+	_session.TransportStateChange.connect_same_thread (*this, boost::bind (&PluginInsert::wake, this));
+	_session.Located.connect_same_thread (*this, boost::bind (&PluginInsert::wake, this));
 }
 
 PluginInsert::~PluginInsert ()
@@ -633,6 +655,8 @@ PluginInsert::activate ()
 		_plugin_signal_latency = signal_latency ();
 		latency_changed ();
 	}
+	_plugin_signal_tail = _plugins.front ()->signal_tail ();
+	update_may_sleep ();
 }
 
 void
@@ -796,12 +820,15 @@ PluginInsert::inplace_silence_unconnected (BufferSet& bufs, const PinMappings& o
 void
 PluginInsert::connect_and_run (BufferSet& bufs, samplepos_t start, samplepos_t end, double speed, pframes_t nframes, samplecnt_t offset, bool with_auto)
 {
+	TraceRecorder::Span span ("PluginInsert::connect_and_run", _trace_label.c_str ());
+
 	// TODO: atomically copy maps & _no_inplace
 	PinMappings in_map (_in_map);
 	PinMappings out_map (_out_map);
 	ChanMapping thru_map (_thru_map);
 	if (_mapping_changed) { // ToDo use a counters, increment until match.
 		_no_inplace = check_inplace ();
+		_parallel_safe = check_parallel ();
 		_mapping_changed = false;
 	}
 
@@ -1014,10 +1041,12 @@ PluginInsert::connect_and_run (BufferSet& bufs, samplepos_t start, samplepos_t e
 		}
 	} else {
 		/* in-place processing */
-		uint32_t pc = 0;
-		for (Plugins::iterator i = _plugins.begin(); i != _plugins.end(); ++i, ++pc) {
-			if ((*i)->connect_and_run(bufs, start, end, speed, in_map[pc], out_map[pc], nframes, offset)) {
-				deactivate ();
+		if (!run_parallel (bufs, start, end, speed, in_map, out_map, nframes, offset)) {
+			uint32_t pc = 0;
+			for (Plugins::iterator i = _plugins.begin(); i != _plugins.end(); ++i, ++pc) {
+				if ((*i)->connect_and_run(bufs, start, end, speed, in_map[pc], out_map[pc], nframes, offset)) {
+					deactivate ();
+				}
 			}
 		}
 		// now silence unconnected outputs
@@ -1206,6 +1235,35 @@ PluginInsert::run (BufferSet& bufs, samplepos_t start_sample, samplepos_t end_sa
 	if (_pending_active) {
 		/* run as normal if we are active or moving from inactive to active */
 
+		if (g_atomic_int_compare_and_exchange (&_reset_sleep_stats, 1, 0)) {
+			_slept_samples = 0;
+			_saved_cycles = 0;
+		}
+
+		const bool silent_in = _active && _sleep_when_silent && _may_sleep && Config->get_skip_silent_processing () && silent_input (bufs);
+
+		if (g_atomic_int_compare_and_exchange (&_wake, 1, 0)) {
+			/* a parameter or the transport state changed, the plugin may produce output */
+			_silent_samples = 0;
+		}
+
+		if (silent_in && _silent_samples >= silent_tail_length ()) {
+			/* the input is silent and the plugin's output has decayed,
+			 * there is no need to run the plugin.
+			 */
+			automation_run (start_sample, nframes); // evaluate automation only
+			silence_output (bufs, nframes);
+			_sleeping = true;
+			_slept_samples += nframes;
+			_saved_cycles += _run_cost * nframes;
+			return;
+		}
+
+		_sleeping = false;
+
+		_parallel_extra_cycles = 0;
+		const cycles_t run_start = get_cycles ();
+
 		if (_session.transport_rolling() || _session.bounce_processing()) {
 			automate_and_run (bufs, start_sample, end_sample, speed, nframes);
 		} else {
@@ -1213,12 +1271,27 @@ PluginInsert::run (BufferSet& bufs, samplepos_t start_sample, samplepos_t end_sa
 			connect_and_run (bufs, start_sample, end_sample, speed, nframes, 0, lm.locked());
 		}
 
+		/* include CPU time of instances that ran concurrently,
+		 * skip readings of a cycle-counter that went backwards */
+		const uint64_t run_cycles = CycleStats::elapsed (run_start, get_cycles ());
+		if (run_cycles > 0) {
+			update_run_cost (run_cycles + _parallel_extra_cycles, nframes);
+		}
+
+		if (silent_in && silent_output (bufs)) {
+			_silent_samples += nframes;
+		} else {
+			_silent_samples = 0;
+		}
+
 	} else {
 		// XXX should call ::silence() to run plugin(s) for consistent load.
 		// We'll need to change this anyway when bypass can be automated
 		bypass (bufs, nframes);
 		automation_run (start_sample, nframes); // evaluate automation only
 		_delaybuffers.flush ();
+		_silent_samples = 0;
+		_sleeping = false;
 	}
 
 	_active = _pending_active;
@@ -1228,6 +1301,245 @@ PluginInsert::run (BufferSet& bufs, samplepos_t start_sample, samplepos_t end_sa
 	 */
 }
 
+/** @return true if all audio inputs are flagged as silent and
+ * there are no MIDI events. Plugins without inputs (instruments
+ * without MIDI input, generators) and plugins with a sidechain are
+ * never considered to have silent input.
+ */
+bool
+PluginInsert::silent_input (BufferSet& bufs) const
+{
+	if (_sidechain) {
+		return false;
+	}
+
+	const ChanCount in (input_streams ());
+	if (in.n_total () == 0) {
+		return false;
+	}
+
+	for (uint32_t i = 0; i < in.n_audio (); ++i) {
+		if (!bufs.get_audio (i).silent ()) {
+			return false;
+		}
+	}
+	for (uint32_t i = 0; i < in.n_midi (); ++i) {
+		if (!bufs.get_midi (i).empty ()) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/** scan the plugin's output for silence, and flag
+ * silent audio buffers.
+ */
+bool
+PluginInsert::silent_output (BufferSet& bufs) const
+{
+	const ChanCount out (output_streams ());
+	bool silent = true;
+
+	for (uint32_t i = 0; i < out.n_audio (); ++i) {
+		if (!bufs.get_audio (i).detect_silence ()) {
+			silent = false;
+		}
+	}
+	for (uint32_t i = 0; i < out.n_midi (); ++i) {
+		if (!bufs.get_midi (i).empty ()) {
+			silent = false;
+		}
+	}
+	return silent;
+}
+
+void
+PluginInsert::silence_output (BufferSet& bufs, pframes_t nframes)
+{
+	const ChanCount out (output_streams ());
+
+	for (uint32_t i = 0; i < out.n_audio (); ++i) {
+		bufs.get_audio (i).silence (nframes);
+	}
+	for (uint32_t i = 0; i < out.n_midi (); ++i) {
+		bufs.get_midi (i).silence (nframes);
+	}
+}
+
+/** @return the number of samples of silent output (with silent input)
+ * after which the plugin is no longer run.
+ */
+samplecnt_t
+PluginInsert::silent_tail_length () const
+{
+	if (_plugin_signal_tail >= 0) {
+		/* require at least one cycle of silent output */
+		return _plugin_signal_latency + std::max<samplecnt_t> (_plugin_signal_tail, (samplecnt_t) _session.get_block_size ());
+	}
+	/* the plugin does not report the length of its tail (reverb, delay),
+	 * wait 2 seconds in addition to the plugin's latency. */
+	return _plugin_signal_latency + 2 * _session.nominal_sample_rate ();
+}
+
+/* Plugins that are given the transport position (sequencers, arpeggiators,
+ * synced gates) and instruments that do not report a tail may produce
+ * output for silent input, they are never put to sleep.
+ */
+void
+PluginInsert::update_may_sleep ()
+{
+	_may_sleep = !_plugins.front ()->uses_transport_position ()
+		&& !(_plugin_signal_tail < 0 && natural_input_streams ().n_midi () > 0);
+}
+
+void
+PluginInsert::update_run_cost (uint64_t cycles, pframes_t nframes)
+{
+	if (nframes == 0) {
+		return;
+	}
+	const double cost = cycles / (double) nframes;
+	if (_run_cost == 0) {
+		_run_cost = cost;
+	} else {
+		/* low-pass, ignore occasional spikes */
+		_run_cost += .05 * (cost - _run_cost);
+	}
+}
+
+/* @return true if the given pins of a mapping use buffer \p idx */
+static bool
+maps_to (ChanMapping const& m, DataType t, uint32_t n_pins, uint32_t idx)
+{
+	for (uint32_t p = 0; p < n_pins; ++p) {
+		bool valid;
+		if (m.get (t, p, &valid) == idx && valid) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/** replicated instances that process in-place can run concurrently,
+ * as long as no instance writes to a buffer that is used by another.
+ */
+bool
+PluginInsert::check_parallel () const
+{
+	const uint32_t n = get_count ();
+
+	if (_no_inplace || _match.method != Replicate || n < 2 || _parallel_cycles.size () != n) {
+		return false;
+	}
+
+	for (DataType::iterator t = DataType::begin(); t != DataType::end(); ++t) {
+		const uint32_t n_in  = natural_input_streams ().get (*t);
+		const uint32_t n_out = natural_output_streams ().get (*t);
+
+		for (uint32_t a = 0; a < n; ++a) {
+			ChanMapping const& out_a (_out_map.find (a)->second);
+			for (uint32_t o = 0; o < n_out; ++o) {
+				bool valid;
+				const uint32_t idx = out_a.get (*t, o, &valid);
+				if (!valid) {
+					continue;
+				}
+				for (uint32_t b = 0; b < n; ++b) {
+					if (a == b) {
+						continue;
+					}
+					if (maps_to (_in_map.find (b)->second, *t, n_in, idx) || maps_to (_out_map.find (b)->second, *t, n_out, idx)) {
+						return false;
+					}
+				}
+			}
+		}
+	}
+	return true;
+}
+
+/** Run replicated plugin instances concurrently using the session's
+ * RTTaskList, if a single instance is expensive enough to outweigh
+ * the synchronization overhead.
+ * @return false if the plugins were not run
+ */
+bool
+PluginInsert::run_parallel (BufferSet& bufs, samplepos_t start, samplepos_t end, double speed, PinMappings const& in_map, PinMappings const& out_map, pframes_t nframes, samplecnt_t offset)
+{
+	if (!_parallel_safe || !Config->get_parallel_replicated_plugins ()) {
+		return false;
+	}
+
+	const double cpu = CycleStats::calibrated_cycles_per_usec ();
+	if (cpu <= 0 || _run_cost * nframes < cpu * Config->get_parallel_plugin_threshold () * get_count ()) {
+		return false;
+	}
+
+	boost::shared_ptr<RTTaskList> tl (_session.rt_tasklist ());
+	if (!tl) {
+		return false;
+	}
+
+	_parallel_run.bufs    = &bufs;
+	_parallel_run.start   = start;
+	_parallel_run.end     = end;
+	_parallel_run.speed   = speed;
+	_parallel_run.in_map  = &in_map;
+	_parallel_run.out_map = &out_map;
+	_parallel_run.nframes = nframes;
+	_parallel_run.offset  = offset;
+	_parallel_run.failed  = 0;
+
+	const cycles_t t0 = get_cycles ();
+
+	if (!tl->try_process (_replicated_tasks)) {
+		/* worker threads are busy */
+		return false;
+	}
+
+	const uint64_t elapsed = CycleStats::elapsed (t0, get_cycles ());
+	uint64_t total = 0;
+	for (std::vector<uint64_t>::const_iterator i = _parallel_cycles.begin (); i != _parallel_cycles.end (); ++i) {
+		total += *i;
+	}
+	if (total > elapsed) {
+		_parallel_extra_cycles += total - elapsed;
+	}
+
+	if (g_atomic_int_get (&_parallel_run.failed)) {
+		deactivate ();
+	}
+	return true;
+}
+
+void
+PluginInsert::run_instance (uint32_t pc)
+{
+	TraceRecorder::Span span ("PluginInsert::run_instance", _trace_label.c_str ());
+
+	ParallelRun const& r (_parallel_run);
+	const cycles_t t0 = get_cycles ();
+
+	if (_plugins[pc]->connect_and_run (*r.bufs, r.start, r.end, r.speed, r.in_map->find (pc)->second, r.out_map->find (pc)->second, r.nframes, r.offset)) {
+		g_atomic_int_set (&_parallel_run.failed, 1);
+	}
+
+	_parallel_cycles[pc] = CycleStats::elapsed (t0, get_cycles ());
+}
+
+bool
+PluginInsert::get_sleep_stats (samplecnt_t& slept_samples, double& saved_usec) const
+{
+	slept_samples = _slept_samples;
+	if (slept_samples == 0) {
+		saved_usec = 0;
+		return false;
+	}
+	const double cpu = CycleStats::cycles_per_usec ();
+	saved_usec = cpu > 0 ? _saved_cycles / cpu : 0;
+	return true;
+}
+
 void
 PluginInsert::automate_and_run (BufferSet& bufs, samplepos_t start, samplepos_t end, double speed, pframes_t nframes)
 {
@@ -1812,6 +2124,14 @@ PluginInsert::reset_map (bool emit)
 	return true;
 }
 
+bool
+PluginInsert::set_name (const std::string& str)
+{
+	bool ret = Processor::set_name (str);
+	_trace_label.set (name ());
+	return ret;
+}
+
 bool
 PluginInsert::configure_io (ChanCount in, ChanCount out)
 {
@@ -1821,6 +2141,10 @@ PluginInsert::configure_io (ChanCount in, ChanCount out)
 	ChanCount old_out;
 	ChanCount old_pins;
 
+	_silent_samples = 0;
+	_plugin_signal_tail = _plugins.front ()->signal_tail ();
+	update_may_sleep ();
+
 	old_pins = natural_input_streams();
 	old_in = _configured_in;
 	old_out = _configured_out;
@@ -2001,6 +2325,13 @@ PluginInsert::configure_io (ChanCount in, ChanCount out)
 	_no_inplace = check_inplace ();
 	_mapping_changed = false;
 
+	_replicated_tasks.clear ();
+	_parallel_cycles.assign (get_count () > 1 ? get_count () : 0, 0);
+	for (uint32_t pc = 0; pc < get_count () && get_count () > 1; ++pc) {
+		_replicated_tasks.push_back (boost::bind (&PluginInsert::run_instance, this, pc));
+	}
+	_parallel_safe = check_parallel ();
+
 	/* only the "noinplace_buffers" thread buffers need to be this large,
 	 * this can be optimized. other buffers are fine with
 	 * ChanCount::max (natural_input_streams (), natural_output_streams())
@@ -2404,6 +2735,8 @@ PluginInsert::state ()
 	node.add_child_nocopy (* _configured_out.state (X_("ConfiguredOutput")));
 	node.add_child_nocopy (* _preset_out.state (X_("PresetOutput")));
 
+	node.set_property("sleep-when-silent", _sleep_when_silent);
+
 	/* save custom i/o config */
 	node.set_property("custom", _custom_cfg);
 	for (uint32_t pc = 0; pc < get_count(); ++pc) {
@@ -2615,6 +2948,8 @@ PluginInsert::set_state(const XMLNode& node, int version)
 	}
 
 	Processor::set_state (node, version);
+	/* Processor::set_state bypasses set_name () */
+	_trace_label.set (name ());
 
 	PBD::ID new_id = this->id();
 	PBD::ID old_id = this->id();
@@ -2685,6 +3020,7 @@ PluginInsert::set_state(const XMLNode& node, int version)
 	}
 
 	node.get_property (X_("custom"), _custom_cfg);
+	node.get_property (X_("sleep-when-silent"), _sleep_when_silent);
 
 	uint32_t in_maps = 0;
 	uint32_t out_maps = 0;
@@ -2891,6 +3227,11 @@ PluginInsert::PluginControl::actually_set_value (double user_val, PBD::Controlla
 {
 	/* FIXME: probably should be taking out some lock here.. */
 
+	if (user_val != get_value ()) {
+		/* wake up the plugin if it sleeps */
+		g_atomic_int_set (&_plugin->_wake, 1);
+	}
+
 	for (Plugins::iterator i = _plugin->_plugins.begin(); i != _plugin->_plugins.end(); ++i) {
 		(*i)->set_parameter (_list->parameter().id(), user_val);
 	}
@@ -2962,6 +3303,8 @@ PluginInsert::PluginPropertyControl::actually_set_value (double user_val, Contro
 		(*i)->set_property(_list->parameter().id(), value);
 	}
 
+	g_atomic_int_set (&_plugin->_wake, 1);
+
 	_value = value;
 
 	AutomationControl::actually_set_value (user_val, gcd);
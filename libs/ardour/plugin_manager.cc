@@ -70,6 +70,7 @@
 #include <glibmm/miscutils.h>
 
 #include "pbd/convert.h"
+#include "pbd/cpus.h"
 #include "pbd/file_utils.h"
 #include "pbd/tokenizer.h"
 #include "pbd/whitespace.h"
@@ -347,6 +348,16 @@ PluginManager::refresh (bool cache_only)
 	_cancel_scan = false;
 }
 
+uint32_t
+PluginManager::scan_jobs () const
+{
+	uint32_t n = Config->get_plugin_scan_jobs ();
+	if (n == 0) {
+		n = hardware_concurrency ();
+	}
+	return n;
+}
+
 void
 PluginManager::cancel_plugin_scan ()
 {
@@ -547,10 +558,40 @@ PluginManager::ladspa_refresh ()
 	find_files_matching_pattern (ladspa_modules, ladspa_search_path (), "*.dylib");
 	find_files_matching_pattern (ladspa_modules, ladspa_search_path (), "*.dll");
 
+	/* modules that were not modified since the last scan are not loaded */
+	PluginIndex index (Glib::build_filename (user_cache_directory (), X_("ladspa_index")));
+	index.load ();
+
+	size_t const n_indexed = index.n_modules ();
+	size_t n_cached = 0;
+	gint64 start = g_get_monotonic_time ();
+
 	for (vector<std::string>::iterator i = ladspa_modules.begin(); i != ladspa_modules.end(); ++i) {
+		PluginIndex::Entries entries;
+		if (index.lookup (*i, entries)) {
+			for (PluginIndex::Entries::const_iterator e = entries.begin (); e != entries.end (); ++e) {
+				PluginInfoPtr info (new LadspaPluginInfo);
+				e->apply (*info);
+				info->path = *i;
+				info->type = ARDOUR::LADSPA;
+				ladspa_add (info);
+			}
+			++n_cached;
+			continue;
+		}
 		ARDOUR::PluginScanMessage(_("LADSPA"), *i, false);
-		ladspa_discover (*i);
+		if (ladspa_discover (*i, entries) == 0) {
+			index.set (*i, entries);
+		}
+	}
+
+	if (n_cached != ladspa_modules.size () || n_cached != n_indexed) {
+		index.save ();
 	}
+
+	PBD::info << string_compose (_("LADSPA: %1 plugins in %2 modules (%3 indexed) found in %4 ms"),
+	                             _ladspa_plugin_info->size (), ladspa_modules.size (), n_cached,
+	                             (g_get_monotonic_time () - start) / 1000) << endmsg;
 }
 
 #ifdef HAVE_LRDF
@@ -633,7 +674,7 @@ PluginManager::add_lrdf_data (const string &path)
 }
 
 int
-PluginManager::ladspa_discover (string path)
+PluginManager::ladspa_discover (string path, PluginIndex::Entries& entries)
 {
 	DEBUG_TRACE (DEBUG::PluginManager, string_compose ("Checking for LADSPA plugin at %1\n", path));
 
@@ -717,32 +758,39 @@ PluginManager::ladspa_discover (string path)
 			}
 		}
 
-		if(_ladspa_plugin_info->empty()){
-			_ladspa_plugin_info->push_back (info);
-		}
+		entries.push_back (PluginIndex::Entry (*info));
+		ladspa_add (info);
+	}
+
+// GDB WILL NOT LIKE YOU IF YOU DO THIS
+//	dlclose (module);
 
-		//Ensure that the plugin is not already in the plugin list.
+	return 0;
+}
 
-		bool found = false;
+void
+PluginManager::ladspa_add (PluginInfoPtr info)
+{
+	if(_ladspa_plugin_info->empty()){
+		_ladspa_plugin_info->push_back (info);
+	}
 
-		for (PluginInfoList::const_iterator i = _ladspa_plugin_info->begin(); i != _ladspa_plugin_info->end(); ++i) {
-			if(0 == info->unique_id.compare((*i)->unique_id)){
-			      found = true;
-			}
-		}
+	//Ensure that the plugin is not already in the plugin list.
 
-		if(!found){
-		    _ladspa_plugin_info->push_back (info);
-			set_tags (info->type, info->unique_id, info->category, info->name, FromPlug);
-		}
+	bool found = false;
 
-		DEBUG_TRACE (DEBUG::PluginManager, string_compose ("Found LADSPA plugin, name: %1, Inputs: %2, Outputs: %3\n", info->name, info->n_inputs, info->n_outputs));
+	for (PluginInfoList::const_iterator i = _ladspa_plugin_info->begin(); i != _ladspa_plugin_info->end(); ++i) {
+		if(0 == info->unique_id.compare((*i)->unique_id)){
+		      found = true;
+		}
 	}
 
-// GDB WILL NOT LIKE YOU IF YOU DO THIS
-//	dlclose (module);
+	if(!found){
+	    _ladspa_plugin_info->push_back (info);
+		set_tags (info->type, info->unique_id, info->category, info->name, FromPlug);
+	}
 
-	return 0;
+	DEBUG_TRACE (DEBUG::PluginManager, string_compose ("Found LADSPA plugin, name: %1, Inputs: %2, Outputs: %3\n", info->name, info->n_inputs, info->n_outputs));
 }
 
 string
@@ -890,6 +938,10 @@ PluginManager::windows_vst_discover_from_path (string path, bool cache_only)
 
 	find_files_matching_filter (plugin_objects, path, windows_vst_filter, 0, false, true, true);
 
+	if (!cache_only && !cancelled()) {
+		vstfx_scan_parallel (plugin_objects, scan_jobs ());
+	}
+
 	for (x = plugin_objects.begin(); x != plugin_objects.end (); ++x) {
 		ARDOUR::PluginScanMessage(_("VST"), *x, !cache_only && !cancelled());
 		windows_vst_discover (*x, cache_only || cancelled());
@@ -1232,6 +1284,10 @@ PluginManager::lxvst_discover_from_path (string path, bool cache_only)
 
 	find_files_matching_filter (plugin_objects, Config->get_plugin_path_lxvst(), lxvst_filter, 0, false, true, true);
 
+	if (!cache_only && !cancelled()) {
+		vstfx_scan_parallel (plugin_objects, scan_jobs ());
+	}
+
 	for (x = plugin_objects.begin(); x != plugin_objects.end (); ++x) {
 		ARDOUR::PluginScanMessage(_("LXVST"), *x, !cache_only && !cancelled());
 		lxvst_discover (*x, cache_only || cancelled());
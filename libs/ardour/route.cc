@@ -53,6 +53,7 @@
 #include "ardour/gain_control.h"
 #include "ardour/internal_return.h"
 #include "ardour/internal_send.h"
+#include "ardour/loudness_meter.h"
 #include "ardour/meter.h"
 #include "ardour/delayline.h"
 #include "ardour/midi_buffer.h"
@@ -130,6 +131,8 @@ Route::weakroute () {
 int
 Route::init ()
 {
+	_trace_label.set (name ());
+
 	/* set default meter type */
 	if (is_master()) {
 		_meter_type = Config->get_meter_type_master ();
@@ -440,9 +443,16 @@ Route::process_output_buffers (BufferSet& bufs,
 	 *
 	 * ...or simply drop that feature.
 	 */
+	const bool skip_silent = Config->get_skip_silent_processing ();
+
 	if (_denormal_protection || Config->get_denormal_protection()) {
 
 		for (BufferSet::audio_iterator i = bufs.audio_begin(); i != bufs.audio_end(); ++i) {
+			if (skip_silent && i->silent ()) {
+				/* retain the silent flag, to allow processors to skip
+				 * idle input. Exact silence cannot produce denormals. */
+				continue;
+			}
 			Sample* const sp = i->data();
 			for (pframes_t nx = 0; nx < nframes; ++nx) {
 				sp[nx] += 1.0e-27f;
@@ -456,6 +466,7 @@ Route::process_output_buffers (BufferSet& bufs,
 	   ----------------------------------------------------------------------------------------- */
 
 	samplecnt_t latency = 0;
+	const bool cycle_stats = Config->get_processor_cycle_stats ();
 
 	for (ProcessorList::const_iterator i = _processors.begin(); i != _processors.end(); ++i) {
 
@@ -503,12 +514,18 @@ Route::process_output_buffers (BufferSet& bufs,
 			pspeed = 0;
 		}
 
+		const cycles_t cycles_start = cycle_stats ? get_cycles () : 0;
+
 		if (speed < 0) {
 			(*i)->run (bufs, start_sample + latency, end_sample + latency, pspeed, nframes, *i != _processors.back());
 		} else {
 			(*i)->run (bufs, start_sample - latency, end_sample - latency, pspeed, nframes, *i != _processors.back());
 		}
 
+		if (cycle_stats) {
+			(*i)->cycle_stats ().update (cycles_start, get_cycles ());
+		}
+
 		bufs.set_count ((*i)->output_streams());
 
 		/* Note: plugin latency may change. While the plugin does inform the session via
@@ -1372,7 +1389,7 @@ Route::clear_processors (Placement p)
 bool
 Route::is_internal_processor (boost::shared_ptr<Processor> p) const
 {
-	if (p == _amp || p == _meter || p == _main_outs || p == _delayline || p == _trim || p == _polarity) {
+	if (p == _amp || p == _meter || p == _main_outs || p == _delayline || p == _trim || p == _polarity || p == _loudness_meter) {
 		return true;
 	}
 	return false;
@@ -2894,6 +2911,7 @@ Route::set_processor_state (const XMLNode& node)
 	XMLNodeConstIterator niter;
 	ProcessorList new_order;
 	bool must_configure = false;
+	bool have_loudness = false;
 
 	for (niter = nlist.begin(); niter != nlist.end(); ++niter) {
 
@@ -2913,6 +2931,13 @@ Route::set_processor_state (const XMLNode& node)
 			new_order.push_back (_polarity);
 		} else if (prop->value() == "delay") {
 			// skip -- internal
+		} else if (prop->value() == "loudness") {
+			if (!_loudness_meter) {
+				_loudness_meter.reset (new LoudnessMeter (_session));
+				must_configure = true;
+			}
+			_loudness_meter->set_state (**niter, Stateful::current_state_version);
+			have_loudness = true;
 		} else if (prop->value() == "main-outs") {
 			_main_outs->set_state (**niter, Stateful::current_state_version);
 		} else if (prop->value() == "intreturn") {
@@ -2952,6 +2977,12 @@ Route::set_processor_state (const XMLNode& node)
 		 */
 		_processors = new_order;
 
+		if (!have_loudness && _loudness_meter) {
+			/* e.g. undo to a state before loudness metering was enabled */
+			_loudness_meter.reset ();
+			must_configure = true;
+		}
+
 		if (must_configure) {
 			configure_processors_unlocked (0, &lm);
 		}
@@ -3170,6 +3201,27 @@ Route::enable_monitor_send ()
 	configure_processors (0);
 }
 
+void
+Route::set_loudness_metering (bool yn)
+{
+	if (yn == (_loudness_meter != 0)) {
+		return;
+	}
+
+	{
+		Glib::Threads::Mutex::Lock lx (AudioEngine::instance()->process_lock ());
+		if (yn) {
+			_loudness_meter.reset (new LoudnessMeter (_session));
+		} else {
+			_loudness_meter.reset ();
+		}
+		configure_processors (0);
+	}
+
+	processors_changed (RouteProcessorChange ()); /* EMIT SIGNAL */
+	_session.set_dirty ();
+}
+
 /** Add an aux send to a route.
  *  @param route route to send to.
  *  @param before Processor to insert before, or 0 to insert at the end.
@@ -4237,6 +4289,7 @@ Route::set_name (const string& str)
 
 	string name = Route::ensure_track_or_route_name (str, _session);
 	SessionObject::set_name (name);
+	_trace_label.set (name);
 
 	bool ret = (_input->set_name(name) && _output->set_name(name));
 
@@ -4734,6 +4787,13 @@ Route::setup_invisible_processors ()
 		new_processors.insert (meter_point, _meter);
 	}
 
+	/* LOUDNESS METER, post-fader, before panning */
+
+	if (_loudness_meter) {
+		assert (!_loudness_meter->display_to_user ());
+		new_processors.insert (main, _loudness_meter);
+	}
+
 	/* MONITOR SEND */
 
 	if (_monitor_send && !is_monitor ()) {
@@ -17,11 +17,14 @@
  */
 
 
+#include "pbd/debug_rt_alloc.h"
 #include "pbd/pthread_utils.h"
 
 #include "ardour/audioengine.h"
 #include "ardour/debug.h"
+#include "ardour/process_thread.h"
 #include "ardour/rt_tasklist.h"
+#include "ardour/trace_recorder.h"
 #include "ardour/utils.h"
 
 #include "pbd/i18n.h"
@@ -32,6 +35,7 @@ RTTaskList::RTTaskList ()
 	: _threads_active (0)
 	, _task_run_sem ("rt_task_run", 0)
 	, _task_end_sem ("rt_task_done", 0)
+	, _tasklist (0)
 {
 	reset_thread_list ();
 }
@@ -105,6 +109,14 @@ RTTaskList::reset_thread_list ()
 void
 RTTaskList::run ()
 {
+	/* tasks may run plugins, which use per-thread scratch buffers */
+	suspend_rt_malloc_checks ();
+	ProcessThread* pt = new ProcessThread ();
+	TraceRecorder::register_thread ();
+	resume_rt_malloc_checks ();
+
+	pt->get_buffers ();
+
 	Glib::Threads::Mutex::Lock tm (_tasklist_mutex, Glib::Threads::NOT_LOCK);
 	bool wait = true;
 
@@ -120,16 +132,16 @@ RTTaskList::run ()
 
 		wait = false;
 
-		boost::function<void ()> to_run;
+		boost::function<void ()> const* to_run = 0;
 		tm.acquire ();
-		if (_tasklist.size () > 0) {
-			to_run = _tasklist.front();
-			_tasklist.pop_front ();
+		if (_tasklist && _next_task != _tasklist->end ()) {
+			to_run = &(*_next_task);
+			++_next_task;
 		}
 		tm.release ();
 
-		if (!to_run.empty ()) {
-			to_run ();
+		if (to_run) {
+			(*to_run) ();
 			continue;
 		}
 
@@ -139,28 +151,45 @@ RTTaskList::run ()
 
 		wait = true;
 	}
+
+	pt->drop_buffers ();
+	delete pt;
 }
 
 void
 RTTaskList::process (TaskList const& tl)
 {
 	Glib::Threads::Mutex::Lock pm (_process_mutex);
-	_tasklist = tl;
-	process_tasklist ();
-	_tasklist.clear ();
+	process_tasklist (tl);
+}
+
+bool
+RTTaskList::try_process (TaskList const& tl)
+{
+	Glib::Threads::Mutex::Lock pm (_process_mutex, Glib::Threads::TRY_LOCK);
+	if (!pm.locked ()) {
+		return false;
+	}
+	process_tasklist (tl);
+	return true;
 }
 
 void
-RTTaskList::process_tasklist ()
+RTTaskList::process_tasklist (TaskList const& tl)
 {
 	if (0 == g_atomic_int_get (&_threads_active) || _threads.size () == 0) {
-		for (TaskList::iterator i = _tasklist.begin (); i != _tasklist.end(); ++i) {
+		for (TaskList::const_iterator i = tl.begin (); i != tl.end(); ++i) {
 			(*i)();
 		}
 		return;
 	}
 
-	uint32_t nt = std::min (_threads.size (), _tasklist.size ());
+	Glib::Threads::Mutex::Lock tm (_tasklist_mutex);
+	_tasklist  = &tl;
+	_next_task = tl.begin ();
+	tm.release ();
+
+	uint32_t nt = std::min (_threads.size (), tl.size ());
 
 	for (uint32_t i = 0; i < nt; ++i) {
 		_task_run_sem.signal ();
@@ -168,4 +197,7 @@ RTTaskList::process_tasklist ()
 	for (uint32_t i = 0; i < nt; ++i) {
 		_task_end_sem.wait ();
 	}
+
+	tm.acquire ();
+	_tasklist = 0;
 }
@@ -65,6 +65,7 @@
 #include "ardour/control_protocol_manager.h"
 #include "ardour/data_type.h"
 #include "ardour/debug.h"
+#include "ardour/delayline.h"
 #include "ardour/disk_reader.h"
 #include "ardour/directory_names.h"
 #ifdef USE_TRACKS_CODE_FEATURES
@@ -6890,6 +6891,7 @@ restart:
 	}
 
 	DEBUG_TRACE (DEBUG::Latency, string_compose ("worst signal processing latency: %1 (changed ? %2)\n", _worst_route_latency, (changed ? "yes" : "no")));
+	DEBUG_TRACE (DEBUG::LatencyCompensation, string_compose ("delay-lines use %1 bytes\n", DelayLine::allocated_bytes ()));
 
 	return changed;
 }
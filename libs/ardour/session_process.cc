@@ -40,6 +40,7 @@
 #include "ardour/session.h"
 #include "ardour/slave.h"
 #include "ardour/ticker.h"
+#include "ardour/trace_recorder.h"
 #include "ardour/types.h"
 #include "ardour/vca.h"
 #include "ardour/vca_manager.h"
@@ -59,6 +60,7 @@ using namespace std;
 void
 Session::process (pframes_t nframes)
 {
+	TraceRecorder::Span span ("Session::process");
 	samplepos_t transport_at_start = _transport_sample;
 
 	_silent = false;
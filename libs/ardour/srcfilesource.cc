@@ -18,11 +18,30 @@
 
 */
 
+#include <algorithm>
+#include <vector>
+
+#include <fcntl.h>
+#include <glib.h>
+#include "pbd/gstdio_compat.h"
+
+#ifdef PLATFORM_WINDOWS
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#include <glibmm/checksum.h>
+#include <glibmm/miscutils.h>
+
 #include "pbd/error.h"
 #include "pbd/failed_constructor.h"
 
 #include "ardour/audiofilesource.h"
 #include "ardour/debug.h"
+#include "ardour/filename_extensions.h"
+#include "ardour/rc_configuration.h"
+#include "ardour/session_directory.h"
 #include "ardour/srcfilesource.h"
 
 #include "pbd/i18n.h"
@@ -32,34 +51,57 @@ using namespace PBD;
 
 const uint32_t SrcFileSource::max_blocksize = 2097152U; /* see AudioDiskstream::_do_refill_with_alloc, max */
 
+std::list<SrcFileSource*> SrcFileSource::_cache_queue;
+SrcFileSource*            SrcFileSource::_cache_building = 0;
+bool                      SrcFileSource::_cache_thread_running = false;
+Glib::Threads::Mutex      SrcFileSource::_cache_lock;
+Glib::Threads::Cond       SrcFileSource::_cache_cond;
+
+namespace {
+
+/* the cache file is raw float data in native byte order after this header */
+struct CacheHeader {
+	char    magic[8];
+	double  ratio;
+	int64_t length;
+	int32_t quality;
+	int32_t reserved;
+};
+
+const char cache_magic[8] = { 'A', 'R', 'D', 'S', 'R', 'C', '0', '1' };
+
+}
+
 SrcFileSource::SrcFileSource (Session& s, boost::shared_ptr<AudioFileSource> src, SrcQuality srcq)
 	: Source(s, DataType::AUDIO, src->name(), Flag (src->flags() & ~(Writable|Removable|RemovableIfEmpty|RemoveAtDestroy)))
 	, AudioFileSource (s, src->path(), Flag (src->flags() & ~(Writable|Removable|RemovableIfEmpty|RemoveAtDestroy)))
 	, _source (src)
+	, _srcq (srcq)
+	, _src_type (SRC_SINC_BEST_QUALITY)
 	, _src_state (0)
 	, _source_position(0)
 	, _target_position(0)
 	, _fract_position(0)
+	, _cache_fd (-1)
+	, _cache_abort (0)
 {
 	assert(_source->n_channels() == 1);
 
-	int src_type = SRC_SINC_BEST_QUALITY;
-
 	switch (srcq) {
 		case SrcBest:
-			src_type = SRC_SINC_BEST_QUALITY;
+			_src_type = SRC_SINC_BEST_QUALITY;
 			break;
 		case SrcGood:
-			src_type = SRC_SINC_MEDIUM_QUALITY;
+			_src_type = SRC_SINC_MEDIUM_QUALITY;
 			break;
 		case SrcQuick:
-			src_type = SRC_SINC_FASTEST;
+			_src_type = SRC_SINC_FASTEST;
 			break;
 		case SrcFast:
-			src_type = SRC_ZERO_ORDER_HOLD;
+			_src_type = SRC_ZERO_ORDER_HOLD;
 			break;
 		case SrcFastest:
-			src_type = SRC_LINEAR;
+			_src_type = SRC_LINEAR;
 			break;
 	}
 
@@ -71,15 +113,41 @@ SrcFileSource::SrcFileSource (Session& s, boost::shared_ptr<AudioFileSource> src
 	_src_buffer = new float[src_buffer_size];
 
 	int err;
-	if ((_src_state = src_new (src_type, 1, &err)) == 0) {
+	if ((_src_state = src_new (_src_type, 1, &err)) == 0) {
 		error << string_compose(_("Import: src_new() failed : %1"), src_strerror (err)) << endmsg ;
 		throw failed_constructor ();
 	}
+
+	if (Config->get_cache_resampled_sources () && !open_cache ()) {
+		Glib::Threads::Mutex::Lock lm (_cache_lock);
+		_cache_queue.push_back (this);
+		if (!_cache_thread_running) {
+			Glib::Threads::Thread::create (sigc::ptr_fun (&SrcFileSource::cache_thread_work));
+			_cache_thread_running = true;
+		}
+		_cache_cond.broadcast ();
+	}
 }
 
 SrcFileSource::~SrcFileSource ()
 {
 	DEBUG_TRACE (DEBUG::AudioPlayback, "SrcFileSource::~SrcFileSource\n");
+
+	{
+		Glib::Threads::Mutex::Lock lm (_cache_lock);
+		_cache_queue.remove (this);
+		if (_cache_building == this) {
+			g_atomic_int_set (&_cache_abort, 1);
+			while (_cache_building == this) {
+				_cache_cond.wait (_cache_lock);
+			}
+		}
+	}
+
+	if (_cache_fd >= 0) {
+		::close (_cache_fd);
+	}
+
 	_src_state = src_delete (_src_state) ;
 	delete [] _src_buffer;
 }
@@ -96,6 +164,10 @@ SrcFileSource::close ()
 samplecnt_t
 SrcFileSource::read_unlocked (Sample *dst, samplepos_t start, samplecnt_t cnt) const
 {
+	if (_cache_fd >= 0) {
+		return read_cache (dst, start, cnt);
+	}
+
 	int err;
 	const double srccnt = cnt / _ratio;
 
@@ -165,3 +237,205 @@ SrcFileSource::read_unlocked (Sample *dst, samplepos_t start, samplecnt_t cnt) c
 
 	return generated;
 }
+
+std::string
+SrcFileSource::cache_path () const
+{
+	/* unique for the file, channel, target rate and quality */
+	const std::string id = string_compose ("%1:%2:%3:%4", _source->path (), _source->channel (), _session.nominal_sample_rate (), (int) _srcq);
+	return Glib::build_filename (_session.session_directory ().peak_path (),
+	                             Glib::Checksum::compute_checksum (Glib::Checksum::CHECKSUM_SHA1, id) + resampled_suffix);
+}
+
+bool
+SrcFileSource::open_cache ()
+{
+	const std::string path = cache_path ();
+
+	GStatBuf cache_stat;
+	GStatBuf source_stat;
+	if (g_stat (path.c_str (), &cache_stat) != 0
+	    || g_stat (_source->path ().c_str (), &source_stat) != 0
+	    || cache_stat.st_mtime < source_stat.st_mtime) {
+		return false;
+	}
+
+	int fd = g_open (path.c_str (), O_RDONLY, 0444);
+	if (fd < 0) {
+		return false;
+	}
+
+	CacheHeader h;
+	if (::read (fd, &h, sizeof (h)) != sizeof (h)
+	    || memcmp (h.magic, cache_magic, sizeof (cache_magic))
+	    || h.ratio != _ratio
+	    || h.quality != (int32_t) _srcq
+	    || h.length != readable_length ()
+	    || (int64_t) cache_stat.st_size != (int64_t) (sizeof (h) + h.length * sizeof (Sample))) {
+		::close (fd);
+		return false;
+	}
+
+	DEBUG_TRACE (DEBUG::AudioPlayback, string_compose ("SRC: using cache %1 for %2\n", path, _source->path ()));
+
+	Glib::Threads::Mutex::Lock lm (_lock);
+	_cache_fd = fd;
+	return true;
+}
+
+samplecnt_t
+SrcFileSource::read_cache (Sample* dst, samplepos_t start, samplecnt_t cnt) const
+{
+	const samplecnt_t len = readable_length ();
+	if (start >= len) {
+		return 0;
+	}
+	cnt = std::min (cnt, len - start);
+
+	const int64_t pos = sizeof (CacheHeader) + start * sizeof (Sample);
+#ifdef PLATFORM_WINDOWS
+	bool const ok = _lseeki64 (_cache_fd, (__int64) pos, SEEK_SET) >= 0;
+#else
+	bool const ok = lseek (_cache_fd, (off_t) pos, SEEK_SET) >= 0;
+#endif
+	if (!ok) {
+		return 0;
+	}
+
+	char*  p     = (char*) dst;
+	size_t bytes = cnt * sizeof (Sample);
+	while (bytes > 0) {
+		int const r = ::read (_cache_fd, p, std::min<size_t> (bytes, 1048576));
+		if (r <= 0) {
+			break;
+		}
+		p     += r;
+		bytes -= r;
+	}
+	return cnt - bytes / sizeof (Sample);
+}
+
+/** Resample the complete source into a temporary file, and rename it to
+ * the cache path when done. Reads from the process thread continue to
+ * use the converter of this source meanwhile.
+ */
+void
+SrcFileSource::build_cache ()
+{
+	const std::string path = cache_path ();
+	const std::string tmp  = path + temp_suffix;
+
+	int err;
+	SRC_STATE* state = src_new (_src_type, 1, &err);
+	if (!state) {
+		return;
+	}
+
+	FILE* f = g_fopen (tmp.c_str (), "wb");
+	if (!f) {
+		src_delete (state);
+		return;
+	}
+
+	CacheHeader h;
+	memset (&h, 0, sizeof (h));
+	memcpy (h.magic, cache_magic, sizeof (cache_magic));
+	h.ratio   = _ratio;
+	h.length  = readable_length ();
+	h.quality = _srcq;
+
+	bool ok = fwrite (&h, sizeof (h), 1, f) == 1;
+
+	const samplecnt_t   chunk  = 65536;
+	const samplecnt_t   in_len = _source->readable_length ();
+	std::vector<Sample> in (chunk);
+	std::vector<Sample> out ((size_t) ceil (chunk * _ratio) + 2);
+
+	samplepos_t in_pos  = 0;
+	samplecnt_t written = 0;
+
+	SRC_DATA d;
+	d.src_ratio = _ratio;
+
+	while (ok && written < h.length) {
+		if (g_atomic_int_get (&_cache_abort)) {
+			ok = false;
+			break;
+		}
+
+		const samplecnt_t n = _source->read (&in[0], in_pos, chunk);
+		if (n < chunk && in_pos + n < in_len) {
+			/* read error */
+			ok = false;
+			break;
+		}
+
+		d.data_in       = &in[0];
+		d.input_frames  = n;
+		d.data_out      = &out[0];
+		d.output_frames = out.size ();
+		d.end_of_input  = in_pos + n >= in_len;
+
+		if (src_process (state, &d)) {
+			ok = false;
+			break;
+		}
+
+		in_pos += d.input_frames_used;
+
+		const samplecnt_t w = std::min<samplecnt_t> (d.output_frames_gen, h.length - written);
+		ok = fwrite (&out[0], sizeof (Sample), w, f) == (size_t) w;
+		written += w;
+
+		if (d.end_of_input && d.output_frames_gen == 0) {
+			break;
+		}
+	}
+
+	/* the converter may produce a few samples less than the nominal length */
+	if (ok && written < h.length) {
+		std::fill (out.begin (), out.end (), 0.f);
+		while (ok && written < h.length) {
+			const samplecnt_t w = std::min<samplecnt_t> (out.size (), h.length - written);
+			ok = fwrite (&out[0], sizeof (Sample), w, f) == (size_t) w;
+			written += w;
+		}
+	}
+
+	if (fclose (f)) {
+		ok = false;
+	}
+	src_delete (state);
+
+	if (!ok || ::g_rename (tmp.c_str (), path.c_str ())) {
+		::g_unlink (tmp.c_str ());
+		return;
+	}
+
+	open_cache ();
+}
+
+/* One thread for all sources, at normal (not realtime) priority, so that
+ * building caches does not compete with the process and butler threads.
+ */
+void
+SrcFileSource::cache_thread_work ()
+{
+	Glib::Threads::Mutex::Lock lm (_cache_lock);
+
+	while (true) {
+		while (_cache_queue.empty ()) {
+			_cache_cond.wait (_cache_lock);
+		}
+
+		_cache_building = _cache_queue.front ();
+		_cache_queue.pop_front ();
+
+		lm.release ();
+		_cache_building->build_cache ();
+		lm.acquire ();
+
+		_cache_building = 0;
+		_cache_cond.broadcast ();
+	}
+}
@@ -0,0 +1,71 @@
+#include "ardour/cycle_stats.h"
+
+#include "cycle_stats_test.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION (CycleStatsTest);
+
+using namespace ARDOUR;
+
+void
+CycleStatsTest::basicTest ()
+{
+	CycleStats cs;
+	uint64_t min, max;
+	double avg;
+
+	CPPUNIT_ASSERT (!cs.get_stats (min, max, avg));
+	CPPUNIT_ASSERT_EQUAL ((uint64_t) 0, cs.percentile (50));
+
+	cs.update (100);
+	cs.update (300);
+	cs.update (200);
+
+	CPPUNIT_ASSERT (cs.get_stats (min, max, avg));
+	CPPUNIT_ASSERT_EQUAL ((uint64_t) 3, cs.count ());
+	CPPUNIT_ASSERT_EQUAL ((uint64_t) 100, min);
+	CPPUNIT_ASSERT_EQUAL ((uint64_t) 300, max);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL (200.0, avg, 1e-9);
+
+	/* reset is deferred until the next update */
+	cs.reset ();
+	CPPUNIT_ASSERT_EQUAL ((uint64_t) 3, cs.count ());
+	cs.update (42);
+	CPPUNIT_ASSERT (cs.get_stats (min, max, avg));
+	CPPUNIT_ASSERT_EQUAL ((uint64_t) 1, cs.count ());
+	CPPUNIT_ASSERT_EQUAL ((uint64_t) 42, min);
+	CPPUNIT_ASSERT_EQUAL ((uint64_t) 42, max);
+}
+
+void
+CycleStatsTest::percentileTest ()
+{
+	CycleStats cs;
+
+	for (uint64_t i = 1; i <= 1000; ++i) {
+		cs.update (i * 10);
+	}
+
+	/* histogram resolution is 4 buckets per octave */
+	const uint64_t p50 = cs.percentile (50);
+	const uint64_t p99 = cs.percentile (99);
+	CPPUNIT_ASSERT (p50 >= 5000 * 0.8 && p50 <= 5000 * 1.2);
+	CPPUNIT_ASSERT (p99 >= 9900 * 0.8 && p99 <= 9900 * 1.2);
+	CPPUNIT_ASSERT (p50 <= p99);
+
+	/* percentiles are clamped to the measured range */
+	CPPUNIT_ASSERT (cs.percentile (0) >= 10);
+	CPPUNIT_ASSERT (cs.percentile (100) <= 10000);
+}
+
+void
+CycleStatsTest::wrapTest ()
+{
+	CPPUNIT_ASSERT_EQUAL ((uint64_t) 10, CycleStats::elapsed (100, 110));
+	if (sizeof (cycles_t) < 8) {
+		/* 32bit cycle counter wrap-around */
+		CPPUNIT_ASSERT_EQUAL ((uint64_t) 20, CycleStats::elapsed (0xfffffff6, 10));
+	} else {
+		/* a 64-bit counter that went backwards */
+		CPPUNIT_ASSERT_EQUAL ((uint64_t) 0, CycleStats::elapsed (0xfffffff6, 10));
+	}
+}
@@ -0,0 +1,16 @@
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+class CycleStatsTest : public CppUnit::TestFixture
+{
+	CPPUNIT_TEST_SUITE (CycleStatsTest);
+	CPPUNIT_TEST (basicTest);
+	CPPUNIT_TEST (percentileTest);
+	CPPUNIT_TEST (wrapTest);
+	CPPUNIT_TEST_SUITE_END ();
+
+public:
+	void basicTest ();
+	void percentileTest ();
+	void wrapTest ();
+};
@@ -0,0 +1,161 @@
+#ifdef PLATFORM_WINDOWS
+#include <sys/utime.h>
+#else
+#include <utime.h>
+#endif
+
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <glibmm/fileutils.h>
+#include <glibmm/miscutils.h>
+
+#include "pbd/compose.h"
+
+#include "ardour/plugin_index.h"
+
+#include "plugin_index_test.h"
+#include "test_util.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION (PluginIndexTest);
+
+using namespace std;
+using namespace ARDOUR;
+
+static void
+set_mtime (std::string const& path, time_t t)
+{
+	struct utimbuf tb;
+	tb.actime = tb.modtime = t;
+	CPPUNIT_ASSERT (g_utime (path.c_str (), &tb) == 0);
+}
+
+static PluginIndex::Entries
+make_entries (std::string const& prefix, uint32_t n)
+{
+	PluginIndex::Entries entries;
+	for (uint32_t i = 0; i < n; ++i) {
+		PluginIndex::Entry e;
+		e.name      = string_compose ("%1 %2", prefix, i);
+		e.category  = "Delay";
+		e.creator   = "Ardour Community";
+		e.unique_id = string_compose ("urn:ardour:%1-%2", prefix, i);
+		e.index     = i;
+		e.n_inputs  = ChanCount (DataType::AUDIO, 2);
+		e.n_outputs = ChanCount (DataType::AUDIO, 1);
+		e.n_inputs.set_midi (1);
+		entries.push_back (e);
+	}
+	return entries;
+}
+
+void
+PluginIndexTest::setUp ()
+{
+	_dir = new_test_output_dir ("plugin_index");
+	_index = Glib::build_filename (_dir, "index");
+	g_unlink (_index.c_str ());
+
+	/* a LADSPA-like module, and an LV2-like bundle */
+	Glib::file_set_contents (Glib::build_filename (_dir, "a.so"), "a");
+	g_mkdir (Glib::build_filename (_dir, "b.lv2").c_str (), 0755);
+	Glib::file_set_contents (Glib::build_filename (_dir, "b.lv2", "manifest.ttl"), "b");
+	set_mtime (Glib::build_filename (_dir, "a.so"), 1000000);
+	set_mtime (Glib::build_filename (_dir, "b.lv2", "manifest.ttl"), 1000000);
+	set_mtime (Glib::build_filename (_dir, "b.lv2"), 1000000);
+}
+
+void
+PluginIndexTest::roundTripTest ()
+{
+	string const a = Glib::build_filename (_dir, "a.so");
+	string const b = Glib::build_filename (_dir, "b.lv2");
+
+	PluginIndex index (_index);
+	CPPUNIT_ASSERT (!index.load ());
+	index.set (a, make_entries ("a", 3));
+	index.set (b, make_entries ("b", 1));
+	CPPUNIT_ASSERT (index.save ());
+
+	PluginIndex copy (_index);
+	CPPUNIT_ASSERT (copy.load ());
+	CPPUNIT_ASSERT_EQUAL ((size_t) 2, copy.n_modules ());
+
+	vector<string> modules;
+	modules.push_back (a);
+	modules.push_back (b);
+	CPPUNIT_ASSERT (copy.up_to_date (modules));
+
+	PluginIndex::Entries entries;
+	CPPUNIT_ASSERT (copy.lookup (a, entries));
+	CPPUNIT_ASSERT_EQUAL ((size_t) 3, entries.size ());
+
+	PluginIndex::Entries const expected = make_entries ("a", 3);
+	for (size_t i = 0; i < entries.size (); ++i) {
+		CPPUNIT_ASSERT_EQUAL (expected[i].name, entries[i].name);
+		CPPUNIT_ASSERT_EQUAL (expected[i].category, entries[i].category);
+		CPPUNIT_ASSERT_EQUAL (expected[i].creator, entries[i].creator);
+		CPPUNIT_ASSERT_EQUAL (expected[i].unique_id, entries[i].unique_id);
+		CPPUNIT_ASSERT_EQUAL (expected[i].index, entries[i].index);
+		CPPUNIT_ASSERT (expected[i].n_inputs == entries[i].n_inputs);
+		CPPUNIT_ASSERT (expected[i].n_outputs == entries[i].n_outputs);
+	}
+
+	/* a module that is not in the index */
+	modules.push_back (Glib::build_filename (_dir, "c.so"));
+	CPPUNIT_ASSERT (!copy.up_to_date (modules));
+	CPPUNIT_ASSERT (!copy.lookup (modules.back (), entries));
+}
+
+void
+PluginIndexTest::modifiedTest ()
+{
+	string const a = Glib::build_filename (_dir, "a.so");
+	string const b = Glib::build_filename (_dir, "b.lv2");
+
+	PluginIndex index (_index);
+	index.set (a, make_entries ("a", 1));
+	index.set (b, make_entries ("b", 1));
+	CPPUNIT_ASSERT (index.save ());
+
+	/* a file inside a bundle is edited */
+	set_mtime (Glib::build_filename (b, "manifest.ttl"), 2000000);
+	/* a library is replaced */
+	set_mtime (a, 2000000);
+
+	PluginIndex copy (_index);
+	CPPUNIT_ASSERT (copy.load ());
+
+	PluginIndex::Entries entries;
+	CPPUNIT_ASSERT (!copy.lookup (a, entries));
+	CPPUNIT_ASSERT (!copy.lookup (b, entries));
+
+	vector<string> modules;
+	modules.push_back (a);
+	modules.push_back (b);
+	CPPUNIT_ASSERT (!copy.up_to_date (modules));
+}
+
+void
+PluginIndexTest::removedTest ()
+{
+	string const a = Glib::build_filename (_dir, "a.so");
+	string const b = Glib::build_filename (_dir, "b.lv2");
+
+	PluginIndex index (_index);
+	index.set (a, make_entries ("a", 1));
+	index.set (b, make_entries ("b", 1));
+	CPPUNIT_ASSERT (index.save ());
+
+	/* only modules that were used in a scan are written back */
+	PluginIndex rescan (_index);
+	CPPUNIT_ASSERT (rescan.load ());
+	PluginIndex::Entries entries;
+	CPPUNIT_ASSERT (rescan.lookup (a, entries));
+	CPPUNIT_ASSERT (rescan.save ());
+
+	PluginIndex copy (_index);
+	CPPUNIT_ASSERT (copy.load ());
+	CPPUNIT_ASSERT_EQUAL ((size_t) 1, copy.n_modules ());
+	CPPUNIT_ASSERT (copy.lookup (a, entries));
+	CPPUNIT_ASSERT (!copy.lookup (b, entries));
+}
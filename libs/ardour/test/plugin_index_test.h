@@ -0,0 +1,25 @@
+#include <string>
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+class PluginIndexTest : public CppUnit::TestFixture
+{
+	CPPUNIT_TEST_SUITE (PluginIndexTest);
+	CPPUNIT_TEST (roundTripTest);
+	CPPUNIT_TEST (modifiedTest);
+	CPPUNIT_TEST (removedTest);
+	CPPUNIT_TEST_SUITE_END ();
+
+public:
+	void setUp ();
+	void tearDown () {}
+
+	void roundTripTest ();
+	void modifiedTest ();
+	void removedTest ();
+
+private:
+	std::string _dir;
+	std::string _index;
+};
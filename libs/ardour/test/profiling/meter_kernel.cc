@@ -0,0 +1,199 @@
+/* Compare the fused multi-channel MeterKernel with the
+ * per-channel meter objects used previously by PeakMeter,
+ * and measure the cost of 4x oversampled true-peak metering.
+ *
+ * usage: meter_kernel [channels] [cycles] [block-size]
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include <glib.h>
+
+#include "audiographer/general/true_peak.h"
+
+#include "ardour/iec1ppmdsp.h"
+#include "ardour/iec2ppmdsp.h"
+#include "ardour/kmeterdsp.h"
+#include "ardour/meter_kernel.h"
+#include "ardour/vumeterdsp.h"
+
+using namespace std;
+using namespace ARDOUR;
+
+static float
+compute_peak (float const* buf, uint32_t n, float current)
+{
+	for (uint32_t i = 0; i < n; ++i) {
+		current = max (current, fabsf (buf[i]));
+	}
+	return current;
+}
+
+static bool
+check (const char* what, uint32_t c, float a, float b)
+{
+	if (fabsf (a - b) <= 1e-4f * max (1.f, fabsf (a))) {
+		return true;
+	}
+	fprintf (stderr, "Mismatch: %s chn %u: %f != %f\n", what, c, a, b);
+	return false;
+}
+
+int
+main (int argc, char* argv[])
+{
+	const uint32_t n_chn   = argc > 1 ? atoi (argv[1]) : 64;
+	const uint32_t n_cycle = argc > 2 ? atoi (argv[2]) : 5000;
+	const uint32_t n_samp  = argc > 3 ? atoi (argv[3]) : 512;
+	const float    rate    = 48000;
+
+	if (n_chn == 0 || n_samp == 0) {
+		fprintf (stderr, "usage: %s [channels] [cycles] [block-size]\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	Kmeterdsp::init (rate);
+	Iec1ppmdsp::init (rate);
+	Iec2ppmdsp::init (rate);
+	Vumeterdsp::init (rate);
+	MeterKernel::init (rate);
+
+	/* test signal: decaying noise bursts, different per channel */
+	vector<vector<float> > data (n_chn, vector<float> (n_samp));
+	vector<float const*> ptrs (n_chn);
+	srand (1);
+	for (uint32_t c = 0; c < n_chn; ++c) {
+		for (uint32_t i = 0; i < n_samp; ++i) {
+			data[c][i] = (rand () / (float) RAND_MAX - .5f) * (c + 1) / (float) n_chn;
+		}
+		ptrs[c] = &data[c][0];
+	}
+
+	const uint32_t types[] = {
+		MeterPeak,
+		MeterK20,
+		MeterIEC1DIN,
+		MeterIEC2EBU,
+		MeterVU,
+		MeterK20 | MeterIEC1DIN | MeterIEC2EBU | MeterVU
+	};
+	const char* names[] = { "Peak", "K20", "IEC1", "IEC2", "VU", "all" };
+
+	bool ok = true;
+
+	printf ("%u channels, %u cycles of %u samples\n", n_chn, n_cycle, n_samp);
+	printf ("%-6s %14s %14s %8s\n", "type", "objects [us]", "kernel [us]", "ratio");
+
+	for (size_t t = 0; t < sizeof (types) / sizeof (types[0]); ++t) {
+		const uint32_t type = types[t];
+
+		vector<Kmeterdsp>  km (n_chn);
+		vector<Iec1ppmdsp> i1 (n_chn);
+		vector<Iec2ppmdsp> i2 (n_chn);
+		vector<Vumeterdsp> vu (n_chn);
+		vector<float>      peak_o (n_chn, 0);
+
+		MeterKernel   mk;
+		vector<float> peak_k (n_chn, 0);
+		vector<float> cycle_peak (n_chn, 0);
+		mk.set_channels (n_chn);
+
+		/* per-channel objects, as previously used by PeakMeter::run */
+		int64_t t0 = g_get_monotonic_time ();
+		for (uint32_t n = 0; n < n_cycle; ++n) {
+			for (uint32_t c = 0; c < n_chn; ++c) {
+				peak_o[c] = compute_peak (ptrs[c], n_samp, peak_o[c]);
+				if (type & MeterKernel::k_types) {
+					km[c].process (ptrs[c], n_samp);
+				}
+				if (type & MeterKernel::iec1_types) {
+					i1[c].process (ptrs[c], n_samp);
+				}
+				if (type & MeterKernel::iec2_types) {
+					i2[c].process (ptrs[c], n_samp);
+				}
+				if (type & MeterKernel::vu_types) {
+					vu[c].process (ptrs[c], n_samp);
+				}
+			}
+		}
+		int64_t t1 = g_get_monotonic_time ();
+
+		/* fused kernel, peak is computed separately for peak-only meters */
+		for (uint32_t n = 0; n < n_cycle; ++n) {
+			if (type & (MeterKernel::k_types | MeterKernel::iec1_types | MeterKernel::iec2_types | MeterKernel::vu_types)) {
+				mk.process (&ptrs[0], n_chn, n_samp, type, &cycle_peak[0]);
+				for (uint32_t c = 0; c < n_chn; ++c) {
+					peak_k[c] = max (peak_k[c], cycle_peak[c]);
+				}
+			} else {
+				for (uint32_t c = 0; c < n_chn; ++c) {
+					peak_k[c] = compute_peak (ptrs[c], n_samp, peak_k[c]);
+				}
+			}
+		}
+		int64_t t2 = g_get_monotonic_time ();
+
+		printf ("%-6s %14.2f %14.2f %8.2f\n", names[t],
+				(t1 - t0) / (double) n_cycle,
+				(t2 - t1) / (double) n_cycle,
+				(t2 - t1) > 0 ? (t1 - t0) / (double) (t2 - t1) : 0);
+
+		for (uint32_t c = 0; c < n_chn; ++c) {
+			ok &= check ("peak", c, peak_o[c], peak_k[c]);
+			if (type & MeterKernel::k_types) {
+				ok &= check ("K", c, km[c].read (), mk.read_k (c));
+			}
+			if (type & MeterKernel::iec1_types) {
+				ok &= check ("IEC1", c, i1[c].read (), mk.read_iec1 (c));
+			}
+			if (type & MeterKernel::iec2_types) {
+				ok &= check ("IEC2", c, i2[c].read (), mk.read_iec2 (c));
+			}
+			if (type & MeterKernel::vu_types) {
+				ok &= check ("VU", c, vu[c].read (), mk.read_vu (c));
+			}
+		}
+	}
+
+	/* true-peak, compared to sample-peak */
+	{
+		AudioGrapher::TruePeakKernel tp;
+		vector<float> peak_s (n_chn, 0);
+		vector<float> peak_t (n_chn, 0);
+		tp.set_channels (n_chn);
+
+		int64_t t0 = g_get_monotonic_time ();
+		for (uint32_t n = 0; n < n_cycle; ++n) {
+			for (uint32_t c = 0; c < n_chn; ++c) {
+				peak_s[c] = compute_peak (ptrs[c], n_samp, peak_s[c]);
+			}
+		}
+		int64_t t1 = g_get_monotonic_time ();
+		for (uint32_t n = 0; n < n_cycle; ++n) {
+			for (uint32_t c = 0; c < n_chn; ++c) {
+				peak_t[c] = max (peak_t[c], tp.process (c, ptrs[c], n_samp));
+			}
+		}
+		int64_t t2 = g_get_monotonic_time ();
+
+		printf ("%-6s %14.2f %14.2f %8.2f  (sample-peak, true-peak; %.2f%% DSP)\n", "TP",
+				(t1 - t0) / (double) n_cycle,
+				(t2 - t1) / (double) n_cycle,
+				(t2 - t1) > 0 ? (t1 - t0) / (double) (t2 - t1) : 0,
+				100.0 * (t2 - t1) / (double) n_cycle / (1e6 * n_samp / rate));
+
+		for (uint32_t c = 0; c < n_chn; ++c) {
+			/* the oversampled signal includes all samples */
+			if (peak_t[c] < peak_s[c] * 0.999f) {
+				fprintf (stderr, "Mismatch: true-peak chn %u: %f < %f\n", c, peak_t[c], peak_s[c]);
+				ok = false;
+			}
+		}
+	}
+
+	return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,235 @@
+/*
+ * Copyright (C) 2026 The Ardour Developers
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include <algorithm>
+#include <cassert>
+#include <fstream>
+
+#include "pbd/error.h"
+#include "pbd/pthread_utils.h"
+
+#include "ardour/trace_recorder.h"
+
+#include "pbd/i18n.h"
+
+using namespace ARDOUR;
+using namespace PBD;
+
+gint                        TraceRecorder::_active = 0;
+gint                        TraceRecorder::_n_writers = 0;
+gint                        TraceRecorder::_slot_used[TraceRecorder::max_threads];
+uint32_t                    TraceRecorder::_ring_size = 0;
+TraceRecorder::ThreadRing   TraceRecorder::_rings[TraceRecorder::max_threads];
+
+/* Per-thread slot, encoded as (slot + 1), 0 if the thread is not registered.
+ * An integer is used rather than a pointer so that looking up the
+ * ring does not dereference any per-thread memory.
+ */
+GPrivate TraceRecorder::_thread_slot = G_PRIVATE_INIT (TraceRecorder::release_thread);
+
+void
+TraceRecorder::start (uint32_t events_per_thread)
+{
+	if (active ()) {
+		return;
+	}
+
+	if (!_rings[0].events) {
+		_ring_size = std::max<uint32_t> (1024, events_per_thread);
+		for (int i = 0; i < max_threads; ++i) {
+			_rings[i].events = new Event[_ring_size];
+		}
+	}
+
+	/* spans recorded before a previous stop() may still use the rings */
+	wait_for_writers ();
+
+	for (int i = 0; i < max_threads; ++i) {
+		_rings[i].n_written = 0;
+	}
+
+	g_atomic_int_set (&_active, 1);
+}
+
+void
+TraceRecorder::stop ()
+{
+	g_atomic_int_set (&_active, 0);
+}
+
+/* wait until all threads that saw recording as active have left record ().
+ * Writers register before checking _active, so once _active is cleared
+ * no new writer can start.
+ */
+void
+TraceRecorder::wait_for_writers ()
+{
+	assert (!active ());
+	while (g_atomic_int_get (&_n_writers) > 0) {
+		g_usleep (100);
+	}
+}
+
+void
+TraceRecorder::register_thread ()
+{
+	if (g_private_get (&_thread_slot)) {
+		return;
+	}
+
+	for (int slot = 0; slot < max_threads; ++slot) {
+		if (!g_atomic_int_compare_and_exchange (&_slot_used[slot], 0, 1)) {
+			continue;
+		}
+		ThreadRing* r = &_rings[slot];
+		r->n_written = 0;
+		strncpy (r->thread_name, pthread_name (), sizeof (r->thread_name) - 1);
+		r->thread_name[sizeof (r->thread_name) - 1] = '\0';
+
+		g_private_set (&_thread_slot, GINT_TO_POINTER (slot + 1));
+		return;
+	}
+
+	warning << string_compose (_("TraceRecorder: no ring-buffer available for thread '%1'"), pthread_name ()) << endmsg;
+}
+
+void
+TraceRecorder::release_thread (void* v)
+{
+	const int slot = GPOINTER_TO_INT (v) - 1;
+	assert (slot >= 0 && slot < max_threads);
+	g_atomic_int_set (&_slot_used[slot], 0);
+}
+
+/* realtime safe, threads are registered when they are created */
+TraceRecorder::ThreadRing*
+TraceRecorder::thread_ring ()
+{
+	const int v = GPOINTER_TO_INT (g_private_get (&_thread_slot));
+	return v > 0 ? &_rings[v - 1] : 0;
+}
+
+void
+TraceRecorder::record (const char* name, const char* label, int64_t start, int64_t end)
+{
+	if (!active ()) {
+		return;
+	}
+
+	g_atomic_int_inc (&_n_writers);
+
+	/* re-check, stop () may have been called in the meantime */
+	ThreadRing* r = active () ? thread_ring () : 0;
+	if (!r) {
+		g_atomic_int_dec_and_test (&_n_writers);
+		return;
+	}
+
+	Event& e (r->events[r->n_written % _ring_size]);
+	e.name  = name;
+	e.start = start;
+	e.end   = end;
+	if (label) {
+		strncpy (e.label, label, sizeof (e.label) - 1);
+		e.label[sizeof (e.label) - 1] = '\0';
+	} else {
+		e.label[0] = '\0';
+	}
+
+	++r->n_written;
+
+	g_atomic_int_dec_and_test (&_n_writers);
+}
+
+static void
+write_json_string (std::ofstream& f, const char* s)
+{
+	f << '"';
+	for (; *s; ++s) {
+		const unsigned char c = *s;
+		if (c == '"' || c == '\\') {
+			f << '\\' << c;
+		} else if (c < 0x20) {
+			f << ' ';
+		} else {
+			f << c;
+		}
+	}
+	f << '"';
+}
+
+int
+TraceRecorder::dump (std::string const& path)
+{
+	stop ();
+
+	if (!_rings[0].events) {
+		return -1;
+	}
+
+	/* let threads that are currently recording a span finish */
+	wait_for_writers ();
+
+	std::ofstream f (path.c_str ());
+	if (!f) {
+		error << string_compose (_("TraceRecorder: cannot open '%1' for writing"), path) << endmsg;
+		return -1;
+	}
+
+	f << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+
+	bool first = true;
+	for (int t = 0; t < max_threads; ++t) {
+		ThreadRing const& r (_rings[t]);
+
+		if (r.n_written == 0) {
+			continue;
+		}
+
+		if (!first) {
+			f << ",\n";
+		}
+		first = false;
+
+		f << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":" << t << ",\"args\":{\"name\":";
+		write_json_string (f, r.thread_name);
+		f << "}}";
+
+		const uint64_t n = r.n_written;
+		const uint64_t s = n > _ring_size ? n - _ring_size : 0;
+
+		for (uint64_t i = s; i < n; ++i) {
+			Event const& e (r.events[i % _ring_size]);
+			f << ",\n{\"ph\":\"X\",\"cat\":\"ardour\",\"pid\":1,\"tid\":" << t
+				<< ",\"ts\":" << e.start
+				<< ",\"dur\":" << (e.end - e.start)
+				<< ",\"name\":";
+			write_json_string (f, e.name);
+			if (e.label[0]) {
+				f << ",\"args\":{\"label\":";
+				write_json_string (f, e.label);
+				f << "}";
+			}
+			f << "}";
+		}
+	}
+
+	f << "\n]}\n";
+
+	return f.good () ? 0 : -1;
+}
@@ -44,6 +44,7 @@
 #include "ardour/session.h"
 #include "ardour/session_playlists.h"
 #include "ardour/smf_source.h"
+#include "ardour/trace_recorder.h"
 #include "ardour/track.h"
 #include "ardour/types_convert.h"
 #include "ardour/utils.h"
@@ -478,12 +479,14 @@ Track::capture_buffer_load () const
 int
 Track::do_refill ()
 {
+	TraceRecorder::Span span ("Butler::refill", trace_label ());
 	return _disk_reader->do_refill ();
 }
 
 int
 Track::do_flush (RunContext c, bool force)
 {
+	TraceRecorder::Span span ("Butler::flush", trace_label ());
 	return _disk_writer->do_flush (c, force);
 }
 
@@ -22,7 +22,10 @@
  *  e.g. its name, creator etc.
  */
 
+#include <algorithm>
 #include <cassert>
+#include <list>
+#include <set>
 
 #include <sys/types.h>
 
@@ -1103,6 +1106,213 @@ vstfx_get_info (const char* dllpath, enum ARDOUR::PluginType type, enum VSTScanM
 }
 
 
+#ifndef VST_SCANNER_APP
+
+/* *** parallel scan *** */
+
+/** quiet version of vstfx_infofile_for_read(), true if the plugin has an up-to-date info file */
+static bool
+vstfx_infofile_up_to_date (const char* dllpath)
+{
+	string const path = vstfx_infofile_path (dllpath);
+	GStatBuf dllstat;
+	GStatBuf fsistat;
+	return g_stat (dllpath, &dllstat) == 0
+		&& g_stat (path.c_str (), &fsistat) == 0
+		&& dllstat.st_mtime <= fsistat.st_mtime;
+}
+
+static void
+vstfx_write_blacklist (std::string const& bl)
+{
+	string fn = Glib::build_filename (ARDOUR::user_cache_directory (), VST_BLACKLIST);
+	::g_unlink (fn.c_str ());
+	if (bl.empty ()) {
+		return;
+	}
+	FILE * blacklist_fd = NULL;
+	if (! (blacklist_fd = g_fopen (fn.c_str (), "w"))) {
+		PBD::error << _("Cannot open VST blacklist.") << endmsg;;
+		return;
+	}
+	fprintf (blacklist_fd, "%s", bl.c_str ());
+	::fclose (blacklist_fd);
+}
+
+class VSTScanJob {
+public:
+	VSTScanJob (std::string const& p) : path (p), scanner (0), start (0), timeout (0), timed_out (false) {}
+	~VSTScanJob () { delete scanner; }
+
+	/* called from the scanner's reader thread */
+	void collect_output (std::string msg, size_t /*len*/) {
+		Glib::Threads::Mutex::Lock lm (output_lock);
+		output += msg;
+	}
+
+	std::string         path;
+	ARDOUR::SystemExec* scanner;
+	gint64              start;
+	int                 timeout; // deciseconds
+	bool                timed_out;
+
+	Glib::Threads::Mutex      output_lock;
+	std::string               output;
+	PBD::ScopedConnectionList connections;
+};
+
+void
+vstfx_scan_parallel (std::vector<std::string> const& dllpaths, uint32_t n_jobs)
+{
+	std::string scanner_bin_path = ARDOUR::PluginManager::scanner_bin_path;
+
+	if (scanner_bin_path.empty () || n_jobs < 2) {
+		return;
+	}
+
+	std::string blacklist;
+	vstfx_read_blacklist (blacklist);
+
+	std::list<std::string> todo;
+	for (std::vector<std::string>::const_iterator i = dllpaths.begin (); i != dllpaths.end (); ++i) {
+		if (blacklist.find (*i + "\n") != string::npos || vstfx_infofile_up_to_date (i->c_str ())) {
+			continue;
+		}
+		todo.push_back (*i);
+	}
+
+	if (todo.size () < 2) {
+		/* nothing to gain, leave it to vstfx_get_info () */
+		return;
+	}
+
+	size_t const total = todo.size ();
+	n_jobs = std::min<size_t> (n_jobs, total);
+
+	std::list<VSTScanJob*> running;
+	std::set<std::string> scanned;
+	std::set<std::string> failed;
+	size_t n_started = 0;
+	int    poll_cnt  = 0;
+
+	gint64 const start = g_get_monotonic_time ();
+	PBD::info << string_compose (_("VST: scanning %1 plugins using %2 processes"), total, n_jobs) << endmsg;
+
+	while (!todo.empty () || !running.empty ()) {
+		bool const cancelled = ARDOUR::PluginManager::instance ().cancelled ();
+
+		while (!cancelled && !todo.empty () && running.size () < n_jobs) {
+			VSTScanJob* job = new VSTScanJob (todo.front ());
+			todo.pop_front ();
+
+			char **argp= (char**) calloc (3,sizeof (char*));
+			argp[0] = strdup (scanner_bin_path.c_str ());
+			argp[1] = strdup (job->path.c_str ());
+			argp[2] = 0;
+
+			job->scanner = new ARDOUR::SystemExec (scanner_bin_path, argp);
+			job->scanner->ReadStdout.connect_same_thread (job->connections, boost::bind (&VSTScanJob::collect_output, job, _1 ,_2));
+			if (job->scanner->start (2 /* send stderr&stdout via signal */)) {
+				PBD::error << string_compose (_("Cannot launch VST scanner app '%1': %2"), scanner_bin_path, strerror (errno)) << endmsg;
+				delete job;
+				/* remaining plugins are scanned one by one by vstfx_get_info () */
+				todo.clear ();
+				break;
+			}
+			job->start   = g_get_monotonic_time ();
+			job->timeout = PLUGIN_SCAN_TIMEOUT;
+			running.push_back (job);
+
+			ARDOUR::PluginScanMessage (_("VST"), string_compose (_("%1 [%2/%3]"), job->path, ++n_started, total), true);
+		}
+
+		ARDOUR::GUIIdle ();
+		Glib::usleep (100000);
+
+		bool const no_timeout = PLUGIN_SCAN_TIMEOUT <= 0 || ARDOUR::PluginManager::instance ().no_timeout ();
+		int remaining = 0;
+
+		for (std::list<VSTScanJob*>::iterator i = running.begin (); i != running.end ();) {
+			VSTScanJob* job = *i;
+			bool done = !job->scanner->is_running ();
+
+			if (!done && cancelled) {
+				/* info file might be incomplete, the blacklist is restored below */
+				job->scanner->terminate ();
+				vstfx_remove_infofile (job->path.c_str ());
+				delete job;
+				i = running.erase (i);
+				continue;
+			}
+
+			if (!done && !no_timeout && --job->timeout <= 0) {
+				job->timed_out = true;
+				done = true;
+			}
+
+			if (!done) {
+				remaining = std::max (remaining, job->timeout);
+				++i;
+				continue;
+			}
+
+			job->scanner->terminate ();
+			if (job->timed_out) {
+				vstfx_remove_infofile (job->path.c_str ());
+			}
+
+			bool const ok = vstfx_infofile_up_to_date (job->path.c_str ());
+			gint64 const elapsed = (g_get_monotonic_time () - job->start) / 1000;
+
+			{
+				Glib::Threads::Mutex::Lock lm (job->output_lock);
+				if (!job->output.empty ()) {
+					PBD::error << "VST '" << job->path << "': " << job->output;
+				}
+			}
+
+			if (job->timed_out) {
+				PBD::warning << string_compose (_("VST scan of '%1' timed out after %2 ms"), job->path, elapsed) << endmsg;
+			} else {
+				PBD::info << string_compose (_("VST scan of '%1': %2 (%3 ms)"), job->path, ok ? _("OK") : _("failed"), elapsed) << endmsg;
+			}
+
+			scanned.insert (job->path);
+			if (!ok) {
+				failed.insert (job->path);
+			}
+
+			delete job;
+			i = running.erase (i);
+		}
+
+		if (!no_timeout && !running.empty () && (++poll_cnt % 5) == 0) {
+			ARDOUR::PluginScanTimeout (remaining);
+		}
+	}
+
+	/* Scanner processes add themselves to the blacklist, and remove themselves
+	 * when successful. Doing so concurrently is not safe, so rewrite the list from
+	 * its state before the scan and the actual results.
+	 */
+	for (std::set<std::string>::const_iterator i = scanned.begin (); i != scanned.end (); ++i) {
+		size_t const rpl = blacklist.find (*i + "\n");
+		if (rpl != string::npos) {
+			blacklist.replace (rpl, i->size () + 1, "");
+		}
+	}
+	for (std::set<std::string>::const_iterator i = failed.begin (); i != failed.end (); ++i) {
+		blacklist += *i + "\n";
+	}
+	vstfx_write_blacklist (blacklist);
+
+	PBD::info << string_compose (_("VST: scanned %1 of %2 plugins in %3 s, %4 failed"),
+	                             scanned.size (), total, (g_get_monotonic_time () - start) / 1000000.0, failed.size ()) << endmsg;
+}
+
+#endif
+
+
 /* *** public API *** */
 
 void
@@ -620,6 +620,20 @@ VSTPlugin::signal_latency () const
 #endif
 }
 
+samplecnt_t
+VSTPlugin::signal_tail () const
+{
+	/* 0: not supported, 1: no tail */
+	intptr_t tail = _plugin->dispatcher (_plugin, effGetTailSize, 0, 0, NULL, 0.0f);
+	if (tail <= 0) {
+		return -1;
+	}
+	if (tail == 1) {
+		return 0;
+	}
+	return tail;
+}
+
 set<Evoral::Parameter>
 VSTPlugin::automatable () const
 {
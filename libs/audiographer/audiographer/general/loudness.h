@@ -0,0 +1,151 @@
+/*
+ * Copyright (C) 2026 The Ardour Developers
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef AUDIOGRAPHER_LOUDNESS_H
+#define AUDIOGRAPHER_LOUDNESS_H
+
+#include <vector>
+
+#include "audiographer/visibility.h"
+#include "audiographer/types.h"
+
+namespace AudioGrapher
+{
+
+/** Multi-channel EBU R128 loudness measurement (ITU-R BS.1770).
+ *
+ * Computes momentary (400 ms) and short-term (3 s) loudness,
+ * gated integrated loudness and loudness range (EBU Tech 3342).
+ *
+ * The K-weighting filters of all channels are kept in arrays and
+ * processed in groups of 4 channels, allowing the compiler to vectorize
+ * across channels. Loudness is updated every 50 ms (one fragment),
+ * integration uses a histogram with 0.1 LU resolution.
+ *
+ * The algorithm follows Fons Adriaensen's ebu_r128_proc, which is
+ * used by the EBU R128 VAMP plugin.
+ *
+ * Used for realtime metering (ARDOUR::LoudnessMeter) and for export
+ * analysis (LoudnessReader, Analyser).
+ */
+class LIBAUDIOGRAPHER_API LoudnessKernel
+{
+  public:
+	/// Constructor \n not RT safe
+	LoudnessKernel ();
+
+	/// Allocate state for the given number of channels, this also resets all measurements \n not RT safe
+	void init (unsigned int n_channels, float sample_rate);
+	unsigned int n_channels () const { return _n_channels; }
+
+	/** Set the weighting of a channel. \n RT safe
+	 * The default is 1.0 for all channels, and 2.0 (dual mono) if there is only one channel.
+	 * BS.1770 specifies 1.41 for surround channels and 0 for LFE.
+	 */
+	void set_channel_gain (unsigned int c, float gain);
+
+	/// Clear filter state and all measurements \n RT safe
+	void reset ();
+	/// Clear integrated loudness, range and max values \n RT safe
+	void reset_integration ();
+
+	/// Enable or disable integration (off by default) \n RT safe
+	void set_integrating (bool yn) { _integrating = yn; }
+	bool integrating () const { return _integrating; }
+
+	/** Process a block of samples. \n RT safe
+	 * @param data one pointer per channel
+	 * @param n_samples number of samples to process
+	 * @param stride distance between consecutive samples of a channel (use the channel count for interleaved data)
+	 */
+	void process (float const* const* data, samplecnt_t n_samples, unsigned int stride = 1);
+
+	/* loudness in LUFS, LU for range; -200 if there is no data */
+	float momentary () const      { return _loudness_M; }
+	float max_momentary () const  { return _maxloudn_M; }
+	float short_term () const     { return _loudness_S; }
+	float max_short_term () const { return _maxloudn_S; }
+	float integrated () const     { return _integrated; }
+	float range_min () const      { return _range_min; }
+	float range_max () const      { return _range_max; }
+
+	/// number of 50 ms fragments processed since the last reset, loudness values are updated after each fragment
+	uint64_t n_fragments () const { return _n_fragments; }
+
+	/// Histogram of short-term loudness, 0.1 LU per bin, bin 0 = -70 LUFS
+	int const* histogram_short_term () const { return &_hist_S.bins[0]; }
+	int histogram_short_term_count () const { return _hist_S.count; }
+
+	static const int histogram_size = 751;
+
+  private:
+	struct Histogram {
+		Histogram () : bins (histogram_size, 0), count (0) {}
+
+		void  reset ();
+		void  add (float v);
+		float integrate (int i) const;
+		void  calc_integ (float* vi) const;
+		void  calc_range (float* v0, float* v1) const;
+
+		std::vector<int> bins;
+		int              count;
+	};
+
+	void  fragment_done ();
+	float add_fragments (int n) const;
+	float detect (samplecnt_t offset, samplecnt_t n_samples);
+
+	unsigned int _n_channels;
+	unsigned int _n_padded;  // multiple of 4
+	float        _zero;
+
+	/* K-weighting filter coefficients and per channel state */
+	float _a0, _a1, _a2, _b1, _b2, _c3, _c4;
+	std::vector<float> _z1, _z2, _z3, _z4;
+	std::vector<float> _gain;
+	std::vector<float const*>  _ptr;    // per padded channel
+	std::vector<unsigned int>  _stride; // per padded channel
+
+	int      _fragment;  // fragment size, 1/20 second
+	int      _frcnt;     // samples remaining in current fragment
+	float    _frpwr;     // power accumulated for current fragment
+	float    _power[64]; // fragment power ringbuffer
+	int      _wrind;
+	int      _div1;      // momentary histogram, every 2 fragments (100 ms)
+	int      _div2;      // short-term histogram, every 10 fragments (500 ms)
+	uint64_t _n_fragments;
+	bool     _integrating;
+
+	float _loudness_M;
+	float _maxloudn_M;
+	float _loudness_S;
+	float _maxloudn_S;
+	float _integrated;
+	float _range_min;
+	float _range_max;
+
+	Histogram _hist_M;
+	Histogram _hist_S;
+
+	static float _bin_power[100];
+};
+
+} // namespace
+
+#endif // AUDIOGRAPHER_LOUDNESS_H
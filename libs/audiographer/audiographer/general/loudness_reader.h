@@ -19,12 +19,12 @@
 #ifndef AUDIOGRAPHER_LOUDNESS_READER_H
 #define AUDIOGRAPHER_LOUDNESS_READER_H
 
-#include <vamp-hostsdk/PluginLoader.h>
-
 #include "audiographer/visibility.h"
 #include "audiographer/sink.h"
 #include "audiographer/routines.h"
 #include "audiographer/utils/listed_source.h"
+#include "audiographer/general/loudness.h"
+#include "audiographer/general/true_peak.h"
 
 namespace AudioGrapher
 {
@@ -47,14 +47,16 @@ class LIBAUDIOGRAPHER_API LoudnessReader : public ListedSource<float>, public Si
 	using Sink<float>::process;
 
   protected:
-	Vamp::Plugin*  _ebur_plugin;
-	Vamp::Plugin** _dbtp_plugin;
+	LoudnessKernel _ebur;
+	bool           _have_loudness;
+
+	TruePeakKernel     _tp;
+	std::vector<float> _dbtp; // per channel true-peak
 
 	float        _sample_rate;
 	unsigned int _channels;
 	samplecnt_t   _bufsize;
 	samplecnt_t   _pos;
-	float*       _bufs[2];
 };
 
 } // namespace
@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2026 The Ardour Developers
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef AUDIOGRAPHER_SPILL_BUFFER_H
+#define AUDIOGRAPHER_SPILL_BUFFER_H
+
+#include <string>
+#include <vector>
+
+#include <glibmm/threads.h>
+#include <boost/shared_ptr.hpp>
+
+#include "pbd/signals.h"
+
+#include "audiographer/visibility.h"
+#include "audiographer/flag_debuggable.h"
+#include "audiographer/sink.h"
+#include "audiographer/throwing.h"
+#include "audiographer/utils/listed_source.h"
+
+namespace AudioGrapher
+{
+
+/// Amount of memory that may be used by several SpillBuffers together
+class LIBAUDIOGRAPHER_API SpillBudget
+{
+  public:
+	SpillBudget (size_t bytes) : _available (bytes) {}
+
+	/// Reserve memory, returns false if not enough is available \n thread safe
+	bool take (size_t bytes);
+	/// Return memory to the budget \n thread safe
+	void give (size_t bytes);
+
+	size_t available () const { return _available; }
+
+  private:
+	Glib::Threads::Mutex _lock;
+	size_t               _available;
+};
+
+/** Buffer for the complete output of a first processing pass, for reading it back
+ * in a second pass (e.g. to normalize it).
+ *
+ * Data is kept in memory as long as the SpillBudget allows, the remainder is
+ * written to a raw float file (no libsndfile) that is memory-mapped for reading.
+ * Data is interleaved, sample counts are given in items (samples * channels),
+ * as with TmpFile.
+ *
+ * Not suitable for realtime export: memory is allocated while processing.
+ */
+class LIBAUDIOGRAPHER_API SpillBuffer
+  : public ListedSource<float>
+  , public Sink<float>
+  , public Throwing<>
+  , public FlagDebuggable<>
+{
+  public:
+	/** Constructor \n not RT safe
+	 * @param budget memory budget, shared with other buffers
+	 * @param filename_template template for the spill file, must end in "XXXXXX" (see mkstemp)
+	 */
+	SpillBuffer (ChannelCount channels, boost::shared_ptr<SpillBudget> budget, std::string const & filename_template);
+	~SpillBuffer ();
+
+	/// Append data. EndOfInput finishes writing and emits Written
+	void process (ProcessContext<float> const & c);
+	using Sink<float>::process;
+
+	/** Read data into buffer in \a context, only the data is modified (not sample count).
+	 *  The data read is output to the outputs, as well as read into the context.
+	 *  EndOfInput is set when the end is reached.
+	 *  \return number of samples read
+	 */
+	samplecnt_t read (ProcessContext<float> & context);
+
+	/// Start reading at the beginning
+	void rewind () { _read_pos = 0; }
+
+	samplecnt_t get_samples_written () const { return _samples_written; }
+	samplecnt_t samples_in_memory () const   { return _samples_in_memory; }
+	samplecnt_t samples_spilled () const     { return _samples_written - _samples_in_memory; }
+
+	PBD::Signal0<void> Written;
+
+	static const samplecnt_t block_size = 262144; // items per memory block (1 MiB)
+
+  private:
+	void spill (float const * data, samplecnt_t n);
+	void finish_spill ();
+	void read_spilled (float * data, samplecnt_t pos, samplecnt_t n);
+
+	ChannelCount                   _channels;
+	boost::shared_ptr<SpillBudget> _budget;
+	std::vector<float *>           _blocks;
+	samplecnt_t                    _samples_written;
+	samplecnt_t                    _samples_in_memory;
+	samplecnt_t                    _read_pos;
+	bool                           _spilling;
+
+	std::string _filename_template;
+	std::string _filename;
+	int         _fd;
+	void *      _map;
+	size_t      _map_size;
+};
+
+} // namespace
+
+#endif // AUDIOGRAPHER_SPILL_BUFFER_H
@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2026 The Ardour Developers
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef AUDIOGRAPHER_TRUE_PEAK_H
+#define AUDIOGRAPHER_TRUE_PEAK_H
+
+#include <vector>
+
+#include "audiographer/visibility.h"
+#include "audiographer/types.h"
+
+namespace AudioGrapher
+{
+
+/** Multi-channel true-peak detector (ITU-R BS.1770, Annex 2).
+ *
+ * The signal is 4x oversampled using a polyphase FIR (windowed sinc,
+ * 16 taps per phase). All 4 phases of a given input sample are computed
+ * together, so the inner loop maps directly to one SIMD vector.
+ *
+ * Under-read is at most 0.3 dB (the limit of 4x oversampling for
+ * signals close to Nyquist), over-read is less than 0.02 dB.
+ *
+ * The same kernel is used for realtime metering (ARDOUR::PeakMeter)
+ * and for export analysis (LoudnessReader, Analyser).
+ */
+class LIBAUDIOGRAPHER_API TruePeakKernel
+{
+  public:
+	/// Constructor \n not RT safe
+	TruePeakKernel ();
+	~TruePeakKernel ();
+
+	/// Allocate filter state for the given number of channels, this also resets the state \n not RT safe
+	void set_channels (unsigned int n_channels);
+	unsigned int n_channels () const { return _n_channels; }
+
+	/// Clear the filter history of all channels \n RT safe
+	void reset ();
+
+	/** Process a block of samples of a single channel. \n RT safe
+	 * @param c channel, must be less than n_channels ()
+	 * @param data input samples, \a stride apart (use the channel count for interleaved data)
+	 * @param n_samples number of samples to process
+	 * @param stride distance between consecutive samples in \a data
+	 * @return absolute (linear) true-peak of this block
+	 */
+	float process (unsigned int c, float const* data, samplecnt_t n_samples, unsigned int stride = 1);
+
+	/// number of FIR taps per phase
+	static const unsigned int taps = 16;
+	/// delay of the oversampled signal, in input samples
+	static const unsigned int latency = taps / 2;
+
+  private:
+	TruePeakKernel (TruePeakKernel const&);
+	TruePeakKernel& operator= (TruePeakKernel const&);
+
+	static const unsigned int chunk_size = 256;
+
+	float _coeff[taps][4];
+
+	unsigned int       _n_channels;
+	std::vector<float> _history; // (taps - 1) samples per channel
+	float*             _buf;     // (taps - 1 + chunk_size) samples
+};
+
+} // namespace
+
+#endif // AUDIOGRAPHER_TRUE_PEAK_H
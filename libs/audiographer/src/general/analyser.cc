@@ -16,6 +16,8 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
  */
 
+#include <algorithm>
+
 #include "audiographer/general/analyser.h"
 #include "pbd/fastlog.h"
 
@@ -126,9 +128,6 @@ Analyser::process (ProcessContext<float> const & ctx)
 		for (unsigned int c = 0; c < _channels; ++c) {
 			const float v = *d;
 			if (fabsf(v) > _result.peak) { _result.peak = fabsf(v); }
-			if (c < _result.n_channels) {
-				_bufs[c][s] = v;
-			}
 			const unsigned int cc = c & cmask;
 			if (_result.peaks[cc][pbin].min > v) { _result.peaks[cc][pbin].min = *d; }
 			if (_result.peaks[cc][pbin].max < v) { _result.peaks[cc][pbin].max = *d; }
@@ -139,22 +138,21 @@ Analyser::process (ProcessContext<float> const & ctx)
 
 	for (; s < _bufsize; ++s) {
 		_fft_data_in[s] = 0;
-		for (unsigned int c = 0; c < _result.n_channels; ++c) {
-			_bufs[c][s] = 0.f;
-		}
 	}
 
-	if (_ebur_plugin) {
-		_ebur_plugin->process (_bufs, Vamp::RealTime::fromSeconds ((double) _pos / _sample_rate));
+	float const * const data = ctx.data ();
+
+	if (_have_loudness) {
+		float const * p[2] = { data, data + 1 };
+		_ebur.process (p, n_samples, _channels);
 	}
 
-	float const * const data = ctx.data ();
 	for (unsigned int c = 0; c < _channels; ++c) {
-		if (!_dbtp_plugin[c]) { continue; }
-		for (s = 0; s < n_samples; ++s) {
-			_bufs[0][s] = data[s * _channels + c];
+		const float tp = _tp.process (c, data + c, n_samples, _channels);
+		_dbtp[c] = std::max (_dbtp[c], tp);
+		if (tp >= .89125 /* -1dBTP */) {
+			_result.truepeakpos[c & cmask].insert (_pos / _spp);
 		}
-		_dbtp_plugin[c]->process (_bufs, Vamp::RealTime::fromSeconds ((double) _pos / _sample_rate));
 	}
 
 	fftwf_execute (_fft_plan);
@@ -232,37 +230,22 @@ Analyser::result ()
 		}
 	}
 
-	if (_ebur_plugin) {
-		Vamp::Plugin::FeatureSet features = _ebur_plugin->getRemainingFeatures ();
-		if (!features.empty () && features.size () == 3) {
-			_result.loudness = features[0][0].values[0];
-			_result.loudness_range = features[1][0].values[0];
-			assert (features[2][0].values.size () == 540);
-			for (int i = 0; i < 540; ++i) {
-				_result.loudness_hist[i] = features[2][0].values[i];
-				if (_result.loudness_hist[i] > _result.loudness_hist_max) {
-					_result.loudness_hist_max = _result.loudness_hist[i]; }
-			}
-			_result.have_loudness = true;
+	if (_have_loudness) {
+		_result.loudness = _ebur.integrated ();
+		_result.loudness_range = _ebur.range_max () - _ebur.range_min ();
+		/* -59 .. -5 LUFS */
+		int const* hist = _ebur.histogram_short_term ();
+		for (int i = 0; i < 540; ++i) {
+			_result.loudness_hist[i] = hist[i + 110];
+			if (_result.loudness_hist[i] > _result.loudness_hist_max) {
+				_result.loudness_hist_max = _result.loudness_hist[i]; }
 		}
+		_result.have_loudness = true;
 	}
 
-	const unsigned cmask = _result.n_channels - 1; // [0, 1]
 	for (unsigned int c = 0; c < _channels; ++c) {
-		if (!_dbtp_plugin[c]) { continue; }
-		Vamp::Plugin::FeatureSet features = _dbtp_plugin[c]->getRemainingFeatures ();
-		if (!features.empty () && features.size () == 2) {
-			_result.have_dbtp = true;
-			float p = features[0][0].values[0];
-			if (p > _result.truepeak) { _result.truepeak = p; }
-
-			for (std::vector<float>::const_iterator i = features[1][0].values.begin();
-					i != features[1][0].values.end(); ++i) {
-				const samplecnt_t pk = (*i) / _spp;
-				const unsigned int cc = c & cmask;
-				_result.truepeakpos[cc].insert (pk);
-			}
-		}
+		_result.have_dbtp = true;
+		if (_dbtp[c] > _result.truepeak) { _result.truepeak = _dbtp[c]; }
 	}
 
 	return ARDOUR::ExportAnalysisPtr (new ARDOUR::ExportAnalysis (_result));
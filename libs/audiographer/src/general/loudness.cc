@@ -0,0 +1,357 @@
+/*
+ * Copyright (C) 2026 The Ardour Developers
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <math.h>
+
+#include "audiographer/general/loudness.h"
+
+#ifdef COMPILER_MSVC
+#include <float.h>
+#define isfinite_local(val) (bool)_finite((double)val)
+#else
+#define isfinite_local isfinite
+#endif
+
+using namespace AudioGrapher;
+
+const int LoudnessKernel::histogram_size;
+float LoudnessKernel::_bin_power[100] = { 0.0f };
+
+void
+LoudnessKernel::Histogram::reset ()
+{
+	std::fill (bins.begin (), bins.end (), 0);
+	count = 0;
+}
+
+void
+LoudnessKernel::Histogram::add (float v)
+{
+	int k = (int) floorf (10 * v + 700.5f);
+	if (k < 0) {
+		return;
+	}
+	if (k >= histogram_size) {
+		k = histogram_size - 1;
+	}
+	++bins[k];
+	++count;
+}
+
+float
+LoudnessKernel::Histogram::integrate (int i) const
+{
+	int   j = i % 100;
+	int   n = 0;
+	float s = 0;
+
+	while (i < histogram_size) {
+		const int k = bins[i++];
+		n += k;
+		s += k * _bin_power[j++];
+		if (j == 100) {
+			j = 0;
+			s /= 10.0f;
+		}
+	}
+	return s / n;
+}
+
+void
+LoudnessKernel::Histogram::calc_integ (float* vi) const
+{
+	if (count < 50) {
+		*vi = -200.0f;
+		return;
+	}
+	/* relative gate: -10 LU below the ungated result */
+	float s = integrate (0);
+	int   k = (int)(floorf (100 * log10f (s) + 0.5f)) + 600;
+	if (k < 0) {
+		k = 0;
+	}
+	s = integrate (k);
+	*vi = 10 * log10f (s);
+}
+
+void
+LoudnessKernel::Histogram::calc_range (float* v0, float* v1) const
+{
+	if (count < 20) {
+		*v0 = -200.0f;
+		*v1 = -200.0f;
+		return;
+	}
+	/* relative gate: -20 LU, range between the 10% and 95% percentile */
+	float s = integrate (0);
+	int   k = (int)(floorf (100 * log10f (s) + 0.5)) + 500;
+	if (k < 0) {
+		k = 0;
+	}
+	int i, j, n = 0;
+	for (i = k; i < histogram_size; ++i) {
+		n += bins[i];
+	}
+	const float a = 0.10f * n;
+	const float b = 0.95f * n;
+	for (i = k, s = 0; s < a; ++i) {
+		s += bins[i];
+	}
+	for (j = histogram_size - 1, s = n; s > b; --j) {
+		s -= bins[j];
+	}
+	*v0 = (i - 701) / 10.0f;
+	*v1 = (j - 699) / 10.0f;
+}
+
+LoudnessKernel::LoudnessKernel ()
+	: _n_channels (0)
+	, _n_padded (0)
+	, _zero (0)
+	, _a0 (0), _a1 (0), _a2 (0), _b1 (0), _b2 (0), _c3 (0), _c4 (0)
+	, _fragment (0)
+	, _integrating (false)
+{
+	if (_bin_power[0] == 0) {
+		for (int i = 0; i < 100; ++i) {
+			_bin_power[i] = powf (10.0f, i / 100.0f);
+		}
+	}
+	reset ();
+}
+
+void
+LoudnessKernel::init (unsigned int n_channels, float fsamp)
+{
+	_n_channels = n_channels;
+	_n_padded   = (n_channels + 3) & ~3;
+	_fragment   = (int) fsamp / 20;
+
+	_z1.assign (_n_padded, 0.f);
+	_z2.assign (_n_padded, 0.f);
+	_z3.assign (_n_padded, 0.f);
+	_z4.assign (_n_padded, 0.f);
+	_gain.assign (_n_padded, 0.f);
+	_ptr.assign (_n_padded, &_zero);
+	_stride.assign (_n_padded, 0);
+
+	for (unsigned int c = 0; c < n_channels; ++c) {
+		_gain[c] = n_channels == 1 ? 2.f : 1.f;
+	}
+
+	/* K-weighting: high-shelf and high-pass, combined into a
+	 * biquad followed by a 2nd order section (bilinear transform,
+	 * pre-warped for the given sample-rate) */
+	float a, b, c, d, r, u1, u2, w1, w2;
+
+	r  = 1 / tan (4712.3890f / fsamp);
+	w1 = r / 1.12201f;
+	w2 = r * 1.12201f;
+	u1 = u2 = 1.4085f + 210.0f / fsamp;
+	a  = u1 * w1;
+	b  = w1 * w1;
+	c  = u2 * w2;
+	d  = w2 * w2;
+	r  = 1 + a + b;
+	_a0 = (1 + c + d) / r;
+	_a1 = (2 - 2 * d) / r;
+	_a2 = (1 - c + d) / r;
+	_b1 = (2 - 2 * b) / r;
+	_b2 = (1 - a + b) / r;
+	r = 48.0f / fsamp;
+	a = 4.9886075f * r;
+	b = 6.2298014f * r * r;
+	r = 1 + a + b;
+	a *= 2 / r;
+	b *= 4 / r;
+	_c3 = a + b;
+	_c4 = b;
+	r = 1.004995f / r;
+	_a0 *= r;
+	_a1 *= r;
+	_a2 *= r;
+
+	reset ();
+}
+
+void
+LoudnessKernel::set_channel_gain (unsigned int c, float gain)
+{
+	if (c < _n_channels) {
+		_gain[c] = gain;
+	}
+}
+
+void
+LoudnessKernel::reset ()
+{
+	_frcnt = _fragment;
+	_frpwr = 1e-30f;
+	_wrind = 0;
+	_n_fragments = 0;
+	_loudness_M = -200.0f;
+	_loudness_S = -200.0f;
+	memset (_power, 0, sizeof (_power));
+
+	std::fill (_z1.begin (), _z1.end (), 0.f);
+	std::fill (_z2.begin (), _z2.end (), 0.f);
+	std::fill (_z3.begin (), _z3.end (), 0.f);
+	std::fill (_z4.begin (), _z4.end (), 0.f);
+
+	reset_integration ();
+}
+
+void
+LoudnessKernel::reset_integration ()
+{
+	_hist_M.reset ();
+	_hist_S.reset ();
+	_maxloudn_M = -200.0f;
+	_maxloudn_S = -200.0f;
+	_integrated = -200.0f;
+	_range_min  = -200.0f;
+	_range_max  = -200.0f;
+	_div1 = _div2 = 0;
+}
+
+void
+LoudnessKernel::process (float const* const* data, samplecnt_t n_samples, unsigned int stride)
+{
+	if (_fragment == 0) {
+		return;
+	}
+
+	for (unsigned int c = 0; c < _n_channels; ++c) {
+		_ptr[c]    = data[c];
+		_stride[c] = stride;
+	}
+
+	samplecnt_t offset = 0;
+	while (n_samples > 0) {
+		const samplecnt_t k = std::min<samplecnt_t> (_frcnt, n_samples);
+		_frpwr += detect (offset, k);
+		_frcnt -= k;
+		if (_frcnt == 0) {
+			fragment_done ();
+		}
+		offset    += k;
+		n_samples -= k;
+	}
+}
+
+void
+LoudnessKernel::fragment_done ()
+{
+	_power[_wrind++] = _frpwr / _fragment;
+	_frcnt = _fragment;
+	_frpwr = 1e-30f;
+	_wrind &= 63;
+	++_n_fragments;
+
+	_loudness_M = add_fragments (8);
+	_loudness_S = add_fragments (60);
+
+	if (!isfinite_local (_loudness_M) || _loudness_M < -200.f) {
+		_loudness_M = -200.0f;
+	}
+	if (!isfinite_local (_loudness_S) || _loudness_S < -200.f) {
+		_loudness_S = -200.0f;
+	}
+
+	_maxloudn_M = std::max (_maxloudn_M, _loudness_M);
+	_maxloudn_S = std::max (_maxloudn_S, _loudness_S);
+
+	if (!_integrating) {
+		return;
+	}
+
+	if (++_div1 == 2) {
+		_hist_M.add (_loudness_M);
+		_div1 = 0;
+	}
+	if (++_div2 == 10) {
+		_hist_S.add (_loudness_S);
+		_div2 = 0;
+		_hist_M.calc_integ (&_integrated);
+		_hist_S.calc_range (&_range_min, &_range_max);
+	}
+}
+
+float
+LoudnessKernel::add_fragments (int n) const
+{
+	float s = 0;
+	const int k = (_wrind - n) & 63;
+	for (int i = 0; i < n; ++i) {
+		s += _power[(i + k) & 63];
+	}
+	return -0.6976f + 10 * log10f (s / n);
+}
+
+float
+LoudnessKernel::detect (samplecnt_t offset, samplecnt_t n_samples)
+{
+	const float a0 = _a0, a1 = _a1, a2 = _a2;
+	const float b1 = _b1, b2 = _b2, c3 = _c3, c4 = _c4;
+
+	float si = 0;
+
+	for (unsigned int c0 = 0; c0 < _n_padded; c0 += 4) {
+		float z1[4], z2[4], z3[4], z4[4], sj[4];
+		float const* p[4];
+		unsigned int s[4];
+
+		for (int l = 0; l < 4; ++l) {
+			z1[l] = _z1[c0 + l];
+			z2[l] = _z2[c0 + l];
+			z3[l] = _z3[c0 + l];
+			z4[l] = _z4[c0 + l];
+			sj[l] = 0;
+			s[l]  = _stride[c0 + l];
+			p[l]  = _ptr[c0 + l] + offset * s[l];
+		}
+
+		for (samplecnt_t j = 0; j < n_samples; ++j) {
+			float x[4];
+			for (int l = 0; l < 4; ++l) {
+				x[l] = p[l][j * s[l]];
+			}
+			for (int l = 0; l < 4; ++l) {
+				const float xx = x[l] - b1 * z1[l] - b2 * z2[l] + 1e-15f;
+				const float y  = a0 * xx + a1 * z1[l] + a2 * z2[l] - c3 * z3[l] - c4 * z4[l];
+				z2[l] = z1[l];
+				z1[l] = xx;
+				z4[l] += z3[l];
+				z3[l] += y;
+				sj[l] += y * y;
+			}
+		}
+
+		for (int l = 0; l < 4; ++l) {
+			si += _gain[c0 + l] * sj[l];
+			_z1[c0 + l] = isfinite_local (z1[l]) ? z1[l] : 0;
+			_z2[c0 + l] = isfinite_local (z2[l]) ? z2[l] : 0;
+			_z3[c0 + l] = isfinite_local (z3[l]) ? z3[l] : 0;
+			_z4[c0 + l] = isfinite_local (z4[l]) ? z4[l] : 0;
+		}
+	}
+
+	return si;
+}
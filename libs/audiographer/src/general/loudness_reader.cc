@@ -16,14 +16,15 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
  */
 
+#include <algorithm>
+
 #include "audiographer/general/loudness_reader.h"
 #include "pbd/fastlog.h"
 
 using namespace AudioGrapher;
 
 LoudnessReader::LoudnessReader (float sample_rate, unsigned int channels, samplecnt_t bufsize)
-	: _ebur_plugin (0)
-	, _dbtp_plugin (0)
+	: _have_loudness (false)
 	, _sample_rate (sample_rate)
 	, _channels (channels)
 	, _bufsize (bufsize / channels)
@@ -35,57 +36,28 @@ LoudnessReader::LoudnessReader (float sample_rate, unsigned int channels, sample
 	assert (_bufsize > 0);
 
 	if (channels > 0 && channels <= 2) {
-		using namespace Vamp::HostExt;
-		PluginLoader* loader (PluginLoader::getInstance ());
-		_ebur_plugin = loader->loadPlugin ("libardourvampplugins:ebur128", sample_rate, PluginLoader::ADAPT_ALL_SAFE);
-		assert (_ebur_plugin);
-		_ebur_plugin->reset ();
-		if (!_ebur_plugin->initialise (channels, _bufsize, _bufsize)) {
-			delete _ebur_plugin;
-			_ebur_plugin = 0;
-		}
+		_ebur.init (channels, sample_rate);
+		_ebur.set_integrating (true);
+		_have_loudness = true;
 	}
 
-	_dbtp_plugin = (Vamp::Plugin**) malloc (sizeof(Vamp::Plugin*) * channels);
-	for (unsigned int c = 0; c < _channels; ++c) {
-		using namespace Vamp::HostExt;
-		PluginLoader* loader (PluginLoader::getInstance ());
-		_dbtp_plugin[c] = loader->loadPlugin ("libardourvampplugins:dBTP", sample_rate, PluginLoader::ADAPT_ALL_SAFE);
-		assert (_dbtp_plugin[c]);
-		_dbtp_plugin[c]->reset ();
-		if (!_dbtp_plugin[c]->initialise (1, _bufsize, _bufsize)) {
-			delete _dbtp_plugin[c];
-			_dbtp_plugin[c] = 0;
-		}
-	}
-
-	_bufs[0] = (float*) malloc (sizeof (float) * _bufsize);
-	_bufs[1] = (float*) malloc (sizeof (float) * _bufsize);
+	_tp.set_channels (channels);
+	_dbtp.assign (channels, 0.f);
 }
 
 LoudnessReader::~LoudnessReader ()
 {
-	delete _ebur_plugin;
-	for (unsigned int c = 0; c < _channels; ++c) {
-		delete _dbtp_plugin[c];
-	}
-	free (_dbtp_plugin);
-	free (_bufs[0]);
-	free (_bufs[1]);
 }
 
 void
 LoudnessReader::reset ()
 {
-	if (_ebur_plugin) {
-		_ebur_plugin->reset ();
+	if (_have_loudness) {
+		_ebur.reset ();
 	}
 
-	for (unsigned int c = 0; c < _channels; ++c) {
-		if (_dbtp_plugin[c]) {
-			_dbtp_plugin[c]->reset ();
-		}
-	}
+	_tp.reset ();
+	std::fill (_dbtp.begin (), _dbtp.end (), 0.f);
 }
 
 void
@@ -97,44 +69,16 @@ LoudnessReader::process (ProcessContext<float> const & ctx)
 	assert (n_samples <= _bufsize);
 	//printf ("PROC %p @%ld F: %ld, S: %ld C:%d\n", this, _pos, ctx.samples (), n_samples, ctx.channels ());
 
-	unsigned processed_channels = 0;
-	if (_ebur_plugin) {
+	float const * const d = ctx.data ();
+
+	if (_have_loudness) {
 		assert (_channels <= 2);
-		processed_channels = _channels;
-		samplecnt_t s;
-		float const * d = ctx.data ();
-		for (s = 0; s < n_samples; ++s) {
-			for (unsigned int c = 0; c < _channels; ++c, ++d) {
-				_bufs[c][s] = *d;
-			}
-		}
-		for (; s < _bufsize; ++s) {
-			for (unsigned int c = 0; c < _channels; ++c) {
-				_bufs[c][s] = 0.f;
-			}
-		}
-		_ebur_plugin->process (_bufs, Vamp::RealTime::fromSeconds ((double) _pos / _sample_rate));
-		if (_dbtp_plugin[0]) {
-			_dbtp_plugin[0]->process (&_bufs[0], Vamp::RealTime::fromSeconds ((double) _pos / _sample_rate));
-		}
-		if (_channels == 2 && _dbtp_plugin[1]) {
-			_dbtp_plugin[0]->process (&_bufs[1], Vamp::RealTime::fromSeconds ((double) _pos / _sample_rate));
-		}
+		float const * p[2] = { d, d + 1 };
+		_ebur.process (p, n_samples, _channels);
 	}
 
-	for (unsigned int c = processed_channels; c < _channels; ++c) {
-		if (!_dbtp_plugin[c]) {
-			continue;
-		}
-		samplecnt_t s;
-		float const * const d = ctx.data ();
-		for (s = 0; s < n_samples; ++s) {
-			_bufs[0][s] = d[s * _channels + c];
-		}
-		for (; s < _bufsize; ++s) {
-			_bufs[0][s] = 0.f;
-		}
-		_dbtp_plugin[c]->process (_bufs, Vamp::RealTime::fromSeconds ((double) _pos / _sample_rate));
+	for (unsigned int c = 0; c < _channels; ++c) {
+		_dbtp[c] = std::max (_dbtp[c], _tp.process (c, d + c, n_samples, _channels));
 	}
 
 	_pos += n_samples;
@@ -149,24 +93,14 @@ LoudnessReader::get_normalize_gain (float target_lufs, float target_dbtp)
 	uint32_t have_lufs = 0;
 	uint32_t have_dbtp = 0;
 
-	if (_ebur_plugin) {
-		Vamp::Plugin::FeatureSet features = _ebur_plugin->getRemainingFeatures ();
-		if (!features.empty () && features.size () == 3) {
-			const float lufs = features[0][0].values[0];
-			LUFS = std::max (LUFS, lufs);
-			++have_lufs;
-		}
+	if (_have_loudness) {
+		LUFS = std::max (LUFS, _ebur.integrated ());
+		++have_lufs;
 	}
 
 	for (unsigned int c = 0; c < _channels; ++c) {
-		if (_dbtp_plugin[c]) {
-			Vamp::Plugin::FeatureSet features = _dbtp_plugin[c]->getRemainingFeatures ();
-			if (!features.empty () && features.size () == 2) {
-				const float dbtp = features[0][0].values[0];
-				dBTP = std::max (dBTP, dbtp);
-				++have_dbtp;
-			}
-		}
+		dBTP = std::max (dBTP, _dbtp[c]);
+		++have_dbtp;
 	}
 
 	float g = 100000.0; // +100dB
@@ -178,7 +112,6 @@ LoudnessReader::get_normalize_gain (float target_lufs, float target_dbtp)
 		set = true;
 	}
 
-	// TODO check that all channels were used.. ? (have_dbtp == _channels)
 	if (have_dbtp && dBTP > 0.f && target_dbtp <= 0.f) {
 		const float ge = pow (10.f, (target_dbtp * 0.05f)) / dBTP;
 		//printf ("TP:(%d chn) %fdBTP -> %f\n", have_dbtp, dBTP, ge);
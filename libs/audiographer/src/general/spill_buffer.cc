@@ -0,0 +1,254 @@
+/*
+ * Copyright (C) 2026 The Ardour Developers
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+#include <fcntl.h>
+#include <glib.h>
+#include "pbd/gstdio_compat.h"
+
+#ifdef PLATFORM_WINDOWS
+#include <io.h>
+#else
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+
+#include "audiographer/general/spill_buffer.h"
+#include "audiographer/exception.h"
+
+namespace AudioGrapher
+{
+
+bool
+SpillBudget::take (size_t bytes)
+{
+	Glib::Threads::Mutex::Lock lm (_lock);
+	if (bytes > _available) {
+		return false;
+	}
+	_available -= bytes;
+	return true;
+}
+
+void
+SpillBudget::give (size_t bytes)
+{
+	Glib::Threads::Mutex::Lock lm (_lock);
+	_available += bytes;
+}
+
+const samplecnt_t SpillBuffer::block_size;
+
+SpillBuffer::SpillBuffer (ChannelCount channels, boost::shared_ptr<SpillBudget> budget, std::string const & filename_template)
+	: _channels (channels)
+	, _budget (budget)
+	, _samples_written (0)
+	, _samples_in_memory (0)
+	, _read_pos (0)
+	, _spilling (false)
+	, _filename_template (filename_template)
+	, _fd (-1)
+	, _map (0)
+	, _map_size (0)
+{
+	add_supported_flag (ProcessContext<float>::EndOfInput);
+}
+
+SpillBuffer::~SpillBuffer ()
+{
+	for (std::vector<float*>::iterator i = _blocks.begin (); i != _blocks.end (); ++i) {
+		free (*i);
+	}
+	_budget->give (_blocks.size () * block_size * sizeof (float));
+
+#ifndef PLATFORM_WINDOWS
+	if (_map) {
+		munmap (_map, _map_size);
+	}
+#endif
+	if (_fd >= 0) {
+		::close (_fd);
+		::g_unlink (_filename.c_str ());
+	}
+}
+
+void
+SpillBuffer::process (ProcessContext<float> const & c)
+{
+	check_flags (*this, c);
+
+	if (throw_level (ThrowStrict) && c.channels () != _channels) {
+		throw Exception (*this, boost::str (boost::format
+			("Wrong number of channels given to process(), %1% instead of %2%")
+			% c.channels () % _channels));
+	}
+
+	float const * data = c.data ();
+	samplecnt_t   n    = c.samples ();
+
+	while (n > 0 && !_spilling) {
+		samplecnt_t const offset = _samples_in_memory % block_size;
+		if (offset == 0) {
+			/* current block is full, or there is none yet */
+			float* block = 0;
+			if (_budget->take (block_size * sizeof (float))) {
+				block = (float*) malloc (block_size * sizeof (float));
+				if (!block) {
+					_budget->give (block_size * sizeof (float));
+				}
+			}
+			if (!block) {
+				/* once spilling, all remaining data goes to the file */
+				_spilling = true;
+				break;
+			}
+			_blocks.push_back (block);
+		}
+		samplecnt_t const k = std::min (n, block_size - offset);
+		memcpy (_blocks.back () + offset, data, k * sizeof (float));
+		_samples_in_memory += k;
+		data += k;
+		n    -= k;
+	}
+
+	if (n > 0) {
+		spill (data, n);
+	}
+
+	_samples_written += c.samples ();
+
+	if (c.has_flag (ProcessContext<float>::EndOfInput)) {
+		finish_spill ();
+		Written (); /* EMIT SIGNAL */
+	}
+}
+
+samplecnt_t
+SpillBuffer::read (ProcessContext<float> & context)
+{
+	if (throw_level (ThrowStrict) && context.channels () != _channels) {
+		throw Exception (*this, boost::str (boost::format
+			("Wrong number of channels given to read(), %1% instead of %2%")
+			% context.channels () % _channels));
+	}
+
+	finish_spill ();
+
+	samplecnt_t const n = std::min (context.samples (), _samples_written - _read_pos);
+	float* data = context.data ();
+	samplecnt_t done = 0;
+
+	while (done < n) {
+		samplecnt_t const pos = _read_pos + done;
+		samplecnt_t k;
+		if (pos < _samples_in_memory) {
+			samplecnt_t const offset = pos % block_size;
+			k = std::min (n - done, std::min (block_size - offset, _samples_in_memory - pos));
+			memcpy (data + done, _blocks[pos / block_size] + offset, k * sizeof (float));
+		} else {
+			k = n - done;
+			read_spilled (data + done, pos - _samples_in_memory, k);
+		}
+		done += k;
+	}
+
+	_read_pos += n;
+
+	ProcessContext<float> c_out = context.beginning (n);
+	if (n < context.samples ()) {
+		c_out.set_flag (ProcessContext<float>::EndOfInput);
+	}
+	output (c_out);
+	return n;
+}
+
+void
+SpillBuffer::spill (float const * data, samplecnt_t n)
+{
+	if (_fd < 0) {
+		std::vector<char> path (_filename_template.begin (), _filename_template.end ());
+		path.push_back ('\0');
+		_fd = g_mkstemp (&path[0]);
+		if (_fd < 0) {
+			throw Exception (*this, "Cannot create spill file");
+		}
+		_filename = &path[0];
+	}
+
+	char const * p = (char const *) data;
+	size_t bytes = n * sizeof (float);
+	while (bytes > 0) {
+		int const w = ::write (_fd, p, std::min<size_t> (bytes, 1048576));
+		if (w <= 0) {
+			throw Exception (*this, "Could not write to spill file");
+		}
+		p     += w;
+		bytes -= w;
+	}
+}
+
+void
+SpillBuffer::finish_spill ()
+{
+	if (_fd < 0 || _map_size > 0) {
+		return;
+	}
+	_map_size = samples_spilled () * sizeof (float);
+#ifndef PLATFORM_WINDOWS
+	void* m = mmap (0, _map_size, PROT_READ, MAP_SHARED, _fd, 0);
+	if (m != MAP_FAILED) {
+		_map = m;
+		madvise (_map, _map_size, MADV_SEQUENTIAL);
+	}
+	/* else fall back to read () */
+#endif
+}
+
+void
+SpillBuffer::read_spilled (float * data, samplecnt_t pos, samplecnt_t n)
+{
+	if (_map) {
+		memcpy (data, (float const *) _map + pos, n * sizeof (float));
+		return;
+	}
+
+#ifdef PLATFORM_WINDOWS
+	bool const ok = _lseeki64 (_fd, (__int64) pos * sizeof (float), SEEK_SET) >= 0;
+#else
+	bool const ok = lseek (_fd, (off_t) pos * sizeof (float), SEEK_SET) >= 0;
+#endif
+	if (!ok) {
+		throw Exception (*this, "Could not seek in spill file");
+	}
+
+	char* p = (char*) data;
+	size_t bytes = n * sizeof (float);
+	while (bytes > 0) {
+		int const r = ::read (_fd, p, std::min<size_t> (bytes, 1048576));
+		if (r <= 0) {
+			throw Exception (*this, "Could not read from spill file");
+		}
+		p     += r;
+		bytes -= r;
+	}
+}
+
+} // namespace
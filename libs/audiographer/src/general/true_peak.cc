@@ -0,0 +1,136 @@
+/*
+ * Copyright (C) 2026 The Ardour Developers
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <math.h>
+
+#include "audiographer/general/true_peak.h"
+
+using namespace AudioGrapher;
+
+const unsigned int TruePeakKernel::taps;
+const unsigned int TruePeakKernel::latency;
+const unsigned int TruePeakKernel::chunk_size;
+
+static double
+sinc (double x)
+{
+	x = fabs (x);
+	if (x < 1e-6) {
+		return 1.0;
+	}
+	x *= M_PI;
+	return sin (x) / x;
+}
+
+static double
+wind (double x)
+{
+	x = fabs (x);
+	if (x >= 1.0) {
+		return 0.0;
+	}
+	x *= M_PI;
+	return 0.384 + 0.500 * cos (x) + 0.116 * cos (2 * x);
+}
+
+TruePeakKernel::TruePeakKernel ()
+	: _n_channels (0)
+{
+	/* Phase p interpolates the signal at (p / 4) samples after
+	 * input sample (taps / 2 - 1). Coefficients are stored interleaved
+	 * by phase: _coeff[k][p]. Each phase is normalized to unity gain at DC.
+	 */
+	const int    center = taps / 2 - 1;
+	const double hl     = taps / 2;
+
+	for (unsigned int p = 0; p < 4; ++p) {
+		double sum = 0;
+		double h[taps];
+		for (unsigned int k = 0; k < taps; ++k) {
+			const double t = (int)k - center - p / 4.0;
+			h[k] = sinc (t) * wind (t / hl);
+			sum += h[k];
+		}
+		for (unsigned int k = 0; k < taps; ++k) {
+			_coeff[k][p] = h[k] / sum;
+		}
+	}
+
+	_buf = new float[taps - 1 + chunk_size];
+}
+
+TruePeakKernel::~TruePeakKernel ()
+{
+	delete [] _buf;
+}
+
+void
+TruePeakKernel::set_channels (unsigned int n_channels)
+{
+	_n_channels = n_channels;
+	_history.assign (n_channels * (taps - 1), 0.f);
+}
+
+void
+TruePeakKernel::reset ()
+{
+	std::fill (_history.begin (), _history.end (), 0.f);
+}
+
+float
+TruePeakKernel::process (unsigned int c, float const* data, samplecnt_t n_samples, unsigned int stride)
+{
+	float* const hist = &_history[c * (taps - 1)];
+	float* const buf  = _buf;
+	float m[4] = { 0, 0, 0, 0 };
+
+	while (n_samples > 0) {
+		const unsigned int n = std::min<samplecnt_t> (n_samples, chunk_size);
+
+		memcpy (buf, hist, sizeof (float) * (taps - 1));
+		if (stride == 1) {
+			memcpy (buf + taps - 1, data, sizeof (float) * n);
+		} else {
+			for (unsigned int i = 0; i < n; ++i) {
+				buf[taps - 1 + i] = data[i * stride];
+			}
+		}
+
+		for (unsigned int i = 0; i < n; ++i) {
+			float a[4] = { 0, 0, 0, 0 };
+			float const* x = &buf[i];
+			for (unsigned int k = 0; k < taps; ++k) {
+				for (unsigned int p = 0; p < 4; ++p) {
+					a[p] += _coeff[k][p] * x[k];
+				}
+			}
+			for (unsigned int p = 0; p < 4; ++p) {
+				m[p] = std::max (m[p], fabsf (a[p]));
+			}
+		}
+
+		memcpy (hist, buf + n, sizeof (float) * (taps - 1));
+
+		data += n * stride;
+		n_samples -= n;
+	}
+
+	return std::max (std::max (m[0], m[1]), std::max (m[2], m[3]));
+}
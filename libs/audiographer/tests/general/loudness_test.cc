@@ -0,0 +1,157 @@
+#include "tests/utils.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "audiographer/general/loudness.h"
+
+using namespace AudioGrapher;
+
+class LoudnessTest : public CppUnit::TestFixture
+{
+  CPPUNIT_TEST_SUITE (LoudnessTest);
+  CPPUNIT_TEST (testSine);
+  CPPUNIT_TEST (testGating);
+  CPPUNIT_TEST (testInterleaved);
+  CPPUNIT_TEST (testMultiChannel);
+  CPPUNIT_TEST_SUITE_END ();
+
+  public:
+	void setUp()
+	{
+		rate = 48000;
+		samples = 20 * rate;
+		left = new float[samples];
+		right = new float[samples];
+	}
+
+	void tearDown()
+	{
+		delete [] left;
+		delete [] right;
+	}
+
+	void fill (float* d, samplecnt_t n, float freq, float dbfs)
+	{
+		const float g = powf (10.f, .05f * dbfs);
+		for (samplecnt_t i = 0; i < n; ++i) {
+			d[i] = g * sinf (2.0 * M_PI * freq * i / rate);
+		}
+	}
+
+	void run (LoudnessKernel& k, samplecnt_t block)
+	{
+		for (samplecnt_t i = 0; i < samples; i += block) {
+			float const* p[2] = { &left[i], &right[i] };
+			k.process (p, std::min (block, samples - i));
+		}
+	}
+
+	void testSine()
+	{
+		/* EBU Tech 3341, case 1: stereo 1 kHz sine at -23 dBFS reads -23 LUFS */
+		fill (left, samples, 1000, -23);
+		fill (right, samples, 1000, -23);
+
+		LoudnessKernel k;
+		k.init (2, rate);
+		k.set_integrating (true);
+		run (k, 1024);
+
+		CPPUNIT_ASSERT_DOUBLES_EQUAL (-23.0, k.momentary (), 0.1);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL (-23.0, k.short_term (), 0.1);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL (-23.0, k.integrated (), 0.1);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL (-23.0, k.range_max (), 0.1);
+		CPPUNIT_ASSERT (k.range_min () < k.range_max ()); // short-term ramp-up during the first 3 sec
+		CPPUNIT_ASSERT_EQUAL ((uint64_t) 400, k.n_fragments ());
+
+		/* integration is off by default, max values are tracked regardless */
+		LoudnessKernel m;
+		m.init (2, rate);
+		run (m, 1024);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL (-200.0, m.integrated (), 0.1);
+		CPPUNIT_ASSERT_EQUAL (0, m.histogram_short_term_count ());
+		CPPUNIT_ASSERT_DOUBLES_EQUAL (-23.0, m.max_short_term (), 0.1);
+	}
+
+	void testGating()
+	{
+		/* 10 s at -20 dBFS followed by 10 s of -80 dBFS: the quiet part is
+		 * below the absolute gate and does not contribute */
+		fill (left, samples / 2, 1000, -20);
+		fill (&left[samples / 2], samples / 2, 1000, -80);
+		memcpy (right, left, samples * sizeof (float));
+
+		LoudnessKernel k;
+		k.init (2, rate);
+		k.set_integrating (true);
+		run (k, 512);
+
+		CPPUNIT_ASSERT_DOUBLES_EQUAL (-20.0, k.integrated (), 0.2); // transition blocks pass the relative gate
+		CPPUNIT_ASSERT_DOUBLES_EQUAL (-20.0, k.max_momentary (), 0.1);
+		CPPUNIT_ASSERT (k.momentary () < -70);
+
+		k.reset_integration ();
+		CPPUNIT_ASSERT_DOUBLES_EQUAL (-200.0, k.integrated (), 0.1);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL (-200.0, k.max_momentary (), 0.1);
+	}
+
+	void testInterleaved()
+	{
+		fill (left, samples / 2, 1000, -18);
+		fill (right, samples / 2, 500, -26);
+
+		float* interleaved = new float[samples];
+		for (samplecnt_t i = 0; i < samples / 2; ++i) {
+			interleaved[2 * i]     = left[i];
+			interleaved[2 * i + 1] = right[i];
+		}
+
+		LoudnessKernel a;
+		a.init (2, rate);
+		a.set_integrating (true);
+		LoudnessKernel b;
+		b.init (2, rate);
+		b.set_integrating (true);
+
+		for (samplecnt_t i = 0; i < samples / 2; i += 1000) {
+			samplecnt_t n = std::min<samplecnt_t> (1000, samples / 2 - i);
+			float const* p[2] = { &left[i], &right[i] };
+			a.process (p, n);
+			float const* q[2] = { &interleaved[2 * i], &interleaved[2 * i + 1] };
+			b.process (q, n, 2);
+		}
+
+		CPPUNIT_ASSERT_EQUAL (a.momentary (), b.momentary ());
+		CPPUNIT_ASSERT_EQUAL (a.short_term (), b.short_term ());
+		CPPUNIT_ASSERT_EQUAL (a.integrated (), b.integrated ());
+		delete [] interleaved;
+	}
+
+	void testMultiChannel()
+	{
+		/* 6 identical channels (one complete group of 4, one padded group),
+		 * each at -29 dBFS: 10 * log10 (6) ~= 7.8 dB louder than a single one */
+		fill (left, samples / 4, 1000, -29);
+
+		LoudnessKernel k;
+		k.init (6, rate);
+		float const* p[6] = { left, left, left, left, left, left };
+		k.process (p, samples / 4);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL (-29.0 - 3.01 + 10 * log10 (6), k.momentary (), 0.1);
+
+		/* a channel-gain of zero excludes a channel (LFE) */
+		k.init (6, rate);
+		k.set_channel_gain (3, 0);
+		k.process (p, samples / 4);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL (-29.0 - 3.01 + 10 * log10 (5), k.momentary (), 0.1);
+	}
+
+  private:
+	float * left;
+	float * right;
+	samplecnt_t samples;
+	float rate;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION (LoudnessTest);
@@ -0,0 +1,131 @@
+#include <glibmm/miscutils.h>
+
+#include "tests/utils.h"
+#include "audiographer/general/spill_buffer.h"
+
+using namespace AudioGrapher;
+
+class SpillBufferTest : public CppUnit::TestFixture
+{
+  CPPUNIT_TEST_SUITE (SpillBufferTest);
+  CPPUNIT_TEST (testMemory);
+  CPPUNIT_TEST (testSpill);
+  CPPUNIT_TEST (testPartialSpill);
+  CPPUNIT_TEST (testRewind);
+  CPPUNIT_TEST_SUITE_END ();
+
+  public:
+	void setUp()
+	{
+		samples = 2 * SpillBuffer::block_size + 1234;
+		random_data = TestUtils::init_random_data(samples);
+		sink.reset (new AppendingVectorSink<float>());
+		written = false;
+	}
+
+	void tearDown()
+	{
+		delete [] random_data;
+	}
+
+	void testMemory()
+	{
+		boost::shared_ptr<SpillBudget> budget (new SpillBudget (4 * SpillBuffer::block_size * sizeof (float)));
+		{
+			SpillBuffer buffer (channels, budget, spill_template ());
+			write (buffer);
+			CPPUNIT_ASSERT (written);
+			CPPUNIT_ASSERT_EQUAL (samples, buffer.samples_in_memory ());
+			CPPUNIT_ASSERT_EQUAL ((samplecnt_t) 0, buffer.samples_spilled ());
+			CPPUNIT_ASSERT_EQUAL ((size_t) SpillBuffer::block_size * sizeof (float), budget->available ());
+			read (buffer);
+		}
+		CPPUNIT_ASSERT_EQUAL ((size_t) 4 * SpillBuffer::block_size * sizeof (float), budget->available ());
+	}
+
+	void testSpill()
+	{
+		boost::shared_ptr<SpillBudget> budget (new SpillBudget (0));
+		SpillBuffer buffer (channels, budget, spill_template ());
+		write (buffer);
+		CPPUNIT_ASSERT (written);
+		CPPUNIT_ASSERT_EQUAL ((samplecnt_t) 0, buffer.samples_in_memory ());
+		CPPUNIT_ASSERT_EQUAL (samples, buffer.samples_spilled ());
+		read (buffer);
+	}
+
+	void testPartialSpill()
+	{
+		boost::shared_ptr<SpillBudget> budget (new SpillBudget (SpillBuffer::block_size * sizeof (float)));
+		{
+			SpillBuffer buffer (channels, budget, spill_template ());
+			write (buffer);
+			CPPUNIT_ASSERT_EQUAL (SpillBuffer::block_size, buffer.samples_in_memory ());
+			CPPUNIT_ASSERT_EQUAL (samples - SpillBuffer::block_size, buffer.samples_spilled ());
+			CPPUNIT_ASSERT_EQUAL ((size_t) 0, budget->available ());
+			read (buffer);
+		}
+		CPPUNIT_ASSERT_EQUAL ((size_t) SpillBuffer::block_size * sizeof (float), budget->available ());
+	}
+
+	void testRewind()
+	{
+		boost::shared_ptr<SpillBudget> budget (new SpillBudget (SpillBuffer::block_size * sizeof (float)));
+		SpillBuffer buffer (channels, budget, spill_template ());
+		write (buffer);
+		read (buffer);
+		sink->reset ();
+		buffer.rewind ();
+		read (buffer);
+	}
+
+  private:
+	void on_written () { written = true; }
+
+	static std::string spill_template ()
+	{
+		return Glib::build_filename (Glib::get_tmp_dir (), "spill_buffer_test-XXXXXX");
+	}
+
+	void write (SpillBuffer & buffer)
+	{
+		buffer.Written.connect_same_thread (connection, boost::bind (&SpillBufferTest::on_written, this));
+
+		samplecnt_t const chunk = 1000;
+		for (samplecnt_t pos = 0; pos < samples; pos += chunk) {
+			samplecnt_t const n = std::min (chunk, samples - pos);
+			ProcessContext<float> c (random_data + pos, n, channels);
+			if (pos + n == samples) {
+				c.set_flag (ProcessContext<float>::EndOfInput);
+			}
+			buffer.process (c);
+		}
+		CPPUNIT_ASSERT_EQUAL (samples, buffer.get_samples_written ());
+	}
+
+	void read (SpillBuffer & buffer)
+	{
+		buffer.add_output (sink);
+
+		samplecnt_t const chunk = 4096;
+		float data[chunk];
+		ProcessContext<float> c (data, chunk, channels);
+		while (buffer.read (c) == chunk) {}
+
+		buffer.clear_outputs ();
+
+		CPPUNIT_ASSERT_EQUAL ((size_t) samples, sink->get_data ().size ());
+		CPPUNIT_ASSERT (TestUtils::array_equals (random_data, sink->get_array (), samples));
+	}
+
+	static const ChannelCount channels = 2;
+
+	boost::shared_ptr<AppendingVectorSink<float> > sink;
+	PBD::ScopedConnection connection;
+	bool written;
+
+	float * random_data;
+	samplecnt_t samples;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION (SpillBufferTest);
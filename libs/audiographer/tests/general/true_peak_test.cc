@@ -0,0 +1,117 @@
+#include "tests/utils.h"
+
+#include <cmath>
+
+#include "audiographer/general/true_peak.h"
+#include "audiographer/routines.h"
+
+using namespace AudioGrapher;
+
+class TruePeakTest : public CppUnit::TestFixture
+{
+  CPPUNIT_TEST_SUITE (TruePeakTest);
+  CPPUNIT_TEST (testIntersamplePeak);
+  CPPUNIT_TEST (testSinusoids);
+  CPPUNIT_TEST (testInterleaved);
+  CPPUNIT_TEST (testBlockSize);
+  CPPUNIT_TEST_SUITE_END ();
+
+  public:
+	void setUp()
+	{
+		samples = 4096;
+		data = new float[samples * 2];
+	}
+
+	void tearDown()
+	{
+		delete [] data;
+	}
+
+	void testIntersamplePeak()
+	{
+		/* fs/4 sine, phase shifted by 45 deg: all samples are +/- 0.707,
+		 * the true peak is 1.0 (+3dB above sample-peak) */
+		for (samplecnt_t i = 0; i < samples; ++i) {
+			data[i] = sinf (M_PI * i / 2.0 + M_PI / 4.0);
+		}
+
+		TruePeakKernel tp;
+		tp.set_channels (1);
+		tp.process (0, data, 256);
+		float peak = tp.process (0, &data[256], samples - 256);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL (1.0, peak, 0.01);
+		CPPUNIT_ASSERT (Routines::compute_peak (data, samples, 0) < 0.71);
+	}
+
+	void testSinusoids()
+	{
+		TruePeakKernel tp;
+		tp.set_channels (1);
+
+		/* under-read must not exceed 0.3 dB up to 20 kHz @ 48 kHz,
+		 * over-read must not exceed 0.02 dB */
+		for (float f = 500; f <= 20000; f += 1500) {
+			for (int ph = 0; ph < 8; ++ph) {
+				for (samplecnt_t i = 0; i < samples; ++i) {
+					data[i] = sinf (2.0 * M_PI * f * i / 48000.0 + ph * M_PI / 8.0);
+				}
+				tp.reset ();
+				tp.process (0, data, 256);
+				const float peak = tp.process (0, &data[256], samples - 256);
+				CPPUNIT_ASSERT (peak > 0.966f); // -0.3 dB
+				CPPUNIT_ASSERT (peak < 1.0024f); // +0.02 dB
+			}
+		}
+	}
+
+	void testInterleaved()
+	{
+		/* 2 channels, interleaved, with different levels */
+		for (samplecnt_t i = 0; i < samples; ++i) {
+			const float v = sinf (2.0 * M_PI * 1000 * i / 48000.0);
+			data[2 * i]     = 0.5f * v;
+			data[2 * i + 1] = 0.25f * v;
+		}
+
+		TruePeakKernel tp;
+		tp.set_channels (2);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL (0.5, tp.process (0, data, samples, 2), 0.005);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL (0.25, tp.process (1, &data[1], samples, 2), 0.005);
+
+		/* history is kept per channel */
+		tp.reset ();
+		for (samplecnt_t i = 0; i < samples; i += 64) {
+			const float p0 = tp.process (0, &data[2 * i], 64, 2);
+			const float p1 = tp.process (1, &data[2 * i + 1], 64, 2);
+			if (i > 0) {
+				CPPUNIT_ASSERT_DOUBLES_EQUAL (2.f * p1, p0, 1e-5);
+			}
+		}
+	}
+
+	void testBlockSize()
+	{
+		for (samplecnt_t i = 0; i < samples; ++i) {
+			data[i] = (rand () / (float) RAND_MAX) - .5f;
+		}
+
+		TruePeakKernel tp;
+		tp.set_channels (1);
+		const float p_all = tp.process (0, data, samples);
+
+		tp.reset ();
+		float p_split = 0;
+		for (samplecnt_t i = 0; i < samples; i += 100) {
+			p_split = std::max (p_split, tp.process (0, &data[i], std::min<samplecnt_t> (100, samples - i)));
+		}
+		CPPUNIT_ASSERT_DOUBLES_EQUAL (p_all, p_split, 1e-6);
+		CPPUNIT_ASSERT (p_all >= Routines::compute_peak (data, samples, 0) * 0.99f);
+	}
+
+  private:
+	float * data;
+	samplecnt_t samples;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION (TruePeakTest);
@@ -20,6 +20,7 @@
 #include <regex.h>
 #include <sys/mman.h>
 #include <sys/time.h>
+#include <sstream>
 
 #include <glibmm.h>
 
@@ -887,6 +888,9 @@ AlsaAudioBackend::_start (bool for_latency_measurement)
 		PBD::warning << _("AlsaAudioBackend: adjusted input channel count to match device.") << endmsg;
 	}
 
+	_capt_buffers.assign (_pcmi->ncapt (), 0);
+	_play_buffers.assign (_pcmi->nplay (), 0);
+
 	if (_pcmi->fsize() != _samples_per_period) {
 		_samples_per_period = _pcmi->fsize();
 		PBD::warning << _("AlsaAudioBackend: samples per period does not match.") << endmsg;
@@ -1036,6 +1040,51 @@ AlsaAudioBackend::dsp_load () const
 	return 100.f * _dsp_load;
 }
 
+std::string
+AlsaAudioBackend::cycle_timing_report () const
+{
+	if (!_run) {
+		return "";
+	}
+
+	std::stringstream ss;
+	char line[256];
+
+	snprintf (line, sizeof (line), _("Main device: %u Hz, %u samples per period, DSP load %.1f%%\n"),
+			(unsigned int) _samplerate, (unsigned int) _samples_per_period, 100.f * _dsp_load);
+	ss << line;
+
+	for (AudioSlaves::const_iterator s = _slaves.begin (); s != _slaves.end (); ++s) {
+		if ((*s)->dead) {
+			ss << string_compose (_("Additional device '%1': halted\n"), (*s)->name ());
+			continue;
+		}
+		AlsaAudioSlave::Stats st;
+		(*s)->stats (st);
+		snprintf (line, sizeof (line), _("Additional device '%s': %u Hz, %u samples per period\n"),
+				(*s)->name ().c_str (), (*s)->fsamp (), (*s)->fsize ());
+		ss << line;
+		snprintf (line, sizeof (line), _("  resampling ratio %.6f, drift %+.1f ppm, latency capture %u play %u samples\n"),
+				st.ratio, st.drift_ppm, st.capt_latency, st.play_latency);
+		ss << line;
+		snprintf (line, sizeof (line), _("  DSP load: device thread %.1f%%, resampling %.1f%%\n"),
+				100.f * st.dsp_load, 100.f * st.src_load);
+		ss << line;
+		snprintf (line, sizeof (line), _("  x-runs %u, underflows %u, overflows %u, re-syncs %u\n"),
+				st.xruns, st.underflows, st.overflows, st.resyncs);
+		ss << line;
+	}
+	return ss.str ();
+}
+
+void
+AlsaAudioBackend::reset_cycle_timing ()
+{
+	for (AudioSlaves::iterator s = _slaves.begin (); s != _slaves.end (); ++s) {
+		(*s)->reset_stats ();
+	}
+}
+
 size_t
 AlsaAudioBackend::raw_buffer_size (DataType t)
 {
@@ -2001,7 +2050,10 @@ AlsaAudioBackend::main_process_thread ()
 
 				_pcmi->capt_init (_samples_per_period);
 				for (std::vector<AlsaPort*>::const_iterator it = _system_inputs.begin (); it != _system_inputs.end (); ++it, ++i) {
-					_pcmi->capt_chan (i, (float*)((*it)->get_buffer(_samples_per_period)), _samples_per_period);
+					_capt_buffers[i] = (float*)((*it)->get_buffer(_samples_per_period));
+				}
+				if (!_capt_buffers.empty ()) {
+					_pcmi->capt_all (&_capt_buffers[0], _samples_per_period);
 				}
 				_pcmi->capt_done (_samples_per_period);
 
@@ -2011,7 +2063,10 @@ AlsaAudioBackend::main_process_thread ()
 					}
 					i = 0;
 					for (std::vector<AlsaPort*>::const_iterator it = (*s)->inputs.begin (); it != (*s)->inputs.end (); ++it, ++i) {
-						(*s)->capt_chan (i, (float*)((*it)->get_buffer(_samples_per_period)), _samples_per_period);
+						(*s)->capt_buffers[i] = (float*)((*it)->get_buffer(_samples_per_period));
+					}
+					if (i > 0) {
+						(*s)->capt_all (&(*s)->capt_buffers[0], i, _samples_per_period);
 					}
 				}
 
@@ -2032,10 +2087,6 @@ AlsaAudioBackend::main_process_thread ()
 					rm->sync_time (clock1);
 				}
 
-				for (std::vector<AlsaPort*>::const_iterator it = _system_outputs.begin (); it != _system_outputs.end (); ++it) {
-					memset ((*it)->get_buffer (_samples_per_period), 0, _samples_per_period * sizeof (Sample));
-				}
-
 				/* call engine process callback */
 				_last_process_start = g_get_monotonic_time();
 				if (engine.process_callback (_samples_per_period)) {
@@ -2064,10 +2115,10 @@ AlsaAudioBackend::main_process_thread ()
 				i = 0;
 				_pcmi->play_init (_samples_per_period);
 				for (std::vector<AlsaPort*>::const_iterator it = _system_outputs.begin (); it != _system_outputs.end (); ++it, ++i) {
-					_pcmi->play_chan (i, (const float*)(*it)->get_buffer (_samples_per_period), _samples_per_period);
+					_play_buffers[i] = (const float*)(*it)->get_buffer (_samples_per_period);
 				}
-				for (; i < _pcmi->nplay (); ++i) {
-					_pcmi->clear_chan (i, _samples_per_period);
+				if (!_play_buffers.empty ()) {
+					_pcmi->play_all (&_play_buffers[0], _samples_per_period);
 				}
 				_pcmi->play_done (_samples_per_period);
 
@@ -2077,7 +2128,10 @@ AlsaAudioBackend::main_process_thread ()
 					}
 					i = 0;
 					for (std::vector<AlsaPort*>::const_iterator it = (*s)->outputs.begin (); it != (*s)->outputs.end (); ++it, ++i) {
-						(*s)->play_chan (i, (float*)((*it)->get_buffer(_samples_per_period)), _samples_per_period);
+						(*s)->play_buffers[i] = (float const*)((*it)->get_buffer(_samples_per_period));
+					}
+					if (i > 0) {
+						(*s)->play_all (&(*s)->play_buffers[0], i, _samples_per_period);
 					}
 					(*s)->cycle_end ();
 				}
@@ -2233,6 +2287,9 @@ AlsaAudioBackend::add_slave (const char*  device,
 		s->outputs.push_back (ap);
 	}
 
+	s->capt_buffers.assign (s->inputs.size (), 0);
+	s->play_buffers.assign (s->outputs.size (), 0);
+
 	if (!s->start ()) {
 		PBD::error << string_compose (_("Failed to start slave device '%1'\n"), device) << endmsg;
 		goto errout;
@@ -2526,11 +2583,16 @@ void* AlsaAudioPort::get_buffer (pframes_t n_samples)
 		if (it == connections.end ()) {
 			memset (_buffer, 0, n_samples * sizeof (Sample));
 		} else {
-			AlsaAudioPort const * source = static_cast<const AlsaAudioPort*>(*it);
+			AlsaAudioPort * source = static_cast<AlsaAudioPort*>(*it);
 			assert (source && source->is_output ());
+			if (connections.size () == 1) {
+				/* single source: alias its buffer, no copy.
+				 * Input port buffers are read-only, see PortEngine::get_buffer */
+				return source->buffer ();
+			}
 			memcpy (_buffer, source->const_buffer (), n_samples * sizeof (Sample));
 			while (++it != connections.end ()) {
-				source = static_cast<const AlsaAudioPort*>(*it);
+				source = static_cast<AlsaAudioPort*>(*it);
 				assert (source && source->is_output ());
 				Sample* dst = buffer ();
 				const Sample* src = source->const_buffer ();
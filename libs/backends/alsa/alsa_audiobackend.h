@@ -252,6 +252,8 @@ class AlsaAudioBackend : public AudioBackend {
 		int stop ();
 		int freewheel (bool);
 		float dsp_load () const;
+		std::string cycle_timing_report () const;
+		void reset_cycle_timing ();
 		size_t raw_buffer_size (DataType t);
 
 		/* Process time */
@@ -334,6 +336,10 @@ class AlsaAudioBackend : public AudioBackend {
 		std::string _instance_name;
 		Alsa_pcmi *_pcmi;
 
+		/* per device channel buffer pointers, for Alsa_pcmi::capt_all, play_all */
+		std::vector<float*>       _capt_buffers;
+		std::vector<float const*> _play_buffers;
+
 		bool  _run; /* keep going or stop, ardour thread */
 		bool  _active; /* is running, process thread */
 		bool  _freewheel;
@@ -503,6 +509,10 @@ class AlsaAudioBackend : public AudioBackend {
 				std::vector<AlsaPort *> inputs;
 				std::vector<AlsaPort *> outputs;
 
+				/* port buffers, for capt_all (), play_all () */
+				std::vector<float *>       capt_buffers;
+				std::vector<float const *> play_buffers;
+
 				PBD::Signal0<void> UpdateLatency;
 				PBD::ScopedConnection latency_connection;
 
@@ -20,6 +20,10 @@
 #include <cmath>
 #include <glibmm.h>
 
+#ifdef __SSE__
+#include <xmmintrin.h>
+#endif
+
 #include "pbd/compose.h"
 #include "pbd/error.h"
 #include "pbd/pthread_utils.h"
@@ -39,18 +43,28 @@ AlsaAudioSlave::AlsaAudioSlave (
 			unsigned int  slave_samples_per_period,
 			unsigned int  periods_per_cycle)
 	: _pcmi (play_name, capt_name, 0, slave_rate, slave_samples_per_period, periods_per_cycle, 2, /* Alsa_pcmi::DEBUG_ALL */ 0)
+	, _name (play_name ? play_name : capt_name ? capt_name : "")
 	, _run (false)
 	, _active (false)
 	, _samples_since_dll_reset (0)
 	, _ratio (1.0)
 	, _slave_speed (1.0)
 	, _draining (1)
+	, _speed_ratio (1.0)
 	, _rb_capture (4 * /* AlsaAudioBackend::_max_buffer_size */ 8192 * _pcmi.ncapt ())
 	, _rb_playback (4 * /* AlsaAudioBackend::_max_buffer_size */ 8192 * _pcmi.nplay ())
 	, _samples_per_period (master_samples_per_period)
 	, _capt_buff (0)
 	, _play_buff (0)
 	, _src_buff (0)
+	, _src_time (0)
+	, _stats_ratio (1.0)
+	, _dsp_load (0)
+	, _src_load (0)
+	, _n_xruns (0)
+	, _n_underflows (0)
+	, _n_overflows (0)
+	, _n_resyncs (0)
 {
 	if (0 != _pcmi.state()) {
 		return;
@@ -74,6 +88,9 @@ AlsaAudioSlave::AlsaAudioSlave (
 	_capt_buff = (float*) malloc (sizeof(float) * _pcmi.ncapt () * _samples_per_period);
 	_play_buff = (float*) malloc (sizeof(float) * _pcmi.nplay () * _samples_per_period);
 	_src_buff  = (float*) malloc (sizeof(float) * std::max (_pcmi.nplay (), _pcmi.ncapt ()));
+
+	_dsp_load_calc.set_max_time (_pcmi.fsamp (), _pcmi.fsize ());
+	_src_load_calc.set_max_time (master_rate, master_samples_per_period);
 }
 
 AlsaAudioSlave::~AlsaAudioSlave ()
@@ -256,6 +273,7 @@ AlsaAudioSlave::process_thread ()
 				_rb_capture.increment_write_idx (spp * nchn);
 #endif
 			} else {
+				g_atomic_int_inc (&_n_overflows);
 				g_atomic_int_set(&_draining, 1);
 			}
 			_pcmi.capt_done (spp);
@@ -309,6 +327,7 @@ AlsaAudioSlave::process_thread ()
 			} else {
 				if (!drain) {
 					printf ("Slave Process: Playback Buffer Underflow, have %u want %lu\n", _rb_playback.read_space (), _pcmi.nplay () * spp); // XXX DEBUG 
+					g_atomic_int_inc (&_n_underflows);
 					_play_latency += spp * _ratio;
 					update_latencies (_play_latency, _capt_latency);
 				}
@@ -323,7 +342,12 @@ AlsaAudioSlave::process_thread ()
 			++last_n_periods;
 		}
 
+		_dsp_load_calc.set_start_timestamp_us (clock0);
+		_dsp_load_calc.set_stop_timestamp_us (g_get_monotonic_time());
+		_dsp_load = _dsp_load_calc.get_dsp_load ();
+
 		if (xrun && (_pcmi.capt_xrun() > 0 || _pcmi.play_xrun() > 0)) {
+			g_atomic_int_inc (&_n_xruns);
 			reset_dll = true;
 			_samples_since_dll_reset = 0;
 			g_atomic_int_set(&_draining, 1);
@@ -342,15 +366,49 @@ AlsaAudioSlave::process_thread ()
 void
 AlsaAudioSlave::cycle_start (double tme, double mst_speed, bool drain)
 {
-	//printf ("SRC %f / %f = %f\n", mst_speed, _slave_speed, mst_speed / _slave_speed);
 	//printf ("DRIFT (mst) %11.1f - (slv) %11.1f = %.1f us = %.1f spl\n", tme, _t0, tme - _t0, (tme - _t0) * _pcmi.fsamp () * 1e-6);
+	const int64_t t0 = g_get_monotonic_time ();
+	resample_capture (mst_speed, drain);
+	_src_time = g_get_monotonic_time () - t0;
+}
+
+void
+AlsaAudioSlave::cycle_end ()
+{
+	const int64_t t0 = g_get_monotonic_time ();
+	resample_playback ();
+	_src_time += g_get_monotonic_time () - t0;
+
+	_src_load_calc.set_start_timestamp_us (0);
+	_src_load_calc.set_stop_timestamp_us (_src_time);
+	_src_load = _src_load_calc.get_dsp_load ();
+}
+
+void
+AlsaAudioSlave::resample_capture (double mst_speed, bool drain)
+{
+	//printf ("SRC %f / %f = %f\n", mst_speed, _slave_speed, mst_speed / _slave_speed);
 	//printf ("Slave capt: %u play: %u\n", _rb_capture.read_space (), _rb_playback.read_space ());
 
-	// TODO LPF filter ratios, atomic _slave_speed
+	/* Both DLLs (master and slave) have a bandwidth of 0.1 Hz, their
+	 * ratio is additionally low-pass filtered (time constant 1 sec)
+	 * to reduce resampler ratio jitter. The filter is re-initialized
+	 * when the slave is re-synchronized.
+	 */
 	const double slave_speed = _slave_speed;
+	const double speed_ratio = mst_speed / slave_speed;
+
+	if (drain || g_atomic_int_get (&_draining)) {
+		_speed_ratio = speed_ratio;
+	} else {
+		/* one master period, in seconds */
+		const double dt = _samples_per_period / (_ratio * _pcmi.fsamp ());
+		_speed_ratio += dt * (speed_ratio - _speed_ratio);
+	}
 
-	_src_capt.set_rratio (mst_speed / slave_speed);
-	_src_play.set_rratio (slave_speed / mst_speed);
+	_src_capt.set_rratio (_speed_ratio);
+	_src_play.set_rratio (1.0 / _speed_ratio);
+	_stats_ratio = _ratio * _speed_ratio;
 
 	memset (_capt_buff, 0, sizeof(float) * _pcmi.ncapt () * _samples_per_period);
 
@@ -370,9 +428,10 @@ AlsaAudioSlave::cycle_start (double tme, double mst_speed, bool drain)
 	_src_capt.out_data  = _capt_buff;
 
 	/* estimate required samples */
-	const double rratio = _ratio * mst_speed / slave_speed;
+	const double rratio = _ratio * _speed_ratio;
 	if (_rb_capture.read_space() < ceil (nchn * _samples_per_period / rratio)) {
 		printf ("--- UNDERFLOW ---  have %u  want %.1f\n", _rb_capture.read_space(), ceil (nchn * _samples_per_period / rratio)); // XXX DEBUG
+		g_atomic_int_inc (&_n_underflows);
 		_capt_latency += _samples_per_period;
 		update_latencies (_play_latency, _capt_latency);
 		return;
@@ -403,6 +462,7 @@ AlsaAudioSlave::cycle_start (double tme, double mst_speed, bool drain)
 
 	if (underflow) {
 		std::cerr << "ALSA Slave: Capture Ringbuffer Underflow\n"; // XXX
+		g_atomic_int_inc (&_n_underflows);
 		g_atomic_int_set(&_draining, 1);
 	}
 
@@ -414,7 +474,7 @@ AlsaAudioSlave::cycle_start (double tme, double mst_speed, bool drain)
 }
 
 void
-AlsaAudioSlave::cycle_end ()
+AlsaAudioSlave::resample_playback ()
 {
 	bool drain_done = false;
 	bool overflow = false;
@@ -436,6 +496,7 @@ AlsaAudioSlave::cycle_end ()
 			_capt_latency = 16;
 			_play_latency = 16 + _ratio * _pcmi.fsize () * (_pcmi.play_nfrag () - 1);
 			update_latencies (_play_latency, _capt_latency);
+			g_atomic_int_inc (&_n_resyncs);
 			drain_done = true;
 		} else {
 			return;
@@ -476,6 +537,7 @@ AlsaAudioSlave::cycle_end ()
 
 	if (overflow) {
 		std::cerr << "ALSA Slave: Playback Ringbuffer Overflow\n"; // XXX
+		g_atomic_int_inc (&_n_overflows);
 		g_atomic_int_set(&_draining, 1);
 		return;
 	}
@@ -521,3 +583,102 @@ AlsaAudioSlave::play_chan (uint32_t chn, float* src, uint32_t n_samples)
 	}
 	return n_samples;
 }
+
+/* (de)interleave all channels. As in Alsa_pcmi::capt_all () and
+ * Alsa_pcmi::play_all (), leading groups of 4 channels are transposed
+ * in blocks of 4x4 samples with SSE. The remaining channels, and those
+ * after the first unused one, are copied one at a time.
+ */
+void
+AlsaAudioSlave::capt_all (float* const* dst, uint32_t n_chan, uint32_t n_samples)
+{
+	const uint32_t nchn = _pcmi.ncapt ();
+	assert (n_chan <= nchn && n_samples == _samples_per_period);
+	uint32_t c = 0;
+#ifdef __SSE__
+	const uint32_t k = n_samples & ~3;
+	for (; c + 4 <= n_chan && dst[c] && dst[c + 1] && dst[c + 2] && dst[c + 3]; c += 4) {
+		float const* src = &_capt_buff[c];
+		for (uint32_t s = 0; s < k; s += 4) {
+			__m128 r0 = _mm_loadu_ps (src + (s + 0) * nchn);
+			__m128 r1 = _mm_loadu_ps (src + (s + 1) * nchn);
+			__m128 r2 = _mm_loadu_ps (src + (s + 2) * nchn);
+			__m128 r3 = _mm_loadu_ps (src + (s + 3) * nchn);
+			_MM_TRANSPOSE4_PS (r0, r1, r2, r3);
+			_mm_storeu_ps (dst[c + 0] + s, r0);
+			_mm_storeu_ps (dst[c + 1] + s, r1);
+			_mm_storeu_ps (dst[c + 2] + s, r2);
+			_mm_storeu_ps (dst[c + 3] + s, r3);
+		}
+		for (uint32_t s = k; s < n_samples; ++s) {
+			for (uint32_t i = 0; i < 4; ++i) {
+				dst[c + i][s] = src[s * nchn + i];
+			}
+		}
+	}
+#endif
+	for (; c < n_chan; ++c) {
+		if (dst[c]) {
+			capt_chan (c, dst[c], n_samples);
+		}
+	}
+}
+
+void
+AlsaAudioSlave::play_all (float const* const* src, uint32_t n_chan, uint32_t n_samples)
+{
+	const uint32_t nchn = _pcmi.nplay ();
+	assert (n_chan <= nchn && n_samples == _samples_per_period);
+	uint32_t c = 0;
+#ifdef __SSE__
+	const uint32_t k = n_samples & ~3;
+	for (; c + 4 <= n_chan && src[c] && src[c + 1] && src[c + 2] && src[c + 3]; c += 4) {
+		float* dst = &_play_buff[c];
+		for (uint32_t s = 0; s < k; s += 4) {
+			__m128 r0 = _mm_loadu_ps (src[c + 0] + s);
+			__m128 r1 = _mm_loadu_ps (src[c + 1] + s);
+			__m128 r2 = _mm_loadu_ps (src[c + 2] + s);
+			__m128 r3 = _mm_loadu_ps (src[c + 3] + s);
+			_MM_TRANSPOSE4_PS (r0, r1, r2, r3);
+			_mm_storeu_ps (dst + (s + 0) * nchn, r0);
+			_mm_storeu_ps (dst + (s + 1) * nchn, r1);
+			_mm_storeu_ps (dst + (s + 2) * nchn, r2);
+			_mm_storeu_ps (dst + (s + 3) * nchn, r3);
+		}
+		for (uint32_t s = k; s < n_samples; ++s) {
+			for (uint32_t i = 0; i < 4; ++i) {
+				dst[s * nchn + i] = src[c + i][s];
+			}
+		}
+	}
+#endif
+	for (; c < n_chan; ++c) {
+		if (src[c]) {
+			play_chan (c, const_cast<float*> (src[c]), n_samples);
+		}
+	}
+}
+
+void
+AlsaAudioSlave::stats (Stats& s) const
+{
+	s.ratio        = _stats_ratio;
+	s.drift_ppm    = 1e6 * (_speed_ratio - 1.0);
+	s.capt_latency = _capt_latency;
+	s.play_latency = rint (_play_latency);
+	s.dsp_load     = _dsp_load;
+	s.src_load     = _src_load;
+	s.xruns        = g_atomic_int_get (&_n_xruns);
+	s.underflows   = g_atomic_int_get (&_n_underflows);
+	s.overflows    = g_atomic_int_get (&_n_overflows);
+	s.resyncs      = g_atomic_int_get (&_n_resyncs);
+}
+
+void
+AlsaAudioSlave::reset_stats ()
+{
+	g_atomic_int_set (&_n_xruns, 0);
+	g_atomic_int_set (&_n_underflows, 0);
+	g_atomic_int_set (&_n_overflows, 0);
+	g_atomic_int_set (&_n_resyncs, 0);
+}
@@ -20,8 +20,10 @@
 #define __libbackend_alsa_slave_h__
 
 #include <pthread.h>
+#include <string>
 
 #include "pbd/ringbuffer.h"
+#include "ardour/dsp_load_calculator.h"
 #include "zita-resampler/vresampler.h"
 #include "zita-alsa-pcmi.h"
 
@@ -50,12 +52,40 @@ public:
 	uint32_t capt_chan (uint32_t chn, float* dst, uint32_t n_samples);
 	uint32_t play_chan (uint32_t chn, float* src, uint32_t n_samples);
 
+	/* (de)interleave all channels in one pass, dst/src are per channel,
+	 * NULL pointers are skipped */
+	void capt_all (float* const* dst, uint32_t n_chan, uint32_t n_samples);
+	void play_all (float const* const* src, uint32_t n_chan, uint32_t n_samples);
+
 	bool running () const { return _active; }
 	void freewheel (bool);
 
 	int      state (void) const { return _pcmi.state (); }
 	uint32_t nplay (void) const { return _pcmi.nplay (); }
 	uint32_t ncapt (void) const { return _pcmi.ncapt (); }
+	uint32_t fsamp (void) const { return _pcmi.fsamp (); }
+	uint32_t fsize (void) const { return _pcmi.fsize (); }
+
+	std::string const& name () const { return _name; }
+
+	/* Statistics, written by the slave's and the master's process thread.
+	 * Reading them is lock-free, but the values are not an exact snapshot.
+	 */
+	struct Stats {
+		double   ratio;        // current resampling ratio, slave to master
+		double   drift_ppm;    // slave clock relative to master clock
+		uint32_t capt_latency; // samples (master rate)
+		uint32_t play_latency;
+		float    dsp_load;     // slave process thread, relative to a slave period
+		float    src_load;     // resampling in the master process thread, relative to a master period
+		uint32_t xruns;
+		uint32_t underflows;
+		uint32_t overflows;
+		uint32_t resyncs;      // ringbuffers were drained and re-synchronized
+	};
+
+	void stats (Stats&) const;
+	void reset_stats ();
 
 	PBD::Signal0<void> Halted;
 
@@ -64,6 +94,7 @@ protected:
 
 private:
 	Alsa_pcmi _pcmi;
+	std::string _name;
 
 	static void* _process_thread (void *);
 	void* process_thread ();
@@ -83,6 +114,24 @@ private:
 	volatile double _slave_speed;
 	volatile gint   _draining;
 
+	/* low-pass filtered master/slave speed ratio */
+	double _speed_ratio;
+
+	void resample_capture (double mst_speed, bool drain);
+	void resample_playback ();
+
+	/* stats */
+	DSPLoadCalculator _dsp_load_calc;
+	DSPLoadCalculator _src_load_calc;
+	int64_t _src_time;
+	double  _stats_ratio;
+	float   _dsp_load;
+	float   _src_load;
+	gint    _n_xruns;
+	gint    _n_underflows;
+	gint    _n_overflows;
+	gint    _n_resyncs;
+
 	PBD::RingBuffer<float> _rb_capture;
 	PBD::RingBuffer<float> _rb_playback;
 
@@ -23,6 +23,10 @@
 #include <endian.h>
 #endif
 #include <sys/time.h>
+#include <string.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 #include "zita-alsa-pcmi.h"
 
 
@@ -70,6 +74,10 @@ Alsa_pcmi::Alsa_pcmi (
 	, _synced (false)
 	, _play_npfd (0)
 	, _capt_npfd (0)
+	, _play_block (0)
+	, _capt_block (0)
+	, _play_bytes (0)
+	, _capt_bytes (0)
 {
 	const char *p;
 
@@ -341,6 +349,88 @@ void Alsa_pcmi::capt_chan  (int chan, float *dst, int len, int step)
 }
 
 
+// Convert all channels at once. With interleaved access, leading groups
+// of 4 adjacent channels are converted and (de)interleaved together in a
+// single pass over the mmap area, 4 frames at a time. Remaining channels
+// and frames use the per channel functions.
+// Playback: src [i] == 0 clears channel i. Capture: dst [i] == 0 skips it.
+
+static unsigned int interleaved_channels (char const *const *ptr, unsigned int nchan, int bytes, int step)
+{
+	unsigned int i;
+
+	if (step < 4 * bytes) return 0;
+	for (i = 1; i < nchan; i++)
+	{
+		if (ptr [i] != ptr [0] + i * bytes) break;
+	}
+	return i & ~3;
+}
+
+
+void Alsa_pcmi::play_all (const float *const *src, int len)
+{
+	unsigned int i, n = 0;
+	int          k = 0;
+
+	if (_play_block && len >= 4)
+	{
+		n = interleaved_channels (_play_ptr, _play_nchan, _play_bytes, _play_step);
+		for (i = 0; i < n; i++)
+		{
+			if (!src [i]) break;
+		}
+		n = i & ~3;
+	}
+	if (n)
+	{
+		k = len & ~3;
+		(this->*Alsa_pcmi::_play_block)(src, _play_ptr [0], n, k);
+		for (i = 0; i < n; i++)
+		{
+			_play_ptr [i] += k * _play_step;
+			if (k < len) play_chan (i, src [i] + k, len - k);
+		}
+	}
+	for (i = n; i < _play_nchan; i++)
+	{
+		if (src [i]) play_chan (i, src [i], len);
+		else clear_chan (i, len);
+	}
+}
+
+
+void Alsa_pcmi::capt_all (float *const *dst, int len)
+{
+	unsigned int i, n = 0;
+	int          k = 0;
+
+	if (_capt_block && len >= 4)
+	{
+		n = interleaved_channels (_capt_ptr, _capt_nchan, _capt_bytes, _capt_step);
+		for (i = 0; i < n; i++)
+		{
+			if (!dst [i]) break;
+		}
+		n = i & ~3;
+	}
+	if (n)
+	{
+		k = len & ~3;
+		(this->*Alsa_pcmi::_capt_block)(_capt_ptr [0], dst, n, k);
+		for (i = 0; i < n; i++)
+		{
+			_capt_ptr [i] += k * _capt_step;
+			if (k < len) capt_chan (i, dst [i] + k, len - k);
+		}
+	}
+	for (i = n; i < _capt_nchan; i++)
+	{
+		if (dst [i]) capt_chan (i, dst [i], len);
+	}
+}
+
+
 int Alsa_pcmi::play_done (int len)
 {
 	if (!_play_handle) return 0;
@@ -575,6 +665,34 @@ void Alsa_pcmi::initialise (const char *play_name, const char *capt_name, const
 #error "System byte order is undefined or not supported"
 #endif
 
+#if defined(__SSE2__) && __BYTE_ORDER == __LITTLE_ENDIAN
+		switch (_play_format)
+		{
+			case SND_PCM_FORMAT_FLOAT_LE:
+				_play_block = &Alsa_pcmi::play_block_float;
+				_play_bytes = 4;
+				break;
+
+			case SND_PCM_FORMAT_S32_LE:
+				_play_block = &Alsa_pcmi::play_block_32;
+				_play_bytes = 4;
+				break;
+
+			case SND_PCM_FORMAT_S24_3LE:
+				_play_block = &Alsa_pcmi::play_block_24;
+				_play_bytes = 3;
+				break;
+
+			case SND_PCM_FORMAT_S16_LE:
+				_play_block = &Alsa_pcmi::play_block_16;
+				_play_bytes = 2;
+				break;
+
+			default:
+				break;
+		}
+#endif
+
 		_play_npfd = snd_pcm_poll_descriptors_count (_play_handle);
 	}
 
@@ -676,6 +794,34 @@ void Alsa_pcmi::initialise (const char *play_name, const char *capt_name, const
 #error "System byte order is undefined or not supported"
 #endif
 
+#if defined(__SSE2__) && __BYTE_ORDER == __LITTLE_ENDIAN
+		switch (_capt_format)
+		{
+			case SND_PCM_FORMAT_FLOAT_LE:
+				_capt_block = &Alsa_pcmi::capt_block_float;
+				_capt_bytes = 4;
+				break;
+
+			case SND_PCM_FORMAT_S32_LE:
+				_capt_block = &Alsa_pcmi::capt_block_32;
+				_capt_bytes = 4;
+				break;
+
+			case SND_PCM_FORMAT_S24_3LE:
+				_capt_block = &Alsa_pcmi::capt_block_24;
+				_capt_bytes = 3;
+				break;
+
+			case SND_PCM_FORMAT_S16_LE:
+				_capt_block = &Alsa_pcmi::capt_block_16;
+				_capt_bytes = 2;
+				break;
+
+			default:
+				break;
+		}
+#endif
+
 		_capt_npfd = snd_pcm_poll_descriptors_count (_capt_handle);
 	}
 
@@ -889,6 +1035,80 @@ float Alsa_pcmi::xruncheck (snd_pcm_status_t *stat)
 }
 
 
+#ifdef __SSE2__
+
+// Clip to [-1, 1], scale and truncate, same as the scalar code.
+// Operand order matters: NaN propagates and converts to 0x80000000,
+// like the scalar (int) cast on x86.
+static inline __m128i float_to_int (__m128 s, __m128 scale)
+{
+	s = _mm_min_ps (_mm_set1_ps (1.f), _mm_max_ps (_mm_set1_ps (-1.f), s));
+	return _mm_cvttps_epi32 (_mm_mul_ps (s, scale));
+}
+
+// 4 frames of 4 channels -> 4 rows of interleaved ints
+static inline void play_4x4 (const float *const *src, int f, __m128 scale, __m128i *r)
+{
+	__m128 r0 = _mm_castsi128_ps (float_to_int (_mm_loadu_ps (src [0] + f), scale));
+	__m128 r1 = _mm_castsi128_ps (float_to_int (_mm_loadu_ps (src [1] + f), scale));
+	__m128 r2 = _mm_castsi128_ps (float_to_int (_mm_loadu_ps (src [2] + f), scale));
+	__m128 r3 = _mm_castsi128_ps (float_to_int (_mm_loadu_ps (src [3] + f), scale));
+	_MM_TRANSPOSE4_PS (r0, r1, r2, r3);
+	r [0] = _mm_castps_si128 (r0);
+	r [1] = _mm_castps_si128 (r1);
+	r [2] = _mm_castps_si128 (r2);
+	r [3] = _mm_castps_si128 (r3);
+}
+
+// 4 rows of 4 interleaved channels -> 4 frames of 4 channels
+static inline void capt_4x4 (__m128 r0, __m128 r1, __m128 r2, __m128 r3, float *const *dst, int f)
+{
+	_MM_TRANSPOSE4_PS (r0, r1, r2, r3);
+	_mm_storeu_ps (dst [0] + f, r0);
+	_mm_storeu_ps (dst [1] + f, r1);
+	_mm_storeu_ps (dst [2] + f, r2);
+	_mm_storeu_ps (dst [3] + f, r3);
+}
+
+static inline __m128i load_16 (const char *src)
+{
+	const __m128i s = _mm_loadl_epi64 ((__m128i const *) src);
+	return _mm_srai_epi32 (_mm_unpacklo_epi16 (s, s), 16);
+}
+
+static inline int load_24_1 (const char *src)
+{
+	return (src [0] & 0xFF) + ((src [1] & 0xFF) << 8) + ((src [2] & 0xFF) << 16);
+}
+
+static inline __m128i load_24 (const char *src)
+{
+	const __m128i s = _mm_set_epi32 (load_24_1 (src + 9), load_24_1 (src + 6), load_24_1 (src + 3), load_24_1 (src));
+	return _mm_srai_epi32 (_mm_slli_epi32 (s, 8), 8);
+}
+
+static inline void store_16 (char *dst, __m128i d)
+{
+	d = _mm_srai_epi32 (_mm_slli_epi32 (d, 16), 16);
+	_mm_storel_epi64 ((__m128i *) dst, _mm_packs_epi32 (d, d));
+}
+
+// 4 x 24 bit little-endian, packed into 3 words
+static inline void store_24 (char *dst, __m128i d)
+{
+	uint32_t s [4], w;
+	_mm_storeu_si128 ((__m128i *) s, d);
+	w = (s [0] & 0xFFFFFF) | (s [1] << 24);
+	memcpy (dst, &w, 4);
+	w = ((s [1] >> 8) & 0xFFFF) | (s [2] << 16);
+	memcpy (dst + 4, &w, 4);
+	w = ((s [2] >> 16) & 0xFF) | (s [3] << 8);
+	memcpy (dst + 8, &w, 4);
+}
+
+#endif
+
+
 char *Alsa_pcmi::clear_16 (char *dst, int nfrm)
 {
 	while (nfrm--)
@@ -927,6 +1147,16 @@ char *Alsa_pcmi::play_16 (const float *src, char *dst, int nfrm, int step)
 	float     s;
 	short int d;
 
+#ifdef __SSE2__
+	if (step == 1 && _play_step == 2)
+	{
+		const __m128 scale = _mm_set1_ps ((float) 0x7fff);
+		for (; nfrm >= 4; nfrm -= 4, src += 4, dst += 8)
+		{
+			store_16 (dst, float_to_int (_mm_loadu_ps (src), scale));
+		}
+	}
+#endif
 	while (nfrm--)
 	{
 		s = *src;
@@ -964,6 +1194,16 @@ char *Alsa_pcmi::play_24 (const float *src, char *dst, int nfrm, int step)
 	float   s;
 	int     d;
 
+#ifdef __SSE2__
+	if (step == 1 && _play_step == 3)
+	{
+		const __m128 scale = _mm_set1_ps ((float) 0x007fffff);
+		for (; nfrm >= 4; nfrm -= 4, src += 4, dst += 12)
+		{
+			store_24 (dst, float_to_int (_mm_loadu_ps (src), scale));
+		}
+	}
+#endif
 	while (nfrm--)
 	{
 		s = *src;
@@ -1004,6 +1244,16 @@ char *Alsa_pcmi::play_32 (const float *src, char *dst, int nfrm, int step)
 	float   s;
 	int     d;
 
+#ifdef __SSE2__
+	if (step == 1 && _play_step == 4)
+	{
+		const __m128 scale = _mm_set1_ps ((float) 0x007fffff);
+		for (; nfrm >= 4; nfrm -= 4, src += 4, dst += 16)
+		{
+			_mm_storeu_si128 ((__m128i *) dst, _mm_slli_epi32 (float_to_int (_mm_loadu_ps (src), scale), 8));
+		}
+	}
+#endif
 	while (nfrm--)
 	{
 		s = *src;
@@ -1040,6 +1290,11 @@ char *Alsa_pcmi::play_32swap (const float *src, char *dst, int nfrm, int step)
 
 char *Alsa_pcmi::play_float (const float *src, char *dst, int nfrm, int step)
 {
+	if (step == 1 && _play_step == 4)
+	{
+		memcpy (dst, src, nfrm * sizeof (float));
+		return dst + nfrm * sizeof (float);
+	}
 	while (nfrm--)
 	{
 		*((float *) dst) = *src;
@@ -1052,6 +1307,16 @@ char *Alsa_pcmi::play_float (const float *src, char *dst, int nfrm, int step)
 
 const char *Alsa_pcmi::capt_16 (const char *src, float *dst, int nfrm, int step)
 {
+#ifdef __SSE2__
+	if (step == 1 && _capt_step == 2)
+	{
+		const __m128 scale = _mm_set1_ps ((float) 0x7fff);
+		for (; nfrm >= 4; nfrm -= 4, src += 8, dst += 4)
+		{
+			_mm_storeu_ps (dst, _mm_div_ps (_mm_cvtepi32_ps (load_16 (src)), scale));
+		}
+	}
+#endif
 	while (nfrm--)
 	{
 		const short int s = *((short int const *) src);
@@ -1085,6 +1350,16 @@ const char *Alsa_pcmi::capt_24 (const char *src, float *dst, int nfrm, int step)
 	float   d;
 	int     s;
 
+#ifdef __SSE2__
+	if (step == 1 && _capt_step == 3)
+	{
+		const __m128 scale = _mm_set1_ps ((float) 0x007fffff);
+		for (; nfrm >= 4; nfrm -= 4, src += 12, dst += 4)
+		{
+			_mm_storeu_ps (dst, _mm_div_ps (_mm_cvtepi32_ps (load_24 (src)), scale));
+		}
+	}
+#endif
 	while (nfrm--)
 	{
 		s  = (src [0] & 0xFF);
@@ -1120,6 +1395,16 @@ const char *Alsa_pcmi::capt_24swap (const char *src, float *dst, int nfrm, int s
 
 const char *Alsa_pcmi::capt_32 (const char *src, float *dst, int nfrm, int step)
 {
+#ifdef __SSE2__
+	if (step == 1 && _capt_step == 4)
+	{
+		const __m128 scale = _mm_set1_ps ((float) 0x7fffff00);
+		for (; nfrm >= 4; nfrm -= 4, src += 16, dst += 4)
+		{
+			_mm_storeu_ps (dst, _mm_div_ps (_mm_cvtepi32_ps (_mm_loadu_si128 ((__m128i const *) src)), scale));
+		}
+	}
+#endif
 	while (nfrm--)
 	{
 		const int s = *((int const *) src);
@@ -1151,6 +1436,11 @@ const char *Alsa_pcmi::capt_32swap (const char *src, float *dst, int nfrm, int s
 
 const char *Alsa_pcmi::capt_float (const char *src, float *dst, int nfrm, int step)
 {
+	if (step == 1 && _capt_step == 4)
+	{
+		memcpy (dst, src, nfrm * sizeof (float));
+		return src + nfrm * sizeof (float);
+	}
 	while (nfrm--)
 	{
 		*dst = *((float const *) src);
@@ -1159,3 +1449,157 @@ const char *Alsa_pcmi::capt_float (const char *src, float *dst, int nfrm, int st
 	}
 	return src;
 }
+
+
+#ifdef __SSE2__
+
+void Alsa_pcmi::play_block_float (const float *const *src, char *dst, int nchan, int nfrm)
+{
+	for (int f = 0; f < nfrm; f += 4, dst += 4 * _play_step)
+	{
+		for (int c = 0; c < nchan; c += 4)
+		{
+			__m128 r0 = _mm_loadu_ps (src [c] + f);
+			__m128 r1 = _mm_loadu_ps (src [c + 1] + f);
+			__m128 r2 = _mm_loadu_ps (src [c + 2] + f);
+			__m128 r3 = _mm_loadu_ps (src [c + 3] + f);
+			_MM_TRANSPOSE4_PS (r0, r1, r2, r3);
+			_mm_storeu_ps ((float *)(dst + 4 * c), r0);
+			_mm_storeu_ps ((float *)(dst + _play_step + 4 * c), r1);
+			_mm_storeu_ps ((float *)(dst + 2 * _play_step + 4 * c), r2);
+			_mm_storeu_ps ((float *)(dst + 3 * _play_step + 4 * c), r3);
+		}
+	}
+}
+
+void Alsa_pcmi::play_block_32 (const float *const *src, char *dst, int nchan, int nfrm)
+{
+	const __m128 scale = _mm_set1_ps ((float) 0x007fffff);
+	__m128i      r [4];
+
+	for (int f = 0; f < nfrm; f += 4, dst += 4 * _play_step)
+	{
+		for (int c = 0; c < nchan; c += 4)
+		{
+			play_4x4 (src + c, f, scale, r);
+			for (int j = 0; j < 4; j++)
+			{
+				_mm_storeu_si128 ((__m128i *)(dst + j * _play_step + 4 * c), _mm_slli_epi32 (r [j], 8));
+			}
+		}
+	}
+}
+
+void Alsa_pcmi::play_block_24 (const float *const *src, char *dst, int nchan, int nfrm)
+{
+	const __m128 scale = _mm_set1_ps ((float) 0x007fffff);
+	__m128i      r [4];
+
+	for (int f = 0; f < nfrm; f += 4, dst += 4 * _play_step)
+	{
+		for (int c = 0; c < nchan; c += 4)
+		{
+			play_4x4 (src + c, f, scale, r);
+			for (int j = 0; j < 4; j++)
+			{
+				store_24 (dst + j * _play_step + 3 * c, r [j]);
+			}
+		}
+	}
+}
+
+void Alsa_pcmi::play_block_16 (const float *const *src, char *dst, int nchan, int nfrm)
+{
+	const __m128 scale = _mm_set1_ps ((float) 0x7fff);
+	__m128i      r [4];
+
+	for (int f = 0; f < nfrm; f += 4, dst += 4 * _play_step)
+	{
+		for (int c = 0; c < nchan; c += 4)
+		{
+			play_4x4 (src + c, f, scale, r);
+			for (int j = 0; j < 4; j++)
+			{
+				store_16 (dst + j * _play_step + 2 * c, r [j]);
+			}
+		}
+	}
+}
+
+
+void Alsa_pcmi::capt_block_float (const char *src, float *const *dst, int nchan, int nfrm)
+{
+	const int s = _capt_step;
+
+	for (int f = 0; f < nfrm; f += 4, src += 4 * s)
+	{
+		for (int c = 0; c < nchan; c += 4)
+		{
+			const char *p = src + 4 * c;
+			capt_4x4 (_mm_loadu_ps ((float const *) p),
+			          _mm_loadu_ps ((float const *)(p + s)),
+			          _mm_loadu_ps ((float const *)(p + 2 * s)),
+			          _mm_loadu_ps ((float const *)(p + 3 * s)),
+			          dst + c, f);
+		}
+	}
+}
+
+void Alsa_pcmi::capt_block_32 (const char *src, float *const *dst, int nchan, int nfrm)
+{
+	const __m128 scale = _mm_set1_ps ((float) 0x7fffff00);
+	const int    s = _capt_step;
+
+	for (int f = 0; f < nfrm; f += 4, src += 4 * s)
+	{
+		for (int c = 0; c < nchan; c += 4)
+		{
+			const char *p = src + 4 * c;
+			capt_4x4 (_mm_div_ps (_mm_cvtepi32_ps (_mm_loadu_si128 ((__m128i const *) p)), scale),
+			          _mm_div_ps (_mm_cvtepi32_ps (_mm_loadu_si128 ((__m128i const *)(p + s))), scale),
+			          _mm_div_ps (_mm_cvtepi32_ps (_mm_loadu_si128 ((__m128i const *)(p + 2 * s))), scale),
+			          _mm_div_ps (_mm_cvtepi32_ps (_mm_loadu_si128 ((__m128i const *)(p + 3 * s))), scale),
+			          dst + c, f);
+		}
+	}
+}
+
+void Alsa_pcmi::capt_block_24 (const char *src, float *const *dst, int nchan, int nfrm)
+{
+	const __m128 scale = _mm_set1_ps ((float) 0x007fffff);
+	const int    s = _capt_step;
+
+	for (int f = 0; f < nfrm; f += 4, src += 4 * s)
+	{
+		for (int c = 0; c < nchan; c += 4)
+		{
+			const char *p = src + 3 * c;
+			capt_4x4 (_mm_div_ps (_mm_cvtepi32_ps (load_24 (p)), scale),
+			          _mm_div_ps (_mm_cvtepi32_ps (load_24 (p + s)), scale),
+			          _mm_div_ps (_mm_cvtepi32_ps (load_24 (p + 2 * s)), scale),
+			          _mm_div_ps (_mm_cvtepi32_ps (load_24 (p + 3 * s)), scale),
+			          dst + c, f);
+		}
+	}
+}
+
+void Alsa_pcmi::capt_block_16 (const char *src, float *const *dst, int nchan, int nfrm)
+{
+	const __m128 scale = _mm_set1_ps ((float) 0x7fff);
+	const int    s = _capt_step;
+
+	for (int f = 0; f < nfrm; f += 4, src += 4 * s)
+	{
+		for (int c = 0; c < nchan; c += 4)
+		{
+			const char *p = src + 2 * c;
+			capt_4x4 (_mm_div_ps (_mm_cvtepi32_ps (load_16 (p)), scale),
+			          _mm_div_ps (_mm_cvtepi32_ps (load_16 (p + s)), scale),
+			          _mm_div_ps (_mm_cvtepi32_ps (load_16 (p + 2 * s)), scale),
+			          _mm_div_ps (_mm_cvtepi32_ps (load_16 (p + 3 * s)), scale),
+			          dst + c, f);
+		}
+	}
+}
+
+#endif
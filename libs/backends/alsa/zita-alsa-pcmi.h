@@ -73,10 +73,12 @@ public:
 	int play_init (snd_pcm_uframes_t len);
 	void clear_chan (int chan, int len);
 	void play_chan (int chan, const float *src, int len, int step = 1);
+	void play_all (const float *const *src, int len);
 	int play_done (int len);
 
 	int capt_init (snd_pcm_uframes_t len);
 	void capt_chan (int chan, float *dst, int len, int step = 1);
+	void capt_all (float *const *dst, int len);
 	int capt_done (int len);
 
 	int play_avail (void)
@@ -119,9 +121,13 @@ public:
 
 private:
 
+	friend class Alsa_pcmi_bench;
+
 	typedef char *(Alsa_pcmi::*clear_function)(char *, int);
 	typedef char *(Alsa_pcmi::*play_function)(const float *, char *, int, int);
 	typedef const char *(Alsa_pcmi::*capt_function) (const char *, float *, int, int);
+	typedef void (Alsa_pcmi::*play_block_function)(const float *const *, char *, int, int);
+	typedef void (Alsa_pcmi::*capt_block_function)(const char *, float *const *, int, int);
 
 	enum { MAXPFD = 16, MAXCHAN = 128 };
 
@@ -151,6 +157,18 @@ private:
 	const char *capt_24swap (const char *src, float *dst, int nfrm, int step);
 	const char *capt_16swap (const char *src, float *dst, int nfrm, int step);
 
+#ifdef __SSE2__
+	void play_block_float (const float *const *src, char *dst, int nchan, int nfrm);
+	void play_block_32 (const float *const *src, char *dst, int nchan, int nfrm);
+	void play_block_24 (const float *const *src, char *dst, int nchan, int nfrm);
+	void play_block_16 (const float *const *src, char *dst, int nchan, int nfrm);
+
+	void capt_block_float (const char *src, float *const *dst, int nchan, int nfrm);
+	void capt_block_32 (const char *src, float *const *dst, int nchan, int nfrm);
+	void capt_block_24 (const char *src, float *const *dst, int nchan, int nfrm);
+	void capt_block_16 (const char *src, float *const *dst, int nchan, int nfrm);
+#endif
+
 	unsigned int           _fsamp;
 	snd_pcm_uframes_t      _fsize;
 	unsigned int           _play_nfrag;
@@ -185,6 +203,10 @@ private:
 	clear_function         _clear_func;
 	play_function          _play_func;
 	capt_function          _capt_func;
+	play_block_function    _play_block;
+	capt_block_function    _capt_block;
+	int                    _play_bytes;
+	int                    _capt_bytes;
 	void                  *_dummy [16];
 };
 
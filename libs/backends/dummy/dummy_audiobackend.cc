@@ -17,6 +17,10 @@
  * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
  */
 
+#ifndef __STDC_FORMAT_MACROS
+#define __STDC_FORMAT_MACROS
+#endif
+#include <inttypes.h>
 #include <math.h>
 #include <sys/time.h>
 #include <regex.h>
@@ -63,6 +67,7 @@ DummyAudioBackend::DummyAudioBackend (AudioEngine& e, AudioBackendInfo& info)
 	, _samplerate (48000)
 	, _samples_per_period (1024)
 	, _dsp_load (0)
+	, _reset_cycle_timing (0)
 	, _n_inputs (0)
 	, _n_outputs (0)
 	, _n_midi_inputs (0)
@@ -86,6 +91,7 @@ DummyAudioBackend::DummyAudioBackend (AudioEngine& e, AudioBackendInfo& info)
 		_driver_speed.push_back (DriverSpeed (_("15x Speed"),    0.06666f));
 		_driver_speed.push_back (DriverSpeed (_("20x Speed"),    0.05f));
 		_driver_speed.push_back (DriverSpeed (_("50x Speed"),    0.02f));
+		_driver_speed.push_back (DriverSpeed (_("Max Speed"),    0.0f));
 	}
 
 }
@@ -373,6 +379,7 @@ DummyAudioBackend::enumerate_midi_options () const
 		_midi_options.push_back (_("Midi Event Generators"));
 		_midi_options.push_back (_("8 in, 8 out, Loopback"));
 		_midi_options.push_back (_("MIDI to Audio, Loopback"));
+		_midi_options.push_back (_("8 in, 8 out, Stress"));
 		_midi_options.push_back (_("No MIDI I/O"));
 	}
 	return _midi_options;
@@ -403,6 +410,10 @@ DummyAudioBackend::set_midi_option (const std::string& opt)
 		_n_midi_inputs = _n_midi_outputs = UINT32_MAX;
 		_midi_mode = MidiToAudio;
 	}
+	else if (opt == _("8 in, 8 out, Stress")) {
+		_n_midi_inputs = _n_midi_outputs = 8;
+		_midi_mode = MidiStress;
+	}
 	else {
 		_n_midi_inputs = _n_midi_outputs = 0;
 	}
@@ -511,6 +522,91 @@ DummyAudioBackend::dsp_load () const
 	return 100.f * _dsp_load;
 }
 
+void
+DummyAudioBackend::reset_cycle_timing ()
+{
+	if (_running) {
+		g_atomic_int_set (&_reset_cycle_timing, 1);
+	} else {
+		_cycle_timing.reset (_x_get_monotonic_usec ());
+	}
+}
+
+std::string
+DummyAudioBackend::cycle_timing_report () const
+{
+	/* the process thread may update the statistics concurrently,
+	 * values are not an exact snapshot. */
+	const CycleTiming ct (_cycle_timing);
+
+	if (ct.cnt == 0) {
+		return "";
+	}
+
+	const double wall    = 1e-6 * (ct.end - ct.start);
+	const double audio   = ct.samples / (double) _samplerate;
+	const double nominal = 1e6 * _samples_per_period / _samplerate;
+
+	std::stringstream ss;
+	char line[256];
+
+	snprintf (line, sizeof (line), _("Process cycles: %" PRIu64 ", %d samples per cycle, driver: %s\n"),
+			ct.cnt, (int) _samples_per_period, driver_name ().c_str ());
+	ss << line;
+	snprintf (line, sizeof (line), _("Processed %.1f sec of audio in %.1f sec, realtime factor: %.2fx\n"),
+			audio, wall, wall > 0 ? audio / wall : 0);
+	ss << line;
+	snprintf (line, sizeof (line), _("Cycle duration [usec]: min %" PRId64 ", avg %.1f, max %" PRId64 " (nominal %.1f)\n"),
+			ct.min, ct.sum / (double) ct.cnt, ct.max, nominal);
+	ss << line;
+
+	int b0 = 0;
+	int b1 = CycleTiming::n_bins - 1;
+	while (b0 < b1 && ct.hist[b0] == 0) { ++b0; }
+	while (b1 > b0 && ct.hist[b1] == 0) { --b1; }
+
+	for (int b = b0; b <= b1; ++b) {
+		const double pc = 100. * ct.hist[b] / (double) ct.cnt;
+		snprintf (line, sizeof (line), "  %8d .. %8d usec: %10" PRIu64 " %5.1f%% ",
+				b == 0 ? 0 : (1 << b), 1 << (b + 1), ct.hist[b], pc);
+		ss << line << std::string ((size_t) rint (pc / 2.5), '#') << "\n";
+	}
+	return ss.str ();
+}
+
+void
+DummyAudioBackend::CycleTiming::reset (int64_t now)
+{
+	start = end = now;
+	samples = 0;
+	cnt = 0;
+	min = max = sum = 0;
+	memset (hist, 0, sizeof (hist));
+}
+
+void
+DummyAudioBackend::CycleTiming::update (int64_t cycle_start, int64_t cycle_end, pframes_t n_samples)
+{
+	const int64_t elapsed = cycle_end - cycle_start;
+
+	if (cnt == 0 || elapsed < min) {
+		min = elapsed;
+	}
+	if (elapsed > max) {
+		max = elapsed;
+	}
+	sum += elapsed;
+	samples += n_samples;
+	++cnt;
+	end = cycle_end;
+
+	int b = 0;
+	while (b < n_bins - 1 && elapsed >= (2 << b)) {
+		++b;
+	}
+	++hist[b];
+}
+
 size_t
 DummyAudioBackend::raw_buffer_size (DataType t)
 {
@@ -911,6 +1007,11 @@ DummyAudioBackend::register_system_ports()
 				static_cast<DummyMidiPort*>(p)->set_pretty_name (name);
 			}
 		}
+		else if (_midi_mode == MidiStress) {
+			/* 1 event every 2, 4, 8 or 16 samples */
+			std::string name = static_cast<DummyMidiPort*>(p)->setup_stress_generator (2 << (i % 4));
+			static_cast<DummyMidiPort*>(p)->set_pretty_name (name);
+		}
 	}
 
 	lr.min = lr.max = _systemic_output_latency;
@@ -1108,11 +1209,11 @@ DummyAudioBackend::midi_event_get (
 	if (event_index >= source.size ()) {
 		return -1;
 	}
-	DummyMidiEvent * const event = source[event_index].get ();
+	DummyMidiEvent const& event = source[event_index];
 
-	timestamp = event->timestamp ();
-	size = event->size ();
-	*buf = event->data ();
+	timestamp = event.timestamp ();
+	size = event.size ();
+	*buf = source.data (event);
 	return 0;
 }
 
@@ -1124,11 +1225,13 @@ DummyAudioBackend::midi_event_put (
 {
 	assert (buffer && port_buffer);
 	DummyMidiBuffer& dst = * static_cast<DummyMidiBuffer*>(port_buffer);
-	if (dst.size () && (pframes_t)dst.back ()->timestamp () > timestamp) {
+	if (dst.size () && (pframes_t)dst.back ().timestamp () > timestamp) {
 		// nevermind, ::get_buffer() sorts events, but always print warning
-		fprintf (stderr, "DummyMidiBuffer: it's too late for this event %d > %d.\n", (pframes_t)dst.back ()->timestamp (), timestamp);
+		fprintf (stderr, "DummyMidiBuffer: it's too late for this event %d > %d.\n", (pframes_t)dst.back ().timestamp (), timestamp);
+	}
+	if (!dst.push_back (timestamp, buffer, size)) {
+		return -1;
 	}
-	dst.push_back (boost::shared_ptr<DummyMidiEvent>(new DummyMidiEvent (timestamp, buffer, size)));
 #if 0 // DEBUG MIDI EVENTS
 	printf("DummyAudioBackend::midi_event_put %d, %zu: ", timestamp, size);
 	for (size_t xx = 0; xx < size; ++xx) {
@@ -1322,6 +1425,9 @@ DummyAudioBackend::main_process_thread ()
 
 	int64_t clock1;
 	clock1 = -1;
+	_cycle_timing.reset (_x_get_monotonic_usec ());
+	g_atomic_int_set (&_reset_cycle_timing, 0);
+
 	while (_running) {
 		const size_t samples_per_period = _samples_per_period;
 
@@ -1330,6 +1436,10 @@ DummyAudioBackend::main_process_thread ()
 			engine.freewheel_callback (_freewheel);
 		}
 
+		if (g_atomic_int_compare_and_exchange (&_reset_cycle_timing, 1, 0)) {
+			_cycle_timing.reset (_x_get_monotonic_usec ());
+		}
+
 		// re-set input buffers, generate on demand.
 		for (std::vector<DummyAudioPort*>::const_iterator it = _system_inputs.begin (); it != _system_inputs.end (); ++it) {
 			(*it)->next_period();
@@ -1338,10 +1448,12 @@ DummyAudioBackend::main_process_thread ()
 			(*it)->next_period();
 		}
 
+		const int64_t cycle_start = _x_get_monotonic_usec ();
 		if (engine.process_callback (samples_per_period)) {
 			return 0;
 		}
 		_processed_samples += samples_per_period;
+		_cycle_timing.update (cycle_start, _x_get_monotonic_usec (), samples_per_period);
 
 		if (_device == _("Loopback") && _midi_mode != MidiToAudio) {
 			int opn = 0;
@@ -1379,7 +1491,9 @@ DummyAudioBackend::main_process_thread ()
 
 			const int64_t elapsed_time = _dsp_load_calc.elapsed_time_us ();
 			const int64_t nominal_time = _dsp_load_calc.get_max_time_us ();
-			if (elapsed_time < nominal_time) {
+			if (_speedup == 0) {
+				/* max speed: run cycles back to back */
+			} else if (elapsed_time < nominal_time) {
 				const int64_t sleepy = _speedup * (nominal_time - elapsed_time);
 				Glib::usleep (std::max ((int64_t) 100, sleepy));
 			} else {
@@ -1387,7 +1501,9 @@ DummyAudioBackend::main_process_thread ()
 			}
 		} else {
 			_dsp_load = 1.0f;
-			Glib::usleep (100); // don't hog cpu
+			if (_speedup != 0) {
+				Glib::usleep (100); // don't hog cpu
+			}
 		}
 
 		/* beginning of next cycle */
@@ -1905,12 +2021,12 @@ void DummyAudioPort::midi_to_wavetable (DummyMidiBuffer const * const src, size_
 	 * (here: midi-out playback-latency + audio-in capture-latency)
 	 */
 	for (DummyMidiBuffer::const_iterator it = src->begin (); it != src->end (); ++it) {
-		const pframes_t t = (*it)->timestamp();
+		const pframes_t t = it->timestamp();
 		assert(t < n_samples);
 		// somewhat arbitrary mapping for quick visual feedback
 		float v = -.5f;
-		if ((*it)->size() == 3) {
-			const unsigned char *d = (*it)->const_data();
+		if (it->size() == 3) {
+			const unsigned char *d = src->data (*it);
 			if ((d[0] & 0xf0) == 0x90) { // note on
 				v = .25f + d[2] / 512.f;
 			}
@@ -2133,6 +2249,11 @@ void* DummyAudioPort::get_buffer (pframes_t n_samples)
 			if (source->is_physical() && source->is_terminal()) {
 				source->get_buffer(n_samples); // generate signal.
 			}
+			if (connections.size () == 1) {
+				/* single source: alias its buffer, no copy.
+				 * Input port buffers are read-only, see PortEngine::get_buffer */
+				return source->buffer ();
+			}
 			memcpy (_buffer, source->const_buffer (), n_samples * sizeof (Sample));
 			while (++it != connections.end ()) {
 				source = static_cast<DummyAudioPort*>(*it);
@@ -2161,9 +2282,15 @@ DummyMidiPort::DummyMidiPort (DummyAudioBackend &b, const std::string& name, Por
 	, _midi_seq_spb (0)
 	, _midi_seq_time (0)
 	, _midi_seq_pos (0)
+	, _stress_interval (0)
+	, _stress_offset (0)
+	, _stress_count (0)
 {
-	_buffer.clear ();
-	_loopback.clear ();
+	_buffer.reserve (DummyMidiBuffer::default_event_capacity, DummyMidiBuffer::default_data_capacity);
+	if (flags & IsPhysical) {
+		/* only system ports can be loopback targets */
+		_loopback.reserve (DummyMidiBuffer::default_event_capacity, DummyMidiBuffer::default_data_capacity);
+	}
 }
 
 DummyMidiPort::~DummyMidiPort () {
@@ -2171,18 +2298,9 @@ DummyMidiPort::~DummyMidiPort () {
 	_loopback.clear ();
 }
 
-struct MidiEventSorter {
-	bool operator() (const boost::shared_ptr<DummyMidiEvent>& a, const boost::shared_ptr<DummyMidiEvent>& b) {
-		return *a < *b;
-	}
-};
-
 void DummyMidiPort::set_loopback (DummyMidiBuffer const * const src)
 {
-	_loopback.clear ();
-	for (DummyMidiBuffer::const_iterator it = src->begin (); it != src->end (); ++it) {
-		_loopback.push_back (boost::shared_ptr<DummyMidiEvent>(new DummyMidiEvent (**it)));
-	}
+	_loopback.copy (*src);
 }
 
 std::string
@@ -2196,6 +2314,18 @@ DummyMidiPort::setup_generator (int seq_id, const float sr)
 	return DummyMidiData::sequence_names[seq_id];
 }
 
+std::string
+DummyMidiPort::setup_stress_generator (uint32_t interval)
+{
+	DummyPort::setup_random_number_generator();
+	_stress_interval = std::max<uint32_t> (1, interval);
+	_stress_offset = 0;
+	_stress_count = 0;
+	std::stringstream ss;
+	ss << "Stress, 1 event / " << _stress_interval << " sample" << (_stress_interval > 1 ? "s" : "");
+	return ss.str ();
+}
+
 void DummyMidiPort::midi_generate (const pframes_t n_samples)
 {
 	Glib::Threads::Mutex::Lock lm (generator_lock);
@@ -2206,10 +2336,13 @@ void DummyMidiPort::midi_generate (const pframes_t n_samples)
 	_buffer.clear ();
 	_gen_cycle = true;
 
+	if (_stress_interval > 0) {
+		stress_generate (n_samples);
+		return;
+	}
+
 	if (_midi_seq_spb == 0 || !_midi_seq_dat) {
-		for (DummyMidiBuffer::const_iterator it = _loopback.begin (); it != _loopback.end (); ++it) {
-			_buffer.push_back (boost::shared_ptr<DummyMidiEvent>(new DummyMidiEvent (**it)));
-		}
+		_buffer.copy (_loopback);
 		return;
 	}
 
@@ -2221,11 +2354,9 @@ void DummyMidiPort::midi_generate (const pframes_t n_samples)
 		if ((pframes_t) ev_beat_time >= n_samples) {
 			break;
 		}
-		_buffer.push_back (boost::shared_ptr<DummyMidiEvent>(new DummyMidiEvent (
-						ev_beat_time,
-						_midi_seq_dat[_midi_seq_pos].event,
-						_midi_seq_dat[_midi_seq_pos].size
-						)));
+		_buffer.push_back (ev_beat_time,
+				_midi_seq_dat[_midi_seq_pos].event,
+				_midi_seq_dat[_midi_seq_pos].size);
 		++_midi_seq_pos;
 
 		if (_midi_seq_dat[_midi_seq_pos].event[0] == 0xff && _midi_seq_dat[_midi_seq_pos].event[1] == 0xff) {
@@ -2236,6 +2367,55 @@ void DummyMidiPort::midi_generate (const pframes_t n_samples)
 	_midi_seq_time += n_samples;
 }
 
+void DummyMidiPort::stress_generate (const pframes_t n_samples)
+{
+	/* dense stream of note-on/off, CC, pitch-bend and
+	 * occasional sysex messages on all 16 channels */
+	pframes_t t;
+	for (t = _stress_offset; t < n_samples; t += _stress_interval, ++_stress_count) {
+		const uint32_t r = randi ();
+		const uint8_t chn = _stress_count & 0x0f;
+		uint8_t d[16];
+		size_t size = 3;
+
+		switch ((_stress_count >> 4) & 0x3) {
+			case 0:
+				d[0] = 0x90 | chn;
+				d[1] = r & 0x7f;
+				d[2] = 1 + ((r >> 8) % 127);
+				break;
+			case 1:
+				d[0] = 0x80 | chn;
+				d[1] = r & 0x7f;
+				d[2] = 0;
+				break;
+			case 2:
+				d[0] = 0xb0 | chn;
+				d[1] = r & 0x7f;
+				d[2] = (r >> 8) & 0x7f;
+				break;
+			default:
+				d[0] = 0xe0 | chn;
+				d[1] = r & 0x7f;
+				d[2] = (r >> 8) & 0x7f;
+				break;
+		}
+
+		if ((_stress_count & 0xff) == 0xff) {
+			/* universal non-realtime sysex */
+			size = sizeof (d);
+			d[0] = 0xf0;
+			d[1] = 0x7e;
+			for (size_t i = 2; i < size - 1; ++i) {
+				d[i] = (r >> i) & 0x7f;
+			}
+			d[size - 1] = 0xf7;
+		}
+
+		_buffer.push_back (t, d, size);
+	}
+	_stress_offset = t - n_samples;
+}
 
 void* DummyMidiPort::get_buffer (pframes_t n_samples)
 {
@@ -2249,12 +2429,8 @@ void* DummyMidiPort::get_buffer (pframes_t n_samples)
 			if (source->is_physical() && source->is_terminal()) {
 				source->get_buffer(n_samples); // generate signal.
 			}
-			const DummyMidiBuffer *src = source->const_buffer ();
-			for (DummyMidiBuffer::const_iterator it = src->begin (); it != src->end (); ++it) {
-				_buffer.push_back (boost::shared_ptr<DummyMidiEvent>(new DummyMidiEvent (**it)));
-			}
+			_buffer.merge (*source->const_buffer ());
 		}
-		std::stable_sort (_buffer.begin (), _buffer.end (), MidiEventSorter());
 	} else if (is_output () && is_physical () && is_terminal()) {
 		if (!_gen_cycle) {
 			midi_generate(n_samples);
@@ -2263,28 +2439,63 @@ void* DummyMidiPort::get_buffer (pframes_t n_samples)
 	return &_buffer;
 }
 
-DummyMidiEvent::DummyMidiEvent (const pframes_t timestamp, const uint8_t* data, size_t size)
-	: _size (size)
-	, _timestamp (timestamp)
-	, _data (0)
+const size_t DummyMidiBuffer::default_event_capacity;
+const size_t DummyMidiBuffer::default_data_capacity;
+
+void
+DummyMidiBuffer::reserve (size_t n_events, size_t n_bytes)
+{
+	clear ();
+	_events.reserve (n_events);
+	_data.resize (n_bytes);
+}
+
+bool
+DummyMidiBuffer::push_back (pframes_t timestamp, const uint8_t* data, size_t size)
 {
+	if (_events.size () == _events.capacity () || _used + size > _data.size ()) {
+		++_dropped;
+		return false;
+	}
 	if (size > 0) {
-		_data = (uint8_t*) malloc (size);
-		memcpy (_data, data, size);
+		memcpy (&_data[_used], data, size);
 	}
+	_events.push_back (DummyMidiEvent (timestamp, _used, size));
+	_used += size;
+	return true;
 }
 
-DummyMidiEvent::DummyMidiEvent (const DummyMidiEvent& other)
-	: _size (other.size ())
-	, _timestamp (other.timestamp ())
-	, _data (0)
+bool
+DummyMidiBuffer::insert (pframes_t timestamp, const uint8_t* data, size_t size)
 {
-	if (other.size () && other.const_data ()) {
-		_data = (uint8_t*) malloc (other.size ());
-		memcpy (_data, other.const_data (), other.size ());
+	if (!push_back (timestamp, data, size)) {
+		return false;
 	}
-};
+	/* events usually arrive in order, only the event data
+	 * headers are moved, the data remains in place. */
+	const DummyMidiEvent ev = _events.back ();
+	size_t i = _events.size () - 1;
+	while (i > 0 && ev < _events[i - 1]) {
+		_events[i] = _events[i - 1];
+		--i;
+	}
+	_events[i] = ev;
+	return true;
+}
 
-DummyMidiEvent::~DummyMidiEvent () {
-	free (_data);
-};
+void
+DummyMidiBuffer::merge (DummyMidiBuffer const& src)
+{
+	for (const_iterator it = src.begin (); it != src.end (); ++it) {
+		insert (it->timestamp (), src.data (*it), it->size ());
+	}
+}
+
+void
+DummyMidiBuffer::copy (DummyMidiBuffer const& src)
+{
+	clear ();
+	for (const_iterator it = src.begin (); it != src.end (); ++it) {
+		push_back (it->timestamp (), src.data (*it), it->size ());
+	}
+}
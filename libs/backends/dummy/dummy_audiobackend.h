@@ -53,21 +53,64 @@ namespace DummyMidiData {
 
 class DummyMidiEvent {
 	public:
-		DummyMidiEvent (const pframes_t timestamp, const uint8_t* data, size_t size);
-		DummyMidiEvent (const DummyMidiEvent& other);
-		~DummyMidiEvent ();
+		DummyMidiEvent (const pframes_t timestamp, const uint32_t offset, const uint32_t size)
+			: _timestamp (timestamp), _offset (offset), _size (size) {}
 		size_t size () const { return _size; };
 		pframes_t timestamp () const { return _timestamp; };
-		const unsigned char* const_data () const { return _data; };
-		unsigned char* data () { return _data; };
+		uint32_t offset () const { return _offset; };
 		bool operator< (const DummyMidiEvent &other) const { return timestamp () < other.timestamp (); };
 	private:
-		size_t _size;
 		pframes_t _timestamp;
-		uint8_t *_data;
+		uint32_t  _offset; // in the data arena of the buffer
+		uint32_t  _size;
 };
 
-typedef std::vector<boost::shared_ptr<DummyMidiEvent> > DummyMidiBuffer;
+/** MIDI events of a port for one process cycle.
+ *
+ * Event headers and data are kept in flat, preallocated arrays.
+ * Adding events never allocates memory, excess events are dropped.
+ */
+class DummyMidiBuffer {
+	public:
+		DummyMidiBuffer () : _used (0), _dropped (0) {}
+
+		typedef std::vector<DummyMidiEvent>::const_iterator const_iterator;
+
+		/* not RT safe */
+		void reserve (size_t n_events, size_t n_bytes);
+
+		void clear () { _events.clear (); _used = 0; }
+		size_t size () const { return _events.size (); }
+		bool empty () const { return _events.empty (); }
+
+		const_iterator begin () const { return _events.begin (); }
+		const_iterator end () const { return _events.end (); }
+		DummyMidiEvent const& operator[] (size_t i) const { return _events[i]; }
+		DummyMidiEvent const& back () const { return _events.back (); }
+
+		const uint8_t* data (DummyMidiEvent const& ev) const { return &_data[ev.offset ()]; }
+
+		/** append an event, @return false if the buffer is full */
+		bool push_back (pframes_t timestamp, const uint8_t* data, size_t size);
+		/** add an event after all events with the same or an earlier timestamp */
+		bool insert (pframes_t timestamp, const uint8_t* data, size_t size);
+		/** add all events of @a src, keeping the buffer sorted */
+		void merge (DummyMidiBuffer const& src);
+		/** replace the content with a copy of @a src */
+		void copy (DummyMidiBuffer const& src);
+
+		/** number of events that did not fit, since the buffer was created */
+		uint64_t dropped () const { return _dropped; }
+
+		static const size_t default_event_capacity = 4096;
+		static const size_t default_data_capacity  = 32768;
+
+	private:
+		std::vector<DummyMidiEvent> _events;
+		std::vector<uint8_t>        _data;
+		size_t                      _used;
+		uint64_t                    _dropped;
+};
 
 class DummyPort {
 	protected:
@@ -210,6 +253,7 @@ class DummyMidiPort : public DummyPort {
 		const DummyMidiBuffer * const_buffer () const { return &_buffer; }
 
 		std::string setup_generator (int, float const);
+		std::string setup_stress_generator (uint32_t interval);
 		void set_loopback (DummyMidiBuffer const * const src);
 
 	private:
@@ -222,6 +266,12 @@ class DummyMidiPort : public DummyPort {
 		int32_t _midi_seq_time;
 		uint32_t _midi_seq_pos;
 		DummyMidiData::MIDISequence const * _midi_seq_dat;
+
+		// midi throughput stress generator
+		void stress_generate (const pframes_t n_samples);
+		uint32_t _stress_interval; // samples between events, 0: disabled
+		uint32_t _stress_offset;   // position of the next event in the next cycle
+		uint32_t _stress_count;
 }; // class DummyMidiPort
 
 class DummyAudioBackend : public AudioBackend {
@@ -307,6 +357,9 @@ class DummyAudioBackend : public AudioBackend {
 		float dsp_load () const;
 		size_t raw_buffer_size (DataType t);
 
+		std::string cycle_timing_report () const;
+		void reset_cycle_timing ();
+
 		/* Process time */
 		samplepos_t sample_time ();
 		samplepos_t sample_time_at_cycle_start ();
@@ -391,6 +444,7 @@ class DummyAudioBackend : public AudioBackend {
 			MidiGenerator,
 			MidiLoopback,
 			MidiToAudio,
+			MidiStress,
 		};
 
 		struct DriverSpeed {
@@ -415,6 +469,26 @@ class DummyAudioBackend : public AudioBackend {
 		size_t _samples_per_period;
 		float  _dsp_load;
 		DSPLoadCalculator _dsp_load_calc;
+
+		/* process cycle timing statistics */
+		struct CycleTiming {
+			CycleTiming () { reset (0); }
+			void reset (int64_t now);
+			void update (int64_t cycle_start, int64_t cycle_end, pframes_t n_samples);
+
+			static const int n_bins = 24; // log2 usec, 1 usec .. 8 sec
+
+			int64_t     start;   // wall-clock, usec
+			int64_t     end;
+			samplecnt_t samples;
+			uint64_t    cnt;
+			int64_t     min;
+			int64_t     max;
+			int64_t     sum;
+			uint64_t    hist[n_bins];
+		};
+		CycleTiming _cycle_timing;
+		gint        _reset_cycle_timing;
 		static size_t _max_buffer_size;
 
 		uint32_t _n_inputs;
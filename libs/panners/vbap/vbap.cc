@@ -17,6 +17,7 @@
 
 */
 
+#include <algorithm>
 #include <cmath>
 #include <cstdlib>
 #include <cstdio>
@@ -37,6 +38,7 @@
 #include "ardour/buffer_set.h"
 #include "ardour/pan_controllable.h"
 #include "ardour/pannable.h"
+#include "ardour/session.h"
 #include "ardour/speakers.h"
 
 #include "vbap.h"
@@ -77,6 +79,7 @@ VBAPanner::Signal::resize_gains (uint32_t n)
 VBAPanner::VBAPanner (boost::shared_ptr<Pannable> p, boost::shared_ptr<Speakers> s)
 	: Panner (p)
 	, _speakers (new VBAPSpeakers (s))
+	, _gains_pending (0)
 {
         _pannable->pan_azimuth_control->Changed.connect_same_thread (*this, boost::bind (&VBAPanner::update, this));
         _pannable->pan_elevation_control->Changed.connect_same_thread (*this, boost::bind (&VBAPanner::update, this));
@@ -120,13 +123,29 @@ VBAPanner::configure_io (ChanCount in, ChanCount /* ignored - we use Speakers */
 
 void
 VBAPanner::update ()
+{
+        /* this is also called in process context, when automation playback
+           changes the controls. distribute_automated () computes the directions
+           for every block then, so there is nothing to be done here.
+        */
+        if (!(_pannable->automation_playback () && _pannable->session().transport_rolling ())) {
+                compute_directions (_pannable->pan_azimuth_control->get_value(),
+                                    _pannable->pan_width_control->get_value(),
+                                    _pannable->pan_elevation_control->get_value());
+        }
+
+        SignalPositionChanged(); /* emit */
+}
+
+void
+VBAPanner::compute_directions (double azimuth, double width, double elevation)
 {
         /* recompute signal directions based on panner azimuth and, if relevant, width (diffusion) and elevation parameters */
-        double elevation = _pannable->pan_elevation_control->get_value() * 90.0;
+        elevation *= 90.0;
 
         if (_signals.size() > 1) {
-                double w = - (_pannable->pan_width_control->get_value());
-                double signal_direction = 1.0 - (_pannable->pan_azimuth_control->get_value() + (w/2));
+                double w = - width;
+                double signal_direction = 1.0 - (azimuth + (w/2));
                 double grd_step_per_signal = w / (_signals.size() - 1);
                 for (vector<Signal*>::iterator s = _signals.begin(); s != _signals.end(); ++s) {
 
@@ -137,104 +156,137 @@ VBAPanner::update ()
                         signal_direction -= (double)over;
 
                         signal->direction = AngularVector (signal_direction * 360.0, elevation);
-                        compute_gains (signal->desired_gains, signal->desired_outputs, signal->direction.azi, signal->direction.ele);
+                        if (!compute_gains (signal->desired_gains, signal->desired_outputs, signal->direction.azi, signal->direction.ele)) {
+                                g_atomic_int_set (&_gains_pending, 1);
+                        }
                         signal_direction += grd_step_per_signal;
                 }
         } else if (_signals.size() == 1) {
-                double center = (1.0 - _pannable->pan_azimuth_control->get_value()) * 360.0;
+                double center = (1.0 - azimuth) * 360.0;
 
                 /* width has no role to play if there is only 1 signal: VBAP does not do "diffusion" of a single channel */
 
                 Signal* s = _signals.front();
                 s->direction = AngularVector (center, elevation);
-                compute_gains (s->desired_gains, s->desired_outputs, s->direction.azi, s->direction.ele);
+                if (!compute_gains (s->desired_gains, s->desired_outputs, s->direction.azi, s->direction.ele)) {
+                        g_atomic_int_set (&_gains_pending, 1);
+                }
         }
-
-        SignalPositionChanged(); /* emit */
 }
 
-void
+bool
 VBAPanner::compute_gains (double gains[3], int speaker_ids[3], int azi, int ele)
 {
-	/* calculates gain factors using loudspeaker setup and given direction */
-	double cartdir[3];
-	double power;
-	int i,j,k;
-	double small_g;
-	double big_sm_g, gtmp[3];
-	const int dimension = _speakers->dimension();
-	assert(dimension == 2 || dimension == 3);
-
-	spherical_to_cartesian (azi, ele, 1.0, cartdir[0], cartdir[1], cartdir[2]);
-	big_sm_g = -100000.0;
+	/* the gains for all directions are precomputed by VBAPSpeakers when the layout changes.
+	   If the grid is being rebuilt, the previous gains are kept.
+	*/
+	double g[3];
+	int    ls[3];
 
-	gains[0] = gains[1] = gains[2] = 0;
-	speaker_ids[0] = speaker_ids[1] = speaker_ids[2] = 0;
+	if (!_speakers->lookup_gains (azi, ele, g, ls)) {
+		return false;
+	}
 
-	for (i = 0; i < _speakers->n_tuples(); i++) {
+	memcpy (gains, g, sizeof (g));
+	memcpy (speaker_ids, ls, sizeof (ls));
+	return true;
+}
 
-		small_g = 10000000.0;
+void
+VBAPanner::distribute (BufferSet& inbufs, BufferSet& obufs, gain_t gain_coefficient, pframes_t nframes)
+{
+        uint32_t n;
+        vector<Signal*>::iterator s;
 
-		for (j = 0; j < dimension; j++) {
+        assert (inbufs.count().n_audio() == _signals.size());
 
-			gtmp[j] = 0.0;
+        if (g_atomic_int_compare_and_exchange (&_gains_pending, 1, 0)) {
+                /* the speaker grid was rebuilt during the last update */
+                for (s = _signals.begin(); s != _signals.end(); ++s) {
+                        Signal* signal (*s);
+                        if (!compute_gains (signal->desired_gains, signal->desired_outputs, signal->direction.azi, signal->direction.ele)) {
+                                g_atomic_int_set (&_gains_pending, 1);
+                        }
+                }
+        }
 
-			for (k = 0; k < dimension; k++) {
-				gtmp[j] += cartdir[k] * _speakers->matrix(i)[j * dimension + k];
-			}
+        for (s = _signals.begin(), n = 0; s != _signals.end(); ++s, ++n) {
 
-			if (gtmp[j] < small_g) {
-				small_g = gtmp[j];
-			}
-		}
+                Signal* signal (*s);
 
-		if (small_g > big_sm_g) {
+                distribute_one (inbufs.get_audio (n), obufs, gain_coefficient, nframes, n);
 
-			big_sm_g = small_g;
+                memcpy (signal->outputs, signal->desired_outputs, sizeof (signal->outputs));
+        }
+}
 
-			gains[0] = gtmp[0];
-			gains[1] = gtmp[1];
+void
+VBAPanner::distribute_automated (BufferSet& inbufs, BufferSet& obufs,
+                                 samplepos_t start, samplepos_t end, pframes_t nframes,
+                                 pan_t** /*buffers*/)
+{
+        /* gains are updated at block rate: the directions are evaluated at the
+           end of the block, and distribute () ramps from the current gains to
+           the new ones over the block.
+        */
 
-			speaker_ids[0] = _speakers->speaker_for_tuple (i, 0);
-			speaker_ids[1] = _speakers->speaker_for_tuple (i, 1);
+        bool ok_azi, ok_width, ok_ele;
 
-			if (_speakers->dimension() == 3) {
-				gains[2] = gtmp[2];
-				speaker_ids[2] = _speakers->speaker_for_tuple (i, 2);
-			} else {
-				gains[2] = 0.0;
-				speaker_ids[2] = -1;
-			}
-		}
-	}
+        const double azimuth   = _pannable->pan_azimuth_control->list()->rt_safe_eval (end, ok_azi);
+        const double width     = _pannable->pan_width_control->list()->rt_safe_eval (end, ok_width);
+        const double elevation = _pannable->pan_elevation_control->list()->rt_safe_eval (end, ok_ele);
 
-	power = sqrt (gains[0]*gains[0] + gains[1]*gains[1] + gains[2]*gains[2]);
+        if (ok_azi && ok_width && ok_ele) {
+                compute_directions (azimuth, width, elevation);
+        }
+        /* else the automation list is being modified: keep the previous gains */
 
-	if (power > 0) {
-		gains[0] /= power;
-		gains[1] /= power;
-		gains[2] /= power;
-	}
+        distribute (inbufs, obufs, 1.0, nframes);
 }
 
-void
-VBAPanner::distribute (BufferSet& inbufs, BufferSet& obufs, gain_t gain_coefficient, pframes_t nframes)
+/* add src to up to 6 outputs, with gains ramped linearly from g0 to g1
+   over nframes. The input is processed in short chunks, so that it is read
+   from cache for all outputs, and the per-output loops have no dependency
+   between samples so that they are vectorized.
+*/
+static void
+mix_to_outputs (Sample* const* dst, gain_t const* g0, gain_t const* g1, uint32_t n_dst, Sample const* src, pframes_t nframes)
 {
-        uint32_t n;
-        vector<Signal*>::iterator s;
+        const pframes_t chunk = 64;
 
-        assert (inbufs.count().n_audio() == _signals.size());
+        for (pframes_t s = 0; s < nframes; s += chunk) {
 
-        for (s = _signals.begin(), n = 0; s != _signals.end(); ++s, ++n) {
+                const pframes_t n = min (chunk, nframes - s);
+                Sample const* const in = src + s;
 
-                Signal* signal (*s);
+                for (uint32_t o = 0; o < n_dst; ++o) {
 
-                distribute_one (inbufs.get_audio (n), obufs, gain_coefficient, nframes, n);
+                        Sample* const out = dst[o] + s;
+                        const gain_t delta = (g1[o] - g0[o]) / nframes;
 
-                memcpy (signal->outputs, signal->desired_outputs, sizeof (signal->outputs));
+                        if (delta == 0) {
+                                const gain_t g = g0[o];
+                                for (pframes_t i = 0; i < n; ++i) {
+                                        out[i] += in[i] * g;
+                                }
+                        } else {
+                                const gain_t g = g0[o] + s * delta;
+                                for (pframes_t i = 0; i < n; ++i) {
+                                        out[i] += in[i] * (g + i * delta);
+                                }
+                        }
+                }
         }
 }
 
+static Sample*
+output_buffer (BufferSet& obufs, uint32_t n)
+{
+        AudioBuffer& buf (obufs.get_audio (n));
+        buf.set_written (true);
+        return buf.data ();
+}
+
 void
 VBAPanner::distribute_one (AudioBuffer& srcbuf, BufferSet& obufs, gain_t gain_coefficient, pframes_t nframes, uint32_t which)
 {
@@ -257,6 +309,9 @@ VBAPanner::distribute_one (AudioBuffer& srcbuf, BufferSet& obufs, gain_t gain_co
            anything here that will simply assign new (sample) values
            to the output buffers - everything must be done via mixing
            functions and not assignment/copying.
+
+           The outputs and their gains are collected first, and then
+           mixed in one go by mix_to_outputs().
 	*/
 
         vector<double>::size_type sz = signal->gains.size();
@@ -265,6 +320,11 @@ VBAPanner::distribute_one (AudioBuffer& srcbuf, BufferSet& obufs, gain_t gain_co
 
         int8_t *outputs = (int8_t*)alloca(sz); // on the stack, no malloc
 
+        Sample* dst[6];
+        gain_t  g0[6];
+        gain_t  g1[6];
+        uint32_t n_dst = 0;
+
         /* set initial state of each output "record"
          */
 
@@ -321,8 +381,10 @@ VBAPanner::distribute_one (AudioBuffer& srcbuf, BufferSet& obufs, gain_t gain_co
                            interpolate between them.
                         */
 
-                        AudioBuffer& buf (obufs.get_audio (output));
-                        buf.accumulate_with_ramped_gain_from (srcbuf.data(), nframes, signal->gains[output], pan, 0);
+                        dst[n_dst] = output_buffer (obufs, output);
+                        g0[n_dst]  = signal->gains[output];
+                        g1[n_dst]  = pan;
+                        ++n_dst;
                         signal->gains[output] = pan;
 
                 } else {
@@ -330,7 +392,10 @@ VBAPanner::distribute_one (AudioBuffer& srcbuf, BufferSet& obufs, gain_t gain_co
                         /* signal to this output, same gain as before so just copy with gain
                          */
 
-                        mix_buffers_with_gain (obufs.get_audio (output).data(),src,nframes,pan);
+                        dst[n_dst] = output_buffer (obufs, output);
+                        g0[n_dst]  = pan;
+                        g1[n_dst]  = pan;
+                        ++n_dst;
                         signal->gains[output] = pan;
                 }
 	}
@@ -342,12 +407,16 @@ VBAPanner::distribute_one (AudioBuffer& srcbuf, BufferSet& obufs, gain_t gain_co
                 if (outputs[o] == 1) {
                         /* take signal and deliver with a rapid fade out
                          */
-                        AudioBuffer& buf (obufs.get_audio (o));
-                        buf.accumulate_with_ramped_gain_from (srcbuf.data(), nframes, signal->gains[o], 0.0, 0);
+                        dst[n_dst] = output_buffer (obufs, o);
+                        g0[n_dst]  = signal->gains[o];
+                        g1[n_dst]  = 0.0;
+                        ++n_dst;
                         signal->gains[o] = 0.0;
                 }
         }
 
+        mix_to_outputs (dst, g0, g1, n_dst, src, nframes);
+
         /* note that the output buffers were all silenced at some point
            so anything we didn't write to with this signal (or any others)
            is just as it should be.
@@ -359,7 +428,7 @@ VBAPanner::distribute_one_automated (AudioBuffer& /*src*/, BufferSet& /*obufs*/,
                                      samplepos_t /*start*/, samplepos_t /*end*/,
 				     pframes_t /*nframes*/, pan_t** /*buffers*/, uint32_t /*which*/)
 {
-	/* XXX to be implemented */
+	/* unused, see distribute_automated () */
 }
 
 XMLNode&
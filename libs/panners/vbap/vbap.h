@@ -53,6 +53,9 @@ public:
 	static Panner* factory (boost::shared_ptr<Pannable>, boost::shared_ptr<Speakers>);
 
 	void distribute (BufferSet& ibufs, BufferSet& obufs, gain_t gain_coeff, pframes_t nframes);
+	void distribute_automated (BufferSet& ibufs, BufferSet& obufs,
+	                           samplepos_t start, samplepos_t end, pframes_t nframes,
+	                           pan_t** buffers);
 
 	void set_azimuth_elevation (double azimuth, double elevation);
 
@@ -82,7 +85,12 @@ private:
         std::vector<Signal*> _signals;
         boost::shared_ptr<VBAPSpeakers>  _speakers;
 
-	void compute_gains (double g[3], int ls[3], int azi, int ele);
+	/* set if gains could not be looked up while the speaker grid
+	   was rebuilt, distribute () retries */
+	gint _gains_pending;
+
+	bool compute_gains (double g[3], int ls[3], int azi, int ele);
+        void compute_directions (double azimuth, double width, double elevation);
         void update ();
         void clear_signals ();
 
@@ -60,6 +60,7 @@ VBAPSpeakers::~VBAPSpeakers ()
 void
 VBAPSpeakers::update ()
 {
+	Glib::Threads::Mutex::Lock lm (_grid_lock);
 	int dim = 2;
 
         _speakers = _parent->speakers();
@@ -88,6 +89,126 @@ VBAPSpeakers::update ()
 	} else {
 		choose_speaker_pairs ();
 	}
+
+	build_grid ();
+}
+
+void
+VBAPSpeakers::build_grid ()
+{
+	const int n_ele = (_dimension == 3) ? 91 : 1;
+
+	_grid.resize (360 * n_ele);
+
+	for (int ele = 0; ele < n_ele; ++ele) {
+		for (int azi = 0; azi < 360; ++azi) {
+			GridPoint& p (_grid[ele * 360 + azi]);
+			double g[3];
+			compute_gains (g, p.tuple, azi, ele);
+			p.gains[0] = g[0];
+			p.gains[1] = g[1];
+			p.gains[2] = g[2];
+		}
+	}
+}
+
+void
+VBAPSpeakers::compute_gains (double gains[3], int& tuple, double azi, double ele) const
+{
+	/* calculates gain factors using loudspeaker setup and given direction */
+	double cartdir[3];
+	double power;
+	int i,j,k;
+	double small_g;
+	double big_sm_g, gtmp[3];
+	const int dimension = _dimension;
+	assert(dimension == 2 || dimension == 3);
+
+	spherical_to_cartesian (azi, ele, 1.0, cartdir[0], cartdir[1], cartdir[2]);
+	big_sm_g = -100000.0;
+
+	gains[0] = gains[1] = gains[2] = 0;
+	tuple = -1;
+
+	for (i = 0; i < n_tuples(); i++) {
+
+		const dvector& matrix (_matrices[i]);
+		small_g = 10000000.0;
+
+		for (j = 0; j < dimension; j++) {
+
+			gtmp[j] = 0.0;
+
+			for (k = 0; k < dimension; k++) {
+				gtmp[j] += cartdir[k] * matrix[j * dimension + k];
+			}
+
+			if (gtmp[j] < small_g) {
+				small_g = gtmp[j];
+			}
+		}
+
+		if (small_g > big_sm_g) {
+
+			big_sm_g = small_g;
+
+			gains[0] = gtmp[0];
+			gains[1] = gtmp[1];
+			gains[2] = (dimension == 3) ? gtmp[2] : 0.0;
+			tuple = i;
+		}
+	}
+
+	power = sqrt (gains[0]*gains[0] + gains[1]*gains[1] + gains[2]*gains[2]);
+
+	if (power > 0) {
+		gains[0] /= power;
+		gains[1] /= power;
+		gains[2] /= power;
+	}
+}
+
+bool
+VBAPSpeakers::lookup_gains (int azi, int ele, double gains[3], int speaker_ids[3]) const
+{
+	Glib::Threads::Mutex::Lock lm (_grid_lock, Glib::Threads::TRY_LOCK);
+
+	if (!lm.locked ()) {
+		return false;
+	}
+
+	gains[0] = gains[1] = gains[2] = 0;
+	speaker_ids[0] = speaker_ids[1] = speaker_ids[2] = 0;
+
+	if (_grid.empty ()) {
+		return true;
+	}
+
+	azi %= 360;
+	if (azi < 0) {
+		azi += 360;
+	}
+	ele = (_dimension == 3) ? std::max (0, std::min (90, ele)) : 0;
+
+	const GridPoint& p (_grid[ele * 360 + azi]);
+
+	if (p.tuple < 0) {
+		return true;
+	}
+
+	gains[0] = p.gains[0];
+	gains[1] = p.gains[1];
+	speaker_ids[0] = _speaker_tuples[p.tuple][0];
+	speaker_ids[1] = _speaker_tuples[p.tuple][1];
+
+	if (_dimension == 3) {
+		gains[2] = p.gains[2];
+		speaker_ids[2] = _speaker_tuples[p.tuple][2];
+	} else {
+		speaker_ids[2] = -1;
+	}
+
+	return true;
 }
 
 void
@@ -24,6 +24,8 @@
 
 #include <boost/utility.hpp>
 
+#include <glibmm/threads.h>
+
 #include <pbd/signals.h>
 
 #include "ardour/panner.h"
@@ -47,6 +49,14 @@ public:
         uint32_t n_speakers() const { return _speakers.size(); }
         boost::shared_ptr<Speakers> parent() const { return _parent; }
 
+	/** look up gains and speakers for a direction (in whole degrees) in the
+	 * grid that is computed when the speaker layout changes.
+	 * This never waits, it is used in process context (also indirectly,
+	 * by control changes during automation playback).
+	 * @return false if the grid is being rebuilt
+	 */
+	bool lookup_gains (int azi, int ele, double gains[3], int speaker_ids[3]) const;
+
 	~VBAPSpeakers ();
 
 private:
@@ -77,6 +87,18 @@ private:
 	std::vector<dvector>  _matrices;       /* holds matrices for a given speaker combinations */
 	std::vector<tmatrix>  _speaker_tuples; /* holds speakers IDs for a given combination */
 
+	/* gains for every direction in whole degrees, azimuth 0..359 and
+	 * elevation 0..90 (in 2D the elevation does not change the gains,
+	 * there is only one row)
+	 */
+	struct GridPoint {
+		float gains[3];
+		int   tuple; /* -1 if there is none */
+	};
+
+	std::vector<GridPoint> _grid;
+	mutable Glib::Threads::Mutex _grid_lock; /* protects the grid and tuples */
+
 	/* A struct for all loudspeakers */
 	struct ls_triplet_chain {
 		int ls_nos[3];
@@ -91,6 +113,8 @@ private:
 	static void   cross_prod(PBD::CartesianVector v1,PBD::CartesianVector v2, PBD::CartesianVector *res);
 
 	void update ();
+	void build_grid ();
+	void compute_gains (double gains[3], int& tuple, double azi, double ele) const;
 	int  any_ls_inside_triplet (int a, int b, int c);
 	void add_ldsp_triplet (int i, int j, int k, struct ls_triplet_chain **ls_triplets);
 	int  lines_intersect (int i,int j,int k,int l);
@@ -13,6 +13,7 @@
  */
 
 #include <math.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
@@ -31,6 +32,13 @@
 #  define M_PI 3.14159265358979323846
 #endif
 
+#ifndef MIN
+#define MIN(A,B) (((A) < (B)) ? (A) : (B))
+#endif
+
+#define ACOMP_BLOCK 64 /* samples processed at once, and parameter interpolation interval */
+#define ACOMP_MAX_LOOKAHEAD 20 /* ms */
+
 #ifdef COMPILER_MSVC
 #include <float.h>
 #define isfinite_local(val) (bool)_finite((double)val)
@@ -56,6 +64,8 @@ typedef enum {
 	ACOMP_A2,
 	ACOMP_A3,
 	ACOMP_A4,
+	ACOMP_A5,
+	ACOMP_A6,
 } PortIndex;
 
 typedef struct {
@@ -70,6 +80,8 @@ typedef struct {
 	float* outlevel;
 	float* sidechain;
 	float* enable;
+	float* lookahead;
+	float* latency;
 
 	float* input0;
 	float* input1;
@@ -84,6 +96,19 @@ typedef struct {
 
 	float makeup_gain;
 
+	/* gain computer parameters, interpolated per block */
+	float tau;
+	bool  params_valid;
+	float p_ratio;
+	float p_thresdb;
+	float p_width;
+
+	/* look-ahead: the audio is delayed, the detector is not */
+	float*   delaybuf[2];
+	uint32_t delay_mask;
+	uint32_t delay_wr;
+	uint32_t lookahead_samples;
+
 #ifdef LV2_EXTENDED
 	LV2_Inline_Display_Image_Surface surf;
 	bool                     need_expose;
@@ -114,6 +139,9 @@ instantiate(const LV2_Descriptor* descriptor,
             const LV2_Feature* const* features)
 {
 	AComp* acomp = (AComp*)calloc(1, sizeof(AComp));
+	if (!acomp) {
+		return NULL;
+	}
 
 	for (int i=0; features[i]; ++i) {
 #ifdef LV2_EXTENDED
@@ -126,6 +154,21 @@ instantiate(const LV2_Descriptor* descriptor,
 	acomp->srate = rate;
 	acomp->old_yl=acomp->old_y1=acomp->old_yg=0.f;
 	acomp->makeup_gain = 1.f;
+	acomp->tau = (1.0 - exp (-2.f * M_PI * ACOMP_BLOCK * 25.f / acomp->srate));
+
+	uint32_t delay_size = 1;
+	while (delay_size < ceil (rate * ACOMP_MAX_LOOKAHEAD / 1000.0) + ACOMP_BLOCK) {
+		delay_size *= 2;
+	}
+	acomp->delay_mask = delay_size - 1;
+	for (int c = 0; c < 2; ++c) {
+		acomp->delaybuf[c] = (float*)calloc(delay_size, sizeof(float));
+		if (!acomp->delaybuf[c]) {
+			free (acomp->delaybuf[0]);
+			free (acomp);
+			return NULL;
+		}
+	}
 #ifdef LV2_EXTENDED
 	acomp->need_expose = true;
 	acomp->v_lvl_out = -70.f;
@@ -196,6 +239,12 @@ connect_mono(LV2_Handle instance,
 		case ACOMP_A2:
 			acomp->output0 = (float*)data;
 			break;
+		case ACOMP_A3:
+			acomp->lookahead = (float*)data;
+			break;
+		case ACOMP_A4:
+			acomp->latency = (float*)data;
+			break;
 	default:
 		break;
 	}
@@ -225,6 +274,12 @@ connect_stereo(LV2_Handle instance,
 		case ACOMP_A4:
 			acomp->output1 = (float*)data;
 			break;
+		case ACOMP_A5:
+			acomp->lookahead = (float*)data;
+			break;
+		case ACOMP_A6:
+			acomp->latency = (float*)data;
+			break;
 	default:
 		break;
 	}
@@ -257,6 +312,224 @@ activate(LV2_Handle instance)
 	*(acomp->gainr) = 0.0f;
 	*(acomp->outlevel) = -45.0f;
 	acomp->old_yl=acomp->old_y1=acomp->old_yg=0.f;
+	acomp->params_valid = false;
+	acomp->delay_wr = 0;
+	for (int c = 0; c < 2; ++c) {
+		memset (acomp->delaybuf[c], 0, (acomp->delay_mask + 1) * sizeof(float));
+	}
+}
+
+/* log() and exp() without library calls, so that loops using them can be
+ * vectorized. The relative error is about 1e-7. */
+static inline float
+log_approx(float x) {
+	union { float f; int32_t i; } u;
+	u.f = x;
+	int32_t e = ((u.i >> 23) & 0xff) - 127;
+	u.i = (u.i & 0x007fffff) | 0x3f800000;
+
+	/* mantissa in [sqrt(.5), sqrt(2)) */
+	const int32_t hi = u.f > 1.41421356f;
+	const float m = hi ? .5f * u.f : u.f;
+	e += hi;
+
+	/* log(m) = 2 atanh(s) */
+	const float s = (m - 1.f) / (m + 1.f);
+	const float s2 = s * s;
+	const float p = 1.f + s2 * (1.f / 3.f + s2 * (1.f / 5.f + s2 * (1.f / 7.f + s2 * (1.f / 9.f))));
+	return 2.f * s * p + e * 0.693147181f;
+}
+
+static inline float
+exp_approx(float x) {
+	x = fminf (fmaxf (x, -87.f), 88.f);
+
+	/* exp(x) = 2^n * exp(r), |r| <= ln(2) / 2 */
+	const float t = x * 1.44269504f;
+	const int32_t n = (int32_t)(t < 0 ? t - .5f : t + .5f);
+	const float r = x - n * 0.693147181f;
+	const float p = 1.f + r * (1.f + r * (1.f / 2.f + r * (1.f / 6.f + r * (1.f / 24.f + r * (1.f / 120.f + r * (1.f / 720.f + r * (1.f / 5040.f)))))));
+
+	union { float f; int32_t i; } u;
+	u.i = (n + 127) << 23;
+	return p * u.f;
+}
+
+typedef struct {
+	float in_peak;  /* detector input */
+	float out_peak;
+	float gr_peak;  /* gain reduction in dB */
+	float gr;       /* gain reduction at the end */
+} CompStats;
+
+static void
+update_lookahead(AComp* acomp) {
+	uint32_t la = 0;
+	if (acomp->lookahead && *acomp->lookahead > 0) {
+		la = rintf (fminf (*acomp->lookahead, ACOMP_MAX_LOOKAHEAD) * acomp->srate / 1000.f);
+	}
+	acomp->lookahead_samples = la;
+	if (acomp->latency) {
+		*(acomp->latency) = la;
+	}
+}
+
+static void
+interpolate_params(AComp* acomp, float ratio, float thresdb, float width) {
+	if (!acomp->params_valid) {
+		acomp->p_ratio = ratio;
+		acomp->p_thresdb = thresdb;
+		acomp->p_width = width;
+		acomp->params_valid = true;
+		return;
+	}
+	const float tau = acomp->tau;
+	if (fabsf (ratio - acomp->p_ratio) < 1e-3) {
+		acomp->p_ratio = ratio;
+	} else {
+		acomp->p_ratio += tau * (ratio - acomp->p_ratio);
+	}
+	if (fabsf (thresdb - acomp->p_thresdb) < 1e-3) {
+		acomp->p_thresdb = thresdb;
+	} else {
+		acomp->p_thresdb += tau * (thresdb - acomp->p_thresdb);
+	}
+	if (fabsf (width - acomp->p_width) < 1e-3) {
+		acomp->p_width = width;
+	} else {
+		acomp->p_width += tau * (width - acomp->p_width);
+	}
+}
+
+static void
+interpolate_makeup(AComp* acomp, float makeup_target) {
+	if ( fabsf(makeup_target - acomp->makeup_gain) < 1e-6 ) {
+		acomp->makeup_gain = makeup_target;
+	} else {
+		acomp->makeup_gain += acomp->tau * (makeup_target - acomp->makeup_gain) + 1e-12;
+	}
+}
+
+/* Write n samples to the look-ahead delay-line, and read them back delayed */
+static void
+delay_block(AComp* acomp, int c, const float* in, float* out, uint32_t n) {
+	float* const buf = acomp->delaybuf[c];
+	const uint32_t mask = acomp->delay_mask;
+	const uint32_t wr = acomp->delay_wr;
+	const uint32_t rd = wr - acomp->lookahead_samples;
+
+	for (uint32_t i = 0; i < n; ++i) {
+		buf[(wr + i) & mask] = in[i];
+	}
+	for (uint32_t i = 0; i < n; ++i) {
+		out[i] = buf[(rd + i) & mask];
+	}
+}
+
+/* Process up to ACOMP_BLOCK samples, in1 and out1 are NULL for mono.
+ *
+ * The level detection and the gain computer do not depend on previous
+ * samples and are computed for the whole block first, as is the applied
+ * gain afterwards. Only the attack/release envelope is computed
+ * sample by sample.
+ */
+static void
+process_block(AComp* acomp,
+              const float* in0, const float* in1, const float* sc,
+              float* out0, float* out1, uint32_t n,
+              float attack_coeff, float release_coeff, bool usesidechain,
+              CompStats* stats)
+{
+	float lvl[ACOMP_BLOCK];
+	float gain[ACOMP_BLOCK];
+	float dly0[ACOMP_BLOCK];
+	float dly1[ACOMP_BLOCK];
+
+	const float ratio = acomp->p_ratio;
+	const float thresdb = acomp->p_thresdb;
+	const float width = acomp->p_width;
+	const float makeup_gain = acomp->makeup_gain;
+	const float slope = 1.f / ratio - 1.f;
+
+	/* detector */
+	float in_peak = stats->in_peak;
+	for (uint32_t i = 0; i < n; ++i) {
+		float ingain;
+		if (usesidechain) {
+			ingain = fabsf (sc[i]);
+		} else if (in1) {
+			ingain = fmaxf (fabsf (in0[i]), fabsf (in1[i]));
+		} else {
+			ingain = fabsf (in0[i]);
+		}
+		in_peak = fmaxf (in_peak, ingain);
+		lvl[i] = ingain;
+	}
+	stats->in_peak = in_peak;
+
+	/* gain computer, lvl[] is replaced by the gain reduction in dB.
+	 * Below -160dB the level is below the knee for all parameters */
+	for (uint32_t i = 0; i < n; ++i) {
+		const float xg = (lvl[i] < 1e-8f) ? -160.f : 8.68588964f * log_approx (lvl[i]);
+		const float d = xg - thresdb;
+		float yg;
+		if (2.f * d < -width) {
+			yg = xg;
+		} else if (2.f * d > width) {
+			yg = sanitize_denormal (thresdb + d / ratio);
+		} else {
+			const float k = d + width / 2.f;
+			yg = xg + slope * k * k / (2.f * width);
+		}
+		lvl[i] = xg - yg;
+	}
+
+	/* attack, release */
+	float y1 = acomp->old_y1;
+	float yl = acomp->old_yl;
+	float gr_peak = stats->gr_peak;
+	for (uint32_t i = 0; i < n; ++i) {
+		const float xl = lvl[i];
+		y1 = sanitize_denormal (y1);
+		yl = sanitize_denormal (yl);
+		y1 = fmaxf (xl, release_coeff * y1 + (1.f - release_coeff) * xl);
+		yl = attack_coeff * yl + (1.f - attack_coeff) * y1;
+		y1 = sanitize_denormal (y1);
+		yl = sanitize_denormal (yl);
+		gain[i] = yl;
+		gr_peak = fmaxf (gr_peak, yl);
+	}
+	acomp->old_y1 = y1;
+	acomp->old_yl = yl;
+	stats->gr_peak = gr_peak;
+	if (n > 0) {
+		stats->gr = yl;
+	}
+
+	for (uint32_t i = 0; i < n; ++i) {
+		gain[i] = exp_approx (-gain[i] * 0.115129255f);
+	}
+
+	/* apply gain to the delayed audio. The delay-line is also used
+	 * without look-ahead, so that it is filled when enabling it */
+	delay_block (acomp, 0, in0, dly0, n);
+	if (in1) {
+		delay_block (acomp, 1, in1, dly1, n);
+	}
+	acomp->delay_wr = (acomp->delay_wr + n) & acomp->delay_mask;
+
+	float out_peak = stats->out_peak;
+	for (uint32_t i = 0; i < n; ++i) {
+		out0[i] = (dly0[i] * gain[i]) * makeup_gain;
+		out_peak = fmaxf (out_peak, fabsf (out0[i]));
+	}
+	if (in1) {
+		for (uint32_t i = 0; i < n; ++i) {
+			out1[i] = (dly1[i] * gain[i]) * makeup_gain;
+			out_peak = fmaxf (out_peak, fabsf (out1[i]));
+		}
+	}
+	stats->out_peak = out_peak;
 }
 
 static void
@@ -270,27 +543,15 @@ run_mono(LV2_Handle instance, uint32_t n_samples)
 
 	float srate = acomp->srate;
 	float width = (6.f * *(acomp->knee)) + 0.01;
-	float cdb=0.f;
 	float attack_coeff = exp(-1000.f/(*(acomp->attack) * srate));
 	float release_coeff = exp(-1000.f/(*(acomp->release) * srate));
 
-	float max = 0.f;
-	float lgaininp = 0.f;
-	float Lgain = 1.f;
-	float Lxg, Lxl, Lyg, Lyl, Ly1;
-	int usesidechain = (*(acomp->sidechain) <= 0.f) ? 0 : 1;
-	uint32_t i;
-	float ingain;
-	float in0;
-	float sc0;
+	bool usesidechain = (*(acomp->sidechain) <= 0.f) ? false : true;
 
 	float ratio = *acomp->ratio;
 	float thresdb = *acomp->thresdb;
 	float makeup = *acomp->makeup;
 	float makeup_target = from_dB(makeup);
-	float makeup_gain = acomp->makeup_gain;
-
-	const float tau = (1.0 - exp (-2.f * M_PI * n_samples * 25.f / acomp->srate));
 
 	if (*acomp->enable <= 0) {
 		ratio = 1.f;
@@ -321,68 +582,31 @@ run_mono(LV2_Handle instance, uint32_t n_samples)
 	}
 #endif
 
-	float in_peak = 0;
-	acomp->v_gainr = 0.0;
-
-	for (i = 0; i < n_samples; i++) {
-		in0 = input[i];
-		sc0 = sc[i];
-		ingain = usesidechain ? fabs(sc0) : fabs(in0);
-		in_peak = fmaxf (in_peak, ingain);
-		Lyg = 0.f;
-		Lxg = (ingain==0.f) ? -160.f : to_dB(ingain);
-		Lxg = sanitize_denormal(Lxg);
-
-
-		if (2.f*(Lxg-thresdb) < -width) {
-			Lyg = Lxg;
-		} else if (2.f*(Lxg-thresdb) > width) {
-			Lyg = thresdb + (Lxg-thresdb)/ratio;
-			Lyg = sanitize_denormal(Lyg);
-		} else {
-			Lyg = Lxg + (1.f/ratio-1.f)*(Lxg-thresdb+width/2.f)*(Lxg-thresdb+width/2.f)/(2.f*width);
-		}
-
-		Lxl = Lxg - Lyg;
-
-		acomp->old_y1 = sanitize_denormal(acomp->old_y1);
-		acomp->old_yl = sanitize_denormal(acomp->old_yl);
-		Ly1 = fmaxf(Lxl, release_coeff * acomp->old_y1+(1.f-release_coeff)*Lxl);
-		Lyl = attack_coeff * acomp->old_yl+(1.f-attack_coeff)*Ly1;
-		Ly1 = sanitize_denormal(Ly1);
-		Lyl = sanitize_denormal(Lyl);
+	update_lookahead (acomp);
 
-		cdb = -Lyl;
-		Lgain = from_dB(cdb);
+	CompStats stats = { 0, 0, 0, *(acomp->gainr) };
+	uint32_t offset = 0;
 
-		*(acomp->gainr) = Lyl;
-		if (Lyl > acomp->v_gainr) {
-			acomp->v_gainr = Lyl;
-		}
-
-		lgaininp = in0 * Lgain;
-
-		output[i] = lgaininp * makeup_gain;
-
-		max = (fabsf(output[i]) > max) ? fabsf(output[i]) : sanitize_denormal(max);
-
-		// TODO re-use local variables on stack
-		// store values back to acomp at the end of the inner-loop
-		acomp->old_yl = Lyl;
-		acomp->old_y1 = Ly1;
-		acomp->old_yg = Lyg;
+	while (offset < n_samples) {
+		const uint32_t block = MIN (ACOMP_BLOCK, n_samples - offset);
+		interpolate_params (acomp, ratio, thresdb, width);
+		process_block (acomp,
+		               &input[offset], NULL, &sc[offset],
+		               &output[offset], NULL, block,
+		               attack_coeff, release_coeff, usesidechain, &stats);
+		interpolate_makeup (acomp, makeup_target);
+		offset += block;
 	}
 
-	if ( fabsf(makeup_target - makeup_gain) < 1e-6 ) {
-		makeup_gain = makeup_target;
-	} else {
-		makeup_gain += tau * (makeup_target - makeup_gain) + 1e-12;
-	}
+	const float max = stats.out_peak;
+	*(acomp->gainr) = stats.gr;
 
 	*(acomp->outlevel) = (max < 0.0056f) ? -45.f : to_dB(max);
-	acomp->makeup_gain = makeup_gain;
 
 #ifdef LV2_EXTENDED
+	const float in_peak = stats.in_peak;
+	acomp->v_gainr = stats.gr_peak;
+
 	const float old_v_lv1 = acomp->v_lv1;
 	const float old_v_lvl = acomp->v_lvl;
 	const float tot_rel_c = exp(-1000.f/(*(acomp->release) * srate) * n_samples);
@@ -422,30 +646,15 @@ run_stereo(LV2_Handle instance, uint32_t n_samples)
 
 	float srate = acomp->srate;
 	float width = (6.f * *(acomp->knee)) + 0.01;
-	float cdb=0.f;
 	float attack_coeff = exp(-1000.f/(*(acomp->attack) * srate));
 	float release_coeff = exp(-1000.f/(*(acomp->release) * srate));
 
-	float max = 0.f;
-	float lgaininp = 0.f;
-	float rgaininp = 0.f;
-	float Lgain = 1.f;
-	float Lxg, Lxl, Lyg, Lyl, Ly1;
-	int usesidechain = (*(acomp->sidechain) <= 0.f) ? 0 : 1;
-	uint32_t i;
-	float ingain;
-	float in0;
-	float in1;
-	float sc0;
-	float maxabslr;
+	bool usesidechain = (*(acomp->sidechain) <= 0.f) ? false : true;
 
 	float ratio = *acomp->ratio;
 	float thresdb = *acomp->thresdb;
 	float makeup = *acomp->makeup;
 	float makeup_target = from_dB(makeup);
-	float makeup_gain = acomp->makeup_gain;
-
-	const float tau = (1.0 - exp (-2.f * M_PI * n_samples * 25.f / acomp->srate));
 
 	if (*acomp->enable <= 0) {
 		ratio = 1.f;
@@ -476,72 +685,31 @@ run_stereo(LV2_Handle instance, uint32_t n_samples)
 	}
 #endif
 
-	float in_peak = 0;
-	acomp->v_gainr = 0.0;
-
-	for (i = 0; i < n_samples; i++) {
-		in0 = input0[i];
-		in1 = input1[i];
-		sc0 = sc[i];
-		maxabslr = fmaxf(fabs(in0), fabs(in1));
-		ingain = usesidechain ? fabs(sc0) : maxabslr;
-		in_peak = fmaxf (in_peak, ingain);
-		Lyg = 0.f;
-		Lxg = (ingain==0.f) ? -160.f : to_dB(ingain);
-		Lxg = sanitize_denormal(Lxg);
-
-
-		if (2.f*(Lxg-thresdb) < -width) {
-			Lyg = Lxg;
-		} else if (2.f*(Lxg-thresdb) > width) {
-			Lyg = thresdb + (Lxg-thresdb)/ratio;
-			Lyg = sanitize_denormal(Lyg);
-		} else {
-			Lyg = Lxg + (1.f/ratio-1.f)*(Lxg-thresdb+width/2.f)*(Lxg-thresdb+width/2.f)/(2.f*width);
-		}
-
-		Lxl = Lxg - Lyg;
-
-		acomp->old_y1 = sanitize_denormal(acomp->old_y1);
-		acomp->old_yl = sanitize_denormal(acomp->old_yl);
-		Ly1 = fmaxf(Lxl, release_coeff * acomp->old_y1+(1.f-release_coeff)*Lxl);
-		Lyl = attack_coeff * acomp->old_yl+(1.f-attack_coeff)*Ly1;
-		Ly1 = sanitize_denormal(Ly1);
-		Lyl = sanitize_denormal(Lyl);
-
-		cdb = -Lyl;
-		Lgain = from_dB(cdb);
-
-		*(acomp->gainr) = Lyl;
-		if (Lyl > acomp->v_gainr) {
-			acomp->v_gainr = Lyl;
-		}
-
-		lgaininp = in0 * Lgain;
-		rgaininp = in1 * Lgain;
+	update_lookahead (acomp);
 
-		output0[i] = lgaininp * makeup_gain;
-		output1[i] = rgaininp * makeup_gain;
+	CompStats stats = { 0, 0, 0, *(acomp->gainr) };
+	uint32_t offset = 0;
 
-		max = (fmaxf(fabs(output0[i]), fabs(output1[i])) > max) ? fmaxf(fabs(output0[i]), fabs(output1[i])) : sanitize_denormal(max);
-
-		// TODO re-use local variables on stack
-		// store values back to acomp at the end of the inner-loop
-		acomp->old_yl = Lyl;
-		acomp->old_y1 = Ly1;
-		acomp->old_yg = Lyg;
+	while (offset < n_samples) {
+		const uint32_t block = MIN (ACOMP_BLOCK, n_samples - offset);
+		interpolate_params (acomp, ratio, thresdb, width);
+		process_block (acomp,
+		               &input0[offset], &input1[offset], &sc[offset],
+		               &output0[offset], &output1[offset], block,
+		               attack_coeff, release_coeff, usesidechain, &stats);
+		interpolate_makeup (acomp, makeup_target);
+		offset += block;
 	}
 
-	if ( fabsf(makeup_target - makeup_gain) < 1e-6 ) {
-		makeup_gain = makeup_target;
-	} else {
-		makeup_gain += tau * (makeup_target - makeup_gain) + 1e-12;
-	}
+	const float max = stats.out_peak;
+	*(acomp->gainr) = stats.gr;
 
 	*(acomp->outlevel) = (max < 0.0056f) ? -45.f : to_dB(max);
-	acomp->makeup_gain = makeup_gain;
 
 #ifdef LV2_EXTENDED
+	const float in_peak = stats.in_peak;
+	acomp->v_gainr = stats.gr_peak;
+
 	const float old_v_lv1 = acomp->v_lv1;
 	const float old_v_lvl = acomp->v_lvl;
 	const float tot_rel_c = exp(-1000.f/(*(acomp->release) * srate) * n_samples);
@@ -587,10 +755,6 @@ cleanup(LV2_Handle instance)
 }
 
 
-#ifndef MIN
-#define MIN(A,B) ((A) < (B)) ? (A) : (B)
-#endif
-
 #ifdef LV2_EXTENDED
 static float
 comp_curve (const AComp* self, float xg) {
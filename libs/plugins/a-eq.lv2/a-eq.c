@@ -30,6 +30,11 @@
 #define isfinite_local isfinite
 #endif
 
+#if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define AEQ_SSE2
+#endif
+
 #include "lv2/lv2plug.in/ns/lv2core/lv2.h"
 
 #ifdef LV2_EXTENDED
@@ -344,6 +349,150 @@ static float run_linear_svf(struct linear_svf *self, float in)
 	return (float)out;
 }
 
+#ifdef AEQ_SSE2
+/* two bands per register, state and coefficients transposed */
+struct svf_pair {
+	__m128d a0, a1, a2;
+	__m128d m0, m1, m2;
+	__m128d s0, s1;
+};
+
+static inline void svf_pair_load(struct svf_pair *p, const struct linear_svf *f)
+{
+	p->a0 = _mm_set_pd(f[1].a[0], f[0].a[0]);
+	p->a1 = _mm_set_pd(f[1].a[1], f[0].a[1]);
+	p->a2 = _mm_set_pd(f[1].a[2], f[0].a[2]);
+	p->m0 = _mm_set_pd(f[1].m[0], f[0].m[0]);
+	p->m1 = _mm_set_pd(f[1].m[1], f[0].m[1]);
+	p->m2 = _mm_set_pd(f[1].m[2], f[0].m[2]);
+	p->s0 = _mm_set_pd(f[1].s[0], f[0].s[0]);
+	p->s1 = _mm_set_pd(f[1].s[1], f[0].s[1]);
+}
+
+static inline void svf_pair_store(const struct svf_pair *p, struct linear_svf *f)
+{
+	_mm_storel_pd(&f[0].s[0], p->s0);
+	_mm_storeh_pd(&f[1].s[0], p->s0);
+	_mm_storel_pd(&f[0].s[1], p->s1);
+	_mm_storeh_pd(&f[1].s[1], p->s1);
+}
+
+/* same operations in the same order as run_linear_svf(),
+ * including the rounding of the output to float */
+static inline __m128d run_svf_pair(struct svf_pair *p, __m128d din)
+{
+	const __m128d two = _mm_set1_pd(2.0);
+	__m128d v0, v1, v2, out;
+
+	v2 = _mm_sub_pd(din, p->s1);
+	v0 = _mm_add_pd(_mm_mul_pd(p->a0, p->s0), _mm_mul_pd(p->a1, v2));
+	v1 = _mm_add_pd(_mm_add_pd(p->s1, _mm_mul_pd(p->a1, p->s0)), _mm_mul_pd(p->a2, v2));
+
+	p->s0 = _mm_sub_pd(_mm_mul_pd(two, v0), p->s0);
+	p->s1 = _mm_sub_pd(_mm_mul_pd(two, v1), p->s1);
+
+	out = _mm_add_pd(_mm_add_pd(_mm_mul_pd(p->m0, din), _mm_mul_pd(p->m1, v0)), _mm_mul_pd(p->m2, v1));
+	return _mm_cvtps_pd(_mm_cvtpd_ps(out));
+}
+#endif
+
+/* Run the filters in series.
+ *
+ * The bands are processed as a pipeline: in each step band j processes
+ * sample (t - j), using the output that band (j - 1) produced in the previous
+ * step. The bands of one step are independent and are computed in parallel,
+ * two per SSE2 register. Filling and draining the pipeline is done in scalar
+ * code. Every band still sees the same input in the same order, so the result
+ * is identical to running the cascade one sample at a time.
+ */
+static void run_svf_cascade(struct linear_svf *f, const float *input, float *output, uint32_t n_samples, double gain)
+{
+	/* p[j] is the input of band j for the current step, p[BANDS] the output */
+	float p[BANDS + 1];
+	uint32_t t;
+
+	if (n_samples < BANDS) {
+		for (uint32_t i = 0; i < n_samples; ++i) {
+			float out = input[i];
+			for (uint32_t j = 0; j < BANDS; j++) {
+				out = run_linear_svf(&f[j], out);
+			}
+			output[i] = out * gain;
+		}
+		return;
+	}
+
+	/* fill: bands 0..t are active */
+	p[0] = input[0];
+	for (t = 0; t < BANDS - 1; ++t) {
+		for (int j = t; j >= 0; --j) {
+			p[j + 1] = run_linear_svf(&f[j], p[j]);
+		}
+		p[0] = input[t + 1];
+	}
+
+	/* all bands active, output sample (t - BANDS + 1) */
+#ifdef AEQ_SSE2
+	{
+		struct svf_pair f01, f23, f45;
+		__m128d x01, x23, x45;
+
+		svf_pair_load(&f01, &f[0]);
+		svf_pair_load(&f23, &f[2]);
+		svf_pair_load(&f45, &f[4]);
+
+		x01 = _mm_set_pd(p[1], p[0]);
+		x23 = _mm_set_pd(p[3], p[2]);
+		x45 = _mm_set_pd(p[5], p[4]);
+
+		for (; t < n_samples; ++t) {
+			const __m128d y01 = run_svf_pair(&f01, x01);
+			const __m128d y23 = run_svf_pair(&f23, x23);
+			const __m128d y45 = run_svf_pair(&f45, x45);
+			double y5;
+
+			_mm_storeh_pd(&y5, y45);
+			output[t - BANDS + 1] = y5 * gain;
+
+			x01 = _mm_unpacklo_pd(_mm_set_sd(t + 1 < n_samples ? input[t + 1] : 0.f), y01);
+			x23 = _mm_shuffle_pd(y01, y23, 1);
+			x45 = _mm_shuffle_pd(y23, y45, 1);
+		}
+
+		svf_pair_store(&f01, &f[0]);
+		svf_pair_store(&f23, &f[2]);
+		svf_pair_store(&f45, &f[4]);
+
+		/* values are exact floats */
+		double x[BANDS];
+		_mm_storeu_pd(&x[0], x01);
+		_mm_storeu_pd(&x[2], x23);
+		_mm_storeu_pd(&x[4], x45);
+		for (int j = 0; j < BANDS; ++j) {
+			p[j] = x[j];
+		}
+	}
+#else
+	for (; t < n_samples; ++t) {
+		for (int j = BANDS - 1; j >= 0; --j) {
+			p[j + 1] = run_linear_svf(&f[j], p[j]);
+		}
+		output[t - BANDS + 1] = p[BANDS] * gain;
+		if (t + 1 < n_samples) {
+			p[0] = input[t + 1];
+		}
+	}
+#endif
+
+	/* drain: bands (t - n_samples + 1)..(BANDS - 1) are active */
+	for (; t < n_samples + BANDS - 1; ++t) {
+		for (int j = BANDS - 1; j > (int)(t - n_samples); --j) {
+			p[j + 1] = run_linear_svf(&f[j], p[j]);
+		}
+		output[t - BANDS + 1] = p[BANDS] * gain;
+	}
+}
+
 static void set_params(LV2_Handle instance, int band) {
 	Aeq* aeq = (Aeq*)instance;
 
@@ -425,15 +574,7 @@ run(LV2_Handle instance, uint32_t n_samples)
 			block = MIN (64, n_samples);
 		}
 
-		for (uint32_t i = 0; i < block; ++i) {
-			float in0, out;
-			in0 = input[i + offset];
-			out = in0;
-			for (uint32_t j = 0; j < BANDS; j++) {
-				out = run_linear_svf(&aeq->v_filter[j], out);
-			}
-			output[i + offset] = out * from_dB(aeq->v_master);
-		}
+		run_svf_cascade(aeq->v_filter, input + offset, output + offset, block, from_dB(aeq->v_master));
 		n_samples -= block;
 		offset += block;
 	}
@@ -25,13 +25,19 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
 #include <ctype.h>
 #include <math.h>
 #include <string.h>
 
 #define RV_NZ 7
+#define RV_BLOCK 256 /* max samples processed at once */
 #define DENORMAL_PROTECT (1e-14)
 
+#ifndef MIN
+#define MIN(A,B) (((A) < (B)) ? (A) : (B))
+#endif
+
 #ifdef COMPILER_MSVC
 #include <float.h>
 #define isfinite_local(val) (bool)_finite((double)val)
@@ -54,6 +60,7 @@ typedef struct {
 	float y_1_1; /**< Feedback sample */
 
 	int end[2][RV_NZ];
+	uint32_t block; /**< samples per block, at most the shortest comb delay */
 
 	float inputGain;	/**< Input gain value */
 	float fbk;	/**< Feedback gain */
@@ -133,109 +140,173 @@ initReverb (b_reverb *r, const double rate)
 	r->yy1_1 = 0.0;
 	r->y_1_1 = 0.0;
 
+	r->block = RV_BLOCK;
 	for (int i = 0; i < RV_NZ; ++i) {
 		err |= setReverbPointers (r, i, 0, rate);
 		err |= setReverbPointers (r, i, 1, rate);
+		for (int c = 0; c < 2 && i < 4; ++c) {
+			r->block = MIN (r->block, (uint32_t)(r->endp[c][i] - r->idx0[c][i]));
+		}
 	}
 	return err;
 }
 
+/* Delay lines are processed in blocks of up to r->block samples, which is
+ * at most the length of the shortest comb filter. All samples that are read
+ * from a comb filter during a block were written before the block, so the
+ * taps of the whole block can be summed before the feedback is known.
+ * The all-pass filters are computed for the block one stage after another,
+ * in segments that end where the delay line wraps (a short delay line reads
+ * what was written by an earlier segment).
+ * These loops can be vectorized by the compiler, only the feedback and the
+ * output low-pass remain per sample. The operations for each sample are the
+ * same as those of a sample-by-sample implementation.
+ */
+
+/* add the current tap of a comb filter to xa[] */
 static void
-reverb (b_reverb* r,
-        const float* inbuf0,
-        const float* inbuf1,
-        float* outbuf0,
-        float* outbuf1,
-        size_t n_samples)
+comb_tap (float* const idx0, float* const endp, const float* p, float* restrict xa, uint32_t n)
 {
-	float** const idxp0 = r->idxp[0];
-	float** const idxp1 = r->idxp[1];
-	float* const* const endp0 = r->endp[0];
-	float* const* const endp1 = r->endp[1];
-	float* const* const idx00 = r->idx0[0];
-	float* const* const idx01 = r->idx0[1];
+	uint32_t k = 0;
+	while (k < n) {
+		const uint32_t len = MIN (n - k, (uint32_t)(endp - p));
+		const float* restrict src = p;
+		float* restrict dst = &xa[k];
+		for (uint32_t i = 0; i < len; ++i) {
+			dst[i] += src[i];
+		}
+		k += len;
+		p = idx0;
+	}
+}
+
+/* replace the tap with the input plus the feedback, and advance */
+static void
+comb_feed (float* const idx0, float* const endp, float** idxp, const float g, const float* restrict x, uint32_t n)
+{
+	float* p = *idxp;
+	uint32_t k = 0;
+	while (k < n) {
+		const uint32_t len = MIN (n - k, (uint32_t)(endp - p));
+		float* restrict dst = p;
+		const float* restrict src = &x[k];
+		for (uint32_t i = 0; i < len; ++i) {
+			dst[i] = src[i] + (g * dst[i]);
+		}
+		k += len;
+		p += len;
+		if (endp <= p) {
+			p = idx0;
+		}
+	}
+	*idxp = p;
+}
+
+static void
+allpass (float* const idx0, float* const endp, float** idxp, const float g, float* restrict xa, uint32_t n)
+{
+	float* p = *idxp;
+	uint32_t k = 0;
+	while (k < n) {
+		const uint32_t len = MIN (n - k, (uint32_t)(endp - p));
+		float* restrict d = p;
+		float* restrict x = &xa[k];
+		for (uint32_t i = 0; i < len; ++i) {
+			const float y = d[i];
+			d[i] = g * (x[i] + y);
+			x[i] = y - x[i];
+		}
+		k += len;
+		p += len;
+		if (endp <= p) {
+			p = idx0;
+		}
+	}
+	*idxp = p;
+}
+
+static void
+reverb_block (b_reverb* r,
+              const int c,
+              const float* in,
+              float* out,
+              uint32_t n,
+              float* y_1,
+              float* yy1)
+{
+	float** const idxp = r->idxp[c];
+	float* const* const endp = r->endp[c];
+	float* const* const idx0 = r->idx0[c];
 	const float* const gain = r->gain;
 	const float inputGain = r->inputGain;
 	const float fbk = r->fbk;
 	const float wet = r->wet;
 	const float dry = r->dry;
 
-	const float* xp0 = inbuf0;
-	const float* xp1 = inbuf1;
-	float* yp0 = outbuf0;
-	float* yp1 = outbuf1;
+	float xo[RV_BLOCK];
+	float xa[RV_BLOCK];
+	float x[RV_BLOCK];
+	int j;
 
-	float y_1_0 = r->y_1_0;
-	float yy1_0 = r->yy1_0;
-	float y_1_1 = r->y_1_1;
-	float yy1_1 = r->yy1_1;
+	for (uint32_t i = 0; i < n; ++i) {
+		float v = in[i];
+		if (!isfinite_local(v) || fabsf (v) > 10.f) { v = 0; }
+		xo[i] = v + DENORMAL_PROTECT;
+		xa[i] = 0.0;
+	}
 
-	for (size_t i = 0; i < n_samples; ++i) {
-		int j;
-		float y;
-		float xo0 = *xp0++;
-		float xo1 = *xp1++;
-		if (!isfinite_local(xo0) || fabsf (xo0) > 10.f) { xo0 = 0; }
-		if (!isfinite_local(xo1) || fabsf (xo1) > 10.f) { xo1 = 0; }
-		xo0 += DENORMAL_PROTECT;
-		xo1 += DENORMAL_PROTECT;
-		const float x0 = y_1_0 + (inputGain * xo0);
-		const float x1 = y_1_1 + (inputGain * xo1);
-
-		float xa = 0.0;
-		float xb = 0.0;
-		/* First we do four feedback comb filters (ie parallel delay lines,
-		 * each with a single tap at the end that feeds back at the start) */
-
-		for (j = 0; j < 4; ++j) {
-			y = *idxp0[j];
-			*idxp0[j] = x0 + (gain[j] * y);
-			if (endp0[j] <= ++(idxp0[j])) {
-				idxp0[j] = idx00[j];
-			}
-			xa += y;
-		}
-		for (; j < 7; ++j) {
-			y = *idxp0[j];
-			*idxp0[j] = gain[j] * (xa + y);
-			if (endp0[j] <= ++(idxp0[j])) {
-				idxp0[j] = idx00[j];
-			}
-			xa = y - xa;
-		}
+	/* First we do four feedback comb filters (ie parallel delay lines,
+	 * each with a single tap at the end that feeds back at the start).
+	 * The taps do not depend on the input of the current block. */
+	for (j = 0; j < 4; ++j) {
+		comb_tap (idx0[j], endp[j], idxp[j], xa, n);
+	}
 
-		y = 0.5f * (xa + yy1_0);
-		yy1_0 = y;
-		y_1_0 = fbk * xa;
+	/* all-pass filters in series */
+	for (; j < 7; ++j) {
+		allpass (idx0[j], endp[j], &idxp[j], gain[j], xa, n);
+	}
 
-		*yp0++ = ((wet * y) + (dry * xo0));
+	/* feedback and output */
+	float fb = *y_1;
+	float lp = *yy1;
+	for (uint32_t i = 0; i < n; ++i) {
+		x[i] = fb + (inputGain * xo[i]);
+		lp = 0.5f * (xa[i] + lp);
+		fb = fbk * xa[i];
+		out[i] = ((wet * lp) + (dry * xo[i]));
+	}
+	*y_1 = fb;
+	*yy1 = lp;
 
-		for (j = 0; j < 4; ++j) {
-			y = *idxp1[j];
-			*idxp1[j] = x1 + (gain[j] * y);
-			if (endp1[j] <= ++(idxp1[j])) {
-				idxp1[j] = idx01[j];
-			}
-			xb += y;
-		}
-		for (; j < 7; ++j) {
-			y = *idxp1[j];
-			*idxp1[j] = gain[j] * (xb + y);
-			if (endp1[j] <= ++(idxp1[j])) {
-				idxp1[j] = idx01[j];
-			}
-			xb = y - xb;
-		}
+	for (j = 0; j < 4; ++j) {
+		comb_feed (idx0[j], endp[j], &idxp[j], gain[j], x, n);
+	}
+}
 
-		y = 0.5f * (xb + yy1_1);
-		yy1_1 = y;
-		y_1_1 = fbk * xb;
+static void
+reverb (b_reverb* r,
+        const float* inbuf0,
+        const float* inbuf1,
+        float* outbuf0,
+        float* outbuf1,
+        size_t n_samples)
+{
+	float y_1_0 = r->y_1_0;
+	float yy1_0 = r->yy1_0;
+	float y_1_1 = r->y_1_1;
+	float yy1_1 = r->yy1_1;
 
-		*yp1++ = ((wet * y) + (dry * xo1));
+	size_t offset = 0;
+	while (offset < n_samples) {
+		const uint32_t n = MIN (n_samples - offset, r->block);
+		reverb_block (r, 0, &inbuf0[offset], &outbuf0[offset], n, &y_1_0, &yy1_0);
+		reverb_block (r, 1, &inbuf1[offset], &outbuf1[offset], n, &y_1_1, &yy1_1);
+		offset += n;
 	}
 
 	if (!isfinite_local(y_1_0)) { y_1_0 = 0; }
-	if (!isfinite_local(yy1_1)) { yy1_0 = 0; }
+	if (!isfinite_local(yy1_0)) { yy1_0 = 0; }
 	if (!isfinite_local(y_1_1)) { y_1_1 = 0; }
 	if (!isfinite_local(yy1_1)) { yy1_1 = 0; }
 
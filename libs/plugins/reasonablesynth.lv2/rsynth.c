@@ -40,6 +40,10 @@
 #define MIN(A, B) ( (A) < (B) ? (A) : (B) )
 #endif
 
+#ifndef RS_LANES
+#define RS_LANES 4 /* voices rendered in parallel */
+#endif
+
 /* internal MIDI event abstraction */
 enum RMIDI_EV_TYPE {
   INVALID=0,
@@ -79,18 +83,21 @@ typedef struct _RSSynthChannel {
   int8_t    midimsgs [128];  // internal, note-off + on in same cycle, sustained-off
   int8_t    sustain;         // sustain pedal pressed
   ADSRcfg   adsr;
-  void      (*synthesize) (struct _RSSynthChannel* sc,
-      const uint8_t note, const float vol, const float pc,
-      const size_t n_samples, float* left, float* right);
 } RSSynthChannel;
 
-typedef void (*SynthFunction) (RSSynthChannel* sc,
-    const uint8_t note, const float vol, const float pc,
-    const size_t n_samples, float* left, float* right);
+/* voices that are rendered together, one per lane (structure of arrays) */
+typedef struct {
+  uint32_t n_voices;
+  float    phase[RS_LANES];
+  float    fq[RS_LANES];
+  float    amp[BUFFER_SIZE_SAMPLES][RS_LANES]; // volume * envelope
+  float*   phase_out[RS_LANES]; // where to store the phase, NULL if the note ended
+} RSVoiceBatch;
 
 typedef struct {
   uint32_t       boffset;
   float          buf [2][BUFFER_SIZE_SAMPLES];
+  RSVoiceBatch   vb;
   RSSynthChannel sc[16];
   float          freqs[128];
   float          kcgain;
@@ -177,42 +184,176 @@ static inline float adsr_env(RSSynthChannel *sc, const uint8_t note) {
   }
 }
 
+/* volume * envelope for n_samples, same as calling adsr_env() for every
+ * sample, but one linear segment at a time. Values are written to
+ * amp[i * stride], the number of samples until the note ended is returned.
+ */
+static size_t adsr_env_run(RSSynthChannel *sc, const uint8_t note, const float vol,
+    const size_t n_samples, float *amp, const size_t stride) {
+
+  const ADSRcfg* adsr = &sc->adsr;
+  size_t i = 0;
+
+  while (i < n_samples) {
+    const uint32_t cnt = sc->adsr_cnt[note];
+    uint32_t base, end;
+    float target;
+
+    if (cnt < adsr->off[0]) {
+      // attack
+      base = 0; end = adsr->off[0]; target = adsr->vol[0];
+    }
+    else if (cnt < adsr->off[1]) {
+      // decay
+      base = adsr->off[0]; end = adsr->off[1]; target = adsr->vol[1];
+    }
+    else if (cnt == adsr->off[1]) {
+      // sustain
+      const float a = vol * adsr->vol[1];
+      for (; i < n_samples; ++i) {
+        amp[i * stride] = a > 1e-10 ? a : 0;
+      }
+      break;
+    }
+    else if (cnt < adsr->off[2]) {
+      // release
+      base = adsr->off[1]; end = adsr->off[2]; target = 0;
+    }
+    else {
+      sc->adsr_cnt[note] = 0;
+      break;
+    }
+
+    const uint32_t k = MIN(n_samples - i, end - cnt);
+    const float a0 = sc->adsr_amp[note];
+    const float d = target - a0;
+    const float tme = end - base;
+    uint32_t j;
+    for (j = 0; j < k; ++j) {
+      const uint32_t p = cnt + 1 + j - base;
+      const float a = vol * (a0 + (p / tme) * d);
+      amp[(i + j) * stride] = a > 1e-10 ? a : 0;
+    }
+    sc->adsr_cnt[note] = cnt + k;
+    if (cnt + k == end) {
+      const float a = vol * target;
+      amp[(i + k - 1) * stride] = a > 1e-10 ? a : 0;
+      sc->adsr_amp[note] = target;
+    }
+    i += k;
+  }
+  return i;
+}
 
 /*****************************************************************************/
-/* piano like sound w/slight stereo phase */
-static void synthesize_sineP (RSSynthChannel* sc,
-    const uint8_t note, const float vol, const float fq,
-    const size_t n_samples, float* left, float* right) {
+/* piano like sound w/slight stereo phase
+ *
+ * Voices are collected in a RSVoiceBatch and rendered RS_LANES at a time,
+ * the loops over the lanes are vectorized by the compiler. The envelope
+ * and volume are computed per voice beforehand, see adsr_env_run().
+ *
+ * sin(2 pi phase) and cos(2 pi phase) are approximated by a polynomial,
+ * the overtones are derived from those using angle addition (instead
+ * of calling sinf() ten times per sample and voice).
+ */
+
+/* sin and cos of 2 * M_PI * p */
+static inline void sincos_2pi (const float p, float* s, float* c) {
+  /* half-angle in [-pi/2, pi/2] */
+  const float r = p - (int32_t)(p < 0 ? p - .5f : p + .5f);
+  const float x = (float)M_PI * r;
+  const float x2 = x * x;
+  const float sh = x * (1.f - x2 * (1.f / 6.f - x2 * (1.f / 120.f - x2 * (1.f / 5040.f - x2 * (1.f / 362880.f - x2 * (1.f / 39916800.f))))));
+  const float ch = 1.f - x2 * (1.f / 2.f - x2 * (1.f / 24.f - x2 * (1.f / 720.f - x2 * (1.f / 40320.f - x2 * (1.f / 3628800.f - x2 * (1.f / 479001600.f))))));
+  *s = 2.f * sh * ch;
+  *c = ch * ch - sh * sh;
+}
+
+/* overtones 1,2,3,4 and 7, sign of the 4th and 7th */
+static inline float piano_tone (const float s1, const float c1, const float sgn) {
+  const float s2 = 2.f * s1 * c1;
+  const float c2 = c1 * c1 - s1 * s1;
+  const float s3 = s2 * c1 + c2 * s1;
+  const float c3 = c2 * c1 - s2 * s1;
+  const float s4 = 2.f * s2 * c2;
+  const float c4 = c2 * c2 - s2 * s2;
+  const float s7 = s4 * c3 + c4 * s3;
+  return s1 + .300f * s2 + .150f * s3 + sgn * (.080f * s4 + .020f * s7);
+}
 
+static void render_voices (RSVoiceBatch* vb, const size_t n_samples, float* left, float* right) {
+  float phase[RS_LANES];
+  float rot_s[RS_LANES];
+  float rot_c[RS_LANES];
+  uint32_t v;
   size_t i;
-  float phase = sc->phase[note];
 
-  for (i=0; i < n_samples; ++i) {
-    float env = adsr_env(sc, note);
-    if (sc->adsr_cnt[note] == 0) break;
-    const float amp = vol * env;
-    if (amp > 1e-10) {
-      left[i]  += amp * sinf(2.0 * M_PI * phase);
-      left[i]  += .300 * amp * sinf(2.0 * M_PI * phase * 2.0);
-      left[i]  += .150 * amp * sinf(2.0 * M_PI * phase * 3.0);
-      left[i]  += .080 * amp * sinf(2.0 * M_PI * phase * 4.0);
-      //left[i]  -= .007 * amp * sinf(2.0 * M_PI * phase * 5.0);
-      //left[i]  += .010 * amp * sinf(2.0 * M_PI * phase * 6.0);
-      left[i]  += .020 * amp * sinf(2.0 * M_PI * phase * 7.0);
-      phase += fq;
-      right[i] += amp * sinf(2.0 * M_PI * phase);
-      right[i] += .300 * amp * sinf(2.0 * M_PI * phase * 2.0);
-      right[i] += .150 * amp * sinf(2.0 * M_PI * phase * 3.0);
-      right[i] -= .080 * amp * sinf(2.0 * M_PI * phase * 4.0);
-      //right[i] += .007 * amp * sinf(2.0 * M_PI * phase * 5.0);
-      //right[i] += .010 * amp * sinf(2.0 * M_PI * phase * 6.0);
-      right[i] -= .020 * amp * sinf(2.0 * M_PI * phase * 7.0);
-    } else {
-      phase += fq;
+  for (v = vb->n_voices; v < RS_LANES; ++v) {
+    vb->phase[v] = 0;
+    vb->fq[v] = 0;
+    vb->phase_out[v] = NULL;
+    for (i = 0; i < n_samples; ++i) {
+      vb->amp[i][v] = 0;
+    }
+  }
+
+  memcpy (phase, vb->phase, sizeof (phase));
+
+  /* the right channel is one step ahead, rotate by fq */
+  for (v = 0; v < RS_LANES; ++v) {
+    sincos_2pi (vb->fq[v], &rot_s[v], &rot_c[v]);
+  }
+
+  for (i = 0; i < n_samples; ++i) {
+    const float* const amp = vb->amp[i];
+    float l[RS_LANES];
+    float r[RS_LANES];
+    for (v = 0; v < RS_LANES; ++v) {
+      float s, c;
+      sincos_2pi (phase[v], &s, &c);
+      l[v] = amp[v] * piano_tone (s, c, 1.f);
+      r[v] = amp[v] * piano_tone (s * rot_c[v] + c * rot_s[v], c * rot_c[v] - s * rot_s[v], -1.f);
+      phase[v] += vb->fq[v];
+      phase[v] = phase[v] > 1.f ? phase[v] - 2.f : phase[v];
     }
-    if (phase > 1.0) phase -= 2.0;
+    float sl = 0;
+    float sr = 0;
+    for (v = 0; v < RS_LANES; ++v) {
+      sl += l[v];
+      sr += r[v];
+    }
+    left[i]  += sl;
+    right[i] += sr;
+  }
+
+  for (v = 0; v < vb->n_voices; ++v) {
+    if (vb->phase_out[v]) {
+      *vb->phase_out[v] = phase[v];
+    }
+  }
+  vb->n_voices = 0;
+}
+
+/* compute the envelope of a voice and add it to the batch,
+ * render the batch when it is full */
+static void synthesize_sineP (RSVoiceBatch* vb, RSSynthChannel* sc,
+    const uint8_t note, const float vol, const float fq,
+    const size_t n_samples, float* left, float* right) {
+
+  const uint32_t v = vb->n_voices;
+  size_t i = adsr_env_run(sc, note, vol, n_samples, &vb->amp[0][v], RS_LANES);
+
+  for (; i < n_samples; ++i) {
+    vb->amp[i][v] = 0;
+  }
+
+  vb->phase[v] = sc->phase[note];
+  vb->fq[v] = fq;
+  vb->phase_out[v] = sc->adsr_cnt[note] == 0 ? NULL : &sc->phase[note];
+
+  if (++vb->n_voices == RS_LANES) {
+    render_voices (vb, n_samples, left, right);
   }
-  sc->phase[note] = phase;
 }
 
 static const ADSRcfg piano_adsr = {{   5, 800,  100}, { 1.0,  0.0}, {0,0,0}};
@@ -278,7 +419,7 @@ static void process_key (void *synth,
   //printf("NOTE: %d (%d %d %d)\n", sc->adsr_cnt[note], sc->adsr.off[0], sc->adsr.off[1], sc->adsr.off[2]);
 
   // synthesize actual sound
-  sc->synthesize(sc, note, vol, rs->freqs[note], n_samples, left, right);
+  synthesize_sineP(&rs->vb, sc, note, vol, rs->freqs[note], n_samples, left, right);
 
   if (sc->adsr_cnt[note] == 0) {
     //printf("Note %d,%d released\n", chn, note);
@@ -308,6 +449,10 @@ static void synth_fragment (void *synth, const size_t n_samples, float *left, fl
     keycomp += rs->sc[c].keycomp;
   }
 
+  if (rs->vb.n_voices > 0) {
+    render_voices (&rs->vb, n_samples, left, right);
+  }
+
 #if 1 // key-compression
   float kctgt = 8.0 / (float)(keycomp + 7.0);
   if (kctgt < .5) kctgt = .5;
@@ -344,13 +489,11 @@ static void synth_reset(void *synth) {
 }
 
 static void synth_load(RSSynthChannel *sc, const double rate,
-    SynthFunction synthesize,
     ADSRcfg const * const adsr) {
   synth_reset_channel(sc);
   init_adsr(&sc->adsr, rate,
       adsr->tme[0], adsr->tme[1], adsr->tme[2],
       adsr->vol[0], adsr->vol[1]);
-  sc->synthesize = synthesize;
 }
 
 
@@ -533,7 +676,7 @@ static void synth_init(void *synth, double rate) {
   synth_reset(synth);
 
   for (c=0; c < 16; c++) {
-    synth_load(&rs->sc[c], rate, &synthesize_sineP, &piano_adsr);
+    synth_load(&rs->sc[c], rate, &piano_adsr);
   }
   rs->xmas_on = 0;
   rs->xmas_off = 0;
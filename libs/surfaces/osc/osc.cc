@@ -653,6 +653,8 @@ OSC::register_callbacks()
 		REGISTER_CALLBACK (serv, X_("/strip/plugin/list"), "i", route_plugin_list);
 		REGISTER_CALLBACK (serv, X_("/strip/plugin/descriptor"), "ii", route_plugin_descriptor);
 		REGISTER_CALLBACK (serv, X_("/strip/plugin/reset"), "ii", route_plugin_reset);
+		REGISTER_CALLBACK (serv, X_("/strip/plugin/stats"), "ii", route_plugin_stats);
+		REGISTER_CALLBACK (serv, X_("/strip/plugin/stats/reset"), "ii", route_plugin_stats_reset);
 
 		/* still not-really-standardized query interface */
 		//REGISTER_CALLBACK (serv, "/ardour/*/#current_value", "", current_value);
@@ -5412,6 +5414,70 @@ OSC::route_plugin_reset (int ssid, int piid, lo_message msg) {
 	return 0;
 }
 
+int
+OSC::route_plugin_stats (int ssid, int piid, lo_message msg) {
+	if (!session) {
+		return -1;
+	}
+
+	boost::shared_ptr<Route> r = boost::dynamic_pointer_cast<Route>(get_strip (ssid, get_address (msg)));
+
+	if (!r) {
+		PBD::error << "OSC: Invalid Remote Control ID '" << ssid << "'" << endmsg;
+		return -1;
+	}
+
+	boost::shared_ptr<Processor> redi = r->nth_plugin(piid - 1);
+
+	if (!redi) {
+		PBD::error << "OSC: cannot find plugin # " << piid << " for RID '" << ssid << "'" << endmsg;
+		return -1;
+	}
+
+	double min, max, avg, p95, p99;
+	if (!redi->get_cycle_stats (min, max, avg, p95, p99)) {
+		/* no data: stats are disabled, or the plugin did not run yet */
+		min = max = avg = p95 = p99 = -1;
+	}
+
+	lo_message reply = lo_message_new ();
+	lo_message_add_int32 (reply, ssid);
+	lo_message_add_int32 (reply, piid);
+	lo_message_add_float (reply, min);
+	lo_message_add_float (reply, avg);
+	lo_message_add_float (reply, max);
+	lo_message_add_float (reply, p95);
+	lo_message_add_float (reply, p99);
+
+	lo_send_message (get_address (msg), X_("/strip/plugin/stats"), reply);
+	lo_message_free (reply);
+	return 0;
+}
+
+int
+OSC::route_plugin_stats_reset (int ssid, int piid, lo_message msg) {
+	if (!session) {
+		return -1;
+	}
+
+	boost::shared_ptr<Route> r = boost::dynamic_pointer_cast<Route>(get_strip (ssid, get_address (msg)));
+
+	if (!r) {
+		PBD::error << "OSC: Invalid Remote Control ID '" << ssid << "'" << endmsg;
+		return -1;
+	}
+
+	boost::shared_ptr<Processor> redi = r->nth_plugin(piid - 1);
+
+	if (!redi) {
+		PBD::error << "OSC: cannot find plugin # " << piid << " for RID '" << ssid << "'" << endmsg;
+		return -1;
+	}
+
+	redi->reset_cycle_stats ();
+	return 0;
+}
+
 int
 OSC::route_plugin_parameter (int ssid, int piid, int par, float val, lo_message msg)
 {
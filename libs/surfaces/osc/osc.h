@@ -650,6 +650,8 @@ class OSC : public ARDOUR::ControlProtocol, public AbstractUI<OSCUIRequest>
 	PATH_CALLBACK1_MSG(route_plugin_list,i);
 	PATH_CALLBACK2_MSG(route_plugin_descriptor,i,i);
 	PATH_CALLBACK2_MSG(route_plugin_reset,i,i);
+	PATH_CALLBACK2_MSG(route_plugin_stats,i,i);
+	PATH_CALLBACK2_MSG(route_plugin_stats_reset,i,i);
 
 	int route_rename (int rid, char *s, lo_message msg);
 	int strip_group (int ssid, char *g, lo_message msg);
@@ -684,6 +686,8 @@ class OSC : public ARDOUR::ControlProtocol, public AbstractUI<OSCUIRequest>
 	int route_plugin_list(int ssid, lo_message msg);
 	int route_plugin_descriptor(int ssid, int piid, lo_message msg);
 	int route_plugin_reset(int ssid, int piid, lo_message msg);
+	int route_plugin_stats(int ssid, int piid, lo_message msg);
+	int route_plugin_stats_reset(int ssid, int piid, lo_message msg);
 
 	//banking functions
 	int set_bank (uint32_t bank_start, lo_message msg);
@@ -24,6 +24,7 @@
 #include "ardour/amp.h"
 #include "ardour/session.h"
 #include "ardour/dB.h"
+#include "ardour/loudness_meter.h"
 #include "ardour/meter.h"
 #include "ardour/monitor_processor.h"
 
@@ -326,6 +327,17 @@ OSCGlobalObserver::tick ()
 		}
 		_last_meter = now_meter;
 
+		if (feedback[7]) {
+			boost::shared_ptr<LoudnessMeter> lm = session->master_out()->loudness_meter();
+			LoudnessMeter::Readout r;
+			if (lm && lm->read (r)) {
+				send_loudness (X_("/master/loudness/momentary"), r.momentary, _last_loudness.momentary);
+				send_loudness (X_("/master/loudness/short_term"), r.short_term, _last_loudness.short_term);
+				send_loudness (X_("/master/loudness/integrated"), r.integrated, _last_loudness.integrated);
+				send_loudness (X_("/master/loudness/range"), r.range, _last_loudness.range);
+				send_loudness (X_("/master/loudness/true_peak"), r.true_peak, _last_loudness.true_peak);
+			}
+		}
 	}
 	if (feedback[4]) {
 		if (master_timeout) {
@@ -407,6 +419,17 @@ OSCGlobalObserver::send_trim_message (string path, boost::shared_ptr<Controllabl
 }
 
 
+void
+OSCGlobalObserver::send_loudness (std::string const& path, float now, float& last)
+{
+	/* 0.1 LU resolution */
+	now = rintf (now * 10.f) / 10.f;
+	if (now != last) {
+		_osc.float_message (path, now, addr);
+		last = now;
+	}
+}
+
 void
 OSCGlobalObserver::send_transport_state_changed()
 {
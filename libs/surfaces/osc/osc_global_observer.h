@@ -27,6 +27,7 @@
 
 #include "pbd/controllable.h"
 #include "pbd/stateful.h"
+#include "ardour/loudness_meter.h"
 #include "ardour/types.h"
 
 class OSCGlobalObserver
@@ -66,6 +67,7 @@ class OSCGlobalObserver
 	samplepos_t _last_sample;
 	uint32_t _heartbeat;
 	float _last_meter;
+	ARDOUR::LoudnessMeter::Readout _last_loudness;
 	uint32_t master_timeout;
 	uint32_t monitor_timeout;
 	uint32_t last_punchin;
@@ -91,6 +93,7 @@ class OSCGlobalObserver
 	void send_change_message (std::string path, boost::shared_ptr<PBD::Controllable> controllable);
 	void send_gain_message (std::string path, boost::shared_ptr<PBD::Controllable> controllable);
 	void send_trim_message (std::string path, boost::shared_ptr<PBD::Controllable> controllable);
+	void send_loudness (std::string const& path, float now, float& last);
 	void send_transport_state_changed (void);
 	void send_record_state_changed (void);
 	void solo_active (bool active);
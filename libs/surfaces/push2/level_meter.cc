@@ -164,7 +164,7 @@ LevelMeter::update_meters ()
 				const float peak = _meter->meter_level (n, meter_type);
 				if (meter_type == MeterPeak) {
 					(*i).meter->set (log_meter (peak));
-				} else if (meter_type == MeterPeak0dB) {
+				} else if (meter_type == MeterPeak0dB || meter_type == MeterTruePeak) {
 					(*i).meter->set (log_meter0dB (peak));
 				} else if (meter_type == MeterIEC1NOR) {
 					(*i).meter->set (meter_deflect_nordic (peak + meter_lineup(0)));
@@ -417,6 +417,7 @@ LevelMeter::setup_meters (int len, int initial_width, int thin_width)
 					c[7] = c[8] = c[9] = c[6];
 					break;
 				case MeterPeak0dB:
+				case MeterTruePeak:
 					 stp[1] =  89.125; // 115.0 * log_meter0dB(-9);
 					 stp[2] = 106.375; // 115.0 * log_meter0dB(-3);
 					 stp[3] = 115.0;   // 115.0 * log_meter0dB(0);
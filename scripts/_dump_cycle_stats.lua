@@ -0,0 +1,35 @@
+ardour { ["type"] = "Snippet", name = "Dump Processor DSP Stats",
+	license     = "MIT",
+	author      = "Ardour Team",
+	description = [[Print per-processor CPU usage (requires Preferences > General > DSP Profiling)]]
+}
+
+function factory () return function ()
+	if not ARDOUR.config():get_processor_cycle_stats () then
+		print ("Per-processor DSP statistics are not enabled.")
+		return
+	end
+
+	print (string.format ("%-32s %9s %9s %9s %9s %9s", "Processor [usec]", "min", "avg", "max", "95%", "99%"))
+	for r in Session:get_routes ():iter () do
+		print (" -- " .. r:name ())
+		local i = 0
+		while true do
+			local proc = r:nth_processor (i)
+			if proc:isnil () then break end
+			local rv, st = proc:get_cycle_stats (0, 0, 0, 0, 0)
+			if rv then
+				print (string.format (" * %-29s %9.2f %9.2f %9.2f %9.2f %9.2f",
+				string.sub (proc:name (), 0, 29), st[1], st[3], st[2], st[4], st[5]))
+			end
+			local pi = proc:to_insert ()
+			if not pi:isnil () then
+				local slept, sst = pi:get_sleep_stats (0, 0)
+				if slept then
+					print (string.format ("   slept for %d samples, saved %.1f ms", sst[1], sst[2] / 1000))
+				end
+			end
+			i = i + 1
+		end
+	end
+end end
@@ -0,0 +1,20 @@
+ardour { ["type"] = "EditorAction", name = "Toggle Process Trace",
+	license     = "MIT",
+	author      = "Ardour Team",
+	description = [[Start recording a trace of the realtime process-cycle, or stop and save it as Chrome Trace JSON in the session folder. The file can be inspected with chrome://tracing or https://ui.perfetto.dev]]
+}
+
+function factory () return function ()
+	if ARDOUR.TraceRecorder.active () then
+		local path = ARDOUR.LuaAPI.build_filename (Session:path (), "process-trace.json")
+		if 0 == ARDOUR.TraceRecorder.dump (path) then
+			print ("Process trace written to: " .. path)
+		else
+			print ("Failed to write process trace.")
+		end
+	else
+		-- capacity: events per thread
+		ARDOUR.TraceRecorder.start (65536)
+		print ("Process trace started. Run this action again to stop and save the trace.")
+	end
+end end
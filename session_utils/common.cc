@@ -8,6 +8,7 @@
 #include "pbd/failed_constructor.h"
 #include "pbd/pthread_utils.h"
 
+#include "ardour/audio_backend.h"
 #include "ardour/audioengine.h"
 #include "ardour/filename_extensions.h"
 #include "ardour/types.h"
@@ -85,6 +86,9 @@ class MyEventLoop : public sigc::trackable, public EventLoop
 
 static MyEventLoop *event_loop;
 
+static bool engine_max_speed = false;
+static uint32_t engine_buffer_size = 0;
+
 void
 SessionUtils::init (bool print_log)
 {
@@ -105,6 +109,32 @@ SessionUtils::init (bool print_log)
 	}
 }
 
+void
+SessionUtils::set_engine_options (bool max_speed, uint32_t buffer_size)
+{
+	engine_max_speed = max_speed;
+	engine_buffer_size = buffer_size;
+}
+
+static bool
+apply_engine_options (AudioEngine* engine)
+{
+	if (engine_max_speed) {
+		/* driver names are translated, the Dummy backend lists
+		 * speeds in increasing order, the last one is "Max Speed" */
+		std::vector<std::string> drivers (engine->current_backend ()->enumerate_drivers ());
+		if (drivers.empty () || engine->current_backend ()->set_driver (drivers.back ())) {
+			std::cerr << "Cannot set engine driver to max speed\n";
+			return false;
+		}
+	}
+	if (engine_buffer_size > 0 && engine->set_buffer_size (engine_buffer_size)) {
+		std::cerr << "Cannot set buffer size to " << engine_buffer_size << "\n";
+		return false;
+	}
+	return true;
+}
+
 // TODO return NULL, rather than exit() ?!
 static Session * _load_session (string dir, string state)
 {
@@ -118,6 +148,10 @@ static Session * _load_session (string dir, string state)
 	engine->set_input_channels (256);
 	engine->set_output_channels (256);
 
+	if (!apply_engine_options (engine)) {
+		return 0;
+	}
+
 	float sr;
 	SampleFormat sf;
 	std::string v;
@@ -189,6 +223,10 @@ SessionUtils::create_session (string dir, string state, float sample_rate)
 	engine->set_input_channels (256);
 	engine->set_output_channels (256);
 
+	if (!apply_engine_options (engine)) {
+		return 0;
+	}
+
 	if (engine->set_sample_rate (sample_rate)) {
 		std::cerr << "Cannot set session's samplerate.\n";
 		return 0;
@@ -23,6 +23,13 @@ namespace SessionUtils {
 	 */
 	void cleanup ();
 
+	/** set options of the Dummy backend, used by subsequent
+	 * \ref load_session and \ref create_session calls.
+	 * @param max_speed process as fast as possible (the Dummy's "Max Speed" driver)
+	 * @param buffer_size block size in samples, 0 for the default
+	 */
+	void set_engine_options (bool max_speed, uint32_t buffer_size);
+
 	/** @param dir Session directory.
 	 *  @param state Session state file, without .ardour suffix.
 	 *  @returns an ardour session object (free with \ref unload_session) or NULL
@@ -8,6 +8,8 @@
 #include "pbd/basename.h"
 #include "pbd/enumwriter.h"
 
+#include "ardour/audio_backend.h"
+#include "ardour/audioengine.h"
 #include "ardour/broadcast_info.h"
 #include "ardour/export_handler.h"
 #include "ardour/export_status.h"
@@ -30,6 +32,7 @@ struct ExportSettings
 		, _sample_format (ExportFormatBase::SF_16)
 		, _normalize (false)
 		, _bwf (false)
+		, _timing (false)
 	{}
 
 	std::string samplerate () const
@@ -58,6 +61,7 @@ struct ExportSettings
 	ExportFormatBase::SampleFormat _sample_format;
 	bool _normalize;
 	bool _bwf;
+	bool _timing;
 };
 
 static int export_session (Session *session,
@@ -158,6 +162,11 @@ static int export_session (Session *session,
 	/* do audio export */
 	fmp->set_soundcloud_upload(false);
 	session->get_export_handler()->add_export_config (tsp, ccp, fmp, fnp, b);
+
+	if (settings._timing) {
+		AudioEngine::instance()->current_backend()->reset_cycle_timing ();
+	}
+
 	session->get_export_handler()->do_export();
 
 	boost::shared_ptr<ARDOUR::ExportStatus> status = session->get_export_status ();
@@ -185,6 +194,10 @@ static int export_session (Session *session,
 
 	status->finish ();
 
+	if (settings._timing) {
+		printf ("%s", AudioEngine::instance()->current_backend()->cycle_timing_report ().c_str ());
+	}
+
 	printf ("* Done.\n");
 	return 0;
 }
@@ -197,9 +210,12 @@ static void usage (int status) {
   -b, --bitdepth <depth>     set export-format (16, 24, 32, float)\n\
   -B, --broadcast            include broadcast wave header\n\
   -h, --help                 display this help and exit\n\
+  -m, --max-speed            process as fast as possible (no sleep between cycles)\n\
   -n, --normalize            normalize signal level (to 0dBFS)\n\
   -o, --output  <file>       export output file name\n\
+  -P, --period <samples>     engine block size (default 1024, max 8192)\n\
   -s, --samplerate <rate>    samplerate to use\n\
+  -T, --timing               print process cycle timing statistics\n\
   -V, --version              print version information and exit\n\
 \n");
 	printf ("\n\
@@ -209,6 +225,10 @@ By default a 16bit signed .wav file at session-rate is exported.\n\
 If the no output-file is given, the session's export dir is used.\n\
 \n\
 Note: the tool expects a session-name without .ardour file-name extension.\n\
+\n\
+For batch rendering use --max-speed with a large --period (e.g. 8192);\n\
+--timing reports the achieved realtime factor and a histogram of the\n\
+process cycle duration.\n\
 \n");
 
 	printf ("Report bugs to <http://tracker.ardour.org/>\n"
@@ -220,16 +240,21 @@ int main (int argc, char* argv[])
 {
 	ExportSettings settings;
 	std::string outfile;
+	bool max_speed = false;
+	uint32_t period = 0;
 
-	const char *optstring = "b:Bhno:s:V";
+	const char *optstring = "b:Bhmno:P:s:TV";
 
 	const struct option longopts[] = {
 		{ "bitdepth",   1, 0, 'b' },
 		{ "broadcast",  0, 0, 'B' },
 		{ "help",       0, 0, 'h' },
+		{ "max-speed",  0, 0, 'm' },
 		{ "normalize",  0, 0, 'n' },
 		{ "output",     1, 0, 'o' },
+		{ "period",     1, 0, 'P' },
 		{ "samplerate", 1, 0, 's' },
+		{ "timing",     0, 0, 'T' },
 		{ "version",    0, 0, 'V' },
 	};
 
@@ -265,6 +290,10 @@ int main (int argc, char* argv[])
 				settings._bwf = true;
 				break;
 
+			case 'm':
+				max_speed = true;
+				break;
+
 			case 'n':
 				settings._normalize = true;
 				break;
@@ -273,6 +302,17 @@ int main (int argc, char* argv[])
 				outfile = optarg;
 				break;
 
+			case 'P':
+				{
+					const int p = atoi (optarg);
+					if (p >= 16 && p <= 8192) {
+						period = p;
+					} else {
+						fprintf(stderr, "Invalid Period\n");
+					}
+				}
+				break;
+
 			case 's':
 				{
 					const int sr = atoi (optarg);
@@ -284,6 +324,10 @@ int main (int argc, char* argv[])
 				}
 				break;
 
+			case 'T':
+				settings._timing = true;
+				break;
+
 			case 'V':
 				printf ("ardour-utils version %s\n\n", VERSIONSTRING);
 				printf ("Copyright (C) GPL 2015,2017 Robin Gareus <robin@gareus.org>\n");
@@ -305,6 +349,7 @@ int main (int argc, char* argv[])
 	}
 
 	SessionUtils::init(false);
+	SessionUtils::set_engine_options (max_speed, period);
 	Session* s = 0;
 
 	s = SessionUtils::load_session (argv[optind], argv[optind+1]);
@@ -0,0 +1,639 @@
+/* gcc -O3 -ffast-math -std=gnu99 -DLV2_EXTENDED -I libs/ardour -o a-comp_test tools/a-comp_test.c `pkg-config --cflags --libs lv2 cairo` -lm */
+
+/* Offline comparison test for a-Comp.
+ *
+ * The block-wise run_mono () and run_stereo () are compared against the
+ * previous sample-by-sample implementation (copied verbatim below), for
+ * several parameter sets, with and without sidechain, at various
+ * sample-rates, using random cycle sizes and a signal with a stepped
+ * envelope. Outputs are compared once the makeup gain has settled.
+ *
+ * Look-ahead is tested with a ratio of 1: the output must be the input,
+ * delayed by exactly the latency that is reported.
+ *
+ * Returns 0 if all differences are within the tolerance.
+ */
+
+#include <stdio.h>
+#include <getopt.h>
+#include <time.h>
+
+#include "../libs/plugins/a-comp.lv2/a-comp.c"
+
+static int64_t
+usec (void)
+{
+	struct timespec ts;
+	clock_gettime (CLOCK_MONOTONIC, &ts);
+	return (int64_t) ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+/* reference implementation, per sample */
+
+static void
+reference_run_mono(LV2_Handle instance, uint32_t n_samples)
+{
+	AComp* acomp = (AComp*)instance;
+
+	const float* const input = acomp->input0;
+	const float* const sc = acomp->sc;
+	float* const output = acomp->output0;
+
+	float srate = acomp->srate;
+	float width = (6.f * *(acomp->knee)) + 0.01;
+	float cdb=0.f;
+	float attack_coeff = exp(-1000.f/(*(acomp->attack) * srate));
+	float release_coeff = exp(-1000.f/(*(acomp->release) * srate));
+
+	float max = 0.f;
+	float lgaininp = 0.f;
+	float Lgain = 1.f;
+	float Lxg, Lxl, Lyg, Lyl, Ly1;
+	int usesidechain = (*(acomp->sidechain) <= 0.f) ? 0 : 1;
+	uint32_t i;
+	float ingain;
+	float in0;
+	float sc0;
+
+	float ratio = *acomp->ratio;
+	float thresdb = *acomp->thresdb;
+	float makeup = *acomp->makeup;
+	float makeup_target = from_dB(makeup);
+	float makeup_gain = acomp->makeup_gain;
+
+	const float tau = (1.0 - exp (-2.f * M_PI * n_samples * 25.f / acomp->srate));
+
+	if (*acomp->enable <= 0) {
+		ratio = 1.f;
+		thresdb = 0.f;
+		makeup = 0.f;
+		makeup_target = 1.f;
+	}
+
+#ifdef LV2_EXTENDED
+	if (acomp->v_knee != *acomp->knee) {
+		acomp->v_knee = *acomp->knee;
+		acomp->need_expose = true;
+	}
+
+	if (acomp->v_ratio != ratio) {
+		acomp->v_ratio = ratio;
+		acomp->need_expose = true;
+	}
+
+	if (acomp->v_thresdb != thresdb) {
+		acomp->v_thresdb = thresdb;
+		acomp->need_expose = true;
+	}
+
+	if (acomp->v_makeup != makeup) {
+		acomp->v_makeup = makeup;
+		acomp->need_expose = true;
+	}
+#endif
+
+	float in_peak = 0;
+	acomp->v_gainr = 0.0;
+
+	for (i = 0; i < n_samples; i++) {
+		in0 = input[i];
+		sc0 = sc[i];
+		ingain = usesidechain ? fabs(sc0) : fabs(in0);
+		in_peak = fmaxf (in_peak, ingain);
+		Lyg = 0.f;
+		Lxg = (ingain==0.f) ? -160.f : to_dB(ingain);
+		Lxg = sanitize_denormal(Lxg);
+
+
+		if (2.f*(Lxg-thresdb) < -width) {
+			Lyg = Lxg;
+		} else if (2.f*(Lxg-thresdb) > width) {
+			Lyg = thresdb + (Lxg-thresdb)/ratio;
+			Lyg = sanitize_denormal(Lyg);
+		} else {
+			Lyg = Lxg + (1.f/ratio-1.f)*(Lxg-thresdb+width/2.f)*(Lxg-thresdb+width/2.f)/(2.f*width);
+		}
+
+		Lxl = Lxg - Lyg;
+
+		acomp->old_y1 = sanitize_denormal(acomp->old_y1);
+		acomp->old_yl = sanitize_denormal(acomp->old_yl);
+		Ly1 = fmaxf(Lxl, release_coeff * acomp->old_y1+(1.f-release_coeff)*Lxl);
+		Lyl = attack_coeff * acomp->old_yl+(1.f-attack_coeff)*Ly1;
+		Ly1 = sanitize_denormal(Ly1);
+		Lyl = sanitize_denormal(Lyl);
+
+		cdb = -Lyl;
+		Lgain = from_dB(cdb);
+
+		*(acomp->gainr) = Lyl;
+		if (Lyl > acomp->v_gainr) {
+			acomp->v_gainr = Lyl;
+		}
+
+		lgaininp = in0 * Lgain;
+
+		output[i] = lgaininp * makeup_gain;
+
+		max = (fabsf(output[i]) > max) ? fabsf(output[i]) : sanitize_denormal(max);
+
+		// TODO re-use local variables on stack
+		// store values back to acomp at the end of the inner-loop
+		acomp->old_yl = Lyl;
+		acomp->old_y1 = Ly1;
+		acomp->old_yg = Lyg;
+	}
+
+	if ( fabsf(makeup_target - makeup_gain) < 1e-6 ) {
+		makeup_gain = makeup_target;
+	} else {
+		makeup_gain += tau * (makeup_target - makeup_gain) + 1e-12;
+	}
+
+	*(acomp->outlevel) = (max < 0.0056f) ? -45.f : to_dB(max);
+	acomp->makeup_gain = makeup_gain;
+
+#ifdef LV2_EXTENDED
+	const float old_v_lv1 = acomp->v_lv1;
+	const float old_v_lvl = acomp->v_lvl;
+	const float tot_rel_c = exp(-1000.f/(*(acomp->release) * srate) * n_samples);
+	const float tot_atk_c = exp(-1000.f/(*(acomp->attack) * srate) * n_samples);
+	acomp->v_lv1 = fmaxf (in_peak, tot_rel_c*old_v_lv1 + (1.f-tot_rel_c)*in_peak);
+	acomp->v_lvl = tot_atk_c*old_v_lvl + (1.f-tot_atk_c)*acomp->v_lv1;
+
+	if (!isfinite_local (acomp->v_lvl)) {
+		acomp->v_lvl = 0.f;
+	}
+	const float v_lvl_in = (acomp->v_lvl < 0.001f) ? -60.f : to_dB(acomp->v_lvl);
+	const float v_lvl_out = (max < 0.001f) ? -60.f : to_dB(max);
+	if (fabsf (acomp->v_lvl_out - v_lvl_out) >= 1 || fabsf (acomp->v_lvl_in - v_lvl_in) >= 1) {
+		// >= 1dB difference
+		acomp->need_expose = true;
+		acomp->v_lvl_in = v_lvl_in;
+		const float relax_coef = exp(-(float)n_samples/srate);
+		acomp->v_lvl_out = fmaxf (v_lvl_out, relax_coef*acomp->v_lvl_out + (1.f-relax_coef)*v_lvl_out);
+	}
+	if (acomp->need_expose && acomp->queue_draw) {
+		acomp->need_expose = false;
+		acomp->queue_draw->queue_draw (acomp->queue_draw->handle);
+	}
+#endif
+}
+
+static void
+reference_run_stereo(LV2_Handle instance, uint32_t n_samples)
+{
+	AComp* acomp = (AComp*)instance;
+
+	const float* const input0 = acomp->input0;
+	const float* const input1 = acomp->input1;
+	const float* const sc = acomp->sc;
+	float* const output0 = acomp->output0;
+	float* const output1 = acomp->output1;
+
+	float srate = acomp->srate;
+	float width = (6.f * *(acomp->knee)) + 0.01;
+	float cdb=0.f;
+	float attack_coeff = exp(-1000.f/(*(acomp->attack) * srate));
+	float release_coeff = exp(-1000.f/(*(acomp->release) * srate));
+
+	float max = 0.f;
+	float lgaininp = 0.f;
+	float rgaininp = 0.f;
+	float Lgain = 1.f;
+	float Lxg, Lxl, Lyg, Lyl, Ly1;
+	int usesidechain = (*(acomp->sidechain) <= 0.f) ? 0 : 1;
+	uint32_t i;
+	float ingain;
+	float in0;
+	float in1;
+	float sc0;
+	float maxabslr;
+
+	float ratio = *acomp->ratio;
+	float thresdb = *acomp->thresdb;
+	float makeup = *acomp->makeup;
+	float makeup_target = from_dB(makeup);
+	float makeup_gain = acomp->makeup_gain;
+
+	const float tau = (1.0 - exp (-2.f * M_PI * n_samples * 25.f / acomp->srate));
+
+	if (*acomp->enable <= 0) {
+		ratio = 1.f;
+		thresdb = 0.f;
+		makeup = 0.f;
+		makeup_target = 1.f;
+	}
+
+#ifdef LV2_EXTENDED
+	if (acomp->v_knee != *acomp->knee) {
+		acomp->v_knee = *acomp->knee;
+		acomp->need_expose = true;
+	}
+
+	if (acomp->v_ratio != ratio) {
+		acomp->v_ratio = ratio;
+		acomp->need_expose = true;
+	}
+
+	if (acomp->v_thresdb != thresdb) {
+		acomp->v_thresdb = thresdb;
+		acomp->need_expose = true;
+	}
+
+	if (acomp->v_makeup != makeup) {
+		acomp->v_makeup = makeup;
+		acomp->need_expose = true;
+	}
+#endif
+
+	float in_peak = 0;
+	acomp->v_gainr = 0.0;
+
+	for (i = 0; i < n_samples; i++) {
+		in0 = input0[i];
+		in1 = input1[i];
+		sc0 = sc[i];
+		maxabslr = fmaxf(fabs(in0), fabs(in1));
+		ingain = usesidechain ? fabs(sc0) : maxabslr;
+		in_peak = fmaxf (in_peak, ingain);
+		Lyg = 0.f;
+		Lxg = (ingain==0.f) ? -160.f : to_dB(ingain);
+		Lxg = sanitize_denormal(Lxg);
+
+
+		if (2.f*(Lxg-thresdb) < -width) {
+			Lyg = Lxg;
+		} else if (2.f*(Lxg-thresdb) > width) {
+			Lyg = thresdb + (Lxg-thresdb)/ratio;
+			Lyg = sanitize_denormal(Lyg);
+		} else {
+			Lyg = Lxg + (1.f/ratio-1.f)*(Lxg-thresdb+width/2.f)*(Lxg-thresdb+width/2.f)/(2.f*width);
+		}
+
+		Lxl = Lxg - Lyg;
+
+		acomp->old_y1 = sanitize_denormal(acomp->old_y1);
+		acomp->old_yl = sanitize_denormal(acomp->old_yl);
+		Ly1 = fmaxf(Lxl, release_coeff * acomp->old_y1+(1.f-release_coeff)*Lxl);
+		Lyl = attack_coeff * acomp->old_yl+(1.f-attack_coeff)*Ly1;
+		Ly1 = sanitize_denormal(Ly1);
+		Lyl = sanitize_denormal(Lyl);
+
+		cdb = -Lyl;
+		Lgain = from_dB(cdb);
+
+		*(acomp->gainr) = Lyl;
+		if (Lyl > acomp->v_gainr) {
+			acomp->v_gainr = Lyl;
+		}
+
+		lgaininp = in0 * Lgain;
+		rgaininp = in1 * Lgain;
+
+		output0[i] = lgaininp * makeup_gain;
+		output1[i] = rgaininp * makeup_gain;
+
+		max = (fmaxf(fabs(output0[i]), fabs(output1[i])) > max) ? fmaxf(fabs(output0[i]), fabs(output1[i])) : sanitize_denormal(max);
+
+		// TODO re-use local variables on stack
+		// store values back to acomp at the end of the inner-loop
+		acomp->old_yl = Lyl;
+		acomp->old_y1 = Ly1;
+		acomp->old_yg = Lyg;
+	}
+
+	if ( fabsf(makeup_target - makeup_gain) < 1e-6 ) {
+		makeup_gain = makeup_target;
+	} else {
+		makeup_gain += tau * (makeup_target - makeup_gain) + 1e-12;
+	}
+
+	*(acomp->outlevel) = (max < 0.0056f) ? -45.f : to_dB(max);
+	acomp->makeup_gain = makeup_gain;
+
+#ifdef LV2_EXTENDED
+	const float old_v_lv1 = acomp->v_lv1;
+	const float old_v_lvl = acomp->v_lvl;
+	const float tot_rel_c = exp(-1000.f/(*(acomp->release) * srate) * n_samples);
+	const float tot_atk_c = exp(-1000.f/(*(acomp->attack) * srate) * n_samples);
+	acomp->v_lv1 = fmaxf (in_peak, tot_rel_c*old_v_lv1 + (1.f-tot_rel_c)*in_peak);
+	acomp->v_lvl = tot_atk_c*old_v_lvl + (1.f-tot_atk_c)*acomp->v_lv1;
+	if (!isfinite_local (acomp->v_lvl)) {
+		acomp->v_lvl = 0.f;
+	}
+	const float v_lvl_in = (acomp->v_lvl < 0.001f) ? -60.f : to_dB(acomp->v_lvl);
+	const float v_lvl_out = (max < 0.001f) ? -60.f : to_dB(max);
+	if (fabsf (acomp->v_lvl_out - v_lvl_out) >= 1 || fabsf (acomp->v_lvl_in - v_lvl_in) >= 1) {
+		// >= 1dB difference
+		acomp->need_expose = true;
+		acomp->v_lvl_in = v_lvl_in;
+		const float relax_coef = exp(-2.0*n_samples/srate);
+		acomp->v_lvl_out = fmaxf (v_lvl_out, relax_coef*acomp->v_lvl_out + (1.f-relax_coef)*v_lvl_out);
+	}
+	if (acomp->need_expose && acomp->queue_draw) {
+		acomp->need_expose = false;
+		acomp->queue_draw->queue_draw (acomp->queue_draw->handle);
+	}
+#endif
+}
+
+/******************************************************************************/
+
+#define MAX_CYCLE 4096
+
+typedef struct {
+	float attack, release, knee, ratio, thresdb, makeup, sidechain;
+} Params;
+
+static const Params params[] = {
+	{  10,   80, 0,  4, -20,  0, 0 },
+	{ 0.1,    1, 8, 20, -40,  6, 0 },
+	{ 100, 2000, 3,  2, -10, 12, 0 },
+	{   5,   50, 1,  8, -30,  0, 1 },
+};
+
+typedef struct {
+	const LV2_Descriptor* desc;
+	LV2_Handle handle;
+	float ctrl[ACOMP_A6 + 1];
+	float out[2][MAX_CYCLE];
+} Instance;
+
+static float
+randf (void)
+{
+	return rand () / (float) RAND_MAX;
+}
+
+static bool
+instance_init (Instance* inst, const LV2_Descriptor* desc, double rate, const Params* p, float lookahead,
+               float const* in0, float const* in1, float const* sc)
+{
+	const LV2_Feature* features[] = { NULL };
+	const bool stereo = desc == &descriptor_stereo;
+
+	inst->desc = desc;
+	inst->handle = desc->instantiate (desc, rate, "", features);
+	if (!inst->handle) {
+		return false;
+	}
+
+	memset (inst->ctrl, 0, sizeof (inst->ctrl));
+	inst->ctrl[ACOMP_ATTACK]    = p->attack;
+	inst->ctrl[ACOMP_RELEASE]   = p->release;
+	inst->ctrl[ACOMP_KNEE]      = p->knee;
+	inst->ctrl[ACOMP_RATIO]     = p->ratio;
+	inst->ctrl[ACOMP_THRESHOLD] = p->thresdb;
+	inst->ctrl[ACOMP_MAKEUP]    = p->makeup;
+	inst->ctrl[ACOMP_SIDECHAIN] = p->sidechain;
+	inst->ctrl[ACOMP_ENABLE]    = 1;
+
+	for (uint32_t i = 0; i < ACOMP_A0; ++i) {
+		desc->connect_port (inst->handle, i, &inst->ctrl[i]);
+	}
+
+	if (stereo) {
+		inst->ctrl[ACOMP_A5] = lookahead;
+		desc->connect_port (inst->handle, ACOMP_A0, (void*) in0);
+		desc->connect_port (inst->handle, ACOMP_A1, (void*) in1);
+		desc->connect_port (inst->handle, ACOMP_A2, (void*) sc);
+		desc->connect_port (inst->handle, ACOMP_A3, inst->out[0]);
+		desc->connect_port (inst->handle, ACOMP_A4, inst->out[1]);
+		desc->connect_port (inst->handle, ACOMP_A5, &inst->ctrl[ACOMP_A5]);
+		desc->connect_port (inst->handle, ACOMP_A6, &inst->ctrl[ACOMP_A6]);
+	} else {
+		inst->ctrl[ACOMP_A3] = lookahead;
+		desc->connect_port (inst->handle, ACOMP_A0, (void*) in0);
+		desc->connect_port (inst->handle, ACOMP_A1, (void*) sc);
+		desc->connect_port (inst->handle, ACOMP_A2, inst->out[0]);
+		desc->connect_port (inst->handle, ACOMP_A3, &inst->ctrl[ACOMP_A3]);
+		desc->connect_port (inst->handle, ACOMP_A4, &inst->ctrl[ACOMP_A4]);
+	}
+
+	desc->activate (inst->handle);
+	return true;
+}
+
+static void
+instance_free (Instance* inst)
+{
+	inst->desc->deactivate (inst->handle);
+	inst->desc->cleanup (inst->handle);
+}
+
+/* noise with a level that changes every 50..250 ms, including silence */
+typedef struct {
+	float    level;
+	uint32_t remain;
+} Envelope;
+
+static float
+envelope_next (Envelope* e, double rate)
+{
+	static const float levels[] = { 0, 0.001, 0.01, 0.05, 0.2, 0.5, 0.9 };
+	if (e->remain == 0) {
+		e->level = levels[rand () % (sizeof (levels) / sizeof (float))];
+		e->remain = rate * (.05 + .2 * randf ());
+	}
+	--e->remain;
+	return e->level * (2.f * randf () - 1.f);
+}
+
+static void
+usage (void)
+{
+	printf ("a-comp_test - compare a-Comp with its reference implementation.\n\n");
+	printf ("Usage: a-comp_test [ OPTIONS ]\n\n");
+	printf ("Options:\n\
+  -e <tolerance>   max difference relative to the makeup gain (default 1e-5)\n\
+  -h               print this message\n\
+  -s <seconds>     duration per test (default 20)\n\n");
+}
+
+static int
+compare (const LV2_Descriptor* desc, double rate, const Params* p, float duration, float tolerance)
+{
+	const bool stereo = desc == &descriptor_stereo;
+	const float makeup = from_dB (p->makeup);
+
+	float in0[MAX_CYCLE];
+	float in1[MAX_CYCLE];
+	float sc[MAX_CYCLE];
+
+	memset (in0, 0, sizeof (in0));
+	memset (in1, 0, sizeof (in1));
+	memset (sc, 0, sizeof (sc));
+
+	Instance ref, cmp;
+	if (!instance_init (&ref, desc, rate, p, 0, in0, in1, sc) || !instance_init (&cmp, desc, rate, p, 0, in0, in1, sc)) {
+		fprintf (stderr, "Cannot instantiate plugin\n");
+		return 1;
+	}
+
+	Envelope e_in = { 0, 0 };
+	Envelope e_sc = { 0, 0 };
+	int64_t t_ref = 0;
+	int64_t t_cmp = 0;
+	float max_diff = 0;
+	float max_gr_diff = 0;
+	size_t done = 0;
+
+	while (done < duration * rate) {
+		uint32_t n_samples;
+		switch (rand () % 4) {
+			case 0:  n_samples = 1 + rand () % 100; break;
+			case 1:  n_samples = 1 + rand () % MAX_CYCLE; break;
+			default: n_samples = 64 << (rand () % 4); break;
+		}
+
+		for (uint32_t i = 0; i < n_samples; ++i) {
+			const float v = envelope_next (&e_in, rate);
+			in0[i] = v;
+			in1[i] = .7f * v + .3f * envelope_next (&e_in, rate);
+			sc[i] = envelope_next (&e_sc, rate);
+		}
+
+		int64_t t0 = usec ();
+		if (stereo) {
+			reference_run_stereo (ref.handle, n_samples);
+		} else {
+			reference_run_mono (ref.handle, n_samples);
+		}
+		int64_t t1 = usec ();
+		desc->run (cmp.handle, n_samples);
+		int64_t t2 = usec ();
+
+		t_ref += t1 - t0;
+		t_cmp += t2 - t1;
+
+		/* wait for the makeup gain to settle */
+		if (done > rate) {
+			for (int c = 0; c < (stereo ? 2 : 1); ++c) {
+				for (uint32_t i = 0; i < n_samples; ++i) {
+					const float d = fabsf (ref.out[c][i] - cmp.out[c][i]) / makeup;
+					if (!(d <= max_diff)) {
+						max_diff = isfinite (d) ? d : INFINITY;
+					}
+				}
+			}
+			const float d = fabsf (ref.ctrl[ACOMP_GAINR] - cmp.ctrl[ACOMP_GAINR]);
+			if (d > max_gr_diff) {
+				max_gr_diff = d;
+			}
+		}
+
+		done += n_samples;
+	}
+
+	printf ("%-24s %6.0f Hz, ratio %4.1f, knee %.0f, sc %.0f: max. difference %.2g, gain-reduction %.2g dB, reference %.1f ms, block-wise %.1f ms (%.2fx)\n",
+			desc->URI, rate, p->ratio, p->knee, p->sidechain, max_diff, max_gr_diff,
+			t_ref / 1e3, t_cmp / 1e3, t_cmp > 0 ? t_ref / (double) t_cmp : 0);
+
+	instance_free (&ref);
+	instance_free (&cmp);
+
+	return (max_diff <= tolerance && max_gr_diff <= 1e-3) ? 0 : 1;
+}
+
+static int
+test_lookahead (const LV2_Descriptor* desc, double rate)
+{
+	const bool stereo = desc == &descriptor_stereo;
+	const Params p = { 10, 80, 0, 1, 0, 0, 0 };
+	const uint32_t n_total = rate;
+	uint32_t latency = 0;
+
+	float* in = (float*) malloc ((n_total + MAX_CYCLE) * sizeof (float));
+	float in1[MAX_CYCLE];
+	float sc[MAX_CYCLE];
+	for (uint32_t i = 0; i < n_total + MAX_CYCLE; ++i) {
+		in[i] = randf () - .5f;
+	}
+	memset (in1, 0, sizeof (in1));
+	memset (sc, 0, sizeof (sc));
+
+	Instance inst;
+	if (!instance_init (&inst, desc, rate, &p, 5, in, in1, sc)) {
+		fprintf (stderr, "Cannot instantiate plugin\n");
+		return 1;
+	}
+
+	int rv = 0;
+	uint32_t done = 0;
+	while (done < n_total && !rv) {
+		const uint32_t n_samples = 1 + rand () % 1024;
+
+		desc->connect_port (inst.handle, ACOMP_A0, &in[done]);
+		memcpy (in1, &in[done], n_samples * sizeof (float));
+		desc->run (inst.handle, n_samples);
+
+		const float reported = inst.ctrl[stereo ? ACOMP_A6 : ACOMP_A4];
+		if (done == 0) {
+			latency = reported;
+		}
+		if (reported != latency || fabs (latency - 5 * rate / 1000) > 1) {
+			printf ("%s: reported latency %.0f, expected %.1f\n", desc->URI, reported, 5 * rate / 1000);
+			rv = 1;
+		}
+		for (int c = 0; c < (stereo ? 2 : 1) && !rv; ++c) {
+			for (uint32_t i = 0; i < n_samples; ++i) {
+				const float expected = done + i < latency ? 0 : in[done + i - latency];
+				if (inst.out[c][i] != expected) {
+					printf ("%s: look-ahead output differs at sample %u\n", desc->URI, done + i);
+					rv = 1;
+					break;
+				}
+			}
+		}
+		done += n_samples;
+	}
+
+	if (!rv) {
+		printf ("%-24s %6.0f Hz, look-ahead: output delayed by the reported latency of %u samples\n", desc->URI, rate, latency);
+	}
+
+	instance_free (&inst);
+	free (in);
+	return rv;
+}
+
+int
+main (int argc, char** argv)
+{
+	const double rates[] = { 44100, 48000, 96000 };
+	const LV2_Descriptor* descs[] = { &descriptor_mono, &descriptor_stereo };
+	float tolerance = 1e-5;
+	float duration = 20;
+	int rv = 0;
+
+	int c;
+	while ((c = getopt (argc, argv, "e:hs:")) != -1) {
+		switch (c) {
+			case 'e': tolerance = atof (optarg); break;
+			case 's': duration = atof (optarg); break;
+			case 'h':
+				usage ();
+				return 0;
+			default:
+				usage ();
+				return 1;
+		}
+	}
+
+	srand (1);
+
+	for (int d = 0; d < 2; ++d) {
+		for (size_t r = 0; r < sizeof (rates) / sizeof (double); ++r) {
+			for (size_t p = 0; p < sizeof (params) / sizeof (Params); ++p) {
+				rv |= compare (descs[d], rates[r], &params[p], duration, tolerance);
+			}
+			rv |= test_lookahead (descs[d], rates[r]);
+		}
+	}
+
+	if (rv) {
+		printf ("FAILED\n");
+	}
+	return rv;
+}
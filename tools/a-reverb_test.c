@@ -0,0 +1,279 @@
+/* gcc -O3 -ffast-math -std=gnu99 -o a-reverb_test tools/a-reverb_test.c `pkg-config --cflags lv2` -lm */
+
+/* Regression test for a-Reverb.
+ *
+ * The plugin's block-wise reverb () is compared against the previous
+ * sample-by-sample implementation (copied verbatim below) on noise, impulses
+ * and invalid input, with random cycle sizes and changing room-size and mix,
+ * at various sample-rates. The time spent in each implementation is reported.
+ *
+ * Returns 0 if the max. difference of all outputs is within the tolerance.
+ */
+
+#include <getopt.h>
+#include <time.h>
+
+#include "../libs/plugins/a-reverb.lv2/a-reverb.c"
+
+static int64_t
+usec (void)
+{
+	struct timespec ts;
+	clock_gettime (CLOCK_MONOTONIC, &ts);
+	return (int64_t) ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+/* reference implementation, per sample */
+
+static void
+reference_reverb (b_reverb* r,
+                  const float* inbuf0,
+                  const float* inbuf1,
+                  float* outbuf0,
+                  float* outbuf1,
+                  size_t n_samples)
+{
+	float** const idxp0 = r->idxp[0];
+	float** const idxp1 = r->idxp[1];
+	float* const* const endp0 = r->endp[0];
+	float* const* const endp1 = r->endp[1];
+	float* const* const idx00 = r->idx0[0];
+	float* const* const idx01 = r->idx0[1];
+	const float* const gain = r->gain;
+	const float inputGain = r->inputGain;
+	const float fbk = r->fbk;
+	const float wet = r->wet;
+	const float dry = r->dry;
+
+	const float* xp0 = inbuf0;
+	const float* xp1 = inbuf1;
+	float* yp0 = outbuf0;
+	float* yp1 = outbuf1;
+
+	float y_1_0 = r->y_1_0;
+	float yy1_0 = r->yy1_0;
+	float y_1_1 = r->y_1_1;
+	float yy1_1 = r->yy1_1;
+
+	for (size_t i = 0; i < n_samples; ++i) {
+		int j;
+		float y;
+		float xo0 = *xp0++;
+		float xo1 = *xp1++;
+		if (!isfinite_local(xo0) || fabsf (xo0) > 10.f) { xo0 = 0; }
+		if (!isfinite_local(xo1) || fabsf (xo1) > 10.f) { xo1 = 0; }
+		xo0 += DENORMAL_PROTECT;
+		xo1 += DENORMAL_PROTECT;
+		const float x0 = y_1_0 + (inputGain * xo0);
+		const float x1 = y_1_1 + (inputGain * xo1);
+
+		float xa = 0.0;
+		float xb = 0.0;
+		/* First we do four feedback comb filters (ie parallel delay lines,
+		 * each with a single tap at the end that feeds back at the start) */
+
+		for (j = 0; j < 4; ++j) {
+			y = *idxp0[j];
+			*idxp0[j] = x0 + (gain[j] * y);
+			if (endp0[j] <= ++(idxp0[j])) {
+				idxp0[j] = idx00[j];
+			}
+			xa += y;
+		}
+		for (; j < 7; ++j) {
+			y = *idxp0[j];
+			*idxp0[j] = gain[j] * (xa + y);
+			if (endp0[j] <= ++(idxp0[j])) {
+				idxp0[j] = idx00[j];
+			}
+			xa = y - xa;
+		}
+
+		y = 0.5f * (xa + yy1_0);
+		yy1_0 = y;
+		y_1_0 = fbk * xa;
+
+		*yp0++ = ((wet * y) + (dry * xo0));
+
+		for (j = 0; j < 4; ++j) {
+			y = *idxp1[j];
+			*idxp1[j] = x1 + (gain[j] * y);
+			if (endp1[j] <= ++(idxp1[j])) {
+				idxp1[j] = idx01[j];
+			}
+			xb += y;
+		}
+		for (; j < 7; ++j) {
+			y = *idxp1[j];
+			*idxp1[j] = gain[j] * (xb + y);
+			if (endp1[j] <= ++(idxp1[j])) {
+				idxp1[j] = idx01[j];
+			}
+			xb = y - xb;
+		}
+
+		y = 0.5f * (xb + yy1_1);
+		yy1_1 = y;
+		y_1_1 = fbk * xb;
+
+		*yp1++ = ((wet * y) + (dry * xo1));
+	}
+
+	if (!isfinite_local(y_1_0)) { y_1_0 = 0; }
+	if (!isfinite_local(yy1_1)) { yy1_0 = 0; }
+	if (!isfinite_local(y_1_1)) { y_1_1 = 0; }
+	if (!isfinite_local(yy1_1)) { yy1_1 = 0; }
+
+	r->y_1_0 = y_1_0 + DENORMAL_PROTECT;
+	r->yy1_0 = yy1_0 + DENORMAL_PROTECT;
+	r->y_1_1 = y_1_1 + DENORMAL_PROTECT;
+	r->yy1_1 = yy1_1 + DENORMAL_PROTECT;
+}
+
+static void
+set_room (b_reverb* r, float roomsz, float mix)
+{
+	r->gain[0] = 0.773 * roomsz;
+	r->gain[1] = 0.802 * roomsz;
+	r->gain[2] = 0.753 * roomsz;
+	r->gain[3] = 0.733 * roomsz;
+	r->wet = mix;
+	r->dry = 1.0 - mix;
+}
+
+static float
+randf (void)
+{
+	return rand () / (float) RAND_MAX;
+}
+
+static void
+usage (void)
+{
+	printf ("a-reverb_test - compare a-Reverb with its reference implementation.\n\n");
+	printf ("Usage: a-reverb_test [ OPTIONS ]\n\n");
+	printf ("Options:\n\
+  -e <tolerance>   max absolute difference (default 1e-6)\n\
+  -h               print this message\n\
+  -s <seconds>     duration per sample-rate (default 30)\n\n");
+}
+
+int
+main (int argc, char** argv)
+{
+	const double rates[] = { 8000, 22050, 44100, 48000, 96000, 192000 };
+	float tolerance = 1e-6;
+	float duration = 30;
+	int rv = 0;
+
+	int c;
+	while ((c = getopt (argc, argv, "e:hs:")) != -1) {
+		switch (c) {
+			case 'e': tolerance = atof (optarg); break;
+			case 's': duration = atof (optarg); break;
+			case 'h':
+				usage ();
+				return 0;
+			default:
+				usage ();
+				return 1;
+		}
+	}
+
+	float* in0  = (float*) malloc (8192 * sizeof (float));
+	float* in1  = (float*) malloc (8192 * sizeof (float));
+	float* ref0 = (float*) malloc (8192 * sizeof (float));
+	float* ref1 = (float*) malloc (8192 * sizeof (float));
+	float* out0 = (float*) malloc (8192 * sizeof (float));
+	float* out1 = (float*) malloc (8192 * sizeof (float));
+
+	for (size_t r = 0; r < sizeof (rates) / sizeof (double); ++r) {
+		b_reverb ref;
+		b_reverb rvb;
+
+		srand (r + 1);
+
+		if (initReverb (&ref, rates[r]) || initReverb (&rvb, rates[r])) {
+			fprintf (stderr, "Cannot allocate reverb\n");
+			return 1;
+		}
+
+		int64_t t_ref = 0;
+		int64_t t_new = 0;
+		float   max_diff = 0;
+		size_t  done = 0;
+
+		while (done < duration * rates[r]) {
+			/* mostly typical period sizes, sometimes odd or very large ones */
+			uint32_t n_samples;
+			switch (rand () % 4) {
+				case 0:  n_samples = 1 + rand () % 100; break;
+				case 1:  n_samples = 1 + rand () % 8192; break;
+				default: n_samples = 64 << (rand () % 5); break;
+			}
+
+			if (rand () % 8 == 0) {
+				const float roomsz = randf ();
+				const float mix = randf ();
+				set_room (&ref, roomsz, mix);
+				set_room (&rvb, roomsz, mix);
+			}
+
+			for (uint32_t i = 0; i < n_samples; ++i) {
+				in0[i] = randf () - .5f;
+				in1[i] = rand () % 1000 == 0 ? 1.f : 0.f;
+			}
+			if (rand () % 50 == 0) {
+				in0[rand () % n_samples] = NAN;
+				in1[rand () % n_samples] = 20.f;
+			}
+
+			int64_t t0 = usec ();
+			reference_reverb (&ref, in0, in1, ref0, ref1, n_samples);
+			int64_t t1 = usec ();
+			reverb (&rvb, in0, in1, out0, out1, n_samples);
+			int64_t t2 = usec ();
+
+			t_ref += t1 - t0;
+			t_new += t2 - t1;
+
+			for (uint32_t i = 0; i < n_samples; ++i) {
+				const float d0 = fabsf (ref0[i] - out0[i]);
+				const float d1 = fabsf (ref1[i] - out1[i]);
+				if (!isfinite (d0) || !isfinite (d1)) {
+					max_diff = INFINITY;
+				}
+				if (d0 > max_diff) { max_diff = d0; }
+				if (d1 > max_diff) { max_diff = d1; }
+			}
+			done += n_samples;
+		}
+
+		printf ("%6.0f Hz: block %2u, max. difference %g, reference %.1f ms, block-wise %.1f ms (%.2fx)\n",
+				rates[r], rvb.block, max_diff, t_ref / 1e3, t_new / 1e3,
+				t_new > 0 ? t_ref / (double) t_new : 0);
+
+		if (!(max_diff <= tolerance)) {
+			rv = 1;
+		}
+
+		for (int i = 0; i < RV_NZ; ++i) {
+			free (ref.delays[0][i]);
+			free (ref.delays[1][i]);
+			free (rvb.delays[0][i]);
+			free (rvb.delays[1][i]);
+		}
+	}
+
+	free (in0);
+	free (in1);
+	free (ref0);
+	free (ref1);
+	free (out0);
+	free (out1);
+
+	if (rv) {
+		printf ("FAILED: difference exceeds %g\n", tolerance);
+	}
+	return rv;
+}
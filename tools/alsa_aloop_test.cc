@@ -0,0 +1,256 @@
+/* g++ -O2 -o alsa_aloop_test -DPACKAGE=\"alsa-backend\" -I libs/backends/alsa -I libs/pbd -I libs/ardour -I libs/temporal -I libs/zita-resampler -I build/libs/pbd -I build/libs/ardour tools/alsa_aloop_test.cc libs/backends/alsa/alsa_slave.cc libs/backends/alsa/zita-alsa-pcmi.cc -L build/libs/pbd -L build/libs/zita-resampler -lpbd -lzita-resampler `pkg-config --cflags --libs glibmm-2.4 sigc++-2.0 alsa` */
+
+/* Test drift compensation of the ALSA backend's additional devices
+ * (AlsaAudioSlave) without audio hardware, using the snd-aloop kernel module.
+ *
+ * Setup:
+ *   sudo modprobe snd-aloop pcm_substreams=2
+ *
+ * Substream 0 of the loopback card acts as master device, substream 1
+ * is used as additional (slave) device. Audio written to hw:Loopback,0,N
+ * is captured from hw:Loopback,1,N, so the slave's playback is looped back
+ * to its own capture. A sine is sent to the slave and checked for
+ * discontinuities after it was resampled twice.
+ *
+ * The check is suspended for a settle time (the round-trip latency) after
+ * the start, and after every drain, underflow, overflow or resync of the
+ * slave: these insert or drop samples on purpose. They are reported
+ * separately and do not fail the test.
+ *
+ * To simulate clock drift, change the rate of the slave's substream
+ * while the test is running, e.g. +100 ppm:
+ *   amixer -c Loopback cset numid=$(amixer -c Loopback controls | grep "PCM Rate Shift.*subdevice=1" | head -1 | sed 's/numid=\([0-9]*\).*/\1/') 100010
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <getopt.h>
+#include <signal.h>
+
+#include <glib.h>
+
+#include "pbd/pbd.h"
+#include "alsa_slave.h"
+
+using namespace ARDOUR;
+
+static volatile bool run = true;
+
+static void
+sig_int (int)
+{
+	run = false;
+}
+
+class TestSlave : public AlsaAudioSlave
+{
+public:
+	TestSlave (const char* play, const char* capt, unsigned int mrate, unsigned int mspp, unsigned int srate, unsigned int sspp)
+		: AlsaAudioSlave (play, capt, mrate, mspp, srate, sspp, 2)
+	{}
+
+protected:
+	void update_latencies (uint32_t play, uint32_t capt)
+	{
+		printf ("# latency update: play %u capt %u\n", play, capt);
+	}
+};
+
+static void
+usage ()
+{
+	fprintf (stderr, "alsa_aloop_test [ -c CARD ] [ -r MASTER-RATE ] [ -p MASTER-PERIOD ] [ -R SLAVE-RATE ] [ -P SLAVE-PERIOD ] [ -d SECONDS ]\n");
+}
+
+int
+main (int argc, char** argv)
+{
+	const char* card = "Loopback";
+	unsigned int rate = 48000;
+	unsigned int spp = 256;
+	unsigned int slave_rate = 48000;
+	unsigned int slave_spp = 256;
+	int duration = 60;
+	int c;
+
+	while ((c = getopt (argc, argv, "c:r:p:R:P:d:h")) != -1) {
+		switch (c) {
+			case 'c': card = optarg; break;
+			case 'r': rate = atoi (optarg); break;
+			case 'p': spp = atoi (optarg); break;
+			case 'R': slave_rate = atoi (optarg); break;
+			case 'P': slave_spp = atoi (optarg); break;
+			case 'd': duration = atoi (optarg); break;
+			default: usage (); return 0;
+		}
+	}
+
+	if (!PBD::init ()) {
+		fprintf (stderr, "Cannot initialize libpbd\n");
+		return 1;
+	}
+
+	char mplay[64], mcapt[64], splay[64], scapt[64];
+	snprintf (mplay, sizeof (mplay), "hw:%s,0,0", card);
+	snprintf (mcapt, sizeof (mcapt), "hw:%s,1,0", card);
+	snprintf (splay, sizeof (splay), "hw:%s,0,1", card);
+	snprintf (scapt, sizeof (scapt), "hw:%s,1,1", card);
+
+	/* master device, provides the clock */
+	Alsa_pcmi master (mplay, mcapt, 0, rate, spp, 2, 2);
+	if (master.state ()) {
+		fprintf (stderr, "Cannot open master device %s/%s (error %d). Is snd-aloop loaded?\n", mplay, mcapt, master.state ());
+		return 1;
+	}
+
+	TestSlave slave (splay, scapt, rate, spp, slave_rate, slave_spp);
+	if (slave.state ()) {
+		fprintf (stderr, "Cannot open slave device %s/%s (error %d)\n", splay, scapt, slave.state ());
+		return 1;
+	}
+
+	const uint32_t n_play = slave.nplay ();
+	const uint32_t n_capt = slave.ncapt ();
+	float** play = (float**) malloc (n_play * sizeof (float*));
+	float** capt = (float**) malloc (n_capt * sizeof (float*));
+	for (uint32_t i = 0; i < n_play; ++i) {
+		play[i] = (float*) calloc (spp, sizeof (float));
+	}
+	for (uint32_t i = 0; i < n_capt; ++i) {
+		capt[i] = (float*) calloc (spp, sizeof (float));
+	}
+	float* silence = (float*) calloc (spp, sizeof (float));
+
+	if (!slave.start ()) {
+		fprintf (stderr, "Cannot start slave\n");
+		return 1;
+	}
+
+	signal (SIGINT, sig_int);
+
+	/* master DLL, same as AlsaAudioBackend::main_process_thread */
+	double dll_dt = 1e6 * spp / (double) rate;
+	const double dll_w1 = 2 * M_PI * 0.1 * spp / (double) rate;
+	const double dll_w2 = dll_w1 * dll_w1;
+	const double sr_norm = 1e-6 * (double) rate / (double) spp;
+	double t0 = 0, t1 = 0;
+	bool reset_dll = true;
+	bool drain = true;
+
+	/* test signal, and discontinuity detection: a sine satisfies
+	 * x[n] = 2 cos (w) x[n-1] - x[n-2] */
+	const double w = 2 * M_PI * 997 / rate;
+	const float k = 2 * cos (w);
+	double phase = 0;
+	float x1 = 0, x2 = 0;
+	uint64_t n_samples = 0;
+	uint64_t n_glitches = 0;
+	uint64_t n_glitches_total = 0;
+	uint64_t n_cycles = 0;
+
+	/* samples to skip before checking for discontinuities */
+	const uint64_t settle_len = rate / 2;
+	uint64_t settle = settle_len;
+	uint32_t n_events = 0;
+	AlsaAudioSlave::Stats st;
+
+	master.pcm_start ();
+
+	while (run && n_samples < (uint64_t) duration * rate) {
+		long nr = master.pcm_wait ();
+		if (master.state () < 0) {
+			fprintf (stderr, "Master I/O error\n");
+			break;
+		}
+		if (master.state () > 0) {
+			printf ("# master x-run\n");
+			reset_dll = true;
+		}
+
+		const int64_t clock0 = g_get_monotonic_time ();
+		if (reset_dll) {
+			reset_dll = false;
+			drain = true;
+			dll_dt = 1e6 * spp / (double) rate;
+			t0 = clock0;
+			t1 = clock0 + dll_dt;
+		} else {
+			const double er = clock0 - t1;
+			t0 = t1;
+			t1 = t1 + dll_w1 * er + dll_dt;
+			dll_dt += dll_w2 * er;
+		}
+
+		while (nr >= (long) spp) {
+			slave.cycle_start (t0, (t1 - t0) * sr_norm, drain);
+			if (drain) {
+				settle = settle_len;
+			}
+			drain = false;
+
+			/* master device I/O, discard */
+			master.capt_init (spp);
+			master.capt_done (spp);
+			master.play_init (spp);
+			for (uint32_t i = 0; i < master.nplay (); ++i) {
+				master.play_chan (i, silence, spp);
+			}
+			master.play_done (spp);
+
+			slave.capt_all (capt, n_capt, spp);
+
+			slave.stats (st);
+			if (st.underflows + st.overflows + st.resyncs != n_events) {
+				n_events = st.underflows + st.overflows + st.resyncs;
+				settle = settle_len;
+			}
+
+			for (uint32_t s = 0; s < spp; ++s) {
+				const float x = capt[0][s];
+				if (settle > 0) {
+					--settle;
+				} else if (fabsf (x) > 1e-4 || fabsf (x1) > 1e-4) {
+					if (fabsf (x - (k * x1 - x2)) > 1e-2) {
+						++n_glitches;
+					}
+				}
+				x2 = x1;
+				x1 = x;
+			}
+
+			for (uint32_t s = 0; s < spp; ++s) {
+				play[0][s] = 0.5 * sin (phase);
+				phase += w;
+			}
+			phase = fmod (phase, 2 * M_PI);
+			for (uint32_t i = 1; i < n_play; ++i) {
+				memcpy (play[i], play[0], spp * sizeof (float));
+			}
+			slave.play_all (play, n_play, spp);
+
+			slave.cycle_end ();
+
+			nr -= spp;
+			n_samples += spp;
+
+			if (++n_cycles % (rate / spp) == 0) {
+				printf ("%5.1fs ratio %.6f drift %+7.1f ppm lat %u/%u load %4.1f%% src %4.1f%% xrun %u under %u over %u sync %u glitch %" G_GUINT64_FORMAT "\n",
+						n_samples / (double) rate, st.ratio, st.drift_ppm, st.capt_latency, st.play_latency,
+						100.f * st.dsp_load, 100.f * st.src_load,
+						st.xruns, st.underflows, st.overflows, st.resyncs, n_glitches);
+				n_glitches_total += n_glitches;
+				n_glitches = 0;
+			}
+		}
+	}
+
+	master.pcm_stop ();
+	slave.stop ();
+
+	slave.stats (st);
+	printf ("Slave: %u x-runs, %u underflows, %u overflows, %u resyncs\n", st.xruns, st.underflows, st.overflows, st.resyncs);
+	printf ("Total discontinuities: %" G_GUINT64_FORMAT "\n", n_glitches_total + n_glitches);
+	return (n_glitches_total + n_glitches) > 0 ? 1 : 0;
+}
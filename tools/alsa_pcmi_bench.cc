@@ -0,0 +1,355 @@
+/* g++ -O3 -I libs/backends/alsa -o alsa_pcmi_bench tools/alsa_pcmi_bench.cc libs/backends/alsa/zita-alsa-pcmi.cc -lasound */
+
+/* Benchmark and verify the sample format conversion of Alsa_pcmi.
+ *
+ * No sound-card is used: the mmap areas are emulated in memory, for
+ * both interleaved and non-interleaved access. Results of
+ * Alsa_pcmi::play_all () and capt_all () are compared bit-by-bit against
+ * a plain per-sample reference implementation (identical to the original
+ * scalar code), and the time per process cycle is reported.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <getopt.h>
+#include <time.h>
+
+#include <algorithm>
+
+#include "zita-alsa-pcmi.h"
+
+static int64_t
+usec ()
+{
+	struct timespec ts;
+	clock_gettime (CLOCK_MONOTONIC, &ts);
+	return (int64_t) ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+/* reference implementation, per sample */
+
+static int
+ref_play_int (float s, int max)
+{
+	if (s > 1) return max;
+	if (s < -1) return -max;
+	return (int)((float) max * s);
+}
+
+static void
+ref_play (snd_pcm_format_t fmt, const float* src, char* dst, int nfrm, int step)
+{
+	for (int i = 0; i < nfrm; ++i, dst += step) {
+		switch (fmt) {
+			case SND_PCM_FORMAT_FLOAT_LE:
+				memcpy (dst, &src[i], 4);
+				break;
+			case SND_PCM_FORMAT_S32_LE:
+				{
+					const int d = ref_play_int (src[i], 0x007fffff) << 8;
+					memcpy (dst, &d, 4);
+				}
+				break;
+			case SND_PCM_FORMAT_S24_3LE:
+				{
+					const int d = ref_play_int (src[i], 0x007fffff);
+					dst[0] = d;
+					dst[1] = d >> 8;
+					dst[2] = d >> 16;
+				}
+				break;
+			case SND_PCM_FORMAT_S16_LE:
+				{
+					const short int d = ref_play_int (src[i], 0x7fff);
+					memcpy (dst, &d, 2);
+				}
+				break;
+			default:
+				break;
+		}
+	}
+}
+
+static void
+ref_capt (snd_pcm_format_t fmt, const char* src, float* dst, int nfrm, int step)
+{
+	for (int i = 0; i < nfrm; ++i, src += step) {
+		switch (fmt) {
+			case SND_PCM_FORMAT_FLOAT_LE:
+				memcpy (&dst[i], src, 4);
+				break;
+			case SND_PCM_FORMAT_S32_LE:
+				{
+					int s;
+					memcpy (&s, src, 4);
+					dst[i] = (float) s / (float) 0x7fffff00;
+				}
+				break;
+			case SND_PCM_FORMAT_S24_3LE:
+				{
+					int s = (src[0] & 0xFF) + ((src[1] & 0xFF) << 8) + ((src[2] & 0xFF) << 16);
+					if (s & 0x00800000) s -= 0x01000000;
+					dst[i] = (float) s / (float) 0x007fffff;
+				}
+				break;
+			case SND_PCM_FORMAT_S16_LE:
+				{
+					short int s;
+					memcpy (&s, src, 2);
+					dst[i] = (float) s / (float) 0x7fff;
+				}
+				break;
+			default:
+				break;
+		}
+	}
+}
+
+class Alsa_pcmi_bench
+{
+public:
+	Alsa_pcmi_bench (unsigned int nchan, unsigned int nfrm)
+		: _pcmi (0, 0, 0, 48000, nfrm, 2, 2)
+		, _nchan (nchan)
+		, _nfrm (nfrm)
+	{
+		_src = (float**) malloc (nchan * sizeof (float*));
+		_dst = (float**) malloc (nchan * sizeof (float*));
+		_ref = (float**) malloc (nchan * sizeof (float*));
+		for (unsigned int c = 0; c < nchan; ++c) {
+			_src[c] = (float*) malloc (nfrm * sizeof (float));
+			_dst[c] = (float*) malloc (nfrm * sizeof (float));
+			_ref[c] = (float*) malloc (nfrm * sizeof (float));
+			for (unsigned int i = 0; i < nfrm; ++i) {
+				_src[c][i] = 2.4f * (rand () / (float) RAND_MAX) - 1.2f;
+			}
+		}
+		_area = (char*) malloc (nchan * nfrm * 4);
+		_area_ref = (char*) malloc (nchan * nfrm * 4);
+	}
+
+	~Alsa_pcmi_bench ()
+	{
+		for (unsigned int c = 0; c < _nchan; ++c) {
+			free (_src[c]);
+			free (_dst[c]);
+			free (_ref[c]);
+		}
+		free (_src);
+		free (_dst);
+		free (_ref);
+		free (_area);
+		free (_area_ref);
+	}
+
+	bool run (snd_pcm_format_t fmt, bool interleaved, int n_cycles);
+
+private:
+	void set_format (snd_pcm_format_t);
+	void set_pointers (bool interleaved);
+
+	Alsa_pcmi    _pcmi;
+	unsigned int _nchan;
+	unsigned int _nfrm;
+	int          _bytes;
+	float**      _src;
+	float**      _dst;
+	float**      _ref;
+	char*        _area;
+	char*        _area_ref;
+};
+
+void
+Alsa_pcmi_bench::set_format (snd_pcm_format_t fmt)
+{
+	Alsa_pcmi& p (_pcmi);
+
+	p._play_format = p._capt_format = fmt;
+	p._play_nchan  = p._capt_nchan  = _nchan;
+	p._play_block  = 0;
+	p._capt_block  = 0;
+
+	switch (fmt) {
+		case SND_PCM_FORMAT_FLOAT_LE:
+			_bytes = 4;
+			p._clear_func = &Alsa_pcmi::clear_32;
+			p._play_func  = &Alsa_pcmi::play_float;
+			p._capt_func  = &Alsa_pcmi::capt_float;
+#ifdef __SSE2__
+			p._play_block = &Alsa_pcmi::play_block_float;
+			p._capt_block = &Alsa_pcmi::capt_block_float;
+#endif
+			break;
+		case SND_PCM_FORMAT_S32_LE:
+			_bytes = 4;
+			p._clear_func = &Alsa_pcmi::clear_32;
+			p._play_func  = &Alsa_pcmi::play_32;
+			p._capt_func  = &Alsa_pcmi::capt_32;
+#ifdef __SSE2__
+			p._play_block = &Alsa_pcmi::play_block_32;
+			p._capt_block = &Alsa_pcmi::capt_block_32;
+#endif
+			break;
+		case SND_PCM_FORMAT_S24_3LE:
+			_bytes = 3;
+			p._clear_func = &Alsa_pcmi::clear_24;
+			p._play_func  = &Alsa_pcmi::play_24;
+			p._capt_func  = &Alsa_pcmi::capt_24;
+#ifdef __SSE2__
+			p._play_block = &Alsa_pcmi::play_block_24;
+			p._capt_block = &Alsa_pcmi::capt_block_24;
+#endif
+			break;
+		case SND_PCM_FORMAT_S16_LE:
+		default:
+			_bytes = 2;
+			p._clear_func = &Alsa_pcmi::clear_16;
+			p._play_func  = &Alsa_pcmi::play_16;
+			p._capt_func  = &Alsa_pcmi::capt_16;
+#ifdef __SSE2__
+			p._play_block = &Alsa_pcmi::play_block_16;
+			p._capt_block = &Alsa_pcmi::capt_block_16;
+#endif
+			break;
+	}
+	p._play_bytes = p._capt_bytes = _bytes;
+}
+
+/* emulate play_init () / capt_init () */
+void
+Alsa_pcmi_bench::set_pointers (bool interleaved)
+{
+	Alsa_pcmi& p (_pcmi);
+
+	p._play_step = p._capt_step = interleaved ? _nchan * _bytes : _bytes;
+	for (unsigned int c = 0; c < _nchan; ++c) {
+		const size_t offset = interleaved ? c * _bytes : c * _nfrm * _bytes;
+		p._play_ptr[c] = _area + offset;
+		p._capt_ptr[c] = _area + offset;
+	}
+}
+
+bool
+Alsa_pcmi_bench::run (snd_pcm_format_t fmt, bool interleaved, int n_cycles)
+{
+	set_format (fmt);
+
+	const int step = interleaved ? _nchan * _bytes : _bytes;
+	const size_t area_size = _nchan * _nfrm * _bytes;
+	bool ok = true;
+
+	/* verify playback */
+	for (unsigned int c = 0; c < _nchan; ++c) {
+		const size_t offset = interleaved ? c * _bytes : c * _nfrm * _bytes;
+		ref_play (fmt, _src[c], _area_ref + offset, _nfrm, step);
+	}
+	memset (_area, 0, area_size);
+	set_pointers (interleaved);
+	_pcmi.play_all (_src, _nfrm);
+	if (memcmp (_area, _area_ref, area_size)) {
+		ok = false;
+	}
+
+	/* verify capture, using the data written above as input */
+	for (unsigned int c = 0; c < _nchan; ++c) {
+		const size_t offset = interleaved ? c * _bytes : c * _nfrm * _bytes;
+		ref_capt (fmt, _area + offset, _ref[c], _nfrm, step);
+	}
+	set_pointers (interleaved);
+	_pcmi.capt_all (_dst, _nfrm);
+	for (unsigned int c = 0; c < _nchan; ++c) {
+		if (memcmp (_dst[c], _ref[c], _nfrm * sizeof (float))) {
+			ok = false;
+		}
+	}
+
+	/* timing */
+	int64_t t0 = usec ();
+	for (int n = 0; n < n_cycles; ++n) {
+		for (unsigned int c = 0; c < _nchan; ++c) {
+			const size_t offset = interleaved ? c * _bytes : c * _nfrm * _bytes;
+			ref_play (fmt, _src[c], _area + offset, _nfrm, step);
+		}
+	}
+	int64_t t1 = usec ();
+	for (int n = 0; n < n_cycles; ++n) {
+		set_pointers (interleaved);
+		_pcmi.play_all (_src, _nfrm);
+	}
+	int64_t t2 = usec ();
+	for (int n = 0; n < n_cycles; ++n) {
+		for (unsigned int c = 0; c < _nchan; ++c) {
+			const size_t offset = interleaved ? c * _bytes : c * _nfrm * _bytes;
+			ref_capt (fmt, _area + offset, _ref[c], _nfrm, step);
+		}
+	}
+	int64_t t3 = usec ();
+	for (int n = 0; n < n_cycles; ++n) {
+		set_pointers (interleaved);
+		_pcmi.capt_all (_dst, _nfrm);
+	}
+	int64_t t4 = usec ();
+
+	printf ("%-10s %-14s  play: %7.3f -> %7.3f usec (%4.1fx)   capt: %7.3f -> %7.3f usec (%4.1fx)  %s\n",
+			snd_pcm_format_name (fmt), interleaved ? "interleaved" : "non-interleaved",
+			(t1 - t0) / (double) n_cycles, (t2 - t1) / (double) n_cycles, (t1 - t0) / (double) std::max<int64_t> (1, t2 - t1),
+			(t3 - t2) / (double) n_cycles, (t4 - t3) / (double) n_cycles, (t3 - t2) / (double) std::max<int64_t> (1, t4 - t3),
+			ok ? "OK" : "MISMATCH");
+
+	return ok;
+}
+
+static void
+usage ()
+{
+	fprintf (stderr, "alsa_pcmi_bench [ -c CHANNELS ] [ -p PERIOD ] [ -n CYCLES ]\n");
+}
+
+int
+main (int argc, char** argv)
+{
+	int nchan = 64;
+	int period = 32;
+	int n_cycles = 100000;
+	int c;
+
+	while ((c = getopt (argc, argv, "c:p:n:h")) != -1) {
+		switch (c) {
+			case 'c':
+				nchan = atoi (optarg);
+				break;
+			case 'p':
+				period = atoi (optarg);
+				break;
+			case 'n':
+				n_cycles = atoi (optarg);
+				break;
+			default:
+				usage ();
+				return 0;
+		}
+	}
+
+	if (nchan < 1 || nchan > 128 || period < 1 || n_cycles < 1) {
+		usage ();
+		return 1;
+	}
+
+	printf ("%d channels, %d samples per period, %d cycles. Time per cycle, reference -> Alsa_pcmi\n", nchan, period, n_cycles);
+
+	const snd_pcm_format_t formats[] = {
+		SND_PCM_FORMAT_FLOAT_LE, SND_PCM_FORMAT_S32_LE, SND_PCM_FORMAT_S24_3LE, SND_PCM_FORMAT_S16_LE
+	};
+
+	Alsa_pcmi_bench bench (nchan, period);
+	bool ok = true;
+
+	for (int i = 0; i < 4; ++i) {
+		ok &= bench.run (formats[i], true, n_cycles);
+		ok &= bench.run (formats[i], false, n_cycles);
+	}
+
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,370 @@
+/* g++ -O3 -ffast-math -I libs/ardour -I libs/pbd -I libs/evoral -I libs/temporal -I build/libs/ardour `pkg-config --cflags --libs glibmm-2.4 samplerate` -o interpolation_bench tools/interpolation_bench.cc libs/ardour/interpolation.cc */
+
+/* Compare the varispeed interpolators: quality and CPU usage.
+ *
+ * Sine tones are resampled the way the DiskReader does it: one call per
+ * cycle, the input is advanced by distance () and the output is of fixed
+ * size. For every interpolator and speed, the following is reported:
+ *
+ *  - THD+N of a tone in the pass-band: the output is fitted to a sine of the
+ *    expected frequency, the residual (noise, distortion, images and
+ *    glitches at cycle boundaries) is given relative to the fitted tone.
+ *    Like the session's transport, distance () moves floor (speed * n) per
+ *    cycle, so the expected frequency is that of the effective speed.
+ *    CubicInterpolation restarts at phase 0 every cycle, which shows up as
+ *    a glitch at cycle boundaries at most speeds.
+ *  - for speeds > 1.1: the level of a tone that is moved beyond Nyquist by
+ *    the speed change, i.e. what aliases back into the audible range.
+ *  - CPU time per output sample (and CPU cycles on x86).
+ *
+ * In addition, SincInterpolation is checked at several cycle sizes to
+ * produce identical output when the input of a cycle is passed in two
+ * parts, as happens when the read-vector of the playback ringbuffer wraps,
+ * and to not slip against distance () (which results in a click).
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <stdint.h>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <vector>
+
+#include <getopt.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAVE_RDTSC
+#endif
+
+#include "ardour/interpolation.h"
+
+using namespace ARDOUR;
+
+static int64_t
+usec (void)
+{
+	struct timespec ts;
+	clock_gettime (CLOCK_MONOTONIC, &ts);
+	return (int64_t) ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static uint64_t
+cycles (void)
+{
+#ifdef HAVE_RDTSC
+	return __rdtsc ();
+#else
+	return 0;
+#endif
+}
+
+static void
+usage (void)
+{
+	printf ("interpolation_bench - compare varispeed interpolators.\n\n");
+	printf ("Usage: interpolation_bench [ OPTIONS ]\n\n");
+	printf ("Options:\n\
+  -b <samples>  samples per cycle (default 1024)\n\
+  -f <hz>       frequency of the pass-band tone (default 1000)\n\
+  -h            print this message\n\
+  -n <cycles>   number of cycles to run (default 500)\n\
+  -r <rate>     sample rate (default 48000)\n\
+  -s <speed>    test only this speed\n\n");
+}
+
+struct Result {
+	double thdn;
+	double alias;
+	double usec_per_sample;
+	double cycles_per_sample;
+};
+
+/* run @a interp like DiskReader::run (), return the output */
+static void
+run (Interpolation& interp, std::vector<Sample>& in, std::vector<Sample>& out, double speed, samplecnt_t n_samples, uint32_t n_cycles, int64_t& t_usec, uint64_t& t_cycles)
+{
+	interp.reset ();
+	interp.set_speed (speed);
+
+	samplecnt_t pos = 0;
+	t_usec = 0;
+	t_cycles = 0;
+
+	for (uint32_t c = 0; c < n_cycles; ++c) {
+		const samplecnt_t to_consume = interp.distance (n_samples);
+		samplecnt_t ocnt = n_samples;
+		const int64_t  t0 = usec ();
+		const uint64_t c0 = cycles ();
+		interp.interpolate (0, in.size () - pos, &in[pos], ocnt, &out[c * n_samples]);
+		t_cycles += cycles () - c0;
+		t_usec   += usec () - t0;
+		if (ocnt != n_samples) {
+			memset (&out[c * n_samples + ocnt], 0, sizeof (Sample) * (n_samples - ocnt));
+		}
+		pos += to_consume;
+	}
+}
+
+/* the speed the transport actually moves at */
+static double
+effective_speed (double speed, samplecnt_t n_samples)
+{
+	return floor (speed * n_samples) / n_samples;
+}
+
+static void
+sine (std::vector<Sample>& buf, double freq, double rate)
+{
+	for (size_t i = 0; i < buf.size (); ++i) {
+		buf[i] = .5 * sin (2.0 * M_PI * freq * i / rate);
+	}
+}
+
+/* residual of a least-squares fit of a sine with known frequency (and DC),
+ * relative to the fitted sine, in dB */
+static double
+thd_n (Sample const* x, size_t n, double omega)
+{
+	double m[3][3] = { { 0 } };
+	double v[3] = { 0 };
+	for (size_t i = 0; i < n; ++i) {
+		const double b[3] = { sin (omega * i), cos (omega * i), 1.0 };
+		for (int r = 0; r < 3; ++r) {
+			for (int c = 0; c < 3; ++c) {
+				m[r][c] += b[r] * b[c];
+			}
+			v[r] += b[r] * x[i];
+		}
+	}
+
+	/* Gauss-Jordan, the matrix is well conditioned */
+	for (int p = 0; p < 3; ++p) {
+		for (int r = 0; r < 3; ++r) {
+			if (r == p) {
+				continue;
+			}
+			const double f = m[r][p] / m[p][p];
+			for (int c = 0; c < 3; ++c) {
+				m[r][c] -= f * m[p][c];
+			}
+			v[r] -= f * v[p];
+		}
+	}
+	const double a = v[0] / m[0][0];
+	const double b = v[1] / m[1][1];
+	const double d = v[2] / m[2][2];
+
+	double e_sig = 0;
+	double e_res = 0;
+	for (size_t i = 0; i < n; ++i) {
+		const double s = a * sin (omega * i) + b * cos (omega * i);
+		e_sig += s * s;
+		e_res += (x[i] - s - d) * (x[i] - s - d);
+	}
+	return 10.0 * log10 (e_res / e_sig + 1e-30);
+}
+
+static double
+level (Sample const* x, size_t n)
+{
+	double e = 0;
+	for (size_t i = 0; i < n; ++i) {
+		e += x[i] * x[i];
+	}
+	/* relative to the RMS of a sine with amplitude .5 */
+	return 10.0 * log10 (e / n / .125 + 1e-30);
+}
+
+static Result
+measure (Interpolation& interp, double speed, double freq, double rate, samplecnt_t n_samples, uint32_t n_cycles)
+{
+	Result r;
+	std::vector<Sample> in (ceil (speed * n_samples * n_cycles) + 4 * n_samples);
+	std::vector<Sample> out (n_samples * n_cycles);
+	int64_t  t_usec;
+	uint64_t t_cycles;
+
+	/* skip the first cycles, the interpolator starts with silence */
+	const size_t skip = 4 * n_samples;
+
+	sine (in, freq, rate);
+
+	/* the fastest of a few runs, to reduce the influence of other processes */
+	int64_t  min_usec = INT64_MAX;
+	uint64_t min_cycles = UINT64_MAX;
+	for (int i = 0; i < 3; ++i) {
+		run (interp, in, out, speed, n_samples, n_cycles, t_usec, t_cycles);
+		min_usec = std::min (min_usec, t_usec);
+		min_cycles = std::min (min_cycles, t_cycles);
+	}
+
+	r.thdn = thd_n (&out[skip], out.size () - skip, 2.0 * M_PI * freq * effective_speed (speed, n_samples) / rate);
+	r.usec_per_sample = min_usec / (double) out.size ();
+	r.cycles_per_sample = min_cycles / (double) out.size ();
+
+	r.alias = 0;
+	if (speed > 1.1) {
+		sine (in, .55 * rate / speed, rate);
+		run (interp, in, out, speed, n_samples, n_cycles, t_usec, t_cycles);
+		r.alias = level (&out[skip], out.size () - skip);
+	}
+	return r;
+}
+
+/* the output must not depend on how the input is split */
+static bool
+check_split (SincInterpolation& interp, double speed, double rate, samplecnt_t n_samples)
+{
+	const uint32_t n_cycles = std::max<uint32_t> (50, 8192 / n_samples);
+	std::vector<Sample> in (ceil (speed * n_samples * n_cycles) + 4 * n_samples);
+	std::vector<Sample> ref (n_samples * n_cycles);
+	std::vector<Sample> out (n_samples * n_cycles);
+	int64_t  t_usec;
+	uint64_t t_cycles;
+
+	sine (in, 997, rate);
+	run (interp, in, ref, speed, n_samples, n_cycles, t_usec, t_cycles);
+
+	/* the input that is consumed must match distance (), a slip shows
+	 * up as a click */
+	const size_t skip = std::max<size_t> (4 * n_samples, 2048);
+	const double thdn = thd_n (&ref[skip], ref.size () - skip, 2.0 * M_PI * 997 * effective_speed (speed, n_samples) / rate);
+	if (thdn > -60) {
+		fprintf (stderr, "THD+N at speed %.3f with %ld samples per cycle is %.1f dB\n", speed, (long) n_samples, thdn);
+		return false;
+	}
+
+	interp.reset ();
+	interp.set_speed (speed);
+	samplecnt_t pos = 0;
+	for (uint32_t c = 0; c < n_cycles; ++c) {
+		const samplecnt_t to_consume = interp.distance (n_samples);
+		if (to_consume != (samplecnt_t) floor (speed * n_samples)) {
+			/* the session moves the transport by floor (speed * n) */
+			fprintf (stderr, "Playback drifts from the transport at speed %.3f with %ld samples per cycle\n", speed, (long) n_samples);
+			return false;
+		}
+		/* split somewhere in (or just after) the data of this cycle */
+		const samplecnt_t len0 = 1 + (c * 7919) % (to_consume + interp.lookahead ());
+		samplecnt_t ocnt = n_samples;
+		Sample* o = &out[c * n_samples];
+		interp.interpolate (0, len0, &in[pos], ocnt, o);
+		if (ocnt < n_samples) {
+			o += ocnt;
+			ocnt = n_samples - ocnt;
+			interp.interpolate (0, in.size () - pos - len0, &in[pos + len0], ocnt, o);
+		}
+		pos += to_consume;
+	}
+
+	/* positions are relative to the start of the input, so rounding
+	 * differs slightly */
+	float max_diff = 0;
+	for (size_t i = 0; i < ref.size (); ++i) {
+		max_diff = std::max (max_diff, fabsf (ref[i] - out[i]));
+	}
+	if (max_diff > 1e-6) {
+		fprintf (stderr, "Split input changes the output at speed %.3f with %ld samples per cycle by %g\n", speed, (long) n_samples, max_diff);
+		return false;
+	}
+	return true;
+}
+
+int
+main (int argc, char** argv)
+{
+	samplecnt_t n_samples = 1024;
+	uint32_t    n_cycles  = 500;
+	double      rate      = 48000;
+	double      freq      = 1000;
+	double      only      = 0;
+
+	int c;
+	while ((c = getopt (argc, argv, "b:f:hn:r:s:")) != -1) {
+		switch (c) {
+			case 'b': n_samples = atoi (optarg); break;
+			case 'f': freq = atof (optarg); break;
+			case 'n': n_cycles = atoi (optarg); break;
+			case 'r': rate = atof (optarg); break;
+			case 's': only = atof (optarg); break;
+			case 'h':
+				usage ();
+				return 0;
+			default:
+				usage ();
+				return 1;
+		}
+	}
+
+	if (optind != argc || n_samples < 64 || n_cycles < 8 || only < 0 || freq <= 0 || freq >= rate / 4) {
+		usage ();
+		return 1;
+	}
+
+	const double speeds[] = { 0.25, 0.5, 0.8, 0.97, 1.02, 1.2, 1.4, 1.5, 1.7, 2.0, 2.7, 3.0, 3.2 };
+	std::vector<double> test_speeds;
+	if (only > 0) {
+		test_speeds.push_back (only);
+	} else {
+		test_speeds.assign (speeds, speeds + sizeof (speeds) / sizeof (double));
+	}
+
+	CubicInterpolation cubic;
+	SincInterpolation  fast (SincInterpolation::Fast);
+	SincInterpolation  medium (SincInterpolation::Medium);
+	SincInterpolation  best (SincInterpolation::Best);
+
+	Interpolation* interp[] = { &cubic, &fast, &medium, &best };
+	const char* names[] = { "cubic", "sinc fast", "sinc medium", "sinc best" };
+	const int n_interp = 4;
+
+	for (int i = 0; i < n_interp; ++i) {
+		interp[i]->add_channel ();
+	}
+
+	printf ("%.0f Hz tone, %.0f Hz sample rate, %ld samples per cycle\n\n", freq, rate, (long) n_samples);
+	printf ("%-12s %6s %10s %10s %10s %10s\n", "", "speed", "THD+N[dB]", "alias[dB]", "usec/smpl", "cyc/smpl");
+
+	int rv = 0;
+
+	for (size_t s = 0; s < test_speeds.size (); ++s) {
+		double cubic_thdn = 0;
+		for (int i = 0; i < n_interp; ++i) {
+			const Result r = measure (*interp[i], test_speeds[s], freq, rate, n_samples, n_cycles);
+			printf ("%-12s %6.3f %10.1f ", names[i], test_speeds[s], r.thdn);
+			if (test_speeds[s] > 1.1) {
+				printf ("%10.1f ", r.alias);
+			} else {
+				printf ("%10s ", "-");
+			}
+			printf ("%10.5f %10.1f\n", r.usec_per_sample, r.cycles_per_sample);
+
+			if (i == 0) {
+				cubic_thdn = r.thdn;
+			} else if (r.thdn > cubic_thdn) {
+				fprintf (stderr, "%s is worse than cubic at speed %.3f\n", names[i], test_speeds[s]);
+				rv = 1;
+			}
+		}
+		printf ("\n");
+
+		/* odd and small block sizes that used to make the interpolator
+		 * slip by one sample */
+		const samplecnt_t block_sizes[] = { n_samples, 64, 100, 256 };
+		for (int i = 1; i < n_interp; ++i) {
+			for (size_t b = 0; b < sizeof (block_sizes) / sizeof (samplecnt_t); ++b) {
+				if (!check_split (*static_cast<SincInterpolation*> (interp[i]), test_speeds[s], rate, block_sizes[b])) {
+					rv = 1;
+				}
+			}
+		}
+	}
+
+	if (rv) {
+		printf ("FAILED\n");
+	}
+	return rv;
+}
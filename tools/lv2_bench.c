@@ -0,0 +1,301 @@
+/* gcc -O2 -o lv2_bench tools/lv2_bench.c `pkg-config --cflags lv2` -ldl -lm */
+
+/* Run an LV2 plugin on synthetic buffers, without a host or a session.
+ *
+ * The plugin library is loaded directly, all ports are connected to plain
+ * buffers: audio inputs get a deterministic mix of a sine sweep and noise,
+ * control ports are set on the command line, unmentioned ports read 0.
+ * Controls can be toggled periodically to exercise parameter smoothing.
+ *
+ * The time per cycle is reported, and the output can be written to a raw
+ * float file and compared against one from a different build of the same
+ * plugin (e.g. to check that an optimization does not change the result).
+ *
+ * Example (a-eq, all bands enabled, master +3dB, band 1 gain toggled):
+ *
+ *   ./lv2_bench -c 0=160 -c 1=2 -c 2=300 -c 3=-4 -c 4=1 -c 5=1000 -c 6=3 -c 7=1 \
+ *     -c 8=2500 -c 9=-2 -c 10=1 -c 11=6000 -c 12=4 -c 13=1 -c 14=9000 -c 15=-3 \
+ *     -c 16=3 -c 17=1 -c 18=1 -c 19=1 -c 20=1 -c 21=1 -c 22=1 -c 23=1 \
+ *     -m 3=6 -a 24 -o 25 -w new.raw \
+ *     build/libs/LV2/a-eq.lv2/a-eq.so urn:ardour:a-eq
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <getopt.h>
+#include <dlfcn.h>
+
+#include "lv2/lv2plug.in/ns/lv2core/lv2.h"
+
+#define MAX_PORTS 128
+
+static int64_t
+usec (void)
+{
+	struct timespec ts;
+	clock_gettime (CLOCK_MONOTONIC, &ts);
+	return (int64_t) ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static void
+usage (void)
+{
+	printf ("lv2_bench - run an LV2 plugin on synthetic data.\n\n");
+	printf ("Usage: lv2_bench [ OPTIONS ] <plugin-library> <plugin-uri>\n\n");
+	printf ("Options:\n\
+  -a <port>        audio input port (may be given several times)\n\
+  -b <samples>     samples per cycle (default 1024)\n\
+  -c <port>=<val>  set control input port\n\
+  -e <tolerance>   max absolute difference for -x (default 0)\n\
+  -h               print this message\n\
+  -m <port>=<val>  toggle control port between its -c value and <val>\n\
+  -n <cycles>      number of cycles to run (default 10000)\n\
+  -o <port>        audio output port (may be given several times)\n\
+  -p <cycles>      toggle period for -m (default 50)\n\
+  -r <rate>        sample rate (default 48000)\n\
+  -w <file>        write output to raw float file\n\
+  -x <file>        compare output with raw float file\n\n");
+}
+
+static int
+parse_port_value (const char* arg, uint32_t* port, float* val)
+{
+	char* end;
+	*port = strtoul (arg, &end, 10);
+	if (*end != '=' || *port >= MAX_PORTS) {
+		return -1;
+	}
+	*val = strtof (end + 1, NULL);
+	return 0;
+}
+
+int
+main (int argc, char** argv)
+{
+	uint32_t n_samples = 1024;
+	uint32_t n_cycles  = 10000;
+	uint32_t period    = 50;
+	double   rate      = 48000;
+	float    tolerance = 0;
+	const char* write_file = NULL;
+	const char* cmp_file   = NULL;
+
+	float    control[MAX_PORTS];
+	float    toggle[MAX_PORTS];
+	int      is_toggled[MAX_PORTS];
+	uint32_t audio_in[MAX_PORTS];
+	uint32_t audio_out[MAX_PORTS];
+	uint32_t n_in  = 0;
+	uint32_t n_out = 0;
+	uint32_t n_ports = 0;
+
+	memset (control, 0, sizeof (control));
+	memset (is_toggled, 0, sizeof (is_toggled));
+
+	int c;
+	while ((c = getopt (argc, argv, "a:b:c:e:hm:n:o:p:r:w:x:")) != -1) {
+		uint32_t port;
+		float    val;
+		switch (c) {
+			case 'a':
+				audio_in[n_in] = atoi (optarg);
+				if (n_in == MAX_PORTS || audio_in[n_in] >= MAX_PORTS) {
+					usage ();
+					return 1;
+				}
+				if (audio_in[n_in] >= n_ports) { n_ports = audio_in[n_in] + 1; }
+				++n_in;
+				break;
+			case 'o':
+				audio_out[n_out] = atoi (optarg);
+				if (n_out == MAX_PORTS || audio_out[n_out] >= MAX_PORTS) {
+					usage ();
+					return 1;
+				}
+				if (audio_out[n_out] >= n_ports) { n_ports = audio_out[n_out] + 1; }
+				++n_out;
+				break;
+			case 'c':
+			case 'm':
+				if (parse_port_value (optarg, &port, &val)) {
+					usage ();
+					return 1;
+				}
+				if (c == 'c') {
+					control[port] = val;
+				} else {
+					toggle[port] = val;
+					is_toggled[port] = 1;
+				}
+				if (port >= n_ports) { n_ports = port + 1; }
+				break;
+			case 'b': n_samples = atoi (optarg); break;
+			case 'e': tolerance = atof (optarg); break;
+			case 'n': n_cycles = atoi (optarg); break;
+			case 'p': period = atoi (optarg); break;
+			case 'r': rate = atof (optarg); break;
+			case 'w': write_file = optarg; break;
+			case 'x': cmp_file = optarg; break;
+			case 'h':
+				usage ();
+				return 0;
+			default:
+				usage ();
+				return 1;
+		}
+	}
+
+	if (optind + 2 != argc || n_samples == 0 || n_out == 0 || period == 0) {
+		usage ();
+		return 1;
+	}
+
+	void* lib = dlopen (argv[optind], RTLD_NOW | RTLD_LOCAL);
+	if (!lib) {
+		fprintf (stderr, "Cannot load %s: %s\n", argv[optind], dlerror ());
+		return 1;
+	}
+
+	LV2_Descriptor_Function df = (LV2_Descriptor_Function) dlsym (lib, "lv2_descriptor");
+	if (!df) {
+		fprintf (stderr, "%s is not an LV2 plugin library\n", argv[optind]);
+		return 1;
+	}
+
+	const LV2_Descriptor* desc = NULL;
+	for (uint32_t i = 0; (desc = df (i)); ++i) {
+		if (!strcmp (desc->URI, argv[optind + 1])) {
+			break;
+		}
+	}
+	if (!desc) {
+		fprintf (stderr, "Plugin %s was not found in %s\n", argv[optind + 1], argv[optind]);
+		return 1;
+	}
+
+	const LV2_Feature* features[] = { NULL };
+	LV2_Handle handle = desc->instantiate (desc, rate, "", features);
+	if (!handle) {
+		fprintf (stderr, "Cannot instantiate %s\n", desc->URI);
+		return 1;
+	}
+
+	float* in_buf  = (float*) calloc (n_in  * n_samples, sizeof (float));
+	float* out_buf = (float*) calloc (n_out * n_samples, sizeof (float));
+	float* ref_buf = (float*) calloc (n_out * n_samples, sizeof (float));
+	float  port_val[MAX_PORTS];
+
+	for (uint32_t p = 0; p < n_ports; ++p) {
+		port_val[p] = control[p];
+		desc->connect_port (handle, p, &port_val[p]);
+	}
+	for (uint32_t i = 0; i < n_in; ++i) {
+		desc->connect_port (handle, audio_in[i], &in_buf[i * n_samples]);
+	}
+	for (uint32_t i = 0; i < n_out; ++i) {
+		desc->connect_port (handle, audio_out[i], &out_buf[i * n_samples]);
+	}
+
+	FILE* wf = NULL;
+	FILE* xf = NULL;
+	if (write_file && !(wf = fopen (write_file, "wb"))) {
+		fprintf (stderr, "Cannot open %s for writing\n", write_file);
+		return 1;
+	}
+	if (cmp_file && !(xf = fopen (cmp_file, "rb"))) {
+		fprintf (stderr, "Cannot open %s for reading\n", cmp_file);
+		return 1;
+	}
+
+	if (desc->activate) {
+		desc->activate (handle);
+	}
+
+	uint32_t rng = 1;
+	double   phase = 0;
+	int64_t  t_total = 0;
+	int64_t  t_min = INT64_MAX;
+	int64_t  t_max = 0;
+	float    max_diff = 0;
+
+	for (uint32_t cycle = 0; cycle < n_cycles; ++cycle) {
+		/* 20Hz..20kHz log sweep over 10 seconds, plus white noise at -20dBFS.
+		 * Computed in double with a fixed seed, so that the data is the
+		 * same for every build of this tool. */
+		for (uint32_t s = 0; s < n_samples; ++s) {
+			const double t = fmod ((double)(cycle * n_samples + s) / rate, 10.0);
+			phase += 2.0 * M_PI * 20.0 * pow (1000.0, t / 10.0) / rate;
+			if (phase > 2.0 * M_PI) { phase -= 2.0 * M_PI; }
+			for (uint32_t i = 0; i < n_in; ++i) {
+				rng = rng * 1103515245 + 12345;
+				const float noise = ((rng >> 8) / 8388608.f - 1.f) * .1f;
+				in_buf[i * n_samples + s] = .5f * (float) sin (phase + i) + noise;
+			}
+		}
+
+		for (uint32_t p = 0; p < n_ports; ++p) {
+			if (is_toggled[p]) {
+				port_val[p] = ((cycle / period) & 1) ? toggle[p] : control[p];
+			}
+		}
+
+		const int64_t t0 = usec ();
+		desc->run (handle, n_samples);
+		const int64_t t1 = usec ();
+
+		t_total += t1 - t0;
+		if (t1 - t0 < t_min) { t_min = t1 - t0; }
+		if (t1 - t0 > t_max) { t_max = t1 - t0; }
+
+		if (wf && fwrite (out_buf, sizeof (float), n_out * n_samples, wf) != n_out * n_samples) {
+			fprintf (stderr, "Write error\n");
+			return 1;
+		}
+
+		if (xf) {
+			if (fread (ref_buf, sizeof (float), n_out * n_samples, xf) != n_out * n_samples) {
+				fprintf (stderr, "Reference file is too short\n");
+				return 1;
+			}
+			for (uint32_t s = 0; s < n_out * n_samples; ++s) {
+				const float d = fabsf (out_buf[s] - ref_buf[s]);
+				if (!isfinite (out_buf[s]) && out_buf[s] != ref_buf[s]) {
+					max_diff = INFINITY;
+				} else if (d > max_diff) {
+					max_diff = d;
+				}
+			}
+		}
+	}
+
+	if (desc->deactivate) {
+		desc->deactivate (handle);
+	}
+	desc->cleanup (handle);
+
+	const double dsp_time = 1e6 * n_samples / rate;
+	printf ("%s: %u cycles of %u samples\n", desc->URI, n_cycles, n_samples);
+	printf ("  min: %6ld usec, max: %6ld usec, avg: %8.2f usec, %6.3f%% DSP load\n",
+			(long) t_min, (long) t_max, (double) t_total / n_cycles,
+			100.0 * t_total / n_cycles / dsp_time);
+
+	int rv = 0;
+	if (xf) {
+		printf ("  max. difference to reference: %g\n", max_diff);
+		rv = max_diff > tolerance ? 2 : 0;
+		fclose (xf);
+	}
+	if (wf) {
+		fclose (wf);
+	}
+
+	free (in_buf);
+	free (out_buf);
+	free (ref_buf);
+	dlclose (lib);
+	return rv;
+}
@@ -0,0 +1,331 @@
+/* gcc -O3 -ffast-math -std=gnu99 -o rsynth_test tools/rsynth_test.c -lm */
+
+/* Offline comparison and polyphony benchmark for the reasonable synth.
+ *
+ * The voice-parallel engine (RS_LANES voices per batch) is compared
+ * against the previous per-voice engine (copied verbatim below, only the
+ * synthesize function-pointer is replaced by a direct call), sample by
+ * sample, at increasing polyphony. Notes are re-triggered periodically,
+ * half of them are released before, so that all ADSR states are used.
+ * Cycle sizes are random, to exercise the internal fragment buffer.
+ *
+ * The new engine approximates sin/cos by a polynomial and derives the
+ * overtones from those, so the output is not bit-identical: the maximum
+ * absolute difference is reported, and must be below the tolerance.
+ *
+ * Returns 0 if all differences are within the tolerance.
+ */
+
+#include <stdio.h>
+#include <getopt.h>
+#include <time.h>
+
+#include "../libs/plugins/reasonablesynth.lv2/rsynth.c"
+
+#define MAX_CYCLE 2048
+
+static int64_t
+usec (void)
+{
+	struct timespec ts;
+	clock_gettime (CLOCK_MONOTONIC, &ts);
+	return (int64_t) ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+/* reference implementation, one voice at a time */
+
+static void reference_synthesize_sineP (RSSynthChannel* sc,
+    const uint8_t note, const float vol, const float fq,
+    const size_t n_samples, float* left, float* right) {
+
+  size_t i;
+  float phase = sc->phase[note];
+
+  for (i=0; i < n_samples; ++i) {
+    float env = adsr_env(sc, note);
+    if (sc->adsr_cnt[note] == 0) break;
+    const float amp = vol * env;
+    if (amp > 1e-10) {
+      left[i]  += amp * sinf(2.0 * M_PI * phase);
+      left[i]  += .300 * amp * sinf(2.0 * M_PI * phase * 2.0);
+      left[i]  += .150 * amp * sinf(2.0 * M_PI * phase * 3.0);
+      left[i]  += .080 * amp * sinf(2.0 * M_PI * phase * 4.0);
+      //left[i]  -= .007 * amp * sinf(2.0 * M_PI * phase * 5.0);
+      //left[i]  += .010 * amp * sinf(2.0 * M_PI * phase * 6.0);
+      left[i]  += .020 * amp * sinf(2.0 * M_PI * phase * 7.0);
+      phase += fq;
+      right[i] += amp * sinf(2.0 * M_PI * phase);
+      right[i] += .300 * amp * sinf(2.0 * M_PI * phase * 2.0);
+      right[i] += .150 * amp * sinf(2.0 * M_PI * phase * 3.0);
+      right[i] -= .080 * amp * sinf(2.0 * M_PI * phase * 4.0);
+      //right[i] += .007 * amp * sinf(2.0 * M_PI * phase * 5.0);
+      //right[i] += .010 * amp * sinf(2.0 * M_PI * phase * 6.0);
+      right[i] -= .020 * amp * sinf(2.0 * M_PI * phase * 7.0);
+    } else {
+      phase += fq;
+    }
+    if (phase > 1.0) phase -= 2.0;
+  }
+  sc->phase[note] = phase;
+}
+
+/* process note - move through ADSR states, count active keys,.. */
+static void reference_process_key (void *synth,
+    const uint8_t chn, const uint8_t note,
+    const size_t n_samples, float *left, float *right)
+{
+  RSSynthesizer*  rs = (RSSynthesizer*)synth;
+  RSSynthChannel* sc = &rs->sc[chn];
+  const int8_t vel = sc->miditable[note];
+  const int8_t msg = sc->midimsgs[note];
+  const float vol = /* master_volume */ 0.1f * abs(vel) / 127.f;
+  const float phase = sc->phase[note];
+  const int8_t sus = sc->sustain;
+  sc->midimsgs[note] &= ~3;
+
+  if (phase == -10 && vel > 0) {
+    // new note on
+    sc->midimsgs[note] &= ~4;
+    assert(sc->adsr_cnt[note] == 0);
+    sc->adsr_amp[note] = 0;
+    sc->adsr_cnt[note] = 0;
+    sc->phase[note] = 0;
+    sc->keycomp++;
+    //printf("[On] Now %d keys active on chn %d\n", sc->keycomp, chn);
+  }
+  else if (phase >= -1.0 && phase <= 1.0 && vel > 0) {
+    // sustain note or re-start note while adsr in progress:
+    if (sc->adsr_cnt[note] > sc->adsr.off[1] || msg == 3 || msg == 5 || msg == 7) {
+      sc->midimsgs[note] &= ~4;
+      // x-fade to attack
+      sc->adsr_amp[note] = adsr_env(sc, note);
+      sc->adsr_cnt[note] = 0;
+    }
+  }
+  else if (phase >= -1.0 && phase <= 1.0 && vel < 0) {
+    sc->midimsgs[note] |= 4;
+    // note off
+    if (sc->adsr_cnt[note] <= sc->adsr.off[1] && !sus) {
+      if (sc->adsr_cnt[note] != sc->adsr.off[1]) {
+        // x-fade to release
+        sc->adsr_amp[note] = adsr_env(sc, note);
+      }
+      sc->adsr_cnt[note] = sc->adsr.off[1] + 1;
+    }
+    else if (sus && sc->adsr_cnt[note] == sc->adsr.off[1]) {
+      sc->adsr_cnt[note] = sc->adsr.off[1] + 1;
+    }
+  }
+  else {
+    //printf("FORCE NOTE OFF: %d %d\n", vel, sus);
+    /* note-on + off in same cycle */
+    sc->miditable[note] = 0;
+    sc->adsr_cnt[note] = 0;
+    sc->phase[note] = -10;
+    return;
+  }
+  //printf("NOTE: %d (%d %d %d)\n", sc->adsr_cnt[note], sc->adsr.off[0], sc->adsr.off[1], sc->adsr.off[2]);
+
+  // synthesize actual sound
+  reference_synthesize_sineP(sc, note, vol, rs->freqs[note], n_samples, left, right);
+
+  if (sc->adsr_cnt[note] == 0) {
+    //printf("Note %d,%d released\n", chn, note);
+    sc->midimsgs[note] = 0;
+    sc->miditable[note] = 0;
+    sc->adsr_amp[note] = 0;
+    sc->phase[note] = -10;
+    sc->keycomp--;
+    //printf("[off] Now %d keys active on chn %d\n", sc->keycomp, chn);
+  }
+}
+
+/* synthesize a BUFFER_SIZE_SAMPLES's of audio-data */
+static void reference_synth_fragment (void *synth, const size_t n_samples, float *left, float *right) {
+  RSSynthesizer* rs = (RSSynthesizer*)synth;
+  memset (left, 0, n_samples * sizeof(float));
+  memset (right, 0, n_samples * sizeof(float));
+  uint8_t keycomp = 0;
+  int c,k;
+  size_t i;
+
+  for (c=0; c < 16; ++c) {
+    for (k=0; k < 128; ++k) {
+      if (rs->sc[c].miditable[k] == 0) continue;
+      reference_process_key(synth, c, k, n_samples, left, right);
+    }
+    keycomp += rs->sc[c].keycomp;
+  }
+
+#if 1 // key-compression
+  float kctgt = 8.0 / (float)(keycomp + 7.0);
+  if (kctgt < .5) kctgt = .5;
+  if (kctgt > 1.0) kctgt = 1.0;
+  const float _w = rs->kcfilt;
+  for (i=0; i < n_samples; ++i) {
+    rs->kcgain += _w * (kctgt - rs->kcgain);
+    left[i]  *= rs->kcgain;
+    right[i] *= rs->kcgain;
+  }
+  rs->kcgain += 1e-12;
+#endif
+}
+
+static uint32_t reference_synth_sound (void *synth, uint32_t written, const uint32_t nframes, float **out) {
+  RSSynthesizer* rs = (RSSynthesizer*)synth;
+
+  while (written < nframes) {
+    uint32_t nremain = nframes - written;
+
+    if (rs->boffset >= BUFFER_SIZE_SAMPLES)  {
+      const uint32_t tosynth = MIN(BUFFER_SIZE_SAMPLES, nremain);
+      rs->boffset = BUFFER_SIZE_SAMPLES - tosynth;
+      reference_synth_fragment(rs, tosynth, &(rs->buf[0][rs->boffset]), &(rs->buf[1][rs->boffset]));
+    }
+
+    uint32_t nread = MIN(nremain, (BUFFER_SIZE_SAMPLES - rs->boffset));
+
+    memcpy(&out[0][written], &rs->buf[0][rs->boffset], nread*sizeof(float));
+    memcpy(&out[1][written], &rs->buf[1][rs->boffset], nread*sizeof(float));
+
+    written += nread;
+    rs->boffset += nread;
+  }
+  return written;
+}
+
+/* test */
+
+static void
+send_notes (void* ref, void* cmp, uint32_t polyphony, uint8_t status, uint8_t velocity, uint32_t step)
+{
+	for (uint32_t j = 0; j < polyphony; j += step) {
+		/* distinct notes 21..108, spread over channels */
+		const uint8_t msg[3] = { status | (j / 88), 21 + (j * 5) % 88, velocity };
+		synth_parse_midi (ref, msg, 3);
+		synth_parse_midi (cmp, msg, 3);
+	}
+}
+
+static void
+usage (void)
+{
+	printf ("rsynth_test - compare the reasonable synth with its reference implementation.\n\n");
+	printf ("Usage: rsynth_test [ OPTIONS ]\n\n");
+	printf ("Options:\n\
+  -e <tolerance>   max absolute difference (default 1e-5)\n\
+  -h               print this message\n\
+  -s <seconds>     duration per test (default 10)\n\n");
+}
+
+static int
+compare (double rate, uint32_t polyphony, float duration, float tolerance)
+{
+	float ref_l[MAX_CYCLE], ref_r[MAX_CYCLE];
+	float cmp_l[MAX_CYCLE], cmp_r[MAX_CYCLE];
+	float* ref_out[2] = { ref_l, ref_r };
+	float* cmp_out[2] = { cmp_l, cmp_r };
+
+	void* ref = synth_alloc ();
+	void* cmp = synth_alloc ();
+	synth_init (ref, rate);
+	synth_init (cmp, rate);
+
+	/* re-trigger every 250ms, release every other note after 200ms */
+	const size_t period = rate / 4;
+	const size_t hold = rate / 5;
+
+	int64_t t_ref = 0;
+	int64_t t_cmp = 0;
+	float max_diff = 0;
+	float peak = 0;
+	size_t done = 0;
+	size_t next_on = 0;
+	size_t next_off = hold;
+	uint8_t velocity = 100;
+
+	while (done < duration * rate) {
+		uint32_t n_samples;
+		switch (rand () % 4) {
+			case 0:  n_samples = 1 + rand () % 100; break;
+			case 1:  n_samples = 1 + rand () % MAX_CYCLE; break;
+			default: n_samples = 64 << (rand () % 4); break;
+		}
+
+		/* events are applied at the start of a cycle */
+		if (done >= next_on) {
+			send_notes (ref, cmp, polyphony, 0x90, velocity, 1);
+			velocity = 40 + (velocity + 37) % 88;
+			next_on += period;
+		}
+		if (done >= next_off) {
+			send_notes (ref, cmp, polyphony, 0x80, 0, 2);
+			next_off += period;
+		}
+
+		int64_t t0 = usec ();
+		reference_synth_sound (ref, 0, n_samples, ref_out);
+		int64_t t1 = usec ();
+		synth_sound (cmp, 0, n_samples, cmp_out);
+		int64_t t2 = usec ();
+
+		t_ref += t1 - t0;
+		t_cmp += t2 - t1;
+
+		for (uint32_t i = 0; i < n_samples; ++i) {
+			const float d = fmaxf (fabsf (ref_l[i] - cmp_l[i]), fabsf (ref_r[i] - cmp_r[i]));
+			if (!(d <= max_diff)) {
+				max_diff = isfinite (d) ? d : INFINITY;
+			}
+			peak = fmaxf (peak, fmaxf (fabsf (ref_l[i]), fabsf (ref_r[i])));
+		}
+
+		done += n_samples;
+	}
+
+	printf ("%6.0f Hz, polyphony %3u: peak %.3f, max. difference %.2g, reference %7.1f ms, voice-parallel %6.1f ms (%.2fx)\n",
+			rate, polyphony, peak, max_diff,
+			t_ref / 1e3, t_cmp / 1e3, t_cmp > 0 ? t_ref / (double) t_cmp : 0);
+
+	synth_free (ref);
+	synth_free (cmp);
+
+	return max_diff <= tolerance ? 0 : 1;
+}
+
+int
+main (int argc, char** argv)
+{
+	const double rates[] = { 44100, 48000, 96000 };
+	const uint32_t polyphony[] = { 1, 2, 3, 4, 8, 16, 32, 64, 128 };
+	float tolerance = 1e-5;
+	float duration = 10;
+	int rv = 0;
+
+	int c;
+	while ((c = getopt (argc, argv, "e:hs:")) != -1) {
+		switch (c) {
+			case 'e': tolerance = atof (optarg); break;
+			case 's': duration = atof (optarg); break;
+			case 'h':
+				usage ();
+				return 0;
+			default:
+				usage ();
+				return 1;
+		}
+	}
+
+	srand (1);
+
+	for (size_t r = 0; r < sizeof (rates) / sizeof (double); ++r) {
+		for (size_t p = 0; p < sizeof (polyphony) / sizeof (uint32_t); ++p) {
+			rv |= compare (rates[r], polyphony[p], duration, tolerance);
+		}
+	}
+
+	if (rv) {
+		printf ("FAILED\n");
+	}
+	return rv;
+}